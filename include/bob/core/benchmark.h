@@ -0,0 +1,376 @@
+/**
+ * @file bob/core/benchmark.h
+ * @date Fri 16 Oct 2026 18:10:37 CEST
+ * @author agent <agent@local>
+ *
+ * @brief A minimal harness for the benchmarks of the bob_benchmark targets.
+ *
+ * A benchmark program defines BOB_BENCHMARK_SUITE (its name) and
+ * BOB_BENCHMARK_MAIN before including this file, and implements
+ * bob_benchmark(), which registers its benchmarks with Suite::run():
+ *
+ * @code
+ * #define BOB_BENCHMARK_SUITE "sp"
+ * #define BOB_BENCHMARK_MAIN
+ * #include "bob/core/benchmark.h"
+ *
+ * void bob_benchmark(bob::core::benchmark::Suite& suite) {
+ *   ...
+ *   suite.run("fft2d/256x256", functor, 1, 256*256*sizeof(double));
+ * }
+ * @endcode
+ *
+ * BOB_BENCHMARK_MAIN defines main() and replaces the global operator
+ * new/delete, in order to count the heap allocations made by each
+ * benchmark (including the ones made inside the bob libraries). It must
+ * hence be defined in a single translation unit of the program.
+ *
+ * The programs accept the following options:
+ *
+ *   --json=FILE       writes the results to FILE, in JSON format
+ *   --filter=TEXT     only runs the benchmarks whose name contains TEXT
+ *   --min-time=SEC    minimum running time of each benchmark (default 0.5)
+ *   --repetitions=N   number of timed repetitions (default 5)
+ *
+ * Other arguments are left to the benchmarks (e.g. data files), see
+ * Suite::getArguments().
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_CORE_BENCHMARK_H
+#define BOB_CORE_BENCHMARK_H
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <stdint.h>
+#include <boost/format.hpp>
+#include <boost/thread.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/random.hpp>
+#include <blitz/array.h>
+#include "bob/config.h"
+
+namespace bob {
+/**
+ * \ingroup libcore_api
+ * @{
+ *
+ */
+  namespace core { namespace benchmark {
+
+    /**
+     * @brief Heap allocation counters, updated by the operator new
+     * replacements of BOB_BENCHMARK_MAIN (and left to zero otherwise).
+     */
+    struct AllocationCounters {
+      volatile uint64_t count;
+      volatile uint64_t bytes;
+    };
+
+    inline AllocationCounters& allocationCounters() {
+      static AllocationCounters counters = {0, 0};
+      return counters;
+    }
+
+    /**
+     * @brief The result of a benchmark. Times are given per operation, i.e.
+     * per call to the benchmarked functor.
+     */
+    struct Result {
+      std::string name;
+      uint64_t iterations; ///< operations per repetition
+      size_t repetitions;
+      double ns_per_op; ///< median over the repetitions
+      double ns_per_op_min;
+      double ns_per_op_max;
+      double items_per_second; ///< from the median time
+      double bytes_per_second; ///< from the median time (0 if not given)
+      double allocations_per_op;
+      double allocated_bytes_per_op;
+    };
+
+    /**
+     * @brief Fills an array with values drawn uniformly in [min, max), from
+     * a generator seeded with seed (the data of the benchmarks is hence the
+     * same from one run to the next one)
+     */
+    template <typename T, int N>
+    void randomize(blitz::Array<T,N>& a, const double min=0.,
+      const double max=1., const uint32_t seed=0)
+    {
+      boost::mt19937 rng(seed);
+      boost::uniform_real<double> range(min, max);
+      for (typename blitz::Array<T,N>::iterator it=a.begin(); it!=a.end(); ++it)
+        *it = static_cast<T>(range(rng));
+    }
+
+    /**
+     * @brief A functor calling op(src, dst), the convention followed by
+     * most of the operators of bob
+     */
+    template <typename Op, typename S, typename D>
+    struct Apply {
+      Op* op;
+      const S* src;
+      D* dst;
+      void operator()() const { (*op)(*src, *dst); }
+    };
+
+    template <typename Op, typename S, typename D>
+    Apply<Op,S,D> apply(Op& op, const S& src, D& dst) {
+      Apply<Op,S,D> retval = {&op, &src, &dst};
+      return retval;
+    }
+
+    /**
+     * @brief A set of benchmarks, timed and reported by the same program
+     */
+    class Suite {
+
+      public:
+
+        /**
+         * @brief Parses the options of the command line (see the file
+         * documentation)
+         */
+        Suite(const std::string& name, int argc, char** argv):
+          m_name(name), m_min_time(0.5), m_repetitions(5)
+        {
+          for (int i=1; i<argc; ++i) {
+            const std::string arg(argv[i]);
+            if (arg.find("--json=") == 0) m_json = arg.substr(7);
+            else if (arg.find("--filter=") == 0) m_filter = arg.substr(9);
+            else if (arg.find("--min-time=") == 0)
+              m_min_time = std::atof(arg.substr(11).c_str());
+            else if (arg.find("--repetitions=") == 0)
+              m_repetitions = std::max(1, std::atoi(arg.substr(14).c_str()));
+            else m_arguments.push_back(arg);
+          }
+        }
+
+        /**
+         * @brief The arguments of the command line that are not options of
+         * the harness
+         */
+        const std::vector<std::string>& getArguments() const
+        { return m_arguments; }
+
+        /**
+         * @brief Times the given functor, called without arguments. Each
+         * call is one operation, which processes items_per_op items and
+         * bytes_per_op bytes (used to report the throughput).
+         *
+         * The functor is called once to warm up, then a number of times
+         * that is increased until a repetition lasts min_time/repetitions,
+         * and finally repetitions times this number of times. The median
+         * time is reported.
+         */
+        template <typename F>
+        void run(const std::string& name, F f, const double items_per_op=1.,
+          const double bytes_per_op=0.)
+        {
+          if (!m_filter.empty() && name.find(m_filter) == std::string::npos)
+            return;
+
+          f();
+          const double target = 1e9 * m_min_time / m_repetitions;
+          uint64_t iterations = 1;
+          for (;;) {
+            const double elapsed = time(f, iterations);
+            if (elapsed >= target || iterations >= ((uint64_t)1 << 40)) break;
+            if (elapsed < target / 16.) iterations *= 16;
+            else iterations = (uint64_t)(iterations * 1.2 * target / elapsed) + 1;
+          }
+
+          AllocationCounters& counters = allocationCounters();
+          const uint64_t count = counters.count;
+          const uint64_t bytes = counters.bytes;
+          std::vector<double> ns(m_repetitions);
+          for (size_t r=0; r<m_repetitions; ++r)
+            ns[r] = time(f, iterations) / iterations;
+          const double ops = (double)iterations * m_repetitions;
+
+          Result result;
+          result.name = name;
+          result.iterations = iterations;
+          result.repetitions = m_repetitions;
+          std::sort(ns.begin(), ns.end());
+          result.ns_per_op = (m_repetitions % 2) ? ns[m_repetitions/2] :
+            0.5 * (ns[m_repetitions/2-1] + ns[m_repetitions/2]);
+          result.ns_per_op_min = ns.front();
+          result.ns_per_op_max = ns.back();
+          result.items_per_second = 1e9 * items_per_op / result.ns_per_op;
+          result.bytes_per_second = 1e9 * bytes_per_op / result.ns_per_op;
+          result.allocations_per_op = (counters.count - count) / ops;
+          result.allocated_bytes_per_op = (counters.bytes - bytes) / ops;
+          m_results.push_back(result);
+
+          std::cout << boost::format("%-44s %12.1f %12.4g %12.4g %10.2f")
+            % name % result.ns_per_op % result.items_per_second
+            % result.bytes_per_second % result.allocations_per_op
+            << std::endl;
+        }
+
+        /**
+         * @brief Writes the JSON report (if requested) and returns the exit
+         * status of the program
+         */
+        int report() const {
+          if (m_json.empty()) return 0;
+          std::ofstream out(m_json.c_str());
+          if (!out) {
+            std::cerr << "cannot write the benchmark results to '" << m_json
+              << "'" << std::endl;
+            return 1;
+          }
+          out << "{\n  \"context\": {\n";
+          out << "    \"suite\": \"" << escape(m_name) << "\",\n";
+#ifdef BOB_VERSION
+          out << "    \"bob_version\": \"" << escape(BOB_VERSION) << "\",\n";
+#endif
+#ifdef BOB_PLATFORM
+          out << "    \"bob_platform\": \"" << escape(BOB_PLATFORM) << "\",\n";
+#endif
+          out << "    \"date\": \"" << boost::posix_time::to_iso_extended_string(
+              boost::posix_time::second_clock::universal_time()) << "Z\",\n";
+          out << "    \"hardware_concurrency\": "
+            << boost::thread::hardware_concurrency() << ",\n";
+          out << "    \"min_time\": " << m_min_time << ",\n";
+          out << "    \"repetitions\": " << m_repetitions << "\n  },\n";
+          out << "  \"benchmarks\": [";
+          for (size_t i=0; i<m_results.size(); ++i) {
+            const Result& r = m_results[i];
+            out << (i ? ",\n" : "\n") << "    {\"name\": \""
+              << escape(r.name) << "\", "
+              << "\"iterations\": " << r.iterations << ", "
+              << "\"repetitions\": " << r.repetitions << ", "
+              << boost::format("\"ns_per_op\": %.6g, \"ns_per_op_min\": %.6g, "
+                  "\"ns_per_op_max\": %.6g, \"items_per_second\": %.6g, "
+                  "\"bytes_per_second\": %.6g, \"allocations_per_op\": %.6g, "
+                  "\"allocated_bytes_per_op\": %.6g}")
+                % r.ns_per_op % r.ns_per_op_min % r.ns_per_op_max
+                % r.items_per_second % r.bytes_per_second
+                % r.allocations_per_op % r.allocated_bytes_per_op;
+          }
+          out << "\n  ]\n}\n";
+          return out.good() ? 0 : 1;
+        }
+
+        /**
+         * @brief Prints the header of the table of results
+         */
+        void printHeader() const {
+          std::cout << boost::format("%-44s %12s %12s %12s %10s")
+            % ("benchmark suite '" + m_name + "'") % "ns/op" % "items/s"
+            % "bytes/s" % "allocs/op" << std::endl;
+        }
+
+      private:
+
+        template <typename F>
+        static double time(F& f, const uint64_t iterations) {
+          const boost::posix_time::ptime start =
+            boost::posix_time::microsec_clock::universal_time();
+          for (uint64_t i=0; i<iterations; ++i) f();
+          const boost::posix_time::time_duration elapsed =
+            boost::posix_time::microsec_clock::universal_time() - start;
+          return 1e3 * elapsed.total_microseconds();
+        }
+
+        static std::string escape(const std::string& s) {
+          std::string retval;
+          for (size_t i=0; i<s.size(); ++i) {
+            if (s[i] == '"' || s[i] == '\\') retval += '\\';
+            retval += s[i];
+          }
+          return retval;
+        }
+
+        std::string m_name;
+        std::string m_json;
+        std::string m_filter;
+        double m_min_time;
+        size_t m_repetitions;
+        std::vector<std::string> m_arguments;
+        std::vector<Result> m_results;
+    };
+
+  }}
+/**
+ * @}
+ */
+}
+
+/**
+ * @brief Registers and runs the benchmarks of the program. To be
+ * implemented by each program defining BOB_BENCHMARK_MAIN.
+ */
+void bob_benchmark(bob::core::benchmark::Suite& suite);
+
+#ifdef BOB_BENCHMARK_MAIN
+
+#ifndef BOB_BENCHMARK_SUITE
+#define BOB_BENCHMARK_SUITE "bob"
+#endif
+
+#include <new>
+
+static inline void* bob_benchmark_allocate(std::size_t n) {
+  bob::core::benchmark::AllocationCounters& counters =
+    bob::core::benchmark::allocationCounters();
+  __sync_fetch_and_add(&counters.count, 1);
+  __sync_fetch_and_add(&counters.bytes, (uint64_t)n);
+  void* p = std::malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new(std::size_t n) { return bob_benchmark_allocate(n); }
+void* operator new[](std::size_t n) { return bob_benchmark_allocate(n); }
+void* operator new(std::size_t n, const std::nothrow_t&) throw() {
+  try { return bob_benchmark_allocate(n); } catch (...) { return 0; }
+}
+void* operator new[](std::size_t n, const std::nothrow_t&) throw() {
+  try { return bob_benchmark_allocate(n); } catch (...) { return 0; }
+}
+void operator delete(void* p) throw() { std::free(p); }
+void operator delete[](void* p) throw() { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) throw() { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) throw() { std::free(p); }
+
+int main(int argc, char** argv) {
+  bob::core::benchmark::Suite suite(BOB_BENCHMARK_SUITE, argc, argv);
+  suite.printHeader();
+  try {
+    bob_benchmark(suite);
+  }
+  catch (std::exception& e) {
+    std::cerr << "benchmark suite '" << BOB_BENCHMARK_SUITE
+      << "' failed: " << e.what() << std::endl;
+    return 1;
+  }
+  return suite.report();
+}
+
+#endif /* BOB_BENCHMARK_MAIN */
+
+#endif /* BOB_CORE_BENCHMARK_H */
@@ -0,0 +1,134 @@
+/**
+ * @file bob/core/parallel.h
+ * @date Fri 16 Oct 2026 11:05:12 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Helpers to split a loop over independent items across several
+ * threads.
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_CORE_PARALLEL_H
+#define BOB_CORE_PARALLEL_H
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace bob {
+/**
+ * \ingroup libcore_api
+ * @{
+ *
+ */
+  namespace core {
+
+    /**
+     * @brief Returns the number of threads to use for a given request: 0
+     * means one thread per hardware core. The result is never larger than
+     * the number of items to process (and at least 1).
+     */
+    inline size_t getNThreads(const size_t n_threads, const size_t n_items)
+    {
+      size_t n = n_threads;
+      if (n == 0) n = boost::thread::hardware_concurrency();
+      if (n == 0) n = 1;
+      return std::max<size_t>(1, std::min(n, n_items));
+    }
+
+    /**
+     * @brief Returns the first item of the i'th of n_shards contiguous and
+     * balanced shards of [0, n_items). The i'th shard is [start(i),
+     * start(i+1)).
+     */
+    inline size_t shardStart(const size_t i, const size_t n_shards,
+      const size_t n_items)
+    {
+      const size_t q = n_items / n_shards;
+      const size_t r = n_items % n_shards;
+      return i * q + std::min(i, r);
+    }
+
+    namespace detail {
+
+      template <typename F>
+      void parallelRun(F f, const size_t thread, const size_t start,
+        const size_t end, std::string* error)
+      {
+        try {
+          f(thread, start, end);
+        }
+        catch (std::exception& e) {
+          *error = e.what();
+          if (error->empty()) *error = "unknown exception";
+        }
+        catch (...) {
+          *error = "unknown exception";
+        }
+      }
+
+    }
+
+    /**
+     * @brief Splits [0, n_items) in n_threads contiguous shards (see
+     * getNThreads() and shardStart()) and calls f(thread, start, end) for
+     * each of them, each call in its own thread. The first shard is
+     * processed by the calling thread. Returns once all shards have been
+     * processed.
+     *
+     * The shards only depend on n_items and on the number of threads, so
+     * that callers accumulating per-shard results and merging them in shard
+     * order obtain reproducible results.
+     *
+     * If any call throws, the first error (in shard order) is re-thrown as
+     * a std::runtime_error once all threads have finished.
+     */
+    template <typename F>
+    void parallelFor(const size_t n_items, const size_t n_threads, F f)
+    {
+      if (n_items == 0) return;
+      const size_t n = getNThreads(n_threads, n_items);
+      if (n == 1) {
+        f(0, 0, n_items);
+        return;
+      }
+
+      std::vector<std::string> errors(n);
+      std::vector<boost::shared_ptr<boost::thread> > threads;
+      threads.reserve(n-1);
+      for (size_t t=1; t<n; ++t)
+        threads.push_back(boost::shared_ptr<boost::thread>(new boost::thread(
+          boost::bind(&detail::parallelRun<F>, f, t,
+            shardStart(t, n, n_items), shardStart(t+1, n, n_items),
+            &errors[t]))));
+      detail::parallelRun<F>(f, 0, 0, shardStart(1, n, n_items), &errors[0]);
+      for (size_t t=0; t<threads.size(); ++t) threads[t]->join();
+
+      for (size_t t=0; t<n; ++t)
+        if (!errors[t].empty()) throw std::runtime_error(errors[t]);
+    }
+
+  }
+/**
+ * @}
+ */
+}
+
+#endif /* BOB_CORE_PARALLEL_H */
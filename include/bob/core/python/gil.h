@@ -10,6 +10,7 @@
 #define BOB_CORE_PYTHON_GIL_H
 
 #include <Python.h>
+#include <boost/thread/mutex.hpp>
 
 namespace bob { namespace python {
 
@@ -62,6 +63,33 @@ namespace bob { namespace python {
 
   };
 
+  /**
+   * Serializes, once the GIL is released, the use of a C++ object that is
+   * not re-entrant (e.g. because it keeps internal buffers) and that might
+   * be shared by several Python threads. Locks are taken from a fixed pool,
+   * indexed by the address of the object. Always create it after no_gil:
+   * a thread waiting for the lock must not hold the GIL.
+   */
+  class object_lock {
+
+    public:
+
+      /**
+       * Waits until no other thread uses the given object
+       */
+      object_lock (const void* object);
+
+      /**
+       * Releases the object
+       */
+      ~object_lock ();
+
+    private:
+
+      boost::mutex& m_mutex;
+
+  };
+
 }}
 
 #endif /* BOB_CORE_PYTHON_GIL_H */
@@ -76,13 +76,20 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
        * b) Will contain the exact number of dimensions of the input type.
        *
        * When you set "list" to true (the default), datasets are created with
-       * chunking automatically enabled (the chunk size is set to the size of
-       * the given variable) and an extra dimension is inserted to accommodate
-       * list operations.
+       * chunking automatically enabled and an extra dimension is inserted to
+       * accommodate list operations.
+       *
+       * The chunk_size sets how many entries (along the first dimension of
+       * the dataset) are stored in each chunk. The value of zero (the
+       * default) picks it automatically, so that each chunk holds about 64
+       * kilobytes, but at most 32 entries for lists (whose chunks are
+       * allocated as a whole, even if they hold a single entry). This
+       * setting has no effect if the dataset already exists on file or is
+       * neither a list nor compressed.
        */
       Dataset(boost::shared_ptr<Group> parent, const std::string& name,
           const bob::io::HDF5Type& type, bool list=true,
-          size_t compression=0);
+          size_t compression=0, size_t chunk_size=0);
 
     public: //api
 
@@ -263,6 +270,54 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
           return readArray<T,N>(0);
         }
 
+      /**
+       * Reads a contiguous range of arrays from the file in a single I/O
+       * operation. The first dimension of the given array indexes the arrays
+       * to read, starting at position "start", and the remaining dimensions
+       * have to be compatible with the type of each array (see
+       * readArray(index, value)). One-dimensional arrays read ranges of
+       * scalars.
+       *
+       * If the range does not exist, raises an index error.
+       *
+       * @param start The position of the first array to read
+       * @param values The output array. It has to be a zero-based C-style
+       * contiguous storage array. If that is not the case, we will raise an
+       * exception.
+       */
+      template <typename T, int N>
+        void readArrays(size_t start, blitz::Array<T,N>& values) {
+          bob::core::array::assertCZeroBaseContiguous(values);
+          bob::io::HDF5Type dest_type = entry_type(bob::io::HDF5Type(values));
+          read_buffer(start, values.extent(0), dest_type,
+              reinterpret_cast<void*>(values.data()));
+        }
+
+      /**
+       * Reads a contiguous range of arrays from the file into an array
+       * allocated dynamically. The same conditions as for readArrays(start,
+       * values) apply.
+       *
+       * @param start The position of the first array to read
+       * @param count The number of arrays to read
+       */
+      template <typename T, int N>
+        blitz::Array<T,N> readArrays(size_t start, size_t count) {
+          for (size_t k=0; k<m_descr.size(); ++k) {
+            const bob::io::HDF5Shape& S = m_descr[k].type.shape();
+            if ((N == 1 && S.n() == 1 && S[0] == 1) || S.n()+1 == N) {
+              blitz::TinyVector<int,N> shape;
+              shape(0) = count;
+              for (int i=1; i<N; ++i) shape(i) = S[i-1];
+              blitz::Array<T,N> retval(shape);
+              readArrays(start, retval);
+              return retval;
+            }
+          }
+          throw bob::io::HDF5IncompatibleIO(url(),
+              m_descr[0].type.str(), "dynamic shape unknown");
+        }
+
       /**
        * DATA WRITING FUNCTIONALITY
        */
@@ -381,6 +436,52 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
           }
       }
 
+      /**
+       * Replaces a contiguous range of arrays in the file, in a single I/O
+       * operation. The first dimension of the given array indexes the arrays
+       * to replace, starting at position "start". The same conditions as for
+       * replaceArray(index, value) apply to each of these arrays.
+       */
+      template <typename T, int N>
+        void replaceArrays(size_t start, const blitz::Array<T,N>& values) {
+          bob::io::HDF5Type dest_type = entry_type(bob::io::HDF5Type(values));
+          if(!bob::core::array::isCZeroBaseContiguous(values)) {
+            blitz::Array<T,N> tmp = bob::core::array::ccopy(values);
+            write_buffer(start, tmp.extent(0), dest_type,
+                reinterpret_cast<const void*>(tmp.data()));
+          }
+          else {
+            write_buffer(start, values.extent(0), dest_type,
+                reinterpret_cast<const void*>(values.data()));
+          }
+        }
+
+      /**
+       * Appends several arrays at once, in a single I/O operation. The first
+       * dimension of the given array indexes the arrays to append. The same
+       * conditions as for addArray(value) apply to each of these arrays.
+       */
+      template <typename T, int N>
+        void addArrays(const blitz::Array<T,N>& values) {
+          bob::io::HDF5Type dest_type = entry_type(bob::io::HDF5Type(values));
+          if(!bob::core::array::isCZeroBaseContiguous(values)) {
+            blitz::Array<T,N> tmp = bob::core::array::ccopy(values);
+            extend_buffer(tmp.extent(0), dest_type,
+                reinterpret_cast<const void*>(tmp.data()));
+          }
+          else {
+            extend_buffer(values.extent(0), dest_type,
+                reinterpret_cast<const void*>(values.data()));
+          }
+        }
+
+      /**
+       * Returns the type of each of the entries of an array that stacks
+       * several entries along its first dimension (a scalar type for
+       * one-dimensional arrays).
+       */
+      static bob::io::HDF5Type entry_type(const bob::io::HDF5Type& block);
+
     private: //apis
 
       /**
@@ -393,6 +494,13 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
       std::vector<bob::io::HDF5Descriptor>::iterator select (size_t index,
           const bob::io::HDF5Type& dest);
 
+      /**
+       * Selects "count" consecutive objects of the given type, starting at
+       * position "start", for the next read or write operation.
+       */
+      std::vector<bob::io::HDF5Descriptor>::iterator select (size_t start,
+          size_t count, const bob::io::HDF5Type& dest);
+
     public: //direct access for other bindings -- don't use these!
 
       /**
@@ -412,6 +520,26 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
        */
       void extend_buffer (const bob::io::HDF5Type& dest, const void* buffer);
 
+      /**
+       * Reads "count" consecutive objects of type "dest", starting at
+       * position "start", into the given (user) buffer.
+       */
+      void read_buffer (size_t start, size_t count,
+          const bob::io::HDF5Type& dest, void* buffer);
+
+      /**
+       * Writes "count" consecutive objects of type "dest", starting at
+       * position "start", from the given buffer.
+       */
+      void write_buffer (size_t start, size_t count,
+          const bob::io::HDF5Type& dest, const void* buffer);
+
+      /**
+       * Extend the dataset with "count" extra variables of type "dest".
+       */
+      void extend_buffer (size_t count, const bob::io::HDF5Type& dest,
+          const void* buffer);
+
     public: //attribute support
 
       /**
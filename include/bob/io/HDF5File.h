@@ -57,8 +57,14 @@ namespace bob { namespace io {
       /**
        * Constructor, starts a new HDF5File object giving it a file name and an
        * action: excl/trunc/in/inout
+       *
+       * The chunk_cache_size sets the size, in bytes, of the chunk cache HDF5
+       * keeps for each dataset of this file. The value of zero (the default)
+       * keeps the HDF5 default (1 MiB). Larger caches help when reading or
+       * writing datasets with large or compressed chunks.
        */
-      HDF5File (const std::string& filename, mode_t mode);
+      HDF5File (const std::string& filename, mode_t mode,
+          size_t chunk_cache_size=0);
 
       /**
        * Destructor virtualization
@@ -242,6 +248,28 @@ namespace bob { namespace io {
           return readArray<T,N>(path, 0);
       }
 
+      /**
+       * Reads a contiguous range of arrays from the file in a single I/O
+       * operation. The first dimension of "values" indexes the arrays to
+       * read, starting at position "start" (one-dimensional arrays read
+       * ranges of scalars). Raises an exception if the type is incompatible
+       * or the range does not exist. Relative paths are accepted.
+       */
+      template <typename T, int N> void readArrays(const std::string& path,
+          size_t start, blitz::Array<T,N>& values) {
+        (*m_cwd)[path]->readArrays(start, values);
+      }
+
+      /**
+       * Reads "count" arrays from the file, starting at position "start", in
+       * a single I/O operation. The destination array is allocated
+       * internally and returned by value. Relative paths are accepted.
+       */
+      template <typename T, int N> blitz::Array<T,N> readArrays
+        (const std::string& path, size_t start, size_t count) {
+        return (*m_cwd)[path]->readArrays<T,N>(start, count);
+      }
+
       /**
        * Modifies the value of a scalar inside the file. Relative paths are
        * accepted.
@@ -316,16 +344,56 @@ namespace bob { namespace io {
        * of zero turns compression off (the default).
        */
       template <typename T> void appendArray(const std::string& path,
-          const T& value, size_t compression=0) {
+          const T& value, size_t compression=0, size_t chunk_size=0) {
         if (!m_file->writeable()) {
           boost::format m("cannot append array to dataset '%s' at path '%s' of file '%s' because it is not writeable");
           m % path % m_cwd->path() % m_file->filename();
           throw std::runtime_error(m.str());
         }
-        if (!contains(path)) m_cwd->create_dataset(path, bob::io::HDF5Type(value), true, compression);
+        if (!contains(path)) m_cwd->create_dataset(path, bob::io::HDF5Type(value), true, compression, chunk_size);
         (*m_cwd)[path]->addArray(value);
       }
 
+      /**
+       * Appends several arrays to a dataset in a single I/O operation. The
+       * first dimension of "values" indexes the arrays to append
+       * (one-dimensional arrays append several scalars). If the dataset does
+       * not yet exist, one is created with the type characteristics of each
+       * of these arrays. Relative paths are accepted.
+       *
+       * The compression and chunk_size settings are only effective if the
+       * dataset does not yet exist, as for appendArray(). The chunk_size is
+       * the number of arrays stored in each chunk. The value of zero (the
+       * default) sets it automatically, so that each chunk holds about 64
+       * kilobytes, but at most 32 arrays.
+       */
+      template <typename T, int N> void appendArrays(const std::string& path,
+          const blitz::Array<T,N>& values, size_t compression=0,
+          size_t chunk_size=0) {
+        if (!m_file->writeable()) {
+          boost::format m("cannot append arrays to dataset '%s' at path '%s' of file '%s' because it is not writeable");
+          m % path % m_cwd->path() % m_file->filename();
+          throw std::runtime_error(m.str());
+        }
+        if (!contains(path)) m_cwd->create_dataset(path, detail::hdf5::Dataset::entry_type(bob::io::HDF5Type(values)), true, compression, chunk_size);
+        (*m_cwd)[path]->addArrays(values);
+      }
+
+      /**
+       * Modifies a contiguous range of arrays inside the file, starting at
+       * position "start", in a single I/O operation. The first dimension of
+       * "values" indexes the arrays to replace. Relative paths are accepted.
+       */
+      template <typename T, int N> void replaceArrays(const std::string& path,
+          size_t start, const blitz::Array<T,N>& values) {
+        if (!m_file->writeable()) {
+          boost::format m("cannot replace arrays at dataset '%s' at path '%s' of file '%s' because it is not writeable");
+          m % path % m_cwd->path() % m_file->filename();
+          throw std::runtime_error(m.str());
+        }
+        (*m_cwd)[path]->replaceArrays(start, values);
+      }
+
       /**
        * Sets the scalar at position 0 to the given value. This method is
        * equivalent to checking if the scalar at position 0 exists and then
@@ -353,13 +421,13 @@ namespace bob { namespace io {
        * of zero turns compression off (the default).
        */
       template <typename T> void setArray(const std::string& path,
-          const T& value, size_t compression=0) {
+          const T& value, size_t compression=0, size_t chunk_size=0) {
         if (!m_file->writeable()) {
           boost::format m("cannot set array at dataset '%s' at path '%s' of file '%s' because it is not writeable");
           m % path % m_cwd->path() % m_file->filename();
           throw std::runtime_error(m.str());
         }
-        if (!contains(path)) m_cwd->create_dataset(path, bob::io::HDF5Type(value), false, compression);
+        if (!contains(path)) m_cwd->create_dataset(path, bob::io::HDF5Type(value), false, compression, chunk_size);
         (*m_cwd)[path]->replaceArray(0, value);
       }
 
@@ -370,7 +438,7 @@ namespace bob { namespace io {
        * existing data is compatible with the required type.
        */
       void create (const std::string& path, const HDF5Type& dest, bool list,
-          size_t compression);
+          size_t compression, size_t chunk_size=0);
 
       /**
        * Reads data from the file into a buffer. The given buffer contains
@@ -394,6 +462,26 @@ namespace bob { namespace io {
       void extend_buffer (const std::string& path,
           const HDF5Type& type, const void* buffer);
 
+      /**
+       * Reads "count" consecutive objects of the given type, starting at
+       * position "pos", into a buffer, in a single I/O operation.
+       */
+      void read_buffer (const std::string& path, size_t pos, size_t count,
+          const HDF5Type& type, void* buffer) const;
+
+      /**
+       * Writes "count" consecutive objects of the given type, starting at
+       * position "pos", from a buffer, in a single I/O operation.
+       */
+      void write_buffer (const std::string& path, size_t pos, size_t count,
+          const HDF5Type& type, const void* buffer);
+
+      /**
+       * Extends the dataset with "count" extra variables of the given type.
+       */
+      void extend_buffer (const std::string& path, size_t count,
+          const HDF5Type& type, const void* buffer);
+
       /**
        * Copy construct an already opened HDF5File; just creates a shallow copy
        * of the file
@@ -57,10 +57,11 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
 
       /**
        * Creates a new HDF5 file. Optionally set the userblock size (multiple
-       * of 2 number of bytes).
+       * of 2 number of bytes) and the size, in bytes, of the chunk cache of
+       * each dataset in the file (zero keeps the HDF5 default of 1 MiB).
        */
       File(const boost::filesystem::path& path, unsigned int flags,
-          size_t userblock_size=0);
+          size_t userblock_size=0, size_t cache_size=0);
 
       /**
        * Copies a file by creating a copy of each of its groups
@@ -31,11 +31,13 @@
 #include "bob/ip/Exception.h"
 
 #include <list>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 
 #include "bob/ip/block.h"
 #include "bob/sp/DCT2D.h"
 #include "bob/ip/zigzag.h"
+#include "bob/core/parallel.h"
 
 
 namespace bob {
@@ -148,7 +150,7 @@ namespace bob {
       void setOverlapW(const size_t overlap_w) 
       { m_overlap_w = overlap_w; }
       void setNDctCoefs(const size_t n_dct_coefs) 
-      { m_n_dct_coefs = n_dct_coefs; resetCacheDct(); }
+      { m_n_dct_coefs = n_dct_coefs; }
       void setNormalizeBlock(const bool norm_block)
       { m_norm_block = norm_block; }
       void setNormalizeDct(const bool norm_dct)
@@ -156,6 +158,9 @@ namespace bob {
  
       /**
         * @brief Process a 2D blitz Array/Image by extracting DCT features.
+        *   All the blocks are first gathered (and normalized if required)
+        *   into a single contiguous buffer, which is then transformed at
+        *   once by a single FFTW plan.
         * @param src The 2D input blitz array
         * @param dst The 2D output array. The first dimension is for the block
         *   index, whereas the second one is for the dct index. The number of 
@@ -164,6 +169,19 @@ namespace bob {
       template <typename T> 
       void operator()(const blitz::Array<T,2>& src, blitz::Array<double,2>& dst) const;
 
+      /**
+        * @brief Process several 2D blitz Arrays/Images by extracting their
+        *   DCT features, the images being split among several threads.
+        * @param src The 2D input blitz arrays
+        * @param dst The 2D output arrays, resized to the number of blocks of
+        *   the corresponding input by the number of DCT coefficients
+        * @param n_threads The number of threads to use (0 for one per core)
+        */
+      template <typename T>
+      void operator()(const std::vector<blitz::Array<T,2> >& src,
+        std::vector<blitz::Array<double,2> >& dst,
+        const size_t n_threads=1) const;
+
       /**
         * @deprecated Please use the version with blitz::Array output. This
         *   version does not support block and/or dct normalization.
@@ -196,6 +214,40 @@ namespace bob {
       size_t getNBlocks(const blitz::Array<T,2>& src) const;
 
     private:
+
+      /**
+        * @brief Extracts the DCT features of a 2D double image into dst,
+        *   which should have the expected shape. zigzag contains the offsets
+        *   of the coefficients to keep within a block, and blocks is a
+        *   working array (resized if required), so that several images can
+        *   be processed concurrently.
+        */
+      void extract(const blitz::Array<double,2>& src,
+        blitz::Array<double,2>& dst, const std::vector<int>& zigzag,
+        blitz::Array<double,3>& blocks) const;
+
+      /**
+        * @brief Computes the offsets (in a C-contiguous block) of the DCT
+        *   coefficients kept, in zigzag order
+        */
+      void zigzagOffsets(std::vector<int>& offsets) const;
+
+      /**
+        * @brief Returns the image itself if it is a double one (by
+        *   reference: copying a blitz array modifies the reference count
+        *   of its data, which is not thread-safe), or a new double copy.
+        */
+      static const blitz::Array<double,2>& toDouble(
+        const blitz::Array<double,2>& src)
+      { return src; }
+      template <typename T>
+      static blitz::Array<double,2> toDouble(const blitz::Array<T,2>& src)
+      { return bob::core::cast<double>(src); }
+
+      /**
+        * @brief Extracts the features of a range of images, for parallelFor()
+        */
+      template <typename T> struct ImageShard;
       
       /**
         * Attributes
@@ -214,12 +266,22 @@ namespace bob {
         */
       void resetCache() const;
       void resetCacheBlock() const;
-      void resetCacheDct() const;
 
       mutable blitz::Array<double,2> m_cache_block1;
-      mutable blitz::Array<double,2> m_cache_block2;
-      mutable blitz::Array<double,1> m_cache_dct1;
-      mutable blitz::Array<double,1> m_cache_dct2;
+      mutable blitz::Array<double,3> m_cache_blocks;
+  };
+
+  template <typename T>
+  struct DCTFeatures::ImageShard {
+    const DCTFeatures* features;
+    const std::vector<blitz::Array<T,2> >* src;
+    std::vector<blitz::Array<double,2> >* dst;
+    const std::vector<int>* zigzag;
+    void operator()(size_t thread, size_t start, size_t end) const {
+      blitz::Array<double,3> blocks;
+      for (size_t i=start; i<end; ++i)
+        features->extract(toDouble((*src)[i]), (*dst)[i], *zigzag, blocks);
+    }
   };
 
   // Declare template method full specialization
@@ -237,6 +299,25 @@ namespace bob {
     this->operator()(src_d, dst);
   }  
 
+  template <typename T>
+  void DCTFeatures::operator()(const std::vector<blitz::Array<T,2> >& src,
+    std::vector<blitz::Array<double,2> >& dst, const size_t n_threads) const
+  {
+    // Checks the inputs and resizes the outputs in the calling thread
+    dst.resize(src.size());
+    for (size_t i=0; i<src.size(); ++i) {
+      const int n_blocks = getNBlocks(src[i]);
+      if (dst[i].extent(0) != n_blocks || 
+          dst[i].extent(1) != (int)m_n_dct_coefs)
+        dst[i].resize(n_blocks, m_n_dct_coefs);
+    }
+    std::vector<int> zigzag;
+    zigzagOffsets(zigzag);
+
+    ImageShard<T> shard = {this, &src, &dst, &zigzag};
+    bob::core::parallelFor(src.size(), n_threads, shard);
+  }
+
   template <typename T, typename U> 
   void DCTFeatures::operator()(const blitz::Array<T,2>& src, 
     U& dst) const
@@ -275,20 +356,20 @@ namespace bob {
 
     bob::core::array::assertSameShape(src, blitz::TinyVector<int, 3>(src.extent(0), m_block_h, m_block_w));
     dst.resize(src.extent(0), m_n_dct_coefs);
+    std::vector<int> zigzag;
+    zigzagOffsets(zigzag);
     
-    // Dct extract each block
+    // Dct extract all the blocks at once (in place, as the cast is a copy)
+    m_dct2d->operator()(double_version, double_version);
+
+    // Extract the required number of coefficients using the zigzag pattern
+    // and push it in the right dst row
+    const int block_size = m_block_h * m_block_w;
     for(int i = 0; i < double_version.extent(0); ++i)
     {
-      // Get the current block
-      blitz::Array<double,2> dct_input = double_version(i, blitz::Range::all(), blitz::Range::all());
-
-      // Extract dct using operator()
-      m_dct2d->operator()(dct_input, m_cache_block1);
-
-      // Extract the required number of coefficients using the zigzag pattern
-      // and push it in the right dst row
-      blitz::Array<double, 1> dst_row = dst(i, blitz::Range::all());
-      zigzag(m_cache_block1, dst_row);
+      const double* block = double_version.data() + i * block_size;
+      for(size_t k = 0; k < zigzag.size(); ++k)
+        dst(i, (int)k) = block[zigzag[k]];
     }
   }
   
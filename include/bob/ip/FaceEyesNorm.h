@@ -21,11 +21,13 @@
 #ifndef BOB_IP_FACE_EYES_NORM_H
 #define BOB_IP_FACE_EYES_NORM_H
 
+#include <vector>
 #include <boost/shared_ptr.hpp>
 #include "bob/core/array_assert.h"
 #include "bob/core/array_check.h"
 #include "bob/ip/GeomNorm.h"
 #include "bob/ip/rotate.h"
+#include "bob/core/parallel.h"
 
 namespace bob {
 /**
@@ -108,16 +110,29 @@ namespace bob {
 
         /**
           * @brief Process a 2D face image by applying the geometric
-          * normalization
+          * normalization. The output may be of any arithmetic type (see
+          * GeomNorm), e.g. uint8 for uint8 images.
           */
-        template <typename T> void operator()(const blitz::Array<T,2>& src, 
-          blitz::Array<double,2>& dst, const double e1_y, const double e1_x,
+        template <typename T, typename U> void operator()(const blitz::Array<T,2>& src, 
+          blitz::Array<U,2>& dst, const double e1_y, const double e1_x,
           const double e2_y, const double e2_x) const;
-        template <typename T> void operator()(const blitz::Array<T,2>& src, 
-          const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst, 
+        template <typename T, typename U> void operator()(const blitz::Array<T,2>& src, 
+          const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst, 
           blitz::Array<bool,2>& dst_mask, const double e1_y, const double e1_x,
           const double e2_y, const double e2_x) const;
 
+        /**
+          * @brief Process several faces of the same 2D image. The eye 
+          * positions of the i'th face are given by the row 
+          * eyes(i,:) = (e1_y, e1_x, e2_y, e2_x), and the face is normalized
+          * into dst(i,:,:). The faces are split among n_threads threads (0 for
+          * one per core).
+          * @warning The last angle and scale are not updated by this method.
+          */
+        template <typename T, typename U> void operator()(const blitz::Array<T,2>& src, 
+          const blitz::Array<double,2>& eyes, blitz::Array<U,3>& dst,
+          const size_t n_threads=1) const;
+
         /**
          * @brief Getter function for the bob::ip::GeomNorm object that is doing the job.
          *
@@ -128,12 +143,25 @@ namespace bob {
         const boost::shared_ptr<GeomNorm> getGeomNorm(){return m_geom_norm;}
 
       private:
-        template <typename T, bool mask> 
+        template <typename T, typename U, bool mask> 
         void processNoCheck(const blitz::Array<T,2>& src, 
-          const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst, 
+          const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst, 
           blitz::Array<bool,2>& dst_mask, const double e1_y, const double e1_x,
           const double e2_y, const double e2_x) const;
 
+        /**
+          * @brief Sets the rotation angle and the scaling factor of geom_norm
+          * for the given eye positions, and returns the center of the eyes
+          */
+        void setupGeomNorm(GeomNorm& geom_norm, const double e1_y,
+          const double e1_x, const double e2_y, const double e2_x,
+          double& center_y, double& center_x) const;
+
+        /**
+          * @brief Normalizes a range of faces, for parallelFor()
+          */
+        template <typename T, typename U> struct FaceShard;
+
         /**
           * Attributes
           */
@@ -150,9 +178,27 @@ namespace bob {
         mutable double m_cache_scale;
     };
 
-    template <typename T> 
+    template <typename T, typename U>
+    struct FaceEyesNorm::FaceShard {
+      const FaceEyesNorm* norm;
+      const blitz::Array<T,2>* src;
+      const blitz::Array<double,2>* eyes;
+      std::vector<blitz::Array<U,2> >* faces;
+      void operator()(size_t thread, size_t start, size_t end) const {
+        // each thread uses its own GeomNorm
+        GeomNorm geom_norm(*norm->m_geom_norm);
+        for (size_t i=start; i<end; ++i) {
+          double center_y, center_x;
+          norm->setupGeomNorm(geom_norm, (*eyes)(i,0), (*eyes)(i,1), 
+            (*eyes)(i,2), (*eyes)(i,3), center_y, center_x);
+          geom_norm(*src, (*faces)[i], center_y, center_x);
+        }
+      }
+    };
+
+    template <typename T, typename U> 
     inline void bob::ip::FaceEyesNorm::operator()(const blitz::Array<T,2>& src, 
-      blitz::Array<double,2>& dst, const double e1_y, const double e1_x,
+      blitz::Array<U,2>& dst, const double e1_y, const double e1_x,
       const double e2_y, const double e2_x) const
     { 
       // Check input
@@ -164,13 +210,13 @@ namespace bob {
 
       // Process
       blitz::Array<bool,2> src_mask, dst_mask;
-      processNoCheck<T,false>(src, src_mask, dst, dst_mask, e1_y, e1_x, e2_y, 
+      processNoCheck<T,U,false>(src, src_mask, dst, dst_mask, e1_y, e1_x, e2_y, 
         e2_x); 
     }
 
-    template <typename T> 
+    template <typename T, typename U> 
     inline void bob::ip::FaceEyesNorm::operator()(const blitz::Array<T,2>& src, 
-      const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst,
+      const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst,
       blitz::Array<bool,2>& dst_mask, const double e1_y, const double e1_x,
       const double e2_y, const double e2_x) const
     { 
@@ -186,27 +232,47 @@ namespace bob {
       bob::core::array::assertSameShape(dst, m_out_shape);
 
       // Process
-      processNoCheck<T,true>(src, src_mask, dst, dst_mask, e1_y, e1_x, e2_y, 
+      processNoCheck<T,U,true>(src, src_mask, dst, dst_mask, e1_y, e1_x, e2_y, 
         e2_x); 
     }
 
-    template <typename T, bool mask> 
+    template <typename T, typename U> 
+    inline void bob::ip::FaceEyesNorm::operator()(const blitz::Array<T,2>& src, 
+      const blitz::Array<double,2>& eyes, blitz::Array<U,3>& dst,
+      const size_t n_threads) const
+    { 
+      // Check input
+      bob::core::array::assertZeroBase(src);
+      bob::core::array::assertZeroBase(eyes);
+      bob::core::array::assertSameDimensionLength(eyes.extent(1), 4);
+
+      // Check output
+      bob::core::array::assertZeroBase(dst);
+      bob::core::array::assertSameShape(dst, blitz::TinyVector<int,3>(
+        eyes.extent(0), m_out_shape(0), m_out_shape(1)));
+
+      // The faces are sliced in the calling thread, so that the threads do
+      // not share the reference count of dst
+      std::vector<blitz::Array<U,2> > faces;
+      faces.reserve(dst.extent(0));
+      for (int i=0; i<dst.extent(0); ++i)
+        faces.push_back(dst(i, blitz::Range::all(), blitz::Range::all()));
+
+      FaceShard<T,U> shard = {this, &src, &eyes, &faces};
+      bob::core::parallelFor(faces.size(), n_threads, shard);
+    }
+
+    template <typename T, typename U, bool mask> 
     inline void bob::ip::FaceEyesNorm::processNoCheck(const blitz::Array<T,2>& src, 
-      const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst,
+      const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst,
       blitz::Array<bool,2>& dst_mask, const double e1_y, const double e1_x,
       const double e2_y, const double e2_x) const
     { 
-      // Get angle to horizontal
-      m_cache_angle = getAngleToHorizontal(e1_y, e1_x, e2_y, e2_x) - m_eyes_angle;
-      m_geom_norm->setRotationAngle(m_cache_angle);
-
-      // Get scaling factor
-      m_cache_scale = m_eyes_distance / sqrt( (e1_y-e2_y)*(e1_y-e2_y) + (e1_x-e2_x)*(e1_x-e2_x) );
-      m_geom_norm->setScalingFactor(m_cache_scale);
-
-      // Get the center (of the eye centers segment)
-      double center_y = (e1_y + e2_y) / 2.;
-      double center_x = (e1_x + e2_x) / 2.;
+      // Get angle, scaling factor and center
+      double center_y, center_x;
+      setupGeomNorm(*m_geom_norm, e1_y, e1_x, e2_y, e2_x, center_y, center_x);
+      m_cache_angle = m_geom_norm->getRotationAngle();
+      m_cache_scale = m_geom_norm->getScalingFactor();
 
       // Perform the normalization
       if(mask)
@@ -25,8 +25,8 @@
 
 #include "bob/core/array_assert.h"
 #include "bob/core/cast.h"
-#include "bob/sp/conv.h"
 #include "bob/sp/extrapolate.h"
+#include "bob/sp/separable.h"
 
 namespace bob {
 
@@ -56,7 +56,7 @@ namespace bob {
             const bob::sp::Extrapolation::BorderType border_type =
               bob::sp::Extrapolation::Mirror):
           m_radius_y(radius_y), m_radius_x(radius_x), m_sigma_y(sigma_y),
-          m_sigma_x(sigma_x), m_conv_border(border_type)
+          m_sigma_x(sigma_x), m_conv_border(border_type), m_recursive(false)
         {
           computeKernel();
         }
@@ -67,7 +67,8 @@ namespace bob {
         Gaussian(const Gaussian& other): 
           m_radius_y(other.m_radius_y), m_radius_x(other.m_radius_x), 
           m_sigma_y(other.m_sigma_y), m_sigma_x(other.m_sigma_x), 
-          m_conv_border(other.m_conv_border)
+          m_conv_border(other.m_conv_border),
+          m_recursive(other.m_recursive)
         {
           computeKernel();
         }
@@ -112,6 +113,7 @@ namespace bob {
         double getSigmaY() const { return m_sigma_y; }
         double getSigmaX() const { return m_sigma_x; }
         bob::sp::Extrapolation::BorderType getConvBorder() const { return m_conv_border; }
+        bool getRecursive() const { return m_recursive; }
         const blitz::Array<double,1>& getKernelY() const { return m_kernel_y; }
         const blitz::Array<double,1>& getKernelX() const { return m_kernel_x; }
        
@@ -129,6 +131,17 @@ namespace bob {
         void setConvBorder(const bob::sp::Extrapolation::BorderType border_type)
         { m_conv_border = border_type; }
 
+        /**
+         * @brief Uses the recursive approximation of the Gaussian filter
+         * (bob::sp::recursiveGaussian()) instead of the convolution with the
+         * sampled kernel. Its cost does not depend on the standard deviations
+         * and the radii are ignored, which is interesting for large standard
+         * deviations. The convolution is still used if one of the standard
+         * deviations is smaller than 0.5.
+         */
+        void setRecursive(const bool recursive)
+        { m_recursive = recursive; }
+
         /**
          * @brief Process a 2D blitz Array/Image
          * @param src The 2D input blitz array
@@ -158,13 +171,10 @@ namespace bob {
         double m_sigma_y;
         double m_sigma_x;
         bob::sp::Extrapolation::BorderType m_conv_border;
+        bool m_recursive;
 
         blitz::Array<double, 1> m_kernel_y;
         blitz::Array<double, 1> m_kernel_x;
-
-        blitz::Array<double, 2> m_tmp_int;
-        blitz::Array<double, 2> m_tmp_int1;
-        blitz::Array<double, 2> m_tmp_int2;
     };
 
     // Declare template method full specialization
@@ -28,6 +28,7 @@
 #ifndef BOB_IP_GEOM_NORM_H
 #define BOB_IP_GROM_NORM_H
 
+#include <limits>
 #include <boost/shared_ptr.hpp>
 #include "bob/core/array_assert.h"
 #include "bob/core/array_check.h"
@@ -42,6 +43,180 @@ namespace bob {
  */
   namespace ip {
 
+    namespace detail {
+
+      /**
+        * @brief Converts an interpolated value to the output type: integral
+        * outputs are rounded to the nearest value and saturated.
+        */
+      template <typename U>
+      inline U geomNormStore(const double value)
+      {
+        if (!std::numeric_limits<U>::is_integer) return static_cast<U>(value);
+        if (value <= (double)std::numeric_limits<U>::min())
+          return std::numeric_limits<U>::min();
+        if (value >= (double)std::numeric_limits<U>::max())
+          return std::numeric_limits<U>::max();
+        return static_cast<U>(std::floor(value + 0.5));
+      }
+
+      /**
+        * @brief Computes the span [begin, end) of the target row, whose
+        * pixel x is mapped to the source position (row_y + x*dy,
+        * row_x + x*dx), for which the four bilinear neighbours lie inside a
+        * source image of the given height and width. Outside of this span,
+        * the pixels require bounds checks.
+        */
+      void geomNormInteriorSpan(const double row_y, const double row_x,
+        const double dy, const double dx, const int height, const int width,
+        const int target_width, int& begin, int& end);
+
+      /**
+        * @brief Bilinear interpolation of the pixel (y,x) of the target
+        * image at the source position (sy,sx), neighbours outside of the
+        * source image (or outside of its mask) contributing zero.
+        */
+      template <typename T, typename U, bool mask>
+      void geomNormBorder(const blitz::Array<T,2>& source,
+        const blitz::Array<bool,2>& source_mask, blitz::Array<U,2>& target,
+        blitz::Array<bool,2>& target_mask, const int y, const int x,
+        const double sy, const double sx)
+      {
+        // split each source x and y in integral and decimal digits
+        const int ox = std::floor(sx);
+        const int oy = std::floor(sy);
+        const double mx = sx - ox;
+        const double my = sy - oy;
+        const int h = source.extent(0) - 1;
+        const int w = source.extent(1) - 1;
+
+        // add the four values bi-linearly interpolated
+        double res = 0.;
+        if (mask){
+          bool new_mask = false;
+          // upper left
+          if (ox >= 0 && oy >= 0 && ox <= w && oy <= h && source_mask(oy,ox)){
+            res += (1.-mx) * (1.-my) * source(oy,ox);
+            new_mask = true;
+          }
+          // upper right
+          if (ox >= -1 && oy >= 0 && ox < w && oy <= h && source_mask(oy,ox+1)){
+            res += mx * (1.-my) * source(oy,ox+1);
+            new_mask = true;
+          }
+          // lower left
+          if (ox >= 0 && oy >= -1 && ox <= w && oy < h && source_mask(oy+1,ox)){
+            res += (1.-mx) * my * source(oy+1,ox);
+            new_mask = true;
+          }
+          // lower right
+          if (ox >= -1 && oy >= -1 && ox < w && oy < h && source_mask(oy+1,ox+1)){
+            res += mx * my * source(oy+1,ox+1);
+            new_mask = true;
+          }
+          target_mask(y,x) = new_mask;
+        } else {
+          // upper left
+          if (ox >= 0 && oy >= 0 && ox <= w && oy <= h)
+            res += (1.-mx) * (1.-my) * source(oy,ox);
+
+          // upper right
+          if (ox >= -1 && oy >= 0 && ox < w && oy <= h)
+            res += mx * (1.-my) * source(oy,ox+1);
+
+          // lower left
+          if (ox >= 0 && oy >= -1 && ox <= w && oy < h)
+            res += (1.-mx) * my * source(oy+1,ox);
+
+          // lower right
+          if (ox >= -1 && oy >= -1 && ox < w && oy < h)
+            res += mx * my * source(oy+1,ox+1);
+        }
+        target(y,x) = geomNormStore<U>(res);
+      }
+
+      /**
+        * @brief Bilinear interpolation of the interior span [begin, end) of
+        * a target row (see geomNormInteriorSpan()), without any bounds check
+        */
+      template <typename T, typename U>
+      void geomNormInterior(const blitz::Array<T,2>& source, U* target,
+        const int target_stride, const double row_y, const double row_x,
+        const double dy, const double dx, const int begin, const int end)
+      {
+        const T* src = source.data();
+        const int s0 = source.stride(0);
+        const int s1 = source.stride(1);
+        for (int x = begin; x < end; ++x){
+          const double sy = row_y + x * dy;
+          const double sx = row_x + x * dx;
+          // the positions are non negative: truncation is the floor
+          const int oy = (int)sy;
+          const int ox = (int)sx;
+          const double my = sy - oy;
+          const double mx = sx - ox;
+          const T* p = src + oy * s0 + ox * s1;
+          target[x * target_stride] = geomNormStore<U>(
+            (1.-mx) * (1.-my) * p[0] + mx * (1.-my) * p[s1] + 
+            (1.-mx) * my * p[s0] + mx * my * p[s0 + s1]);
+        }
+      }
+
+      /**
+        * @brief Specialization for 8-bit images, using fixed-point weights
+        * (10 bits of sub-pixel precision) and integer arithmetic. The result
+        * is within one gray level of the rounded floating-point
+        * interpolation.
+        */
+      void geomNormInterior(const blitz::Array<uint8_t,2>& source,
+        uint8_t* target, const int target_stride, const double row_y,
+        const double row_x, const double dy, const double dx, const int begin,
+        const int end);
+
+      /**
+        * @brief Bilinear interpolation of the interior span [begin, end) of
+        * a target row (see geomNormInteriorSpan()), taking the masks into
+        * account
+        */
+      template <typename T, typename U>
+      void geomNormInteriorMasked(const blitz::Array<T,2>& source,
+        const blitz::Array<bool,2>& source_mask, blitz::Array<U,2>& target,
+        blitz::Array<bool,2>& target_mask, const int y, const double row_y,
+        const double row_x, const double dy, const double dx,
+        const int begin, const int end)
+      {
+        for (int x = begin; x < end; ++x){
+          const double sy = row_y + x * dy;
+          const double sx = row_x + x * dx;
+          const int oy = (int)sy;
+          const int ox = (int)sx;
+          const double my = sy - oy;
+          const double mx = sx - ox;
+          double res = 0.;
+          bool new_mask = false;
+          if (source_mask(oy,ox)){
+            res += (1.-mx) * (1.-my) * source(oy,ox);
+            new_mask = true;
+          }
+          if (source_mask(oy,ox+1)){
+            res += mx * (1.-my) * source(oy,ox+1);
+            new_mask = true;
+          }
+          if (source_mask(oy+1,ox)){
+            res += (1.-mx) * my * source(oy+1,ox);
+            new_mask = true;
+          }
+          if (source_mask(oy+1,ox+1)){
+            res += mx * my * source(oy+1,ox+1);
+            new_mask = true;
+          }
+          target(y,x) = geomNormStore<U>(res);
+          target_mask(y,x) = new_mask;
+        }
+      }
+
+    }
+
     /**
      * @brief This file defines a class to perform geometric normalization of 
      * an image. This means that the image is:
@@ -114,26 +289,28 @@ namespace bob {
 
         /**
           * @brief Process a 2D blitz Array/Image by applying the geometric
-          * normalization
+          * normalization. The output is usually a double array, but may be of
+          * any arithmetic type, integral outputs being rounded and saturated
+          * (uint8 to uint8 normalization uses fixed-point arithmetic).
           */
-        template <typename T> 
+        template <typename T, typename U> 
         void operator()(const blitz::Array<T,2>& src, 
-          blitz::Array<double,2>& dst, const double rot_c_y, const double rot_c_x) const;
-        template <typename T> 
+          blitz::Array<U,2>& dst, const double rot_c_y, const double rot_c_x) const;
+        template <typename T, typename U> 
         void operator()(const blitz::Array<T,2>& src, 
-          const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst, 
+          const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst, 
           blitz::Array<bool,2>& dst_mask, const double rot_c_y, const double rot_c_x) const;
 
         /**
          * @brief Process a 3D blitz Array/Image by applying the geometric
          * normalization to each color plane
          */
-        template <typename T> 
+        template <typename T, typename U> 
         void operator()(const blitz::Array<T,3>& src, 
-          blitz::Array<double,3>& dst, const double rot_c_y, const double rot_c_x) const;
-        template <typename T> 
+          blitz::Array<U,3>& dst, const double rot_c_y, const double rot_c_x) const;
+        template <typename T, typename U> 
         void operator()(const blitz::Array<T,3>& src, 
-          const blitz::Array<bool,3>& src_mask, blitz::Array<double,3>& dst, 
+          const blitz::Array<bool,3>& src_mask, blitz::Array<U,3>& dst, 
           blitz::Array<bool,3>& dst_mask, const double rot_c_y, const double rot_c_x) const;
 
         /**
@@ -146,11 +323,19 @@ namespace bob {
         /**
           * @brief Process a 2D blitz Array/Image
           */
-        template <typename T, bool mask>
+        template <typename T, typename U, bool mask>
         void processNoCheck(const blitz::Array<T,2>& src, 
-          const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst, 
+          const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst, 
           blitz::Array<bool,2>& dst_mask, const double rot_c_y, const double rot_c_x) const;
 
+        /**
+          * @brief Computes the mapping from the target image to the source
+          * image: the target pixel (y,x) comes from the source position
+          * (origin_y + y*dx + x*dy, origin_x - y*dy + x*dx)
+          */
+        void getTransform(const double rot_c_y, const double rot_c_x,
+          double& origin_y, double& origin_x, double& dy, double& dx) const;
+
         /**
           * Attributes
           */
@@ -162,9 +347,9 @@ namespace bob {
         double m_crop_offset_w;
     };
 
-    template <typename T> 
+    template <typename T, typename U> 
     void bob::ip::GeomNorm::operator()(const blitz::Array<T,2>& src,
-      blitz::Array<double,2>& dst, const double rot_c_y, const double rot_c_x) const
+      blitz::Array<U,2>& dst, const double rot_c_y, const double rot_c_x) const
     { 
       // Check input
       bob::core::array::assertZeroBase(src);
@@ -176,12 +361,12 @@ namespace bob {
 
       // Process
       blitz::Array<bool,2> src_mask, dst_mask;
-      processNoCheck<T,false>(src, src_mask, dst, dst_mask, rot_c_y, rot_c_x);
+      processNoCheck<T,U,false>(src, src_mask, dst, dst_mask, rot_c_y, rot_c_x);
     }
 
-    template <typename T> 
+    template <typename T, typename U> 
     void bob::ip::GeomNorm::operator()(const blitz::Array<T,2>& src, 
-      const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst, 
+      const blitz::Array<bool,2>& src_mask, blitz::Array<U,2>& dst, 
       blitz::Array<bool,2>& dst_mask, const double rot_c_y, const double rot_c_x) const
     { 
       // Check input
@@ -197,119 +382,58 @@ namespace bob {
       bob::core::array::assertSameDimensionLength(dst.extent(1), m_crop_width);
 
       // Process
-      processNoCheck<T,true>(src, src_mask, dst, dst_mask, rot_c_y, rot_c_x);
+      processNoCheck<T,U,true>(src, src_mask, dst, dst_mask, rot_c_y, rot_c_x);
     }
 
-    template <typename T, bool mask> 
+    template <typename T, typename U, bool mask> 
     void bob::ip::GeomNorm::processNoCheck(const blitz::Array<T,2>& source,
-      const blitz::Array<bool,2>& source_mask, blitz::Array<double,2>& target,
+      const blitz::Array<bool,2>& source_mask, blitz::Array<U,2>& target,
       blitz::Array<bool,2>& target_mask, const double rot_c_y, const double rot_c_x) const
     { 
-      // This is the fastest version of the function that I can imagine...
-      // It handles two different coordinate systems: original image and new image
-
-      // transformation center in original image
-      const double original_center_x = rot_c_x, 
-                   original_center_y = rot_c_y;
-      // transformation center in new image:
-      const double new_center_x = m_crop_offset_w, 
-                   new_center_y = m_crop_offset_h;
-
-      // With these positions, we can define a mapping from the new image to the original image
-      const double sin_angle = -sin(m_rotation_angle * M_PI / 180.), 
-                   cos_angle = cos(m_rotation_angle * M_PI / 180.);
-      // we compute the distance in the source image, when going 1 pixel in the new image
-      const double dx = cos_angle / m_scaling_factor, 
-                   dy = -sin_angle / m_scaling_factor;
-
-      // Now, we iterate through the target image, and compute pixel positions in the source.
-      // For this purpose, get the (0,0) position of the target image in source image coordinates:
-      double origin_x = original_center_x - (cos_angle * new_center_x + sin_angle * new_center_y) / m_scaling_factor;
-      double origin_y = original_center_y - (cos_angle * new_center_y - sin_angle * new_center_x) / m_scaling_factor;
-
-      // some helpers for the interpolation
-      int ox, oy;
-      double mx, my;
-      int h = source.shape()[0]-1;
-      int w = source.shape()[1]-1;
-
-      // Ok, so let's do it.
+      // It handles two different coordinate systems: original image and new
+      // image. Each row of the new image is split into the span of pixels
+      // whose four neighbours lie inside the original image, which is
+      // interpolated without any bounds check, and the border pixels on
+      // both sides of it.
+      double origin_y, origin_x, dy, dx;
+      getTransform(rot_c_y, rot_c_x, origin_y, origin_x, dy, dx);
+
+      const int height = source.extent(0);
+      const int width = source.extent(1);
+      const int crop_width = m_crop_width;
+      const int target_stride = target.stride(1);
       for (int y = 0; y < (int)m_crop_height; ++y){
-        // set the source image point to first point in row
-        double source_x = origin_x, source_y = origin_y;
-        // iterate over the row
-        for (int x = 0; x < (int)m_crop_width; ++x){
-
-          // We are at the desired pixel in the new image. Interpolate the old image's pixels:
-          double& res = target(y,x) = 0.;
-
-          // split each source x and y in integral and decimal digits
-          ox = std::floor(source_x);
-          oy = std::floor(source_y);
-          mx = source_x - ox;
-          my = source_y - oy;
-
-          // add the four values bi-linearly interpolated
-          if (mask){
-            bool& new_mask = target_mask(y,x) = false;
-            // upper left
-            if (ox >= 0 && oy >= 0 && ox <= w && oy <= h && source_mask(oy,ox)){
-              res += (1.-mx) * (1.-my) * source(oy,ox);
-              new_mask = true;
-            }
-            // upper right
-            if (ox >= -1 && oy >= 0 && ox < w && oy <= h && source_mask(oy,ox+1)){
-              res += mx * (1.-my) * source(oy,ox+1);
-              new_mask = true;
-            }
-            // lower left
-            if (ox >= 0 && oy >= -1 && ox <= w && oy < h && source_mask(oy+1,ox)){
-              res += (1.-mx) * my * source(oy+1,ox);
-              new_mask = true;
-            }
-            // lower right
-            if (ox >= -1 && oy >= -1 && ox < w && oy < h && source_mask(oy+1,ox+1)){
-              res += mx * my * source(oy+1,ox+1);
-              new_mask = true;
-            }
-          } else {
-            // upper left
-            if (ox >= 0 && oy >= 0 && ox <= w && oy <= h)
-              res += (1.-mx) * (1.-my) * source(oy,ox);
-
-            // upper right
-            if (ox >= -1 && oy >= 0 && ox < w && oy <= h)
-              res += mx * (1.-my) * source(oy,ox+1);
-
-            // lower left
-            if (ox >= 0 && oy >= -1 && ox <= w && oy < h)
-              res += (1.-mx) * my * source(oy+1,ox);
-
-            // lower right
-            if (ox >= -1 && oy >= -1 && ox < w && oy < h)
-              res += mx * my * source(oy+1,ox+1);
-          }
-
-          // done with this pixel...
-          // go to the next source pixel in the row
-          source_x += dx;
-          source_y += dy;
-        }
-        // at the end of the row, we shift the origin to the next line
-        origin_x -= dy;
-        origin_y += dx;
+        // position of the first pixel of the row in the original image
+        const double row_y = origin_y + y * dx;
+        const double row_x = origin_x - y * dy;
+
+        int begin, end;
+        detail::geomNormInteriorSpan(row_y, row_x, dy, dx, height, width,
+          crop_width, begin, end);
+
+        for (int x = 0; x < begin; ++x)
+          detail::geomNormBorder<T,U,mask>(source, source_mask, target,
+            target_mask, y, x, row_y + x * dy, row_x + x * dx);
+        if (mask)
+          detail::geomNormInteriorMasked(source, source_mask, target,
+            target_mask, y, row_y, row_x, dy, dx, begin, end);
+        else
+          detail::geomNormInterior(source, target.data() + y * target.stride(0),
+            target_stride, row_y, row_x, dy, dx, begin, end);
+        for (int x = end; x < crop_width; ++x)
+          detail::geomNormBorder<T,U,mask>(source, source_mask, target,
+            target_mask, y, x, row_y + x * dy, row_x + x * dx);
       }
-      // done!
     }
 
-    template <typename T> 
+    template <typename T, typename U> 
     void bob::ip::GeomNorm::operator()(const blitz::Array<T,3>& src, 
-      blitz::Array<double,3>& dst, const double rot_c_y, const double rot_c_x) const
+      blitz::Array<U,3>& dst, const double rot_c_y, const double rot_c_x) const
     {
       for( int p=0; p<dst.extent(0); ++p) {
         const blitz::Array<T,2> src_slice = 
           src( p, blitz::Range::all(), blitz::Range::all() );
-        blitz::Array<double,2> dst_slice = 
+        blitz::Array<U,2> dst_slice = 
           dst( p, blitz::Range::all(), blitz::Range::all() );
         
         // Process one plane
@@ -317,9 +441,9 @@ namespace bob {
       }
     }
 
-    template <typename T> 
+    template <typename T, typename U> 
     void bob::ip::GeomNorm::operator()(const blitz::Array<T,3>& src, 
-      const blitz::Array<bool,3>& src_mask, blitz::Array<double,3>& dst, 
+      const blitz::Array<bool,3>& src_mask, blitz::Array<U,3>& dst, 
       blitz::Array<bool,3>& dst_mask, const double rot_c_y, const double rot_c_x) const
     {
       for( int p=0; p<dst.extent(0); ++p) {
@@ -327,7 +451,7 @@ namespace bob {
           src( p, blitz::Range::all(), blitz::Range::all() );
         const blitz::Array<bool,2> src_mask_slice = 
           src_mask( p, blitz::Range::all(), blitz::Range::all() );
-        blitz::Array<double,2> dst_slice = 
+        blitz::Array<U,2> dst_slice = 
           dst( p, blitz::Range::all(), blitz::Range::all() );
         blitz::Array<bool,2> dst_mask_slice = 
           dst_mask( p, blitz::Range::all(), blitz::Range::all() );
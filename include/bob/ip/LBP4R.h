@@ -150,6 +150,12 @@ namespace bob { namespace ip {
         { return getLBPShape<double>(src); }
 
     private:
+      /**
+       * Compute the offsets of the 4 neighbours from the central pixel, 
+       *   in the order of the bits of the code.
+       */
+      void getSampling(double* dy, double* dx) const;
+
       /**
        * Extract the LBP code of a 2D blitz::Array at the given 
        *   location, and return it, without performing any check.
@@ -176,22 +182,13 @@ namespace bob { namespace ip {
       bob::core::array::assertZeroBase(src);
       bob::core::array::assertZeroBase(dst);
       bob::core::array::assertSameShape(dst, getLBPShape(src) );
+      double dy[4], dx[4];
+      getSampling(dy, dx);
       if( m_circular)
-      {
-        for(int y=0; y<dst.extent(0); ++y)
-          for(int x=0; x<dst.extent(1); ++x)
-            dst(y,x) = 
-              bob::ip::LBP4R::processNoCheck<T,true>(src, 
-                  static_cast<int>(ceil(m_R))+y, static_cast<int>(ceil(m_R2))+x);
-      }
+        processImage(src, dst, static_cast<int>(ceil(m_R)), 
+            static_cast<int>(ceil(m_R2)), dy, dx, 0.2);
       else
-      {
-        for(int y=0; y<dst.extent(0); ++y)
-          for(int x=0; x<dst.extent(1); ++x)
-            dst(y,x) = 
-              bob::ip::LBP4R::processNoCheck<T,false>(src, 
-                  static_cast<int>(m_R_rect)+y, static_cast<int>(m_R2_rect)+x);
-      }
+        processImage(src, dst, m_R_rect, m_R2_rect, dy, dx, 0.2);
     }
 
   template <typename T> 
@@ -150,6 +150,12 @@ namespace bob { namespace ip {
         { return getLBPShape<double>(src); }
 
     private:
+      /**
+       * Compute the offsets of the 8 neighbours from the central pixel, 
+       *   in the order of the bits of the code.
+       */
+      void getSampling(double* dy, double* dx) const;
+
       /**
        * Extract the LBP code of a 2D blitz::Array at the given 
        *   location, and return it, without performing any check.
@@ -176,22 +182,13 @@ namespace bob { namespace ip {
       bob::core::array::assertZeroBase(src);
       bob::core::array::assertZeroBase(dst);
       bob::core::array::assertSameShape(dst, getLBPShape(src) );
+      double dy[8], dx[8];
+      getSampling(dy, dx);
       if( m_circular)
-      {
-        for(int y=0; y<dst.extent(0); ++y)
-          for(int x=0; x<dst.extent(1); ++x)
-            dst(y,x) = 
-              bob::ip::LBP8R::processNoCheck<T,true>(src,
-                  static_cast<int>(ceil(m_R))+y, static_cast<int>(ceil(m_R2))+x);
-      }
+        processImage(src, dst, static_cast<int>(ceil(m_R)), 
+            static_cast<int>(ceil(m_R2)), dy, dx, 0.1111111111);
       else
-      {
-        for(int y=0; y<dst.extent(0); ++y)
-          for(int x=0; x<dst.extent(1); ++x)
-            dst(y,x) = 
-              bob::ip::LBP8R::processNoCheck<T,false>(src,
-                  static_cast<int>(m_R_rect)+y, static_cast<int>(m_R2_rect)+x);
-      }
+        processImage(src, dst, m_R_rect, m_R2_rect, dy, dx, 0.1111111111);
     }
 
   template <typename T> 
@@ -232,32 +229,10 @@ namespace bob { namespace ip {
       double tab[8];
       if(circular)
       {
-        if(m_R == m_R2){
-          const double R_sqrt2 = m_R / sqrt(2);
-          tab[0] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc-R_sqrt2,xc-R_sqrt2);
-          tab[1] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc-m_R,xc);
-          tab[2] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc-R_sqrt2,xc+R_sqrt2);
-          tab[3] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc,xc+m_R);
-          tab[4] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc+R_sqrt2,xc+R_sqrt2);
-          tab[5] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc+m_R,xc);
-          tab[6] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc+R_sqrt2,xc-R_sqrt2);
-          tab[7] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc,xc-m_R);
-        }
-        else{
-        /*An ellipse*/
-          const double PI = 4.0*atan(1.0);
-          /*The elipse navigation was extracted from the book "Computer Vision using LocalBinary Patterns" page 56. In their implementation the first bin is the top-center and the bob implementation is top-left. By that reason the first bin initialized was 7*/
-
-          tab[0] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc-m_R*cos(2*PI*7/m_P),xc+m_R2*sin(2*PI*7/m_P));
-          tab[1] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc-m_R,xc);
-          tab[2] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc-m_R*cos(2*PI*1/m_P),xc+m_R2*sin(2*PI*1/m_P));
-          tab[3] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc,xc+m_R);
-          tab[4] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc-m_R*cos(2*PI*3/m_P),xc+m_R2*sin(2*PI*3/m_P));
-          tab[5] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc+m_R,xc);
-          tab[6] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc-m_R*cos(2*PI*5/m_P),xc+m_R2*sin(2*PI*5/m_P));
-          tab[7] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc,xc-m_R);
-
-        }
+        double dy[8], dx[8];
+        getSampling(dy, dx);
+        for(int p=0; p<8; ++p)
+          tab[p] = bob::sp::detail::bilinearInterpolationNoCheck(src,yc+dy[p],xc+dx[p]);
       }
       else
       {
@@ -31,7 +31,8 @@
 #include "bob/ip/LBP.h"
 #include "bob/ip/LBP4R.h"
 #include "bob/ip/LBP8R.h"
-#include <list>
+#include <algorithm>
+#include <vector>
 
 namespace bob {
 /**
@@ -125,25 +126,74 @@ namespace bob {
     // cast to double
     blitz::Array<double,2> double_version = bob::core::cast<double>(src);
 
-    // get all the blocks
-    std::list<blitz::Array<double,2> > blocks;
-    blockReference(double_version, blocks, m_block_h, m_block_w, m_overlap_h, m_overlap_w);
-  
-    // compute an lbp histogram for each block
-    for( std::list<blitz::Array<double,2> >::const_iterator it = blocks.begin();
-      it != blocks.end(); ++it) 
+    // get the block layout
+    const blitz::TinyVector<int,4> shape = getBlock4DOutputShape(
+      double_version, m_block_h, m_block_w, m_overlap_h, m_overlap_w);
+    const int n_blocks_h = shape(0);
+    const int n_blocks_w = shape(1);
+    const int step_h = m_block_h - m_overlap_h;
+    const int step_w = m_block_w - m_overlap_w;
+
+    // extract the lbp codes of the whole image, once
+    blitz::Array<uint16_t,2> codes(m_lbp->getLBPShape(double_version));
+    m_lbp->operator()(double_version, codes);
+
+    // The histogram of a block is the one of the codes whose neighbourhood
+    // lies inside the block, i.e. of the (code_h,code_w) codes starting at
+    // the same position as the block in the code map
+    const int n_labels = m_lbp->getMaxLabel();
+    const int code_h = std::max(0, 
+      m_block_h - (double_version.extent(0) - codes.extent(0)));
+    const int code_w = std::max(0, 
+      m_block_w - (double_version.extent(1) - codes.extent(1)));
+    const int width = codes.extent(1);
+
+    // Running column histograms of the codes of the current row of blocks,
+    // updated when moving down by removing and adding rows of codes, and
+    // their cumulative sums along the rows, from which the histogram of
+    // each block is read in O(n_labels)
+    std::vector<uint32_t> columns(width*n_labels, 0);
+    std::vector<uint32_t> cumulated((width+1)*n_labels, 0);
+    int row_begin = 0, row_end = 0;
+    for(int h=0; h<n_blocks_h; ++h)
     {
-      // extract lbp using operator()
-      blitz::Array<uint16_t,2> lbp_tmp_block(m_lbp->getLBPShape(*it));
-      m_lbp->operator()(*it, lbp_tmp_block);
-
-      // Compute the LBP histogram
-      blitz::Array<uint64_t, 1> lbp_histo(m_lbp->getMaxLabel());
-      histogram<uint16_t>(lbp_tmp_block, lbp_histo, 0, m_lbp->getMaxLabel()-1, 
-        m_lbp->getMaxLabel());
-
-      // Push the resulting processed block in the container
-      dst.push_back(lbp_histo);
+      const int y0 = h*step_h;
+      const int y1 = y0 + code_h;
+      if(y0 >= row_end)
+      {
+        std::fill(columns.begin(), columns.end(), 0);
+        row_begin = row_end = y0;
+      }
+      for(; row_begin<y0; ++row_begin)
+        for(int x=0; x<width; ++x)
+          --columns[x*n_labels + std::min((int)codes(row_begin,x), n_labels-1)];
+      for(; row_end<y1; ++row_end)
+        for(int x=0; x<width; ++x)
+          ++columns[x*n_labels + std::min((int)codes(row_end,x), n_labels-1)];
+
+      for(int x=0; x<width; ++x)
+        for(int l=0; l<n_labels; ++l)
+          cumulated[(x+1)*n_labels + l] = 
+            cumulated[x*n_labels + l] + columns[x*n_labels + l];
+
+      for(int w=0; w<n_blocks_w; ++w)
+      {
+        if(code_h == 0 || code_w == 0) // blocks too small for the operator
+        {
+          blitz::Array<uint64_t,1> lbp_histo(n_labels);
+          lbp_histo = 0;
+          dst.push_back(lbp_histo);
+          continue;
+        }
+        const uint32_t* left = &cumulated[w*step_w*n_labels];
+        const uint32_t* right = &cumulated[(w*step_w + code_w)*n_labels];
+        blitz::Array<uint64_t,1> lbp_histo(n_labels);
+        for(int l=0; l<n_labels; ++l)
+          lbp_histo(l) = right[l] - left[l];
+
+        // Push the resulting processed block in the container
+        dst.push_back(lbp_histo);
+      }
     }
   }
 
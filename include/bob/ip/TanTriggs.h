@@ -25,8 +25,8 @@
 
 #include "bob/core/array_assert.h"
 #include "bob/ip/gammaCorrection.h"
-#include "bob/sp/conv.h"
 #include "bob/sp/extrapolate.h"
+#include "bob/sp/separable.h"
 
 namespace bob {
 /**
@@ -170,6 +170,8 @@ namespace bob {
 
       // Attributes
       blitz::Array<double, 2> m_kernel;
+      blitz::Array<double, 1> m_kernel0; ///< 1D factors of the Gaussians
+      blitz::Array<double, 1> m_kernel1; ///< of the DoG filter
       blitz::Array<double, 2> m_img_tmp;
       blitz::Array<double, 2> m_img_tmp2;
       double m_gamma;
@@ -193,7 +195,10 @@ namespace bob {
     // Check and resize intermediate array if required
     if( m_img_tmp.extent(0) != src.extent(0) ||  
       m_img_tmp.extent(1) != src.extent(1) )
+    {
       m_img_tmp.resize( src.extent(0), src.extent(1) );
+      m_img_tmp2.resize( src.extent(0), src.extent(1) );
+    }
 
     // 1/ Perform gamma correction
     if( m_gamma > 0.)
@@ -201,20 +206,14 @@ namespace bob {
     else
       m_img_tmp = blitz::log( 1. + src );
 
-    // 2/ Convolution with the DoG Filter
-    if(m_border_type == bob::sp::Extrapolation::Zero)
-      sp::conv( m_img_tmp, m_kernel, dst, bob::sp::Conv::Same);
-    else
-    {
-      m_img_tmp2.resize(bob::sp::getConvOutputSize(m_img_tmp, m_kernel, bob::sp::Conv::Full));
-      if(m_border_type == bob::sp::Extrapolation::NearestNeighbour)
-        bob::sp::extrapolateNearest(m_img_tmp, m_img_tmp2);
-      else if(m_border_type == bob::sp::Extrapolation::Circular)
-        bob::sp::extrapolateCircular(m_img_tmp, m_img_tmp2);
-      else
-        bob::sp::extrapolateMirror(m_img_tmp, m_img_tmp2);
-      bob::sp::conv( m_img_tmp2, m_kernel, dst, bob::sp::Conv::Valid); 
-    }
+    // 2/ Convolution with the DoG Filter, as the difference of the two
+    // (separable) Gaussians. Constant borders are handled as Mirror.
+    const bob::sp::Extrapolation::BorderType border =
+      m_border_type == bob::sp::Extrapolation::Constant ?
+      bob::sp::Extrapolation::Mirror : m_border_type;
+    bob::sp::convSep2D(m_img_tmp, m_kernel0, m_kernel0, dst, border);
+    bob::sp::convSep2D(m_img_tmp, m_kernel1, m_kernel1, m_img_tmp2, border);
+    dst -= m_img_tmp2;
 
     // 3/ Perform contrast equalization
     performContrastEqualization(dst);
@@ -27,6 +27,8 @@
 #include "bob/core/array_assert.h"
 #include "bob/core/array_index.h"
 #include "bob/core/cast.h"
+#include "bob/core/Exception.h"
+#include <algorithm>
 
 namespace bob {
 /**
@@ -114,6 +116,71 @@ namespace bob {
         detail::integralNoCheck(src, dst);
     }
 
+    /**
+      * @brief Function which computes the integral histogram of a 2D 
+      *   blitz::array of bin indices (e.g. LBP codes), in [0,n_bins).
+      *   dst(y,x,b) is the number of elements of src(0:y-1,0:x-1) which
+      *   fall into bin b (the bins being the last dimension, the 
+      *   histograms are contiguous in memory). This requires the dst 
+      *   array to be of size (height+1,width+1,n_bins).
+      *   The histogram of any block can then be obtained in O(n_bins)
+      *   with integralHistogramBlock().
+      * @warning Indices larger than n_bins-1 are counted in the last bin.
+      * @param src The input blitz array
+      * @param dst The output blitz array
+      */
+    template<typename T>
+    void integralHistogram(const blitz::Array<T,2>& src, 
+      blitz::Array<uint32_t,3>& dst)
+    {
+      // Checks that the src/dst arrays have zero base indices
+      bob::core::array::assertZeroBase(src);
+      bob::core::array::assertZeroBase(dst);
+      const int n_bins = dst.extent(2);
+      blitz::TinyVector<int,3> shape(src.extent(0)+1, src.extent(1)+1, n_bins);
+      bob::core::array::assertSameShape(dst, shape);
+      if(n_bins == 0) return;
+
+      const blitz::Range all = blitz::Range::all();
+      dst(0, all, all) = 0;
+      blitz::Array<uint32_t,1> row_sum(n_bins);
+      for(int y=0; y<src.extent(0); ++y)
+      {
+        row_sum = 0;
+        dst(y+1, 0, all) = 0;
+        for(int x=0; x<src.extent(1); ++x)
+        {
+          ++row_sum(std::min(static_cast<int>(src(y,x)), n_bins-1));
+          dst(y+1, x+1, all) = dst(y, x+1, all) + row_sum;
+        }
+      }
+    }
+
+    /**
+      * @brief Function which computes the histogram of the block 
+      *   (y:y+h-1,x:x+w-1) from an integral histogram computed with 
+      *   integralHistogram().
+      * @param src The input integral histogram
+      * @param y, x The top left corner of the block
+      * @param h, w The size of the block
+      * @param dst The output histogram (of size n_bins)
+      */
+    template<typename U>
+    void integralHistogramBlock(const blitz::Array<uint32_t,3>& src, 
+      const int y, const int x, const int h, const int w, 
+      blitz::Array<U,1>& dst)
+    {
+      bob::core::array::assertZeroBase(src);
+      bob::core::array::assertZeroBase(dst);
+      bob::core::array::assertSameDimensionLength(dst.extent(0), src.extent(2));
+      if(y < 0 || x < 0 || h < 0 || w < 0 || y+h >= src.extent(0) || 
+          x+w >= src.extent(1))
+        throw bob::core::InvalidArgumentException("The block is not inside the integral histogram.");
+      for(int b=0; b<dst.extent(0); ++b)
+        dst(b) = static_cast<U>(src(y+h,x+w,b)) + static_cast<U>(src(y,x,b)) -
+          static_cast<U>(src(y,x+w,b)) - static_cast<U>(src(y+h,x,b));
+    }
+
   }
 /**
  * @}
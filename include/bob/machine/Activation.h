@@ -23,6 +23,8 @@
 #ifndef BOB_MACHINE_ACTIVATION_H 
 #define BOB_MACHINE_ACTIVATION_H
 
+#include <cmath>
+#include <blitz/array.h>
 
 namespace bob { namespace machine {
 
@@ -51,6 +53,30 @@ namespace bob { namespace machine {
   inline double tanh_derivative(double x) { return 1-(x*x); }
   inline double logistic_derivative(double x) { return x*(1-x); }
 
+  /**
+   * Applies the activation function to every element of x, after adding the
+   * bias of its column: x(i,j) = f(x(i,j) + bias(j)). The activation is
+   * resolved once per call, so that it is inlined in the loop over the
+   * elements (instead of being called through a function pointer).
+   */
+  void activate(const Activation a, const blitz::Array<double,1>& bias,
+      blitz::Array<double,2>& x);
+
+  /**
+   * Applies the activation function to every element of x, after adding its
+   * bias: x(i) = f(x(i) + bias(i)).
+   */
+  void activate(const Activation a, const blitz::Array<double,1>& bias,
+      blitz::Array<double,1>& x);
+
+  /**
+   * Multiplies every element of error by the derivative of the activation
+   * function, given the activated values (see the derivatives above):
+   * error(i,j) *= f'(output(i,j)).
+   */
+  void multiplyByDerivative(const Activation a,
+      const blitz::Array<double,2>& output, blitz::Array<double,2>& error);
+
 }}
       
 #endif /* BOB_MACHINE_ACTIVATION_H */
@@ -31,13 +31,64 @@
 #include "bob/io/HDF5File.h"
 #include <iostream>
 #include <boost/shared_ptr.hpp>
+#include <boost/noncopyable.hpp>
 #include <vector>
 
 namespace bob { namespace machine {
 
+class GMMMachine;
+
+/**
+ * @brief Scratch memory of the GMMMachine scoring methods.
+ * @details The GMMMachine methods taking a GMMWorkspace only read the
+ * machine and write into the workspace. A single machine can therefore be
+ * used by several threads at the same time, as long as each thread has its
+ * own workspace. The buffers are (re)allocated on use, according to the
+ * dimensions of the machine.
+ */
+class GMMWorkspace: private boost::noncopyable
+{
+  public:
+    /**
+     * Constructor: the buffers are allocated on first use
+     */
+    GMMWorkspace();
+
+  private:
+    friend class GMMMachine;
+
+    /**
+     * Resizes the buffers used to score a single sample, if required
+     */
+    void resize(const size_t n_gaussians, const size_t n_inputs);
+
+    /**
+     * Resizes the buffers used to score blocks of samples, if required
+     */
+    void resizeBatch(const size_t n_gaussians, const size_t n_inputs,
+      const size_t block_size);
+
+    /// For each Gaussian i, log(weight_i*p(x|gaussian_i)), responsibilities
+    blitz::Array<double,1> m_log_weighted_gaussian_likelihoods;
+    blitz::Array<double,1> m_P;
+    blitz::Array<double,2> m_Px;
+
+    /// Parameters and buffers of the block computations over 2D inputs
+    blitz::Array<double,1> m_batch_shift;
+    blitz::Array<double,2> m_batch_W;
+    blitz::Array<double,1> m_batch_const;
+    blitz::Array<double,2> m_batch_Z;
+    blitz::Array<double,2> m_batch_L;
+    blitz::Array<double,1> m_batch_ll;
+    blitz::Array<double,2> m_batch_X;
+    blitz::Array<double,2> m_batch_X2;
+};
+
 /**
  * @brief This class implements a multivariate diagonal Gaussian distribution.
  * @details See Section 2.3.9 of Bishop, "Pattern recognition and machine learning", 2006
+ * The scoring methods that do not take a GMMWorkspace use an internal one,
+ * and should not be called concurrently on the same machine.
  */
 class GMMMachine: public Machine<blitz::Array<double,1>, double>
 {
@@ -156,10 +207,11 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
      * Get the mean supervector
      */
     void getMeanSupervector(blitz::Array<double,1> &mean_supervector) const;
-     /**
-     * Returns a const reference to the supervector (Put in cache)
+    /**
+     * Returns a const reference to the mean supervector (in cache)
      */
-    const blitz::Array<double,1>& getMeanSupervector() const;
+    inline const blitz::Array<double,1>& getMeanSupervector() const
+    { return m_cache_mean_supervector; }
 
     /**
      * Set the variances
@@ -178,9 +230,10 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
      */
     void getVarianceSupervector(blitz::Array<double,1> &variance_supervector) const;
     /**
-     * Returns a const reference to the supervector (Put in cache)
+     * Returns a const reference to the variance supervector (in cache)
      */
-    const blitz::Array<double,1>& getVarianceSupervector() const;
+    inline const blitz::Array<double,1>& getVarianceSupervector() const
+    { return m_cache_variance_supervector; }
 
     /**
      * Set the variance flooring thresholds in each dimension
@@ -232,6 +285,58 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
      */
     double logLikelihood_(const blitz::Array<double, 1> &x) const;
 
+    /**
+     * Output the log likelihood of each sample (row) of x,
+     * i.e. log(p(x_n|GMMMachine)), scoring blocks of samples against all the
+     * Gaussian components at once.
+     * @param[in]  x               The samples (one per row)
+     * @param[out] log_likelihoods The log likelihood of each sample
+     * Dimensions of the parameters are checked
+     */
+    void logLikelihood(const blitz::Array<double,2> &x, blitz::Array<double,1> &log_likelihoods) const;
+
+    /**
+     * Output the log likelihood of each sample (row) of x,
+     * i.e. log(p(x_n|GMMMachine))
+     * @param[in]  x               The samples (one per row)
+     * @param[out] log_likelihoods The log likelihood of each sample
+     * @warning Dimensions of the parameters are not checked
+     */
+    void logLikelihood_(const blitz::Array<double,2> &x, blitz::Array<double,1> &log_likelihoods) const;
+
+    /**
+     * Output the log likelihood of the sample, x, i.e. log(p(x|GMM)),
+     * using the given workspace instead of the internal one. This method
+     * can be called concurrently on the same machine with different
+     * workspaces.
+     * @param[in]  x  The sample
+     * @param[in]  ws The workspace
+     * Dimension of the input is checked
+     */
+    double logLikelihood(const blitz::Array<double, 1> &x, GMMWorkspace& ws) const;
+
+    /**
+     * Output the log likelihood of the sample, x, i.e. log(p(x|GMM)),
+     * using the given workspace instead of the internal one.
+     * @warning Dimension of the input is not checked
+     */
+    double logLikelihood_(const blitz::Array<double, 1> &x, GMMWorkspace& ws) const;
+
+    /**
+     * Output the log likelihood of each sample (row) of x, using the given
+     * workspace instead of the internal one. This method can be called
+     * concurrently on the same machine with different workspaces.
+     * Dimensions of the parameters are checked
+     */
+    void logLikelihood(const blitz::Array<double,2> &x, blitz::Array<double,1> &log_likelihoods, GMMWorkspace& ws) const;
+
+    /**
+     * Output the log likelihood of each sample (row) of x, using the given
+     * workspace instead of the internal one.
+     * @warning Dimensions of the parameters are not checked
+     */
+    void logLikelihood_(const blitz::Array<double,2> &x, blitz::Array<double,1> &log_likelihoods, GMMWorkspace& ws) const;
+
     /**
      * Output the log likelihood of the sample, x
      * (overrides Machine::forward)
@@ -248,6 +353,9 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
 
     /**
      * Accumulates the GMM statistics over a set of samples.
+     * Blocks of samples are scored against all the Gaussian components with
+     * a single matrix product, and the statistics of each block are
+     * accumulated with rank-k updates.
      * @see bool accStatistics(const blitz::Array<double,1> &x, GMMStats stats)
      * Dimensions of the parameters are checked
      */
@@ -278,14 +386,54 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
      */
     void accStatistics_(const blitz::Array<double,1> &x, GMMStats &stats) const;
 
+    /**
+     * Accumulates the GMM statistics over a set of samples, using the given
+     * workspace instead of the internal one. This method can be called
+     * concurrently on the same machine with different workspaces (and
+     * different statistics).
+     * Dimensions of the parameters are checked
+     */
+    void accStatistics(const blitz::Array<double,2>& input, GMMStats &stats, GMMWorkspace& ws) const;
+
+    /**
+     * Accumulates the GMM statistics over a set of samples, using the given
+     * workspace instead of the internal one.
+     * @warning Dimensions of the parameters are not checked
+     */
+    void accStatistics_(const blitz::Array<double,2>& input, GMMStats &stats, GMMWorkspace& ws) const;
+
+    /**
+     * Accumulate the GMM statistics for this sample, using the given
+     * workspace instead of the internal one.
+     * Dimensions of the parameters are checked
+     */
+    void accStatistics(const blitz::Array<double,1> &x, GMMStats &stats, GMMWorkspace& ws) const;
+
+    /**
+     * Accumulate the GMM statistics for this sample, using the given
+     * workspace instead of the internal one.
+     * @warning Dimensions of the parameters are not checked
+     */
+    void accStatistics_(const blitz::Array<double,1> &x, GMMStats &stats, GMMWorkspace& ws) const;
+
     /**
      * Get a pointer to a particular Gaussian component
      * @param[in] i The index of the Gaussian component
      * @return A smart pointer to the i'th Gaussian component
      *         if it exists, otherwise throws an exception
+     * @warning updateCacheSupervectors() must be called after updating the
+     * means or variances of the component
      */
     boost::shared_ptr<bob::machine::Gaussian> getGaussian(const size_t i);
 
+    /**
+     * Updates the mean and variance supervectors in cache, from the means
+     * and variances of the Gaussian components
+     * @warning Should be used by trainers only when updating the components
+     * through getGaussian()
+     */
+    void updateCacheSupervectors();
+
     /**
      * Return the number of Gaussian components
      */
@@ -302,11 +450,6 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
      */
     void load(bob::io::HDF5File& config);
 
-    /**
-     * Load/Reload mean/variance supervector in cache
-     */
-    void reloadCacheSupervectors() const;
-
     friend std::ostream& operator<<(std::ostream& os, const GMMMachine& machine);
 
 
@@ -336,16 +479,10 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
      */
     blitz::Array<double,1> m_weights;
 
-    /**
-     * Update the mean and variance supervectors
-     * in cache (into a 1D blitz array)
-     */
-    void updateCacheSupervectors() const;
-
     /**
      * Initialise the cache members (allocate arrays)
      */
-    void initCache() const;
+    void initCache();
 
     /**
      * Accumulate the GMM statistics for this sample.
@@ -354,21 +491,39 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
      * @param[in]  x     The current sample
      * @param[out] stats The accumulated statistics
      * @param[in]  log_likelihood  The current log_likelihood
+     * @param[in]  ws    The workspace holding the log weighted likelihoods
      * @warning Dimensions of the parameters are not checked
      */
     void accStatisticsInternal(const blitz::Array<double,1> &x,
-      GMMStats &stats, const double log_likelihood) const;
+      GMMStats &stats, const double log_likelihood, GMMWorkspace& ws) const;
+
 
+    /**
+     * Precomputes into the workspace the parameters of the block
+     * computation of the log weighted likelihoods (inverse variances,
+     * means, constant terms)
+     * Called by logLikelihood_() and accStatistics_() for 2D inputs
+     */
+    void updateBatch(GMMWorkspace& ws) const;
+
+    /**
+     * Computes, for a block of samples (at most s_batch_block_size), the
+     * log weighted likelihoods log(weight_i*p(x_n|gaussian_i)) into
+     * ws.m_batch_L and the GMM log likelihoods log(p(x_n|GMMMachine))
+     * into ws.m_batch_ll.
+     * @warning updateBatch() must have been called before
+     */
+    void logLikelihoodBlock_(const blitz::Array<double,2> &x, GMMWorkspace& ws) const;
 
     /// Some cache arrays to avoid re-allocation when computing log-likelihoods
     mutable blitz::Array<double,1> m_cache_log_weights;
-    mutable blitz::Array<double,1> m_cache_log_weighted_gaussian_likelihoods;
-    mutable blitz::Array<double,1> m_cache_P;
-    mutable blitz::Array<double,2> m_cache_Px;
 
-    mutable blitz::Array<double,1> m_cache_mean_supervector;
-    mutable blitz::Array<double,1> m_cache_variance_supervector;
-    mutable bool m_cache_supervector;
+    /// The mean and variance supervectors, updated with the components
+    blitz::Array<double,1> m_cache_mean_supervector;
+    blitz::Array<double,1> m_cache_variance_supervector;
+
+    /// Workspace of the scoring methods that do not take one
+    mutable GMMWorkspace m_workspace;
 
 };
 
@@ -129,6 +129,26 @@ namespace bob{ namespace machine {
         const bob::machine::GaborJetSimilarity& jet_similarity_function
       ) const;
 
+      //! \brief computes the similarities of one probe graph with each of many model graphs, in parallel;
+      //! the similarities are identical to the ones of the pairwise similarity function above
+      void similarities(
+        const blitz::Array<double,4>& many_model_graph_jets,
+        const blitz::Array<double,3>& probe_graph_jets,
+        const bob::machine::GaborJetSimilarity& jet_similarity_function,
+        blitz::Array<double,1>& similarities,
+        const size_t n_threads = 1
+      ) const;
+
+      //! \brief computes the similarities of one probe graph with each of many model graphs (absolute values only), in parallel;
+      //! the similarities are identical to the ones of the pairwise similarity function above
+      void similarities(
+        const blitz::Array<double,3>& many_model_graph_jets,
+        const blitz::Array<double,2>& probe_graph_jets,
+        const bob::machine::GaborJetSimilarity& jet_similarity_function,
+        blitz::Array<double,1>& similarities,
+        const size_t n_threads = 1
+      ) const;
+
       //! saves this machine to file
       void save(bob::io::HDF5File& file) const;
 
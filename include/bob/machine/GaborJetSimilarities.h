@@ -26,6 +26,7 @@
 #include "bob/core/array_assert.h"
 #include <blitz/array.h>
 #include <numeric>
+#include <vector>
 #include "bob/ip/GaborWaveletTransform.h"
 
 namespace bob { namespace machine {
@@ -55,6 +56,15 @@ namespace bob { namespace machine {
       //! The similarity between two Gabor jets, including absolute values only
       double operator()(const blitz::Array<double,1>& jet1, const blitz::Array<double,1>& jet2) const;
 
+      //! \brief The similarity between two Gabor jets, given by pointers to their (contiguous) absolute values and phases.
+      //! The phases are not used by the SCALAR_PRODUCT and CANBERRA types, and might be NULL for these.
+      //! Contrary to the operators above, this function does not check its input and does not update disparity(),
+      //! so that it can be called concurrently, e.g., to compare a probe graph with many model graphs.
+      double similarity_(const double* abs1, const double* phase1, const double* abs2, const double* phase2, const int size) const;
+
+      //! returns true if this similarity function requires the Gabor phases (i.e., for the disparity-like types)
+      bool usesPhases() const {return m_type >= DISPARITY;}
+
       //! returns the disparity vector estimated during the last call of similarity; only valid for disparity types
       blitz::TinyVector<double,2> disparity() const {return m_disparity;}
 
@@ -71,17 +81,18 @@ namespace bob { namespace machine {
       // members required by disparity functions
       bob::ip::GaborWaveletTransform m_gwt;
 
-      // initializes the internal memory to be used for disparity-like Gabor jet similarities
+      // initializes the kernel tables to be used for disparity-like Gabor jet similarities
       void init();
-      // computes confidences from the given Gabor jets
-      void compute_confidences(const blitz::Array<double,2>& jet1, const blitz::Array<double,2>& jet2) const;
-      // computes the disparity using the m_confidences and m_phase_differences values
-      void compute_disparity() const;
+      // computes the similarity of two Gabor jets, and the disparity for disparity-like types
+      double compute_similarity(const double* abs1, const double* phase1, const double* abs2, const double* phase2, const int size, blitz::TinyVector<double,2>& disparity) const;
+      // computes the disparity between the given Gabor jets
+      blitz::TinyVector<double,2> compute_disparity(const double* abs1, const double* phase1, const double* abs2, const double* phase2) const;
 
       mutable blitz::TinyVector<double,2> m_disparity;
 
-      mutable std::vector<double> m_confidences;
-      mutable std::vector<double> m_phase_differences;
+      // the kernel frequencies (y and x components), in the order of the Gabor jet entries
+      std::vector<double> m_kernels_y;
+      std::vector<double> m_kernels_x;
       std::vector<double> m_wavelet_extends;
 
   }; // class GaborJetSimilarity
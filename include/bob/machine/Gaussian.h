@@ -109,6 +109,13 @@ class Gaussian: public Machine<blitz::Array<double,1>, double>
     inline const blitz::Array<double,1>& getMean() const
     { return m_mean; }
 
+    /**
+     * Get the normalization constant g_norm of the log likelihood
+     * @see preComputeConstants()
+     */
+    inline double getGNorm() const
+    { return m_g_norm; }
+
     /**
      * Get the mean in order to be updated
      * @warning Only trainers should use this function for efficiency reason
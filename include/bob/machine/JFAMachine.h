@@ -477,6 +477,76 @@ class JFAMachine
 };
 
 
+/**
+ * Scores a set of probes against many JFA (or ISV) machines.
+ *
+ * The channel factors x of a probe, and hence its channel offset Ux, only
+ * depend on its statistics and on the JFABaseMachine, and not on the model
+ * it is compared to. They are estimated once for all the probes by the
+ * constructor (the probes being split across threads) and kept, so that
+ * the probes can then be scored against any number of machines sharing
+ * the same JFABaseMachine, in a single (blocked) linear scoring call.
+ */
+class JFAScorer
+{
+  public:
+    /**
+     * Estimates and caches the channel offsets of the given probes
+     *
+     * @param jfa_base the JFABaseMachine shared by all the models
+     * @param probes the GMM statistics of the probes
+     * @param n_threads number of threads to use (0 for one per core)
+     */
+    JFAScorer(const boost::shared_ptr<const bob::machine::JFABaseMachine> jfa_base,
+      const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+      const size_t n_threads=1);
+
+    /**
+     * Computes the scores of all the cached probes against the given 
+     * machines, as JFAMachine::forward() would.
+     *
+     * @param models the machines, which must share the JFABaseMachine of
+     *   this scorer
+     * @param[out] scores 2D matrix of scores, <tt>scores[m, p]</tt> is the
+     *   score of model @c m against probe @c p
+     * @warning the output scores matrix should have the correct size
+     *   (number of models x number of probes)
+     */
+    void score(const std::vector<boost::shared_ptr<const bob::machine::JFAMachine> >& models,
+      blitz::Array<double,2>& scores) const;
+
+    /**
+     * Returns the number of cached probes
+     */
+    size_t getNProbes() const 
+    { return m_probes.size(); }
+
+    /**
+     * Returns the estimated channel factors x, one row per probe
+     */
+    const blitz::Array<double,2>& getX() const 
+    { return m_x; }
+
+    /**
+     * Returns the estimated channel offsets Ux, one per probe
+     */
+    const std::vector<blitz::Array<double,1> >& getUx() const 
+    { return m_Ux; }
+
+    /**
+     * Sets/gets the number of threads used (0 for one per core)
+     */
+    void setNThreads(const size_t n_threads) { m_n_threads = n_threads; }
+    size_t getNThreads() const { return m_n_threads; }
+
+  private:
+    boost::shared_ptr<const bob::machine::JFABaseMachine> m_jfa_base;
+    std::vector<boost::shared_ptr<const bob::machine::GMMStats> > m_probes;
+    size_t m_n_threads;
+    blitz::Array<double,2> m_x;
+    std::vector<blitz::Array<double,1> > m_Ux;
+};
+
 }}
 
 #endif
@@ -166,6 +166,26 @@ class KMeansMachine: public Machine<blitz::Array<double,1>, double> {
      */
     double getMinDistance(const blitz::Array<double,1>& input) const;
 
+    /**
+     * Computes the power of two of the Euclidean distance of each sample
+     * (row) of data to each mean, using the expansion 
+     * ||x-m||^2 = ||x||^2 - 2 x.m + ||m||^2, so that the bulk of the work is
+     * a single matrix product. The results may differ from
+     * getDistanceFromMean() by a few ulps (relative to ||x||^2+||m||^2).
+     * @param[in]  data      The samples (one per row)
+     * @param[out] distances The distances, with as many rows as samples and
+     *                       as many columns as means
+     */
+    void getDistancesFromMeans(const blitz::Array<double,2>& data,
+      blitz::Array<double,2>& distances) const;
+
+    /**
+     * Same as getDistancesFromMeans()
+     * @warning The dimensions of the parameters are NOT checked
+     */
+    void getDistancesFromMeans_(const blitz::Array<double,2>& data,
+      blitz::Array<double,2>& distances) const;
+
     /**
      * For each mean, find the subset of the samples
      * that is closest to that mean, and calculate
@@ -188,6 +208,17 @@ class KMeansMachine: public Machine<blitz::Array<double,1>, double> {
     void getVariancesAndWeightsForEachClusterAcc(const blitz::Array<double,2> &data, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const;
     void getVariancesAndWeightsForEachClusterFin(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const;
 
+    /**
+     * Same as the three methods above, except that the sums of the samples
+     * of each cluster are accumulated into the given means array (with as
+     * many rows as means, and as many columns as feature dimensions) instead
+     * of the m_cache_means member. These methods do not modify the machine,
+     * and can hence be called concurrently with different arrays.
+     */
+    void getVariancesAndWeightsForEachClusterInit(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights, blitz::Array<double,2>& means) const;
+    void getVariancesAndWeightsForEachClusterAcc(const blitz::Array<double,2> &data, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights, blitz::Array<double,2>& means) const;
+    void getVariancesAndWeightsForEachClusterFin(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights, blitz::Array<double,2>& means) const;
+
     /**
      * Get the m_cache_means array. 
      * @warning This variable should only be used in the case you want to parallelize the 
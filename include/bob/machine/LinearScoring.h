@@ -39,6 +39,7 @@ namespace bob { namespace machine {
  * @param test_channelOffset  list of channel offset if any (for JFA/ISA for instance)
  * @param frame_length_normalisation   perform a normalisation by the number of feature vectors
  * @param[out] scores 2D matrix of scores, <tt>scores[m, s]</tt> is the score for model @c m against statistics @c s
+ * @param n_threads   number of threads the test statistics are split across (0 for one per core)
  * @warning the output scores matrix should have the correct size (number of models x number of test_stats)
  */
 void linearScoring(const std::vector<blitz::Array<double,1> >& models,
@@ -46,12 +47,75 @@ void linearScoring(const std::vector<blitz::Array<double,1> >& models,
                    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
                    const std::vector<blitz::Array<double, 1> >& test_channelOffset,
                    const bool frame_length_normalisation,
-                   blitz::Array<double, 2>& scores);
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads=1);
 void linearScoring(const std::vector<blitz::Array<double,1> >& models,
                    const blitz::Array<double,1>& ubm_mean, const blitz::Array<double,1>& ubm_variance,
                    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
                    const bool frame_length_normalisation,
-                   blitz::Array<double, 2>& scores);
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads=1);
+
+/**
+ * Compute the matrix of the normalised offsets of the models, one model per
+ * row: <tt>A[m,:] = (models[m] - ubm_mean) / ubm_variance</tt>. This matrix
+ * can be computed once and given to linearScoring() to score several sets
+ * of test statistics against the same models.
+ *
+ * @param models        list of mean supervector for the client models
+ * @param ubm_mean      mean supervector of the world model
+ * @param ubm_variance  variance supervector of the world model
+ * @param[out] A        2D matrix of size number of models x CD
+ * @param n_threads     number of threads the models are split across (0 for one per core)
+ */
+void linearScoringModels(const std::vector<blitz::Array<double,1> >& models,
+                         const blitz::Array<double,1>& ubm_mean, const blitz::Array<double,1>& ubm_variance,
+                         blitz::Array<double,2>& A,
+                         const size_t n_threads=1);
+
+/**
+ * Compute the matrix of the normalised offsets of the models, one model per
+ * row, from the (cached) mean supervectors of GMMMachines.
+ *
+ * @param models      list of client models as GMMMachines
+ * @param ubm         world model as a GMMMachine
+ * @param[out] A      2D matrix of size number of models x CD
+ * @param n_threads   number of threads the models are split across (0 for one per core)
+ */
+void linearScoringModels(const std::vector<boost::shared_ptr<const bob::machine::GMMMachine> >& models,
+                         const bob::machine::GMMMachine& ubm,
+                         blitz::Array<double,2>& A,
+                         const size_t n_threads=1);
+
+/**
+ * Compute a matrix of scores using linear scoring, with models given as
+ * the matrix of their normalised offsets (see linearScoringModels()).
+ *
+ * The test statistics are centered block by block, and each block is
+ * scored against all the models with a single matrix product.
+ *
+ * @param models_normalised   2D matrix of the normalised offsets of the models, as computed by linearScoringModels()
+ * @param ubm_mean      mean supervector of the world model
+ * @param test_stats    list of accumulate statistics for each test trial
+ * @param test_channelOffset  list of channel offset if any (for JFA/ISA for instance)
+ * @param frame_length_normalisation   perform a normalisation by the number of feature vectors
+ * @param[out] scores 2D matrix of scores, <tt>scores[m, s]</tt> is the score for model @c m against statistics @c s
+ * @param n_threads   number of threads the test statistics are split across (0 for one per core)
+ * @warning the output scores matrix should have the correct size (number of models x number of test_stats)
+ */
+void linearScoring(const blitz::Array<double,2>& models_normalised,
+                   const blitz::Array<double,1>& ubm_mean,
+                   const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
+                   const std::vector<blitz::Array<double, 1> >& test_channelOffset,
+                   const bool frame_length_normalisation,
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads=1);
+void linearScoring(const blitz::Array<double,2>& models_normalised,
+                   const blitz::Array<double,1>& ubm_mean,
+                   const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
+                   const bool frame_length_normalisation,
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads=1);
 
 /**
  * Compute a matrix of scores using linear scoring.
@@ -63,13 +127,15 @@ void linearScoring(const std::vector<blitz::Array<double,1> >& models,
  * @param test_stats  list of accumulate statistics for each test trial
  * @param frame_length_normalisation   perform a normalisation by the number of feature vectors
  * @param[out] scores 2D matrix of scores, <tt>scores[m, s]</tt> is the score for model @c m against statistics @c s
+ * @param n_threads   number of threads the test statistics are split across (0 for one per core)
  * @warning the output scores matrix should have the correct size (number of models x number of test_stats)
  */
 void linearScoring(const std::vector<boost::shared_ptr<const bob::machine::GMMMachine> >& models,
                    const bob::machine::GMMMachine& ubm,
                    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
                    const bool frame_length_normalisation,
-                   blitz::Array<double, 2>& scores);
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads=1);
 /**
  * Compute a matrix of scores using linear scoring.
  *
@@ -81,6 +147,7 @@ void linearScoring(const std::vector<boost::shared_ptr<const bob::machine::GMMMa
  * @param test_channelOffset  list of channel offset if any (for JFA/ISA for instance)
  * @param frame_length_normalisation   perform a normalisation by the number of feature vectors
  * @param[out] scores 2D matrix of scores, <tt>scores[m, s]</tt> is the score for model @c m against statistics @c s
+ * @param n_threads   number of threads the test statistics are split across (0 for one per core)
  * @warning the output scores matrix should have the correct size (number of models x number of test_stats)
  */
 void linearScoring(const std::vector<boost::shared_ptr<const bob::machine::GMMMachine> >& models,
@@ -88,7 +155,8 @@ void linearScoring(const std::vector<boost::shared_ptr<const bob::machine::GMMMa
                    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
                    const std::vector<blitz::Array<double, 1> >& test_channelOffset,
                    const bool frame_length_normalisation,
-                   blitz::Array<double, 2>& scores);
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads=1);
 
 }}
 
@@ -150,7 +150,8 @@ namespace bob { namespace machine {
        * Forwards data through the network, outputs the values of each output
        * neuron. This variant will take a number of inputs in one single input
        * matrix with inputs arranged row-wise (i.e., every row contains an
-       * individual input).
+       * individual input). The inputs are processed by blocks, with a
+       * single matrix-matrix product per layer and block.
        *
        * The input and output are NOT checked for compatibility each time. It
        * is your responsibility to do it.
@@ -340,6 +341,7 @@ namespace bob { namespace machine {
       actfun_t m_actfun; ///< currently set activation function
 
       mutable std::vector<blitz::Array<double, 1> > m_buffer; ///< a buffer for speed
+      mutable std::vector<blitz::Array<double, 2> > m_batch_buffer; ///< same, for blocks of inputs
   
   };
 
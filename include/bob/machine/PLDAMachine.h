@@ -25,6 +25,8 @@
 #define BOB_MACHINE_PLDAMACHINE_H
 
 #include <blitz/array.h>
+#include <vector>
+#include <boost/shared_ptr.hpp>
 #include "bob/io/HDF5File.h"
 
 namespace bob { namespace machine {
@@ -689,6 +691,77 @@ class PLDAMachine
     void resize(const size_t dim_d, const size_t dim_f, const size_t dim_g);
 };
 
+/**
+ * @brief Scores many probe samples against many enrolled PLDAMachine's at
+ * once.\n
+ * Everything that does not depend on the probes (\f$\gamma_a\f$'s and 
+ * log-likelihood constant terms, weighted sums of the enrolled samples) is
+ * precomputed by the constructor, from the state of the models at that
+ * time, into an immutable table. score() hence never modifies anything
+ * and can be called concurrently.\n
+ * The projections \f$F^T \beta (x - \mu)\f$ of the probes are computed
+ * only once for all the models, and the log-likelihood ratios of all the
+ * models sharing the same number of enrolled samples are obtained with a
+ * single matrix product. The scores are the same as the ones of 
+ * PLDAMachine::forward(), up to rounding errors.
+ */
+class PLDAScorer
+{
+  public:
+    /**
+     * @brief Constructor, precomputes the terms that only depend on the
+     * models. All the models must share the same PLDABaseMachine.
+     * @param models the enrolled models
+     * @param n_threads number of threads used by score() (0 for one per core)
+     */
+    PLDAScorer(const std::vector<boost::shared_ptr<const PLDAMachine> >& models,
+      const size_t n_threads=1);
+
+    /**
+     * @brief Computes the log-likelihood ratios of all the probes (one per
+     * row of probes) against all the models.
+     * @param probes the probe samples (N x D)
+     * @param[out] scores the log-likelihood ratios (M x N, one row per model)
+     * @warning The destination score array should have the correct size
+     */
+    void score(const blitz::Array<double,2>& probes, 
+      blitz::Array<double,2>& scores) const;
+
+    /**
+     * @brief Gets the number of models
+     */
+    inline size_t getNModels() const 
+    { return m_n_models; }
+    /**
+     * @brief Gets the feature dimensionality
+     */
+    inline size_t getDimD() const 
+    { return m_mu.extent(0); }
+
+    /**
+     * @brief Sets/gets the number of threads used (0 for one per core)
+     */
+    void setNThreads(const size_t n_threads) { m_n_threads = n_threads; }
+    size_t getNThreads() const { return m_n_threads; }
+
+  private:
+    size_t m_n_threads;
+    size_t m_n_models;
+    blitz::Array<double,1> m_mu; ///< \f$\mu\f$
+    blitz::Array<double,2> m_Ft_beta; ///< \f$F^T \beta\f$
+    blitz::Array<double,2> m_gamma_1; ///< \f$\gamma_1\f$ (probe alone)
+    /**
+     * @brief Models grouped by number of enrolled samples \f$a-1\f$. For 
+     * each group: the indices of its models, \f$\gamma_a\f$, the 
+     * \f$(\gamma_a + \gamma_a^T) s_m\f$ rows where \f$s_m\f$ is the
+     * weighted sum of the model, and the probe independent part of the 
+     * log-likelihood ratio of each model.
+     */
+    std::vector<std::vector<int> > m_group_models;
+    std::vector<blitz::Array<double,2> > m_group_gamma;
+    std::vector<blitz::Array<double,2> > m_group_weighted_sums;
+    std::vector<blitz::Array<double,1> > m_group_offsets;
+};
 
 }}
 
@@ -28,6 +28,7 @@
 #include <boost/shared_array.hpp>
 #include <blitz/array.h>
 #include <fstream>
+#include <vector>
 #include "bob/io/HDF5File.h"
 
 // We need to declare the svm_model type for libsvm < 3.0.0. The next bit of
@@ -309,6 +310,21 @@ namespace bob { namespace machine {
        */
       int predictClass_(const blitz::Array<double,1>& input) const;
 
+      /**
+       * Predicts the classes of several inputs (one per row) at once. The
+       * kernel values between a block of inputs and all the support vectors
+       * are computed together, on dense copies of the support vectors. The
+       * "labels" array should have as many entries as there are inputs.
+       */
+      void predictClass(const blitz::Array<double,2>& input,
+         blitz::Array<int,1>& labels) const;
+
+      /**
+       * Same as above, but does not check the input.
+       */
+      void predictClass_(const blitz::Array<double,2>& input,
+         blitz::Array<int,1>& labels) const;
+
       /**
        * Predicts class and scores output for each class on this SVM,
        *
@@ -326,6 +342,22 @@ namespace bob { namespace machine {
         (const blitz::Array<double,1>& input,
          blitz::Array<double,1>& scores) const;
 
+      /**
+       * Predicts the classes and scores of several inputs (one per row) at
+       * once. The "scores" array should have one row per input and
+       * outputSize() columns.
+       */
+      void predictClassAndScores
+        (const blitz::Array<double,2>& input,
+         blitz::Array<int,1>& labels, blitz::Array<double,2>& scores) const;
+
+      /**
+       * Same as above, but does not check the input.
+       */
+      void predictClassAndScores_
+        (const blitz::Array<double,2>& input,
+         blitz::Array<int,1>& labels, blitz::Array<double,2>& scores) const;
+
       /**
        * Predict, output class and probabilities for each class on this SVM,
        * but only if the model supports it. Otherwise, throws a run-time
@@ -373,14 +405,25 @@ namespace bob { namespace machine {
        */
       void reset();
 
+      /**
+       * Predicts the classes (and the decision values, if scores is not
+       * null) of a block of inputs with the dense support vectors. Falls
+       * back to libsvm for precomputed kernels.
+       */
+      void predictBlock(const blitz::Array<double,2>& input,
+          blitz::Array<int,1>& labels, blitz::Array<double,2>* scores) const;
+
     private: //representation
 
       boost::shared_ptr<svm_model> m_model; ///< libsvm model pointer
-      mutable boost::shared_array<svm_node> m_input_cache; ///< cache
       size_t m_input_size; ///< vector size expected as input for the SVM's
       blitz::Array<double,1> m_input_sub; ///< scaling: subtraction
       blitz::Array<double,1> m_input_div; ///< scaling: division
 
+      blitz::Array<double,2> m_sv; ///< dense support vectors (one per row)
+      blitz::Array<double,2> m_sv_coef; ///< SV coefficients (as in libsvm)
+      std::vector<int> m_start; ///< first SV of each class
+
   };
 
 }}
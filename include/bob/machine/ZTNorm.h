@@ -25,6 +25,77 @@
 
 namespace bob { namespace machine {
 
+  /**
+   * ZT-Norm of raw scores that can be processed block by block.
+   *
+   * The T-Norm statistics (the mean and standard deviation, for each probe,
+   * of its Z-normalised scores against the T-Norm models) are computed once
+   * by the constructor. normalize() can then be called on consecutive
+   * blocks of rows (models) of the raw scores, read for instance from a
+   * chunked HDF5 file or a memory-mapped array, so that the whole score
+   * matrix never has to be held in memory. No intermediate matrix of the
+   * size of the inputs is allocated.
+   */
+  class ZTNormalizer {
+    public:
+      /**
+       * Computes the T-Norm statistics
+       *
+       * @exception bob::core::UnexpectedShapeError matrix sizes are not consistent
+       *
+       * @param rawscores_probes_vs_tmodels
+       * @param rawscores_zprobes_vs_tmodels
+       * @param mask_zprobes_vs_tmodels_istruetrial
+       * @param n_threads number of threads to use (0 for one per core)
+       */
+      ZTNormalizer(const blitz::Array<double, 2>& rawscores_probes_vs_tmodels,
+                   const blitz::Array<double, 2>& rawscores_zprobes_vs_tmodels,
+                   const blitz::Array<bool,   2>& mask_zprobes_vs_tmodels_istruetrial,
+                   const size_t n_threads=1);
+
+      /**
+       * Computes the T-Norm statistics, assuming that znorm and tnorm have
+       * no common subject id.
+       */
+      ZTNormalizer(const blitz::Array<double, 2>& rawscores_probes_vs_tmodels,
+                   const blitz::Array<double, 2>& rawscores_zprobes_vs_tmodels,
+                   const size_t n_threads=1);
+
+      /**
+       * Normalises a block of rows of the raw scores, with the corresponding
+       * rows of the Z-Norm scores.
+       *
+       * @param rawscores_probes_vs_models
+       * @param rawscores_zprobes_vs_models
+       * @param[out] normalizedscores normalized scores (may be
+       *        rawscores_probes_vs_models itself, for an in-place
+       *        normalisation)
+       */
+      void normalize(const blitz::Array<double, 2>& rawscores_probes_vs_models,
+                     const blitz::Array<double, 2>& rawscores_zprobes_vs_models,
+                     blitz::Array<double, 2>& normalizedscores) const;
+
+      /**
+       * Returns the T-Norm statistics, one value per probe
+       */
+      const blitz::Array<double, 1>& getTNormMean() const { return m_mean_zC; }
+      const blitz::Array<double, 1>& getTNormStd() const { return m_std_zC; }
+
+      /**
+       * Sets/gets the number of threads used (0 for one per core)
+       */
+      void setNThreads(const size_t n_threads) { m_n_threads = n_threads; }
+      size_t getNThreads() const { return m_n_threads; }
+
+    private:
+      void init(const blitz::Array<double, 2>& C, const blitz::Array<double, 2>& D,
+                const blitz::Array<bool, 2>* mask);
+
+      size_t m_n_threads;
+      blitz::Array<double, 1> m_mean_zC;
+      blitz::Array<double, 1> m_std_zC;
+  };
+
   /**
    * Normalise raw scores with ZT-Norm
    *
@@ -35,7 +106,9 @@ namespace bob { namespace machine {
    * @param rawscores_probes_vs_tmodels
    * @param rawscores_zprobes_vs_tmodels
    * @param mask_zprobes_vs_tmodels_istruetrial
-   * @param[out] normalizedscores normalized scores
+   * @param[out] normalizedscores normalized scores (may be
+   *        rawscores_probes_vs_models itself, for an in-place normalisation)
+   * @param n_threads number of threads to use (0 for one per core)
    * @warning The destination score array should have the correct size
    *          (Same size as rawscores_probes_vs_models)
    */
@@ -44,7 +117,8 @@ namespace bob { namespace machine {
               const blitz::Array<double, 2>& rawscores_probes_vs_tmodels,
               const blitz::Array<double, 2>& rawscores_zprobes_vs_tmodels,
               const blitz::Array<bool,   2>& mask_zprobes_vs_tmodels_istruetrial,
-              blitz::Array<double, 2>& normalizedscores);
+              blitz::Array<double, 2>& normalizedscores,
+              const size_t n_threads=1);
   
   /**
    * Normalise raw scores with ZT-Norm.
@@ -56,7 +130,9 @@ namespace bob { namespace machine {
    * @param rawscores_zprobes_vs_models
    * @param rawscores_probes_vs_tmodels
    * @param rawscores_zprobes_vs_tmodels
-   * @param[out] normalizedscores normalized scores
+   * @param[out] normalizedscores normalized scores (may be
+   *        rawscores_probes_vs_models itself, for an in-place normalisation)
+   * @param n_threads number of threads to use (0 for one per core)
    * @warning The destination score array should have the correct size
    *          (Same size as rawscores_probes_vs_models)
    */
@@ -64,7 +140,8 @@ namespace bob { namespace machine {
               const blitz::Array<double, 2>& rawscores_zprobes_vs_models,
               const blitz::Array<double, 2>& rawscores_probes_vs_tmodels,
               const blitz::Array<double, 2>& rawscores_zprobes_vs_tmodels,
-              blitz::Array<double, 2>& normalizedscores);
+              blitz::Array<double, 2>& normalizedscores,
+              const size_t n_threads=1);
 }
 }
 
@@ -0,0 +1,66 @@
+/**
+ * @file bob/math/gemm.h
+ * @date Fri 16 Oct 2026 14:02:11 CEST
+ * @author agent <agent@local>
+ *
+ * @brief General matrix-matrix product using the dgemm BLAS function.
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_MATH_GEMM_H
+#define BOB_MATH_GEMM_H
+
+#include <blitz/array.h>
+
+namespace bob {
+/**
+ * \ingroup libmath_api
+ * @{
+ *
+ */
+  namespace math {
+    /**
+      * @brief Function which computes C = alpha*op(A)*op(B) + beta*C,
+      *   using the dgemm BLAS function, where op(X) is X or its transpose.
+      *   Contrary to prod(), which relies on blitz expressions, this is meant
+      *   for large products (batches of samples against model parameters).
+      *   Operands which are not C-contiguous are copied first. C-contiguous
+      *   operands are only accessed through their data pointers, such that
+      *   the same (const) operand can be used by several threads at once.
+      * @param A The A matrix (op(A) has size MxK)
+      * @param B The B matrix (op(B) has size KxN)
+      * @param C The C matrix (size MxN)
+      * @param transA Whether op(A) is the transpose of A
+      * @param transB Whether op(B) is the transpose of B
+      * @param alpha The scaling factor of the product
+      * @param beta The scaling factor of the initial content of C
+      */
+    void gemm(const blitz::Array<double,2>& A, const blitz::Array<double,2>& B,
+      blitz::Array<double,2>& C, const bool transA=false, 
+      const bool transB=false, const double alpha=1., const double beta=0.);
+    /**
+      * @warning No checks are performed on the array sizes
+      */
+    void gemm_(const blitz::Array<double,2>& A, const blitz::Array<double,2>& B,
+      blitz::Array<double,2>& C, const bool transA=false, 
+      const bool transB=false, const double alpha=1., const double beta=0.);
+  }
+/**
+ * @}
+ */
+}
+
+#endif /* BOB_MATH_GEMM_H */
@@ -0,0 +1,265 @@
+/**
+ * @file bob/measure/ScoreDistribution.h
+ * @date Fri 16 Oct 2026 17:02:14 CEST
+ * @author agent <agent@local>
+ *
+ * @brief A pair of sorted (or binned) score sets, on which error rates and
+ * error curves are evaluated without going through the scores again.
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_MEASURE_SCOREDISTRIBUTION_H
+#define BOB_MEASURE_SCOREDISTRIBUTION_H
+
+#include <blitz/array.h>
+#include <utility>
+#include <vector>
+#include <cmath>
+#include <stdint.h>
+
+namespace bob { namespace measure {
+
+  /**
+   * @brief The distributions of the negative and of the positive scores of
+   * a system, on which false-accept (FAR) and false-rejection (FRR) ratios
+   * are evaluated at any threshold. See bob::measure::farfrr() for the
+   * definitions of negatives, positives, FAR and FRR.
+   *
+   * @details The distribution is held in one of two modes:
+   *
+   *   - exact (the default): each score set is sorted once, FAR and FRR at
+   *     a threshold are found by binary search. The results of all methods
+   *     are identical to the ones of the free functions of
+   *     bob/measure/error.h, which use this class internally.
+   *   - histogram: the scores are counted in n_bins bins of equal width in
+   *     [min, max), scores outside of the range falling in the first or in
+   *     the last bin. Memory does not depend on the number of scores, which
+   *     makes it suited to score files that do not fit in memory. FAR and
+   *     FRR are exact at bin edges; other thresholds are rounded down to
+   *     the closest edge.
+   *
+   * In both modes, scores can be added by chunks, e.g. while reading a large
+   * score file.
+   */
+  class ScoreDistribution
+  {
+    public:
+      /**
+       * @brief Creates an empty distribution in exact mode
+       */
+      ScoreDistribution();
+
+      /**
+       * @brief Creates a distribution in exact mode from the given scores
+       */
+      ScoreDistribution(const blitz::Array<double,1>& negatives,
+        const blitz::Array<double,1>& positives);
+
+      /**
+       * @brief Creates an empty distribution in histogram mode, with n_bins
+       * bins of equal width covering [min, max)
+       */
+      ScoreDistribution(const size_t n_bins, const double min,
+        const double max);
+
+      /**
+       * @brief Adds scores to the distribution. In exact mode, each new
+       * chunk is sorted and merged with the scores already held.
+       */
+      void add(const blitz::Array<double,1>& negatives,
+        const blitz::Array<double,1>& positives);
+
+      /**
+       * @brief Tells if this distribution is held in histogram mode
+       */
+      bool isHistogram() const { return m_n_bins != 0; }
+
+      /**
+       * @brief The number of negative/positive scores
+       */
+      size_t getNNegatives() const { return m_n_negatives; }
+      size_t getNPositives() const { return m_n_positives; }
+
+      /**
+       * @brief The smallest and largest scores (of both sets) added so far
+       */
+      double getMin() const { return m_score_min; }
+      double getMax() const { return m_score_max; }
+
+      /**
+       * @brief The number of negatives/positives that are strictly lower
+       * than the given threshold
+       */
+      size_t negativesBelow(const double threshold) const;
+      size_t positivesBelow(const double threshold) const;
+
+      /**
+       * @brief The FAR and FRR at the given threshold, in this order. See
+       * bob::measure::farfrr().
+       */
+      std::pair<double, double> farfrr(const double threshold) const;
+
+      /**
+       * @brief Minimizes predicate(far, frr) w.r.t. the threshold. See
+       * bob::measure::minimizingThreshold() for the procedure.
+       */
+      template <typename T> double minimizingThreshold(T& predicate) const;
+
+      /**
+       * @brief See bob::measure::eerThreshold()
+       */
+      double eerThreshold() const;
+
+      /**
+       * @brief See bob::measure::minWeightedErrorRateThreshold()
+       */
+      double minWeightedErrorRateThreshold(const double cost) const;
+
+      /**
+       * @brief See bob::measure::minHterThreshold()
+       */
+      double minHterThreshold() const
+      { return minWeightedErrorRateThreshold(0.5); }
+
+      /**
+       * @brief See bob::measure::farThreshold(). In histogram mode, returns
+       * the lowest bin edge at which the FAR is not larger than far_value.
+       */
+      double farThreshold(const double far_value) const;
+
+      /**
+       * @brief See bob::measure::frrThreshold(). In histogram mode, returns
+       * the highest bin edge at which the FRR is not larger than frr_value.
+       */
+      double frrThreshold(const double frr_value) const;
+
+      /**
+       * @brief See bob::measure::roc(). The thresholds are visited in
+       * ascending order, each search starting where the previous one ended.
+       */
+      blitz::Array<double,2> roc(const size_t points) const;
+
+      /**
+       * @brief See bob::measure::det()
+       */
+      blitz::Array<double,2> det(const size_t points) const;
+
+      /**
+       * @brief See bob::measure::roc_for_far(). Exact mode only.
+       */
+      blitz::Array<double,2> roc_for_far(
+        const blitz::Array<double,1>& far_list) const;
+
+      /**
+       * @brief See bob::measure::rocch(). Exact mode only.
+       */
+      blitz::Array<double,2> rocch() const;
+
+      /**
+       * @brief See bob::measure::eerRocch(). Exact mode only.
+       */
+      double eerRocch() const;
+
+    private:
+      template <typename T>
+      double recursiveMinimization(T& predicate, double min, double max,
+        size_t steps) const;
+
+      void assertExact(const char* method) const;
+      size_t bin(const double threshold) const;
+
+      size_t m_n_negatives;
+      size_t m_n_positives;
+      double m_score_min;
+      double m_score_max;
+
+      // exact mode: the sorted scores
+      std::vector<double> m_negatives;
+      std::vector<double> m_positives;
+
+      // histogram mode: the number of scores in the bins lower than each
+      // bin edge (n_bins+1 values)
+      size_t m_n_bins;
+      double m_min;
+      double m_max;
+      std::vector<uint64_t> m_negatives_cum;
+      std::vector<uint64_t> m_positives_cum;
+  };
+
+  /**
+   * @brief See bob::measure::epc(). The development and test sets are only
+   * sorted (or binned) once for all the points of the curve.
+   */
+  blitz::Array<double,2> epc(const ScoreDistribution& dev,
+    const ScoreDistribution& test, const size_t points);
+
+  template <typename T>
+  double ScoreDistribution::recursiveMinimization(T& predicate, double min,
+      double max, size_t steps) const {
+    static const double QUIT_THRESHOLD = 1e-10;
+    const double diff = max - min;
+    const double too_small = std::abs(diff/max);
+
+    //if the difference between max and min is too small, we quit.
+    if ( too_small < QUIT_THRESHOLD ) return min; //or max, does not matter...
+
+    double step_size = diff/(double)steps;
+    double min_value = predicate(1.0, 0.0); ///< to the left of the range
+
+    //the accumulator holds the thresholds that given the minimum value for the
+    //input predicate.
+    std::vector<double> accumulator;
+    accumulator.reserve(steps);
+
+    for (size_t i=0; i<steps; ++i) {
+      double threshold = ((double)i * step_size) + min;
+
+      std::pair<double, double> ratios = farfrr(threshold);
+
+      double current_cost = predicate(ratios.first, ratios.second);
+
+      if (current_cost < min_value) {
+        min_value = current_cost;
+        accumulator.clear(); ///< clean-up, we got a better minimum
+        accumulator.push_back(threshold); ///< remember this threshold
+      }
+      else if (std::abs(current_cost - min_value) < 1e-16) {
+        //accumulate to later decide...
+        accumulator.push_back(threshold);
+      }
+    }
+
+    //we stop when it doesn't matter anymore to threshold.
+    if (accumulator.size() != steps) {
+      //still needs some refinement: pick-up the middle of the range and go
+      return recursiveMinimization(predicate,
+          accumulator[accumulator.size()/2]-step_size,
+          accumulator[accumulator.size()/2]+step_size,
+          steps);
+    }
+
+    return accumulator[accumulator.size()/2];
+  }
+
+  template <typename T>
+  double ScoreDistribution::minimizingThreshold(T& predicate) const {
+    const size_t N = 100; ///< number of steps in each iteration
+    return recursiveMinimization(predicate, m_score_min, m_score_max, N);
+  }
+
+}}
+
+#endif /* BOB_MEASURE_SCOREDISTRIBUTION_H */
@@ -25,6 +25,7 @@
 #define BOB_SP_DCT1D_H
 
 #include <blitz/array.h>
+#include "bob/sp/fftw.h"
 
 namespace bob {
   /**
@@ -117,6 +118,11 @@ namespace bob {
         double m_sqrt_2l;
         double m_sqrt_1byl;
         double m_sqrt_2byl;
+
+        /**
+          * FFTW plans, created on first use and reused afterwards
+          */
+        detail::FFTWPlanCache m_plans;
     };
 
 
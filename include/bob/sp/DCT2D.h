@@ -25,6 +25,7 @@
 #define BOB_SP_DCT2D_H
 
 #include <blitz/array.h>
+#include "bob/sp/fftw.h"
 
 namespace bob {
   /**
@@ -119,6 +120,11 @@ namespace bob {
         double m_sqrt_2h;
         double m_sqrt_1w;
         double m_sqrt_2w;
+
+        /**
+          * FFTW plans, created on first use and reused afterwards
+          */
+        detail::FFTWPlanCache m_plans;
     };
 
 
@@ -164,6 +170,18 @@ namespace bob {
           */
         virtual void operator()(const blitz::Array<double,2>& src, 
           blitz::Array<double,2>& dst);
+
+        /**
+          * @brief process a set of arrays by applying the direct DCT to each
+          * slice src(i,:,:), storing the result in dst(i,:,:). The slices
+          * are transformed in batches of fixed size by a single (cached)
+          * FFTW plan, which is much faster than processing them one by one
+          * for small sizes, and the remaining ones one at a time. The plans
+          * hence do not depend on the number of slices. src and dst may be
+          * the same array.
+          */
+        void operator()(const blitz::Array<double,3>& src, 
+          blitz::Array<double,3>& dst);
     };
 
 
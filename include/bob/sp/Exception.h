@@ -71,6 +71,17 @@ namespace bob { namespace sp {
       int m_max_dim;
   };
 
+  class FFTWWisdomError: public Exception {
+    public:
+      FFTWWisdomError(const std::string& source) throw();
+      virtual ~FFTWWisdomError() throw();
+      virtual const char* what() const throw();
+
+    private:
+      mutable std::string m_message;
+      std::string m_source;
+  };
+
 
 }}
 
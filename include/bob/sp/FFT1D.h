@@ -26,6 +26,7 @@
 
 #include <complex>
 #include <blitz/array.h>
+#include "bob/sp/fftw.h"
 
 namespace bob {
 /**
@@ -98,6 +99,11 @@ namespace bob {
           * Private attributes
           */
         size_t m_length;
+
+        /**
+          * FFTW plans, created on first use and reused afterwards
+          */
+        detail::FFTWPlanCache m_plans;
     };
 
 
@@ -26,6 +26,7 @@
 
 #include <complex>
 #include <blitz/array.h>
+#include "bob/sp/fftw.h"
 
 namespace bob {
 /**
@@ -107,6 +108,11 @@ namespace bob {
           */
         size_t m_height;
         size_t m_width;
+
+        /**
+          * FFTW plans, created on first use and reused afterwards
+          */
+        detail::FFTWPlanCache m_plans;
     };
 
 
@@ -0,0 +1,183 @@
+/**
+ * @file bob/sp/fftw.h
+ * @date Fri 16 Oct 2026 10:12:31 CEST
+ * @author agent <agent@local>
+ *
+ * @brief FFTW plan management: planning rigor, wisdom persistence and the
+ * per-object plan cache used by the FFT/DCT classes of bob::sp.
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_SP_FFTW_H
+#define BOB_SP_FFTW_H
+
+#include <string>
+#include <complex>
+#include <boost/scoped_ptr.hpp>
+
+namespace bob {
+/**
+ * \ingroup libsp_api
+ * @{
+ *
+ */
+  namespace sp {
+
+    namespace fftw {
+
+      /**
+        * @brief The effort FFTW spends when creating a plan. Anything but
+        * Estimate runs (and times) several candidate algorithms the first
+        * time a given transform size is used, which only pays off when the
+        * same size is processed many times, or when the resulting wisdom is
+        * saved and imported again later.
+        */
+      typedef enum PlanningRigor_ {
+        Estimate,
+        Measure,
+        Patient,
+        Exhaustive
+      } PlanningRigor;
+
+      /**
+        * @brief Sets the rigor used by all the FFT/DCT objects when they
+        * create new plans. Plans that were already created with another
+        * rigor are kept, but will not be reused for the new rigor.
+        */
+      void setPlanningRigor(const PlanningRigor rigor);
+
+      /**
+        * @brief Returns the rigor currently used to create new plans
+        */
+      PlanningRigor getPlanningRigor();
+
+      /**
+        * @brief Loads FFTW wisdom from the given file, merging it with the
+        * wisdom accumulated so far. Throws if the file cannot be read or
+        * does not contain valid wisdom.
+        */
+      void importWisdom(const std::string& filename);
+
+      /**
+        * @brief Merges the wisdom from the given string, as returned by
+        * exportWisdomToString(). Throws if the wisdom is invalid.
+        */
+      void importWisdomFromString(const std::string& wisdom);
+
+      /**
+        * @brief Saves the wisdom accumulated so far into the given file
+        */
+      void exportWisdom(const std::string& filename);
+
+      /**
+        * @brief Returns the wisdom accumulated so far as a string
+        */
+      std::string exportWisdomToString();
+
+      /**
+        * @brief Forgets all the wisdom accumulated so far. Plans already
+        * cached by existing objects are not affected.
+        */
+      void forgetWisdom();
+
+    }
+
+    namespace detail {
+
+      /**
+        * @brief A set of FFTW plans owned by a single transform object.
+        *
+        * Plans are created on first use for a given shape, memory alignment
+        * of the input/output buffers and planning rigor, and are then
+        * executed on the arrays of subsequent calls through the FFTW
+        * new-array execute interface. Plan creation and destruction are
+        * serialized with a global lock, as the FFTW planner is not
+        * thread-safe, and lookups with a per-cache one, so that a transform
+        * object can be used by several threads at once. Execution is
+        * lock-free.
+        */
+      class FFTWPlanCache
+      {
+        public:
+          /**
+            * @brief The real-to-real transforms used by the DCT classes
+            */
+          typedef enum R2RKind_ {
+            DCTII, // FFTW_REDFT10
+            DCTIII // FFTW_REDFT01
+          } R2RKind;
+
+          /**
+            * @brief Constructor: the cache is empty
+            */
+          FFTWPlanCache();
+
+          /**
+            * @brief Destructor: destroys all cached plans
+            */
+          ~FFTWPlanCache();
+
+          /**
+            * @brief Destroys all cached plans
+            */
+          void clear();
+
+          /**
+            * @brief Executes a complex-to-complex transform of the given
+            * rank (1 or 2) and dimensions. sign is -1 for a direct transform
+            * and +1 for an inverse one. src and dst may be identical.
+            */
+          void dft(const int rank, const int* n, std::complex<double>* src,
+            std::complex<double>* dst, const int sign);
+
+          /**
+            * @brief Executes a real-to-real transform of the given rank
+            * (1 or 2) and dimensions, using the same kind along all
+            * dimensions. src and dst may be identical.
+            */
+          void r2r(const int rank, const int* n, double* src, double* dst,
+            const R2RKind kind);
+
+          /**
+            * @brief Executes howmany real-to-real transforms of the given
+            * rank and dimensions at once (fftw_plan_many_r2r), the arrays
+            * being stored contiguously one after the other in src and dst.
+            * The plan depends on howmany, and is thus only reused for
+            * batches of the same size: callers should use a few fixed batch
+            * sizes, as the plans are kept until clear() is called. src and
+            * dst may be identical.
+            */
+          void r2r(const int rank, const int* n, const int howmany,
+            double* src, double* dst, const R2RKind kind);
+
+        private:
+          // plans are bound to their owner, copies start with an empty cache
+          FFTWPlanCache(const FFTWPlanCache& other);
+          FFTWPlanCache& operator=(const FFTWPlanCache& other);
+
+          struct Impl;
+          boost::scoped_ptr<Impl> m_impl;
+      };
+
+    }
+
+  }
+/**
+ * @}
+ */
+}
+
+#endif /* BOB_SP_FFTW_H */
@@ -0,0 +1,93 @@
+/**
+ * @file bob/sp/separable.h
+ * @date Fri 16 Oct 2026 19:02:51 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Separable 2D filters (convolution with a pair of 1D kernels and
+ * recursive Gaussian) with inline border extrapolation
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_SP_SEPARABLE_H
+#define BOB_SP_SEPARABLE_H
+
+#include "bob/sp/extrapolate.h"
+#include <blitz/array.h>
+
+namespace bob {
+  /**
+    * \ingroup libsp_api
+    * @{
+    *
+    */
+  namespace sp {
+
+    /**
+     * @brief Convolves a 2D array along its first dimension with kernel_y
+     * and along its second dimension with kernel_x. The output has the same
+     * size as the input (Conv::Same), the values of the input outside of its
+     * domain being extrapolated according to border_type (Constant is
+     * handled as Zero, as no value can be given).
+     *
+     * The result is the one of bob::sp::convSep() applied twice, with
+     * Conv::Same on the input for Extrapolation::Zero and with Conv::Valid on
+     * the extrapolated input otherwise, but the extrapolated values are
+     * looked up when needed instead of being copied into padded arrays, and
+     * the two passes are fused: each output row is computed from the input
+     * rows it depends on, through a single row buffer. The loops are unit
+     * stride (the column pass running on tiles of columns, to stay in
+     * cache), so that they can be vectorized by the compiler.
+     *
+     * src and dst may be the same array.
+     *
+     * @warning For Extrapolation::Zero, the input should be at least as
+     * large as the kernels (ConvolutionKernelTooLarge is thrown otherwise).
+     */
+    void convSep2D(const blitz::Array<double,2>& src,
+      const blitz::Array<double,1>& kernel_y,
+      const blitz::Array<double,1>& kernel_x, blitz::Array<double,2>& dst,
+      const Extrapolation::BorderType border_type = Extrapolation::Mirror);
+
+    /**
+     * @brief Smoothes a 2D array with a recursive (IIR) approximation of
+     * the Gaussian filter of standard deviations sigma_y and sigma_x, see
+     * I.T. Young and L.J. van Vliet, "Recursive implementation of the
+     * Gaussian filter", Signal Processing 44, 1995.
+     *
+     * Each dimension is processed by a causal and an anti-causal third
+     * order filter, which costs 8 multiplications per pixel and per
+     * dimension whatever the standard deviation. This makes it much faster
+     * than the convolution with a sampled Gaussian kernel for large standard
+     * deviations. The borders are extrapolated (over 4 standard deviations)
+     * according to border_type, Constant being handled as Zero.
+     *
+     * src and dst may be the same array.
+     *
+     * @warning The standard deviations should be larger than or equal to
+     * 0.5, the approximation being poor for smaller values
+     * (InvalidArgumentException is thrown otherwise).
+     */
+    void recursiveGaussian(const blitz::Array<double,2>& src,
+      const double sigma_y, const double sigma_x, blitz::Array<double,2>& dst,
+      const Extrapolation::BorderType border_type = Extrapolation::Mirror);
+
+  }
+  /**
+    * @}
+    */
+}
+
+#endif /* BOB_SP_SEPARABLE_H */
@@ -54,6 +54,7 @@ namespace bob { namespace trainer {
         m_compute_likelihood = other.m_compute_likelihood;
         m_convergence_threshold = other.m_convergence_threshold;
         m_max_iterations = other.m_max_iterations;
+        m_n_threads = other.m_n_threads;
       }
       return *this;
     }
@@ -207,10 +208,28 @@ namespace bob { namespace trainer {
       return m_max_iterations;
     }
 
+    /**
+      * Sets the number of threads used by the E-step of the trainers that
+      * support it (0 means one thread per hardware core). The data is split
+      * in contiguous shards, one per thread, and the partial statistics are
+      * merged in shard order.
+      */
+    void setNThreads(size_t n_threads) {
+      m_n_threads = n_threads;
+    }
+
+    /**
+      * Gets the number of threads used by the E-step
+      */
+    size_t getNThreads() const {
+      return m_n_threads;
+    }
+
   protected:
     bool m_compute_likelihood;
     double m_convergence_threshold;
     size_t m_max_iterations;
+    size_t m_n_threads;
 
     /**
       * Protected constructor to be called in the constructor of derived 
@@ -220,7 +239,8 @@ namespace bob { namespace trainer {
         size_t max_iterations = 10, bool compute_likelihood = true):
       m_compute_likelihood(compute_likelihood), 
       m_convergence_threshold(convergence_threshold), 
-      m_max_iterations(max_iterations) 
+      m_max_iterations(max_iterations),
+      m_n_threads(1)
     {
     }
   };
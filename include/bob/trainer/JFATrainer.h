@@ -423,6 +423,13 @@ class JFABaseTrainer: public JFABaseTrainerBase
       */
     void initializeVD_ISV(const double relevance_factor);
 
+    /**
+      * Sets/gets the number of threads used to process the identities in
+      * the updates of x, y, z, U, V and D (0 means one per hardware core)
+      */
+    void setNThreads(const size_t n_threads) { m_n_threads = n_threads; }
+    size_t getNThreads() const { return m_n_threads; }
+
   private:
     // Cache/Precomputation
     blitz::Array<double,2> m_cache_VtSigmaInv; // Vt * diag(sigma)^-1
@@ -454,6 +461,8 @@ class JFABaseTrainer: public JFABaseTrainerBase
     mutable blitz::Array<double,1> m_tmp_ru;
     mutable blitz::Array<double,1> m_tmp_CD;
     mutable blitz::Array<double,1> m_tmp_CD_b;
+
+    size_t m_n_threads;
 };
 
 
@@ -24,6 +24,7 @@
 #include "bob/machine/KMeansMachine.h"
 #include "bob/trainer/EMTrainer.h"
 #include <boost/version.hpp>
+#include <vector>
 
 namespace bob {
 namespace trainer {
@@ -51,6 +52,32 @@ class KMeansTrainer: public EMTrainer<bob::machine::KMeansMachine, blitz::Array<
     }   
     InitializationMethod;
 
+    /**
+     * @brief This enumeration defines how the E-step finds the closest
+     * mean of each sample:
+     * - BRUTE_FORCE computes the distances to all the means
+     * - GEMM computes the distances to all the means, for blocks of samples
+     *   at once with a matrix product (faster for many means, but the 
+     *   closest mean may differ for samples almost equidistant to two means)
+     * - HAMERLY keeps, for each sample, a lower bound of the distance to 
+     *   the second closest mean, and skips the distance computations 
+     *   whenever the triangle inequality shows that the closest mean did 
+     *   not change. It finds the same means as BRUTE_FORCE (up to rounding
+     *   errors), see 
+     *   G. Hamerly, "Making k-means even faster", SDM 2010.
+     *   The bounds are kept from one E-step to the next one, and assume
+     *   that the data did not change in between: initialization() and 
+     *   finalization() discard them, resetBounds() must be called before
+     *   an E-step on other data (or on data modified in place).
+     * The default is BRUTE_FORCE.
+     */
+    typedef enum {
+      BRUTE_FORCE=0,
+      GEMM,
+      HAMERLY
+    }
+    AssignmentMethod;
+
     /**
      * @brief Constructor
      */
@@ -142,6 +169,24 @@ class KMeansTrainer: public EMTrainer<bob::machine::KMeansMachine, blitz::Array<
      * @brief Gets the initialization method used to generate the initial means
      */
     InitializationMethod getInitializationMethod() const { return m_initialization_method; }
+
+    /**
+     * @brief Sets the method used by the E-step to find the closest means
+     */
+    void setAssignmentMethod(AssignmentMethod v) { m_assignment_method = v; }
+
+    /**
+     * @brief Gets the method used by the E-step to find the closest means
+     */
+    AssignmentMethod getAssignmentMethod() const { return m_assignment_method; }
+
+    /**
+     * @brief Discards the bounds of the HAMERLY assignment method, which 
+     * are computed again by the next E-step. To be called whenever the 
+     * data given to the E-step change outside of initialization() and 
+     * finalization().
+     */
+    void resetBounds();
   
     /**
      * @brief Returns the internal statistics. Useful to parallelize the E-step
@@ -165,6 +210,11 @@ class KMeansTrainer: public EMTrainer<bob::machine::KMeansMachine, blitz::Array<
      */
     InitializationMethod m_initialization_method;
 
+    /**
+     * @brief The method used by the E-step to find the closest means
+     */
+    AssignmentMethod m_assignment_method;
+
     /**
      * @brief Seed used to generate pseudo-random numbers
      */
@@ -188,6 +238,18 @@ class KMeansTrainer: public EMTrainer<bob::machine::KMeansMachine, blitz::Array<
      * equation 9.4, Bishop, "Pattern recognition and machine learning", 2006
      */
     blitz::Array<double,2> m_firstOrderStats;
+
+  private:
+    /**
+     * @brief State of the HAMERLY assignment method, kept from one E-step
+     * to the next one until resetBounds() is called: the closest mean of 
+     * each sample, a lower bound of the distance to its second closest 
+     * mean, and the means the bounds refer to.
+     */
+    bool m_bounds_valid;
+    std::vector<size_t> m_closest_means;
+    blitz::Array<double,1> m_lower_bounds;
+    blitz::Array<double,2> m_bounds_means;
 };
 
 }
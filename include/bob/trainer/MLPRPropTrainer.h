@@ -191,8 +191,7 @@ namespace bob { namespace trainer {
       std::vector<blitz::Array<double,2> > m_prev_deriv; ///< prev.weight deriv.
       std::vector<blitz::Array<double,1> > m_prev_deriv_bias; ///< pr.bias der.
   
-      bob::machine::MLP::actfun_t m_actfun; ///< activation function
-      bob::machine::MLP::actfun_t m_bwdfun; ///< (back) activation function
+      bob::machine::Activation m_activation; ///< activation function
   
       /// buffers that are dependent on the batch_size
       blitz::Array<double,2> m_target; ///< target vectors
@@ -0,0 +1,146 @@
+/**
+ * @file bob/trainer/MiniBatchKMeansTrainer.h
+ * @date Fri 16 Oct 2026 13:21:40 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Mini-batch K-Means, for datasets that are too large to be
+ * processed at once.
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BOB_TRAINER_MINIBATCHKMEANSTRAINER_H
+#define BOB_TRAINER_MINIBATCHKMEANSTRAINER_H
+
+#include "bob/machine/KMeansMachine.h"
+#include "bob/trainer/Trainer.h"
+#include <vector>
+
+namespace bob {
+namespace trainer {
+
+/**
+ * @brief This class implements the mini-batch variant of k-means.
+ * @details See D. Sculley, "Web-scale k-means clustering", WWW 2010.
+ * Each mean is moved towards the samples of a batch it is the closest to,
+ * with a learning rate that is the inverse of the number of samples
+ * assigned to it so far. The means of the machine must have been
+ * initialized beforehand (e.g. with the initialization() of a
+ * KMeansTrainer on a subset of the data).
+ *
+ * Batches can either be given one at a time to update(), for instance
+ * while reading a large dataset from disk, or be drawn randomly from an
+ * array by train().
+ */
+class MiniBatchKMeansTrainer: public Trainer<bob::machine::KMeansMachine, blitz::Array<double,2> >
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param batch_size The number of samples of each batch drawn by train()
+     * @param max_iterations The number of batches processed by train()
+     */
+    MiniBatchKMeansTrainer(size_t batch_size=1000, size_t max_iterations=100);
+
+    /**
+     * @brief Copy constructor
+     */
+    MiniBatchKMeansTrainer(const MiniBatchKMeansTrainer& other);
+
+    /**
+     * @brief Virtualize destructor
+     */
+    virtual ~MiniBatchKMeansTrainer() {}
+
+    /**
+     * @brief Assigns from a different trainer
+     */
+    MiniBatchKMeansTrainer& operator=(const MiniBatchKMeansTrainer& other);
+
+    /**
+     * @brief Equal to
+     */
+    bool operator==(const MiniBatchKMeansTrainer& b) const;
+
+    /**
+     * @brief Not equal to
+     */
+    bool operator!=(const MiniBatchKMeansTrainer& b) const;
+
+    /**
+     * @brief Processes max_iterations batches of batch_size samples, drawn
+     * uniformly (with replacement) from the given data. The per-mean
+     * sample counts are reset first.
+     */
+    virtual void train(bob::machine::KMeansMachine& kmeans,
+      const blitz::Array<double,2>& data);
+
+    /**
+     * @brief Updates the means with a batch of samples (one per row). The
+     * per-mean sample counts are kept from one call to the next one, until
+     * reset() is called (or the number of means changes).
+     */
+    void update(bob::machine::KMeansMachine& kmeans,
+      const blitz::Array<double,2>& batch);
+
+    /**
+     * @brief Resets the per-mean sample counts
+     */
+    void reset();
+
+    /**
+     * @brief Returns the number of samples assigned to each mean so far
+     */
+    const blitz::Array<double,1>& getCounts() const { return m_counts; }
+
+    /**
+     * @brief Sets/gets the number of samples of each batch
+     */
+    void setBatchSize(size_t v) { m_batch_size = v; }
+    size_t getBatchSize() const { return m_batch_size; }
+
+    /**
+     * @brief Sets/gets the number of batches processed by train()
+     */
+    void setMaxIterations(size_t v) { m_max_iterations = v; }
+    size_t getMaxIterations() const { return m_max_iterations; }
+
+    /**
+     * @brief Sets/gets the seed used to draw the batches (-1 for the
+     * default seed of the generator)
+     */
+    void setSeed(int seed) { m_seed = seed; }
+    int getSeed() const { return m_seed; }
+
+  private:
+    size_t m_batch_size;
+    size_t m_max_iterations;
+    int m_seed;
+
+    /**
+     * @brief Number of samples assigned to each mean so far
+     */
+    blitz::Array<double,1> m_counts;
+
+    /**
+     * @brief Cache to avoid re-allocation
+     */
+    blitz::Array<double,2> m_cache_distances;
+    std::vector<size_t> m_cache_closest_means;
+};
+
+}
+}
+
+#endif // BOB_TRAINER_MINIBATCHKMEANSTRAINER_H
@@ -38,6 +38,9 @@ namespace bob { namespace visioner {
     return std::make_pair(score, std::make_pair(reg, ilabel));
   }
 
+  // Copies of the model used by the scanning threads
+  class ScanModels;
+
   /////////////////////////////////////////////////////////////////////////////////////////
   // Object detector that processes a pyramid of images:
   //	::scan()	-> return the object detections (thresholded & clustered)
@@ -93,7 +96,8 @@ namespace bob { namespace visioner {
       // Load an image (build the image pyramid)
       bool load(const std::string& ifile, const std::string& gfile);
       bool load(const ipscale_t& ipscale);
-      bool load(const uint8_t* image, uint64_t rows, uint64_t cols);
+      bool load(const uint8_t* image, uint64_t rows, uint64_t cols, 
+          uint64_t stride = 0);
 
       // Detect objects
       // NB: The detections are thresholded and clustered!
@@ -162,6 +166,22 @@ namespace bob { namespace visioner {
 
     private:
 
+      // Band of sub-windows scanned by a thread: [min_x, max_x) at the scale
+      //  <is> for the output <o>
+      struct scan_band_t
+      {
+        uint64_t        m_scale;
+        uint64_t        m_output;
+        int             m_min_x;
+        int             m_max_x;
+      };
+
+      // Scan the sub-windows of the bands in the given range
+      void scan_bands(const std::vector<scan_band_t>& bands, uint64_t generation,
+          std::vector<std::vector<detection_t> >& detections,
+          std::vector<stats_t>& stats,
+          const std::pair<uint64_t, uint64_t>& range) const;
+
       static void threshold(std::vector<detection_t>& detections, double thres);
       static void cluster(std::vector<detection_t>& detections, double thres, uint64_t n_outputs);                 
 
@@ -186,6 +206,7 @@ namespace bob { namespace visioner {
       uint64_t			m_levels;	       ///< number of levels (speed-up scanning)
       ipyramid_t  m_ipyramid;	     ///< Pyramid of images
       mutable stats_t m_stats;     ///< Scanning statistics
+      boost::shared_ptr<ScanModels> m_scan_models; ///< Per-thread models
 
   };
 
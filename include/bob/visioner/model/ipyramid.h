@@ -97,7 +97,13 @@ namespace bob { namespace visioner {
       // Load scaled versions of an image and its ground truth	
       bool load(const std::string& ifile, const std::string& gfile);		
       bool load(const ipscale_t& ipscale);
-      bool load(const uint8_t* image, uint64_t rows, uint64_t cols);
+      // NB: <stride> is the number of pixels between the beginning of two
+      //  consecutive rows (0 for contiguous rows). The rows are copied once
+      //  into the top level of the pyramid (whose buffer is reused from one
+      //  image to the next), so callers do not need to make the image
+      //  contiguous first.
+      bool load(const uint8_t* image, uint64_t rows, uint64_t cols, 
+          uint64_t stride = 0);
 
       // Map regions (at the original scale) to sub-windows
       subwindow_t map(const QRectF& reg, const param_t& param) const;
@@ -120,6 +126,10 @@ namespace bob { namespace visioner {
 
     private:
 
+      // Build the scaled versions of the top image (the scales are relative
+      //  to the top image and in decreasing order)
+      void build(const std::vector<double>& scales);
+
       // Project a sub-window to another scale
       subwindow_t map(const subwindow_t& sw, int s, const param_t& param) const;
 
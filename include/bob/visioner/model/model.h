@@ -72,8 +72,10 @@ namespace bob { namespace visioner {
       virtual void preprocess(const ipscale_t& ipscale) = 0;
 
       // Compute the model score at the (x, y) position for the output <o>
+      // NB: The feature pools can override the second one to avoid calling
+      //  ::get() for each LUT.
       double score(uint64_t o, int x, int y) const;
-      double score(uint64_t o, uint64_t rbegin, uint64_t rend, int x, int y) const;
+      virtual double score(uint64_t o, uint64_t rbegin, uint64_t rend, int x, int y) const;
 
       // Compute the value of the feature <f> at the (x, y) position
       virtual uint64_t get(uint64_t f, int x, int y) const = 0;
@@ -80,6 +80,22 @@ namespace bob { namespace visioner {
         return TLBPOp(m_iimage, x + mb.m_dx, y + mb.m_dy, mb.m_cx, mb.m_cy);
       }
 
+      // Compute the model score at the (x, y) position for the output <o>
+      //  (the LBP operator is inlined in the LUT evaluation)
+      using IIModel::score;
+      virtual double score(uint64_t o, uint64_t rbegin, uint64_t rend, int x, int y) const
+      {
+        const std::vector<LUT>& oluts = luts()[o];
+        double sum = 0.0;
+        for (uint64_t r = rbegin; r < rend; r ++)
+        {
+          const LUT& lut = oluts[r];
+          const mb_t& mb = m_mbs[lut.feature()];
+          sum += lut[TLBPOp(m_iimage, x + mb.m_dx, y + mb.m_dy, mb.m_cx, mb.m_cy)];
+        }
+        return sum;
+      }
+
       // Access functions
       virtual uint64_t n_features() const { return m_mbs.size(); }
       virtual uint64_t n_fvalues() const { return NFeatureValues; }
@@ -26,10 +26,15 @@
 #define BOB_VISIONER_UTIL_THREADS_H
 
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <stdint.h>
 
 #include <boost/thread.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/lambda/bind.hpp>
-#include <boost/shared_array.hpp>
 
 namespace bob { namespace visioner {
 
@@ -37,98 +42,194 @@ namespace bob { namespace visioner {
   void thread_split(uint64_t n_objects, std::vector<uint64_t>& sbegins, 
       std::vector<uint64_t>& sends, size_t num_of_threads);
 
-  // Split a loop computation of the given size using multiple threads
+  /**
+   * Process-wide pool of worker threads used by all the multi-threaded
+   * visioner code (boosting, sampling and scanning).
+   *
+   * The threads are created once (the first time some work is submitted)
+   * and kept alive between calls, so that the inner iterations of the
+   * training algorithms do not pay for the creation of new threads. A job
+   * is a set of independent tasks, which are grabbed one at a time by the
+   * idle workers (and by the submitting thread itself), so that unbalanced
+   * tasks are spread dynamically. Jobs submitted from within a task are run
+   * inline by the calling thread.
+   *
+   * The pool processes a single job at a time: concurrent callers of run()
+   * are serialized, each waiting for the jobs submitted before its own to
+   * complete. Independent computations that must overlap (e.g. detections
+   * running in several threads of an application) do not benefit from the
+   * pool and should rather use as many threads as possible each.
+   */
+  class ThreadPool: private boost::noncopyable {
+
+    public:
+
+      // Returns the pool shared by the process
+      static ThreadPool& instance();
+
+      // Sets the number of threads processing each job, including the
+      // submitting thread (0 means one per hardware core)
+      void set_n_threads(size_t n_threads);
+      size_t n_threads() const;
+
+      // Pins each worker thread to a core (only supported on Linux)
+      void set_pinning(bool pinning);
+      bool pinning() const;
+
+      // Calls task(i) for all i in [0, n_tasks) and returns once all the
+      // tasks are done, using at most max_threads threads (including the
+      // calling one, 0 means all the threads of the pool). If some tasks 
+      // throw, the error of the first one is re-thrown as a 
+      // std::runtime_error. Blocks while a job submitted by another thread
+      // is running.
+      void run(uint64_t n_tasks, const boost::function<void (uint64_t)>& task,
+          size_t max_threads = 0);
+
+    private:
+
+      ThreadPool();
+      ~ThreadPool();
+
+      void start();
+      void stop();
+      void work();
+      void execute();
+
+      // Attributes
+      mutable boost::mutex                      m_submit_mutex; // one job at a time (serializes the callers of run())
+      mutable boost::mutex                      m_mutex;        // job state
+      boost::condition_variable                 m_work_cond;
+      boost::condition_variable                 m_done_cond;
+      std::vector<boost::shared_ptr<boost::thread> > m_workers;
+      size_t                                    m_n_threads;
+      bool                                      m_pinning;
+      bool                                      m_stop;
+
+      const boost::function<void (uint64_t)>*   m_task;
+      uint64_t                                  m_n_tasks;
+      uint64_t                                  m_next_task;
+      uint64_t                                  m_pending_tasks;
+      size_t                                    m_max_threads;    // threads allowed on the current job
+      size_t                                    m_active_threads; // threads that joined the current job and did not leave it yet
+      uint64_t                                  m_error_task;
+      std::string                               m_error;
+  };
+
+  namespace detail {
+
+    // Number of tasks per thread for the jobs that can be split arbitrarily
+    static const uint64_t tasks_per_thread = 4;
+
+    template <typename TOp> struct loop_task {
+      const TOp& op;
+      const std::vector<uint64_t>& begins;
+      const std::vector<uint64_t>& ends;
+      void operator()(uint64_t ith) const {
+        std::pair<uint64_t, uint64_t> range(begins[ith], ends[ith]);
+        op(range);
+      }
+    };
+
+    template <typename TOp> struct iloop_task {
+      const TOp& op;
+      const std::vector<uint64_t>& begins;
+      const std::vector<uint64_t>& ends;
+      void operator()(uint64_t ith) const {
+        std::pair<uint64_t, uint64_t> range(begins[ith], ends[ith]);
+        op(ith, range);
+      }
+    };
+
+    template <typename TOp, typename TResult> struct loop_result_task {
+      const TOp& op;
+      const std::vector<uint64_t>& begins;
+      const std::vector<uint64_t>& ends;
+      std::vector<TResult>& results;
+      void operator()(uint64_t ith) const {
+        std::pair<uint64_t, uint64_t> range(begins[ith], ends[ith]);
+        op(range, results[ith]);
+      }
+    };
+
+    template <typename TOp, typename TResult> struct iloop_result_task {
+      const TOp& op;
+      const std::vector<uint64_t>& begins;
+      const std::vector<uint64_t>& ends;
+      std::vector<TResult>& results;
+      void operator()(uint64_t ith) const {
+        std::pair<uint64_t, uint64_t> range(begins[ith], ends[ith]);
+        op(ith, range, results[ith]);
+      }
+    };
+
+  }
+
+  // Split a loop computation of the given size using the thread pool
   // NB: Stateless threads: op(<begin, end>)
+  // NB: At most <num_of_threads> threads of the pool process the loop, 
+  //  which is split in more chunks than threads to balance the load.
   template <typename TOp> void thread_loop(TOp op, uint64_t size,
       size_t num_of_threads=boost::thread::hardware_concurrency()) {
-    
-    boost::shared_array<boost::thread> threads(new boost::thread[num_of_threads]);
-    std::vector<uint64_t> th_begins; th_begins.reserve(num_of_threads);
-    std::vector<uint64_t> th_ends; th_ends.reserve(num_of_threads);
-
-    thread_split(size, th_begins, th_ends, num_of_threads);		
 
-    for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
-      std::pair<uint64_t, uint64_t> range(th_begins[ith], th_ends[ith]);
-      boost::thread t(boost::bind(op, range));
-      threads[ith] = boost::move(t);
-    }
+    ThreadPool& pool = ThreadPool::instance();
+    const uint64_t n_threads = std::max<uint64_t>(1,
+        std::min<uint64_t>(num_of_threads, pool.n_threads()));
+    const uint64_t n_chunks = std::max<uint64_t>(1, 
+        std::min<uint64_t>(size, n_threads * detail::tasks_per_thread));
 
-    for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
-      threads[ith].join();
-    }
+    std::vector<uint64_t> th_begins; th_begins.reserve(n_chunks);
+    std::vector<uint64_t> th_ends; th_ends.reserve(n_chunks);
+    thread_split(size, th_begins, th_ends, n_chunks);
 
+    const detail::loop_task<TOp> task = {op, th_begins, th_ends};
+    pool.run(n_chunks, task, n_threads);
   }
 
-  // Split a loop computation of the given size using multiple threads
+  // Split a loop computation of the given size using the thread pool
   // NB: Stateless threads: op(thread_index, <begin, end>)
+  // NB: The loop is split in <num_of_threads> chunks, each processed
+  //  (with its own index) by one of the threads of the pool.
   template <typename TOp> void thread_iloop(TOp op, uint64_t size,
       size_t num_of_threads=boost::thread::hardware_concurrency()) {
 
-    boost::shared_array<boost::thread> threads(new boost::thread[num_of_threads]);
     std::vector<uint64_t> th_begins; th_begins.reserve(num_of_threads);
     std::vector<uint64_t> th_ends; th_ends.reserve(num_of_threads);
+    thread_split(size, th_begins, th_ends, num_of_threads);
 
-    thread_split(size, th_begins, th_ends, num_of_threads);		
-
-    for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
-      std::pair<uint64_t, uint64_t> range(th_begins[ith], th_ends[ith]);
-      boost::thread t(boost::bind(op, ith, range));
-      threads[ith] = boost::move(t);
-    }
-
-    for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
-      threads[ith].join();
-    }
-
+    const detail::iloop_task<TOp> task = {op, th_begins, th_ends};
+    ThreadPool::instance().run(num_of_threads, task);
   }
 
-  // Split a loop computation of the given size using multiple threads
+  // Split a loop computation of the given size using the thread pool
   // NB: State threads: op(<begin, end>, result&)
+  // NB: The loop is split in <num_of_threads> chunks, each with its result.
   template <typename TOp, typename TResult> void thread_loop(TOp op, uint64_t size, std::vector<TResult>& results, size_t num_of_threads=boost::thread::hardware_concurrency()) {
 
-    boost::shared_array<boost::thread> threads(new boost::thread[num_of_threads]);
     std::vector<uint64_t> th_begins; th_begins.reserve(num_of_threads);
     std::vector<uint64_t> th_ends; th_ends.reserve(num_of_threads);
-
-    thread_split(size, th_begins, th_ends, num_of_threads);		
+    thread_split(size, th_begins, th_ends, num_of_threads);
 
     results.resize(num_of_threads);
 
-    for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
-      std::pair<uint64_t, uint64_t> range(th_begins[ith], th_ends[ith]);
-      boost::thread t(boost::bind(op, range, boost::ref(results[ith])));
-      threads[ith] = boost::move(t);
-    }
-
-    for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
-      threads[ith].join();
-    }
-
+    const detail::loop_result_task<TOp, TResult> task = 
+      {op, th_begins, th_ends, results};
+    ThreadPool::instance().run(num_of_threads, task);
   }
 
-  // Split a loop computation of the given size using multiple threads
+  // Split a loop computation of the given size using the thread pool
   // NB: State threads: op(thread_index, <begin, end>, result&)
+  // NB: The loop is split in <num_of_threads> chunks, each with its result.
   template <typename TOp, typename TResult> void thread_iloop(TOp op, uint64_t size, std::vector<TResult>& results, size_t num_of_threads=boost::thread::hardware_concurrency()) {
 
-    boost::shared_array<boost::thread> threads(new boost::thread[num_of_threads]);
     std::vector<uint64_t> th_begins; th_begins.reserve(num_of_threads);
     std::vector<uint64_t> th_ends; th_ends.reserve(num_of_threads);
-
-    thread_split(size, th_begins, th_ends, num_of_threads);		
+    thread_split(size, th_begins, th_ends, num_of_threads);
 
     results.resize(num_of_threads);
 
-    for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
-      std::pair<uint64_t, uint64_t> range(th_begins[ith], th_ends[ith]);
-      boost::thread t(boost::bind(op, ith, range, boost::ref(results[ith])));
-      threads[ith] = boost::move(t);
-    }
-
-    for (uint64_t ith = 0; ith < num_of_threads; ith ++) {
-      threads[ith].join();
-    }
-
+    const detail::iloop_result_task<TOp, TResult> task = 
+      {op, th_begins, th_ends, results};
+    ThreadPool::instance().run(num_of_threads, task);
   }
 
 }}
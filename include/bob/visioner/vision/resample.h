@@ -0,0 +1,61 @@
+/**
+ * @file bob/visioner/vision/resample.h
+ * @date Fri 16 Oct 2026 14:02:11 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Native downscaling of grayscale images, used to build the image
+ * pyramids without going through Qt.
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_VISIONER_RESAMPLE_H
+#define BOB_VISIONER_RESAMPLE_H
+
+#include <stdint.h>
+
+#include "bob/visioner/util/matrix.h"
+
+namespace bob { namespace visioner {
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+  // Downscale a grayscale image to <dst_rows> x <dst_cols> pixels using
+  //	area averaging (each destination pixel is the mean of the source
+  //	pixels it covers). The filter is separable and computed in fixed
+  //	point: rows first, then columns (in contiguous, vectorizable loops).
+  //
+  // The source has <rows> x <cols> pixels with <stride> pixels between the
+  //	beginning of two consecutive rows, so that the caller's buffer can be
+  //	used directly. The destination cannot be larger than the source.
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  void downscale(const uint8_t* src, uint64_t rows, uint64_t cols, uint64_t stride,
+      uint64_t dst_rows, uint64_t dst_cols, Matrix<uint8_t>& dst);
+
+  void downscale(const Matrix<uint8_t>& src, uint64_t dst_rows, uint64_t dst_cols,
+      Matrix<uint8_t>& dst);
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+  // Compute the size of a <rows> x <cols> image scaled by <scale>, keeping
+  //	its aspect ratio (as Qt::KeepAspectRatio): the largest size that fits
+  //	in the rounded scaled sizes. Returns false if the image would be empty.
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  bool scaled_size(uint64_t rows, uint64_t cols, double scale,
+      uint64_t& new_rows, uint64_t& new_cols);
+
+}}
+
+#endif // BOB_VISIONER_RESAMPLE_H
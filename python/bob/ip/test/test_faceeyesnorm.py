@@ -0,0 +1,71 @@
+#!/usr/bin/env python
+# vim: set fileencoding=utf-8 :
+# agent <agent@local>
+# Fri 16 Oct 2026 23:12:40 CEST
+#
+# Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, version 3 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Test the extraction of several faces of the same image
+"""
+
+import unittest
+import bob
+import numpy
+
+# image and eye positions (re_y, re_x, le_y, le_x), one face per row
+IMAGE = numpy.array([[(y * 7 + x * 13 + (x * y) % 23) % 256
+  for x in range(120)] for y in range(100)], numpy.uint8)
+EYES = numpy.array([
+  [40., 35., 40., 75.],
+  [45., 30., 38., 80.],
+  [30., 50., 32., 70.],
+  [60., 20., 55., 90.],
+  [50., 40., 50., 62.],
+  ], numpy.float64)
+
+class FaceEyesNormTest(unittest.TestCase):
+  """Performs various tests for the FaceEyesNorm batch extraction."""
+
+  def test01_batch_float64(self):
+    norm = bob.ip.FaceEyesNorm(20, 40, 32, 15, 16)
+    faces = numpy.zeros((len(EYES), 40, 32), numpy.float64)
+    for n_threads in (1, 2, 0):
+      norm(IMAGE, EYES, faces, n_threads)
+      for i in range(len(EYES)):
+        face = norm(IMAGE, *EYES[i])
+        self.assertTrue( (faces[i] == face).all() )
+
+  def test02_batch_uint8(self):
+    norm = bob.ip.FaceEyesNorm(20, 40, 32, 15, 16)
+    faces = numpy.zeros((len(EYES), 40, 32), numpy.uint8)
+    norm(IMAGE, EYES, faces, n_threads=3)
+    face = numpy.zeros((40, 32), numpy.uint8)
+    for i in range(len(EYES)):
+      norm(IMAGE, face, *EYES[i])
+      self.assertTrue( (faces[i] == face).all() )
+
+  def test03_batch_default_threads(self):
+    norm = bob.ip.FaceEyesNorm(20, 40, 32, 15, 16)
+    faces = numpy.zeros((len(EYES), 40, 32), numpy.float32)
+    norm(IMAGE, EYES, faces)
+    face = numpy.zeros((40, 32), numpy.float32)
+    for i in range(len(EYES)):
+      norm(IMAGE, face, *EYES[i])
+      self.assertTrue( (faces[i] == face).all() )
+
+  def test04_batch_bad_shape(self):
+    norm = bob.ip.FaceEyesNorm(20, 40, 32, 15, 16)
+    faces = numpy.zeros((len(EYES) + 1, 40, 32), numpy.float64)
+    self.assertRaises(RuntimeError, norm, IMAGE, EYES, faces)
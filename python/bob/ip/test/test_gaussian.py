@@ -94,3 +94,17 @@ class GaussianTest(unittest.TestCase):
     self.assertEqual(op1 != op4, True)
     self.assertEqual(op1 != op5, True)
     self.assertEqual(op1 != op6, True)
+
+  def test04_recursive(self):
+    # Recursive approximation, for large standard deviations
+    op = bob.ip.Gaussian(24,24,6.,6.)
+    self.assertEqual(op.recursive, False)
+    op_r = bob.ip.Gaussian(op)
+    op_r.recursive = True
+    self.assertEqual(op_r.recursive, True)
+    self.assertEqual(op == op_r, False)
+    y, x = numpy.mgrid[0:64,0:64]
+    a = 100. * numpy.sin(0.2*y) * numpy.cos(0.15*x)
+    a_ref = op(a)
+    a_out = op_r(a)
+    self.assertTrue(numpy.abs(a_out - a_ref).max() < 5.)
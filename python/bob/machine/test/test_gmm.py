@@ -219,3 +219,30 @@ class GMMMachineTest(unittest.TestCase):
     # implementation
     matlab_ll_ref = -2.361583051672024e+02
     self.assertTrue( abs(gmm(data) - matlab_ll_ref) < 1e-10)
+
+  def test05_GMMMachine(self):
+    """Test a GMMMachine (block computations over 2D inputs)"""
+
+    arrayset = bob.io.load(F("faithful.torch3_f64.hdf5"))
+    gmm = bob.machine.GMMMachine(2, 2)
+    gmm.weights   = numpy.array([0.4, 0.6], 'float64')
+    gmm.means     = numpy.array([[3, 70], [4, 72]], 'float64')
+    gmm.variances = numpy.array([[1, 10], [2, 5]], 'float64')
+
+    # Log-likelihoods of all samples at once vs. one sample at a time
+    ll = gmm.log_likelihood(arrayset)
+    self.assertEqual(ll.shape, (arrayset.shape[0],))
+    for i in range(arrayset.shape[0]):
+      self.assertTrue( abs(ll[i] - gmm.log_likelihood(arrayset[i,:])) < 1e-10 )
+
+    # Statistics accumulated over all samples vs. one sample at a time
+    stats = bob.machine.GMMStats(2, 2)
+    gmm.acc_statistics(arrayset, stats)
+    stats_ref = bob.machine.GMMStats(2, 2)
+    for i in range(arrayset.shape[0]):
+      gmm.acc_statistics(arrayset[i,:], stats_ref)
+    self.assertTrue( stats.t == stats_ref.t )
+    self.assertTrue( abs(stats.log_likelihood - stats_ref.log_likelihood) < 1e-8 )
+    self.assertTrue( numpy.allclose(stats.n, stats_ref.n, atol=1e-10) )
+    self.assertTrue( numpy.allclose(stats.sum_px, stats_ref.sum_px, atol=1e-10) )
+    self.assertTrue( numpy.allclose(stats.sum_pxx, stats_ref.sum_pxx, atol=1e-10) )
@@ -210,3 +210,57 @@ class JFAMachineTest(unittest.TestCase):
 
     # Clean-up
     os.unlink(filename)
+
+  def test04_JFAScorer(self):
+
+    # Creates a UBM
+    weights = numpy.array([0.4, 0.6], 'float64')
+    means = numpy.array([[1, 6, 2], [4, 3, 2]], 'float64')
+    variances = numpy.array([[1, 2, 1], [2, 1, 2]], 'float64')
+    ubm = bob.machine.GMMMachine(2,3)
+    ubm.weights = weights
+    ubm.means = means
+    ubm.variances = variances
+
+    # Creates a JFABaseMachine
+    U = numpy.array([[1, 2], [3, 4], [5, 6], [7, 8], [9, 10], [11, 12]], 'float64')
+    V = numpy.array([[6, 5], [4, 3], [2, 1], [1, 2], [3, 4], [5, 6]], 'float64')
+    d = numpy.array([0, 1, 0, 1, 0, 1], 'float64')
+    base = bob.machine.JFABaseMachine(ubm,2,2)
+    base.u = U
+    base.v = V
+    base.d = d
+
+    # Creates several JFAMachines
+    models = []
+    for i in range(5):
+      m = bob.machine.JFAMachine(base)
+      m.y = numpy.random.randn(2)
+      m.z = numpy.random.randn(6)
+      models.append(m)
+
+    # Defines several GMMStats
+    stats = []
+    for i in range(7):
+      gs = bob.machine.GMMStats(2,3)
+      gs.n = numpy.random.rand(2) + 0.1
+      gs.t = 1
+      gs.sum_px = numpy.random.randn(2,3) + means
+      stats.append(gs)
+
+    # Compares with the scores of the machines, with one or several threads
+    eps = 1e-10
+    ref = numpy.array([[m.forward(gs) for gs in stats] for m in models])
+    for n_threads in (1, 3):
+      s = bob.machine.JFAScorer(base, stats, n_threads)
+      self.assertEqual(s.n_probes, len(stats))
+      for k, gs in enumerate(stats):
+        Ux = numpy.ndarray(shape=(models[0].dim_cd,), dtype=numpy.float64)
+        models[0].estimate_ux(gs, Ux)
+        self.assertTrue( numpy.allclose(s.ux[k], Ux, eps) )
+      scores = s(models)
+      self.assertEqual(scores.shape, (len(models), len(stats)))
+      self.assertTrue( numpy.allclose(scores, ref, eps) )
+      out = numpy.ndarray((len(models), len(stats)), 'float64')
+      s.score(models, out)
+      self.assertTrue( numpy.allclose(out, ref, eps) )
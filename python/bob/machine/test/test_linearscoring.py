@@ -105,3 +105,24 @@ class LinearScoringTest(unittest.TestCase):
     # 2/d/ With test_channelOffset, with frame-length normalisation
     scores = bob.machine.linear_scoring([model1.mean_supervector, model2.mean_supervector], ubm.mean_supervector, ubm.variance_supervector, [stats1, stats2, stats3], test_channeloffset, True)
     self.assertTrue((abs(scores - ref_scores_11) < 1e-7).all())
+
+    # 3/ Use the precomputed normalised models
+    models = bob.machine.linear_scoring_models([model1, model2], ubm)
+    models_sv = bob.machine.linear_scoring_models([model1.mean_supervector, model2.mean_supervector], ubm.mean_supervector, ubm.variance_supervector)
+    self.assertTrue((abs(models - models_sv) < 1e-10).all())
+
+    # 3/a/ Without test_channelOffset, without frame-length normalisation
+    scores = bob.machine.linear_scoring(models, ubm.mean_supervector, [stats1, stats2, stats3])
+    self.assertTrue((abs(scores - ref_scores_00) < 1e-7).all())
+
+    # 3/b/ With test_channelOffset, with frame-length normalisation
+    scores = bob.machine.linear_scoring(models, ubm.mean_supervector, [stats1, stats2, stats3], test_channeloffset, True)
+    self.assertTrue((abs(scores - ref_scores_11) < 1e-7).all())
+
+    # 4/ Several threads
+    scores = bob.machine.linear_scoring([model1, model2], ubm, [stats1, stats2, stats3], test_channeloffset, True, 2)
+    self.assertTrue((abs(scores - ref_scores_11) < 1e-7).all())
+    scores = bob.machine.linear_scoring([model1.mean_supervector, model2.mean_supervector], ubm.mean_supervector, ubm.variance_supervector, [stats1, stats2, stats3], [], False, 3)
+    self.assertTrue((abs(scores - ref_scores_00) < 1e-7).all())
+    scores = bob.machine.linear_scoring(models, ubm.mean_supervector, [stats1, stats2, stats3], [], True, 0)
+    self.assertTrue((abs(scores - ref_scores_01) < 1e-7).all())
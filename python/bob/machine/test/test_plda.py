@@ -483,3 +483,38 @@ class PLDAMachineTest(unittest.TestCase):
     ar2_s2d = numpy.vstack([ar2_e, ar2_p2d])
     llr2d = m.compute_log_likelihood(ar2_s2d, True) - (m.compute_log_likelihood(ar2_s2d, False) + m.log_likelihood)
     self.assertTrue(abs(m.forward(ar2_s2d) - llr2d) < 1e-10)
+
+  def test05_plda_scorer(self):
+    # Defines base machine
+    sigma = numpy.ndarray(C_dim_d, 'float64')
+    sigma.fill(0.01)
+    mu = numpy.random.randn(C_dim_d)
+    mb = bob.machine.PLDABaseMachine(C_dim_d, C_dim_f, C_dim_g)
+    mb.mu = mu
+    mb.f = C_F
+    mb.g = C_G
+    mb.sigma = sigma
+
+    # Defines models with different numbers of enrolled samples
+    models = []
+    for n_samples in (0, 1, 3, 3, 5, 1):
+      m = bob.machine.PLDAMachine(mb)
+      m.n_samples = n_samples
+      m.weighted_sum = numpy.random.randn(C_dim_f)
+      m.w_sum_xit_beta_xi = -numpy.random.rand()
+      m.log_likelihood = -10. * numpy.random.rand()
+      models.append(m)
+
+    # Compares with the scores of the machines, with one or several threads
+    probes = numpy.random.randn(300, C_dim_d)
+    ref = numpy.array([[m.forward(p) for p in probes] for m in models])
+    for n_threads in (1, 4):
+      s = bob.machine.PLDAScorer(models, n_threads)
+      self.assertEqual(s.n_models, len(models))
+      scores = s(probes)
+      self.assertEqual(scores.shape, (len(models), probes.shape[0]))
+      eps = 1e-8 * max(1., abs(ref).max())
+      self.assertTrue(equals(scores, ref, eps))
+      out = numpy.ndarray((len(models), probes.shape[0]), 'float64')
+      s.score(probes, out)
+      self.assertTrue(equals(out, ref, eps))
@@ -76,3 +76,21 @@ class ZTNormTest(unittest.TestCase):
     scores = bob.machine.ztnorm(my_A, my_B, my_C, my_D)
     
     self.assertTrue((abs(scores - ref_scores) < 1e-7).all())
+
+  def test03_ztnorm_blocks(self):
+    my_A = bob.io.load(F("ztnorm_eval_eval.mat"))
+    my_B = bob.io.load(F("ztnorm_znorm_eval.mat"))
+    my_C = bob.io.load(F("ztnorm_eval_tnorm.mat"))
+    my_D = bob.io.load(F("ztnorm_znorm_tnorm.mat"))
+
+    ref_scores = bob.io.load(F("ztnorm_result.mat"))
+
+    # normalises the scores block by block, in place, with several threads
+    normalizer = bob.machine.ZTNormalizer(my_C, my_D, n_threads=2)
+    scores = my_A.copy()
+    for k in range(0, scores.shape[0], 3):
+      block = scores[k:k+3,:].copy()
+      normalizer.normalize(block, my_B[k:k+3,:], block)
+      scores[k:k+3,:] = block
+
+    self.assertTrue((abs(scores - ref_scores) < 1e-7).all())
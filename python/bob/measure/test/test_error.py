@@ -247,3 +247,48 @@ class ErrorTest(unittest.TestCase):
     self.assertEqual(rr, desired_rr)
     cmc = bob.measure.cmc(data)
     self.assertTrue((cmc == desired_cmc).all())
+
+  def test07_distribution(self):
+
+    # The score distribution gives the same results as the free functions,
+    # whether the scores are given at once or by chunks
+    positives = bob.io.load(F('nonsep-positives.hdf5'))
+    negatives = bob.io.load(F('nonsep-negatives.hdf5'))
+    d = bob.measure.ScoreDistribution(negatives, positives)
+    chunks = bob.measure.ScoreDistribution()
+    chunks.add(negatives[:10], positives[:20])
+    chunks.add(negatives[10:], positives[20:])
+
+    for dist in (d, chunks):
+      self.assertEqual(dist.n_negatives, negatives.shape[0])
+      self.assertEqual(dist.n_positives, positives.shape[0])
+      for t in (-1., 0., 0.5, 3., 10.):
+        self.assertEqual(dist.farfrr(t), bob.measure.farfrr(negatives, positives, t))
+      self.assertEqual(dist.eer_threshold(), bob.measure.eer_threshold(negatives, positives))
+      self.assertEqual(dist.min_hter_threshold(), bob.measure.min_hter_threshold(negatives, positives))
+      self.assertEqual(dist.far_threshold(0.1), bob.measure.far_threshold(negatives, positives, 0.1))
+      self.assertEqual(dist.frr_threshold(0.1), bob.measure.frr_threshold(negatives, positives, 0.1))
+      self.assertTrue( numpy.array_equal(dist.roc(100), bob.io.load(F('nonsep-roc.hdf5'))) )
+      self.assertTrue( numpy.array_equal(dist.det(100), bob.measure.det(negatives, positives, 100)) )
+      self.assertTrue( numpy.array_equal(dist.rocch(), bob.measure.rocch(negatives, positives)) )
+      far_list = numpy.array([0.01, 0.1, 0.5])
+      self.assertTrue( numpy.array_equal(dist.roc_for_far(far_list), bob.measure.roc_for_far(negatives, positives, far_list)) )
+
+    dev = bob.measure.ScoreDistribution(negatives[:(negatives.shape[0]/2)], positives[:(positives.shape[0]/2)])
+    test = bob.measure.ScoreDistribution(negatives[(negatives.shape[0]/2):], positives[(positives.shape[0]/2):])
+    self.assertTrue( numpy.allclose(bob.measure.epc(dev, test, 100), bob.io.load(F('nonsep-epc.hdf5')), atol=1e-15) )
+
+    # In histogram mode, FAR and FRR are exact at bin edges (which are exactly
+    # representable here)
+    step = 0.25
+    lo = numpy.floor(d.min) - 1.
+    n_bins = int((numpy.ceil(d.max) + 1. - lo) / step)
+    h = bob.measure.ScoreDistribution(n_bins, lo, lo + n_bins * step)
+    h.add(negatives, positives)
+    self.assertTrue(h.is_histogram)
+    for k in range(n_bins+1):
+      t = lo + k * step
+      far, frr = bob.measure.farfrr(negatives, positives, t)
+      hfar, hfrr = h.farfrr(t)
+      self.assertTrue(abs(far - hfar) < 1e-12 and abs(frr - hfrr) < 1e-12)
+    self.assertRaises(NotImplementedError, h.rocch)
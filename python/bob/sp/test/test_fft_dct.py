@@ -219,3 +219,19 @@ class TransformTest(unittest.TestCase):
 
       # call the test function
       _fft2D(M, N, t, 1e-3, self)
+
+  def test_fftw_measure_and_wisdom(self):
+    # Measured plans are reused and give the same results, and their wisdom
+    # can be exported and imported back
+    bob.sp.fftw_set_planning_rigor(bob.sp.FFTWPlanningRigor.Measure)
+    self.assertEqual(bob.sp.fftw_get_planning_rigor(), bob.sp.FFTWPlanningRigor.Measure)
+    for loop in range(0,3):
+      t = numpy.random.uniform(1, 10, (16,12)).astype('complex128')
+      _fft2D(16, 12, t, 1e-3, self)
+    bob.sp.fftw_set_planning_rigor(bob.sp.FFTWPlanningRigor.Estimate)
+
+    wisdom = bob.sp.fftw_export_wisdom_to_string()
+    self.assertTrue(len(wisdom) > 0)
+    bob.sp.fftw_forget_wisdom()
+    bob.sp.fftw_import_wisdom_from_string(wisdom)
+    self.assertRaises(RuntimeError, bob.sp.fftw_import_wisdom_from_string, "not wisdom")
@@ -535,3 +535,45 @@ class JFATrainerTest(unittest.TestCase):
     gse = [gse1, gse2]
     jfatrainer.enrol(gse, 5)
     self.assertTrue( numpy.allclose(jfamachine.z, z_ref, eps) )
+
+  def test10_ISVTrainMultiThreaded(self):
+    # Trains an 'ISVMachine' with the identities split across two threads
+
+    F1 = numpy.array( [0.3833, 0.4516, 0.6173, 0.2277, 0.5755, 0.8044, 0.5301,
+      0.9861, 0.2751, 0.0300, 0.2486, 0.5357]).reshape((6,2))
+    F2 = numpy.array( [0.0871, 0.6838, 0.8021, 0.7837, 0.9891, 0.5341, 0.0669,
+      0.8854, 0.9394, 0.8990, 0.0182, 0.6259]).reshape((6,2))
+    N1 = numpy.array([0.1379, 0.1821, 0.2178, 0.0418]).reshape((2,2))
+    N2 = numpy.array([0.1069, 0.9397, 0.6164, 0.3545]).reshape((2,2))
+
+    vec = []
+    for F, N in ((F1, N1), (F2, N2)):
+      sessions = []
+      for h in range(2):
+        gs = bob.machine.GMMStats(2,3)
+        gs.n = N[:,h]
+        gs.sum_px = F[:,h].reshape(2,3)
+        sessions.append(gs)
+      vec.append(sessions)
+
+    m = numpy.array([0.1806, 0.0451, 0.7232, 0.3474, 0.6606, 0.3839])
+    E = numpy.array([0.6273, 0.0216, 0.9106, 0.8006, 0.7458, 0.8131])
+    u = numpy.array([0.5118, 0.3464, 0.0826, 0.8865, 0.7196, 0.4547, 0.9962,
+      0.4134, 0.3545, 0.2177, 0.9713, 0.1257]).reshape((6,2))
+
+    eps = 1e-10
+    d_ref = numpy.array([0.39601136, 0.07348469, 0.47712682, 0.44738127, 0.43179856, 0.45086029], 'float64')
+    u_ref = numpy.array([[0.855125642430777, 0.563104284748032], [-0.325497865404680, 1.923598985291687], [0.511575659503837, 1.964288663083095], [9.330165761678115, 1.073623827995043], [0.511099245664012, 0.278551249248978], [5.065578541930268, 0.509565618051587]], 'float64')
+
+    ubm = bob.machine.GMMMachine(2,3)
+    ubm.mean_supervector = m
+    ubm.variance_supervector = E
+    jfam = bob.machine.JFABaseMachine(ubm,2)
+    jfat = bob.trainer.JFABaseTrainer(jfam)
+    jfat.n_threads = 2
+    self.assertEqual( jfat.n_threads, 2 )
+    jfam.u = u
+    jfat.train_isv_no_init(vec, 10, 4)
+
+    self.assertTrue( numpy.allclose(jfam.d, d_ref, eps) )
+    self.assertTrue( numpy.allclose(jfam.u, u_ref, eps) )
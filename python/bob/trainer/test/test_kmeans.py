@@ -196,3 +196,90 @@ class KMeansTest(unittest.TestCase):
     trainer.train(machine, data)
     self.assertFalse( numpy.isnan(machine.means).any())
 
+
+  def test04_kmeans_threads(self):
+
+    # Trains KMeansMachines with a multi-threaded E-step and compares to the
+    # single-threaded results
+    (arStd,std) = NormalizeStdArray(F("faithful.torch3.hdf5"))
+
+    machine1 = bob.machine.KMeansMachine(3, 2)
+    machine4 = bob.machine.KMeansMachine(3, 2)
+    trainer = bob.trainer.KMeansTrainer()
+    trainer.seed = 1337
+    trainer.train(machine1, arStd)
+    d1 = trainer.average_min_distance
+    trainer.n_threads = 4
+    trainer.train(machine4, arStd)
+    self.assertTrue(equals(machine1.means, machine4.means, 1e-8))
+    self.assertTrue(abs(d1 - trainer.average_min_distance) < 1e-8)
+
+  def test05_kmeans_assignment_methods(self):
+
+    # The accelerated E-steps should find the same means as the brute force
+    (arStd,std) = NormalizeStdArray(F("faithful.torch3.hdf5"))
+
+    machine = bob.machine.KMeansMachine(5, 2)
+    machine.means = arStd[0:5,:]
+    distances = machine.get_distances_from_means(arStd)
+    self.assertEqual(distances.shape, (arStd.shape[0], 5))
+    for i in range(arStd.shape[0]):
+      for j in range(5):
+        self.assertTrue(abs(distances[i,j] - machine.get_distance_from_mean(arStd[i,:], j)) < 1e-10)
+
+    trainer = bob.trainer.KMeansTrainer()
+    self.assertEqual(trainer.assignment_method, bob.trainer.KMeansTrainer.BRUTE_FORCE)
+    trainer.seed = 1337
+    trainer.max_iterations = 50
+    results = []
+    for method in (bob.trainer.KMeansTrainer.BRUTE_FORCE, bob.trainer.KMeansTrainer.GEMM, bob.trainer.KMeansTrainer.HAMERLY):
+      for n_threads in (1, 3):
+        machine = bob.machine.KMeansMachine(5, 2)
+        trainer.assignment_method = method
+        trainer.n_threads = n_threads
+        trainer.train(machine, arStd)
+        results.append((machine.means, trainer.average_min_distance))
+    for means, distance in results[1:]:
+      self.assertTrue(equals(means, results[0][0], 1e-8))
+      self.assertTrue(abs(distance - results[0][1]) < 1e-8)
+
+    # The HAMERLY bounds are kept from one E-step to the next one, until
+    # they are reset (e.g. when the data are modified in place)
+    machine = bob.machine.KMeansMachine(5, 2)
+    machine.means = arStd[0:5,:]
+    data = arStd.copy()
+    hamerly = bob.trainer.KMeansTrainer()
+    hamerly.assignment_method = bob.trainer.KMeansTrainer.HAMERLY
+    brute = bob.trainer.KMeansTrainer()
+    self.assertEqual(brute.assignment_method, bob.trainer.KMeansTrainer.BRUTE_FORCE)
+    hamerly.e_step(machine, data)
+    data[:] = data[::-1,:] * 0.5
+    hamerly.reset_bounds()
+    hamerly.e_step(machine, data)
+    brute.e_step(machine, data)
+    self.assertTrue(equals(hamerly.zeroeth_order_statistics, brute.zeroeth_order_statistics, 1e-10))
+    self.assertTrue(equals(hamerly.first_order_statistics, brute.first_order_statistics, 1e-8))
+    self.assertTrue(abs(hamerly.average_min_distance - brute.average_min_distance) < 1e-8)
+
+  def test06_minibatch_kmeans(self):
+
+    # Mini-batch k-means on well separated clusters
+    numpy.random.seed(5)
+    centers = numpy.array([[-10., 0.], [0., 10.], [10., 0.]])
+    data = numpy.vstack([c + numpy.random.randn(300, 2) for c in centers])
+
+    machine = bob.machine.KMeansMachine(3, 2)
+    machine.means = numpy.array([[-5., 1.], [1., 5.], [5., 1.]])
+    trainer = bob.trainer.MiniBatchKMeansTrainer(100, 30)
+    trainer.seed = 1337
+    trainer.train(machine, data)
+    self.assertEqual(trainer.counts.sum(), 3000)
+    self.assertTrue(equals(machine.means, centers, 0.3))
+
+    # Same with batches given one at a time
+    machine.means = numpy.array([[-5., 1.], [1., 5.], [5., 1.]])
+    trainer.reset()
+    for i in range(0, data.shape[0], 90):
+      trainer.update(machine, data[i:i+90,:])
+    self.assertEqual(trainer.counts.sum(), data.shape[0])
+    self.assertTrue(equals(machine.means, centers, 0.3))
@@ -397,3 +397,39 @@ class RPropTest(unittest.TestCase):
         self.assertTrue( numpy.allclose(w, machine.weights[i], epsilon) )
       for i, b in enumerate(pymachine.biases):
         self.assertTrue( numpy.allclose(b, machine.biases[i], epsilon) )
+
+  def test07_FixedProblemAllActivations(self):
+
+    # Trains a small biased MLP on a fixed problem with every activation
+    # function, against the Python implementation. There are more samples
+    # than the block size of the forward pass of the machine.
+
+    N = 300
+    input = numpy.array([[numpy.sin(0.37 * i + j) for j in range(3)]
+      for i in range(N)], 'float64')
+    target = numpy.array([[numpy.cos(0.11 * i), 0.5 * numpy.sin(0.23 * i)]
+      for i in range(N)], 'float64')
+    w0 = numpy.array([[.23, .1, -.4, .05], [-.79, .21, .3, -.12],
+      [.17, -.33, .08, .6]])
+    w1 = numpy.array([[-.12, .4], [-.88, .1], [.25, -.5], [.3, .07]])
+
+    for activation in (bob.machine.Activation.LINEAR,
+        bob.machine.Activation.TANH, bob.machine.Activation.LOG):
+      machine = bob.machine.MLP((3, 4, 2))
+      machine.activation = activation
+      machine.weights = [w0, w1]
+      machine.biases = [numpy.array([.1, -.2, .05, 0.]), numpy.array([-.1, .3])]
+      trainer = bob.trainer.MLPRPropTrainer(machine, N)
+      trainer.train_biases = True
+
+      pytrainer = PythonRProp(train_biases=True)
+      pymachine = bob.machine.MLP(machine) #a copy
+
+      for k in range(10):
+        pytrainer.train(pymachine, input, target)
+        trainer.train_(machine, input, target)
+        for i, w in enumerate(pymachine.weights):
+          self.assertTrue( numpy.allclose(w, machine.weights[i], epsilon) )
+        for i, b in enumerate(pymachine.biases):
+          self.assertTrue( numpy.allclose(b, machine.biases[i], epsilon) )
+      self.assertTrue( numpy.allclose(pymachine(input), machine(input), epsilon) )
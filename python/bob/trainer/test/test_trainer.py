@@ -302,3 +302,33 @@ class GMMTest(unittest.TestCase):
     trainer.max_iterations = 1;
     trainer.train(machine, data) # After the initialization the means are still [0.,0.] (at the C++ level)
     self.assertFalse( numpy.isnan(machine.means).any())
+
+  def test10_gmm_ML_MAP_threads(self):
+
+    # Trains GMMMachines with a multi-threaded E-step and compares to the
+    # single-threaded results
+
+    ar = bob.io.load(F('faithful.torch3_f64.hdf5'))
+
+    gmm1 = loadGMM()
+    gmm4 = loadGMM()
+    trainer = bob.trainer.ML_GMMTrainer(True, True, True)
+    self.assertEqual(trainer.n_threads, 1)
+    trainer.train(gmm1, ar)
+    trainer.n_threads = 4
+    trainer.train(gmm4, ar)
+    self.assertTrue(equals(gmm1.means, gmm4.means, 1e-8))
+    self.assertTrue(equals(gmm1.variances, gmm4.variances, 1e-8))
+    self.assertTrue(equals(gmm1.weights, gmm4.weights, 1e-8))
+
+    gmmprior = bob.machine.GMMMachine(bob.io.HDF5File(F("gmm_ML.hdf5")))
+    gmm1 = bob.machine.GMMMachine(gmmprior)
+    gmm4 = bob.machine.GMMMachine(gmmprior)
+    trainer = bob.trainer.MAP_GMMTrainer(16)
+    trainer.set_prior_gmm(gmmprior)
+    trainer.train(gmm1, ar)
+    trainer.n_threads = 4
+    trainer.train(gmm4, ar)
+    self.assertTrue(equals(gmm1.means, gmm4.means, 1e-8))
+    self.assertTrue(equals(gmm1.variances, gmm4.variances, 1e-8))
+    self.assertTrue(equals(gmm1.weights, gmm4.weights, 1e-8))
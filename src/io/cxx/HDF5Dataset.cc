@@ -20,6 +20,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <boost/format.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/shared_array.hpp>
@@ -235,12 +236,53 @@ h5::Dataset::Dataset(boost::shared_ptr<Group> parent,
   }
 }
 
+/**
+ * Default size, in bytes, aimed at for the chunks of new datasets when the
+ * user does not set the chunk size explicitly. Chunks of this size amortize
+ * the per-chunk B-tree and I/O overheads, while many of them still fit in
+ * the default (1 MiB) HDF5 chunk cache of each dataset.
+ */
+static const hsize_t CHUNK_TARGET_BYTES = 64*1024;
+
+/**
+ * Maximum number of entries of the automatic chunks of (extensible) lists.
+ * HDF5 allocates chunks as a whole and their shape cannot change once the
+ * dataset is created: a list holding a single small entry would otherwise
+ * take a full CHUNK_TARGET_BYTES chunk on disk. Lists of large entries
+ * still get one entry per chunk, and lists of small entries grow by a few
+ * hundred bytes at a time.
+ */
+static const hsize_t CHUNK_LIST_ENTRIES = 32;
+
+/**
+ * Figures out how many entries along the first dimension go into each chunk
+ * of a dataset with the given (extended) shape. A chunk_size of zero means
+ * "automatic": as many entries as fit in CHUNK_TARGET_BYTES (and at most
+ * CHUNK_LIST_ENTRIES for lists), but at least one.
+ */
+static hsize_t chunk_entries(const io::HDF5Shape& xshape, bool list,
+    size_t element_size, size_t chunk_size) {
+  hsize_t entry_bytes = element_size;
+  for (size_t k=1; k<xshape.n(); ++k) entry_bytes *= xshape[k];
+  if (!entry_bytes) entry_bytes = 1;
+
+  hsize_t retval = chunk_size;
+  if (!retval) {
+    retval = std::max<hsize_t>(1, CHUNK_TARGET_BYTES / entry_bytes);
+    if (list) retval = std::min(retval, CHUNK_LIST_ENTRIES);
+  }
+
+  //chunks cannot be larger than the fixed dimensions of a dataset
+  if (!list) retval = std::min(retval, std::max<hsize_t>(1, xshape[0]));
+  return retval;
+}
+
 /**
  * Creates and writes an "empty" Dataset in an existing file.
  */
 static void create_dataset (boost::shared_ptr<h5::Group> par,
  const std::string& name, const io::HDF5Type& type, bool list,
- size_t compression) {
+ size_t compression, size_t chunk_size) {
 
   if (!name.size() || name == "." || name == "..") {
     boost::format m("Cannot create dataset with illegal name `%s' at `%s:%s'");
@@ -269,10 +311,13 @@ static void create_dataset (boost::shared_ptr<h5::Group> par,
   //supposed to be a list -- HDF5 only supports expandability like this.
   boost::shared_ptr<hid_t> dcpl = open_plist(H5P_DATASET_CREATE);
 
+  boost::shared_ptr<hid_t> cls = type.htype();
+
   //according to the HDF5 manual, chunks have to have the same rank as the
-  //array shape.
+  //array shape. Each chunk groups several entries along the first dimension,
+  //so that appending or scanning a list does not touch one chunk per entry.
   io::HDF5Shape chunking(xshape);
-  chunking[0] = 1;
+  chunking[0] = chunk_entries(xshape, list, H5Tget_size(*cls), chunk_size);
   if (list || compression) { ///< note: compression requires chunking
     herr_t status = H5Pset_chunk(*dcpl, chunking.n(), chunking.get());
     if (status < 0) throw io::HDF5StatusError("H5Pset_chunk", status);
@@ -294,8 +339,6 @@ static void create_dataset (boost::shared_ptr<h5::Group> par,
   //please note that we don't define the fill value as in the example, but
   //according to the HDF5 documentation, this value is set to zero by default.
 
-  boost::shared_ptr<hid_t> cls = type.htype();
-
   //finally create the dataset on the file.
   boost::shared_ptr<hid_t> dataset(new hid_t(-1),
       std::ptr_fun(delete_h5dataset));
@@ -360,7 +403,7 @@ static void create_string_dataset (boost::shared_ptr<h5::Group> par,
 
 h5::Dataset::Dataset(boost::shared_ptr<Group> parent,
     const std::string& name, const io::HDF5Type& type,
-    bool list, size_t compression):
+    bool list, size_t compression, size_t chunk_size):
   m_parent(parent),
   m_name(name),
   m_id(),
@@ -378,7 +421,7 @@ h5::Dataset::Dataset(boost::shared_ptr<Group> parent,
     if (type.type() == bob::io::s) 
       create_string_dataset(parent, m_name, type, compression);
     else 
-      create_dataset(parent, m_name, type, list, compression);
+      create_dataset(parent, m_name, type, list, compression, chunk_size);
   }
   else H5Dclose(set_id); //close it, will re-open it properly
 
@@ -500,6 +543,67 @@ void h5::Dataset::write_buffer (size_t index, const io::HDF5Type& dest,
 }
 
 void h5::Dataset::extend_buffer (const bob::io::HDF5Type& dest, const void* buffer) {
+  extend_buffer(1, dest, buffer);
+}
+
+std::vector<io::HDF5Descriptor>::iterator
+h5::Dataset::select (size_t start, size_t count, const io::HDF5Type& dest) {
+
+  //finds compatibility type
+  std::vector<io::HDF5Descriptor>::iterator it = find_type_index(m_descr, dest);
+
+  //if we cannot find a compatible type, we throw
+  if (it == m_descr.end())
+    throw bob::io::HDF5IncompatibleIO(url(), m_descr[0].type.str(), dest.str());
+
+  //checks indexing
+  if (start + count > it->size)
+    throw bob::io::HDF5IndexError(url(), it->size, start + count - 1);
+
+  //each object spans hyperslab_count[0] entries of the first dimension of
+  //the file space: 1 for lists, the whole extent for a straight read/write
+  io::HDF5Shape hstart(it->hyperslab_start);
+  io::HDF5Shape hcount(it->hyperslab_count);
+  hstart[0] = start * hcount[0];
+  hcount[0] *= count;
+
+  set_memspace(m_memspace, hcount);
+
+  herr_t status = H5Sselect_hyperslab(*m_filespace, H5S_SELECT_SET,
+      hstart.get(), 0, hcount.get(), 0);
+  if (status < 0) throw io::HDF5StatusError("H5Sselect_hyperslab", status);
+
+  return it;
+}
+
+void h5::Dataset::read_buffer (size_t start, size_t count,
+    const io::HDF5Type& dest, void* buffer) {
+
+  if (!count) return;
+
+  std::vector<io::HDF5Descriptor>::iterator it = select(start, count, dest);
+
+  herr_t status = H5Dread(*m_id, *it->type.htype(),
+      *m_memspace, *m_filespace, H5P_DEFAULT, buffer);
+
+  if (status < 0) throw io::HDF5StatusError("H5Dread", status);
+}
+
+void h5::Dataset::write_buffer (size_t start, size_t count,
+    const io::HDF5Type& dest, const void* buffer) {
+
+  if (!count) return;
+
+  std::vector<io::HDF5Descriptor>::iterator it = select(start, count, dest);
+
+  herr_t status = H5Dwrite(*m_id, *it->type.htype(),
+      *m_memspace, *m_filespace, H5P_DEFAULT, buffer);
+
+  if (status < 0) throw io::HDF5StatusError("H5Dwrite", status);
+}
+
+void h5::Dataset::extend_buffer (size_t count, const bob::io::HDF5Type& dest,
+    const void* buffer) {
 
   //finds compatibility type
   std::vector<io::HDF5Descriptor>::iterator it = find_type_index(m_descr, dest);
@@ -511,27 +615,37 @@ void h5::Dataset::extend_buffer (const bob::io::HDF5Type& dest, const void* buff
   if (!it->expandable)
     throw io::HDF5NotExpandible(url());
 
+  if (!count) return;
+
   //if it is expandible, try expansion
+  const size_t start = it->size;
   io::HDF5Shape tmp(it->type.shape());
   tmp >>= 1;
-  tmp[0] = it->size + 1;
+  tmp[0] = start + count;
   herr_t status = H5Dset_extent(*m_id, tmp.get());
   if (status < 0) throw io::HDF5StatusError("H5Dset_extent", status);
 
   //if expansion succeeded, update all compatible types
   for (size_t k=0; k<m_descr.size(); ++k) {
     if (m_descr[k].expandable) { //updated only the length
-      m_descr[k].size += 1;
+      m_descr[k].size += count;
     }
     else { //not expandable, update the shape/count for a straight read/write
-      m_descr[k].type.shape()[0] += 1;
-      m_descr[k].hyperslab_count[0] += 1;
+      m_descr[k].type.shape()[0] += count;
+      m_descr[k].hyperslab_count[0] += count;
     }
   }
 
   m_filespace = open_filespace(m_id); //update filespace
 
-  write_buffer(tmp[0]-1, dest, buffer);
+  write_buffer(start, count, dest, buffer);
+}
+
+bob::io::HDF5Type h5::Dataset::entry_type(const bob::io::HDF5Type& block) {
+  if (block.shape().n() <= 1) return bob::io::HDF5Type(block.type());
+  io::HDF5Shape shape(block.shape());
+  shape <<= 1;
+  return bob::io::HDF5Type(block.type(), shape);
 }
 
 void h5::Dataset::gettype_attribute(const std::string& name,
@@ -37,8 +37,10 @@ static unsigned int getH5Access (io::HDF5File::mode_t v) {
   }
 }
 
-io::HDF5File::HDF5File(const std::string& filename, mode_t mode):
-  m_file(new io::detail::hdf5::File(filename, getH5Access(mode))),
+io::HDF5File::HDF5File(const std::string& filename, mode_t mode,
+    size_t chunk_cache_size):
+  m_file(new io::detail::hdf5::File(filename, getH5Access(mode), 0,
+        chunk_cache_size)),
   m_cwd(m_file->root()) ///< we start by looking at the root directory
 {
 }
@@ -136,13 +138,14 @@ void io::HDF5File::copy (HDF5File& other) {
 }
 
 void io::HDF5File::create (const std::string& path, const io::HDF5Type& type,
-    bool list, size_t compression) {
+    bool list, size_t compression, size_t chunk_size) {
   if (!m_file->writeable()) {
     boost::format m("cannot create dataset '%s' at path '%s' of file '%s' because it is not writeable");
     m % path % m_cwd->path() % m_file->filename();
     throw std::runtime_error(m.str());
   }
-  if (!contains(path)) m_cwd->create_dataset(path, type, list, compression);
+  if (!contains(path)) m_cwd->create_dataset(path, type, list, compression,
+      chunk_size);
   else (*m_cwd)[path]->size(type);
 }
 
@@ -171,6 +174,31 @@ void io::HDF5File::extend_buffer(const std::string& path,
   (*m_cwd)[path]->extend_buffer(type, buffer);
 }
 
+void io::HDF5File::read_buffer (const std::string& path, size_t pos,
+    size_t count, const io::HDF5Type& type, void* buffer) const {
+  (*m_cwd)[path]->read_buffer(pos, count, type, buffer);
+}
+
+void io::HDF5File::write_buffer (const std::string& path, size_t pos,
+    size_t count, const io::HDF5Type& type, const void* buffer) {
+  if (!m_file->writeable()) {
+    boost::format m("cannot write to object '%s' at path '%s' of file '%s' because it is not writeable");
+    m % path % m_cwd->path() % m_file->filename();
+    throw std::runtime_error(m.str());
+  }
+  (*m_cwd)[path]->write_buffer(pos, count, type, buffer);
+}
+
+void io::HDF5File::extend_buffer(const std::string& path, size_t count,
+    const io::HDF5Type& type, const void* buffer) {
+  if (!m_file->writeable()) {
+    boost::format m("cannot extend object '%s' at path '%s' of file '%s' because the file is not writeable");
+    m % path % m_cwd->path() % m_file->filename();
+    throw std::runtime_error(m.str());
+  }
+  (*m_cwd)[path]->extend_buffer(count, type, buffer);
+}
+
 bool io::HDF5File::hasAttribute(const std::string& path,
     const std::string& name) const {
   if (m_cwd->has_dataset(path)) {
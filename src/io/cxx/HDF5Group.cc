@@ -380,12 +380,12 @@ bool h5::Group::has_group(const std::string& dir) const {
 
 boost::shared_ptr<h5::Dataset> h5::Group::create_dataset
 (const std::string& dir, const bob::io::HDF5Type& type, bool list,
- size_t compression) {
+ size_t compression, size_t chunk_size) {
   std::string::size_type pos = dir.find_last_of('/');
   if (pos == std::string::npos) { //creates on the current group
     boost::shared_ptr<h5::Dataset> d =
       boost::make_shared<h5::Dataset>(shared_from_this(), dir, type,
-          list, compression);
+          list, compression, chunk_size);
     m_datasets[dir] = d;
     return d;
   }
@@ -402,7 +402,8 @@ boost::shared_ptr<h5::Dataset> h5::Group::create_dataset
     if (!has_group(dest)) g = create_group(dest);
     else g = cd(dest);
   }
-  return g->create_dataset(dir.substr(pos+1), type, list, compression);
+  return g->create_dataset(dir.substr(pos+1), type, list, compression,
+      chunk_size);
 }
 
 void h5::Group::remove_dataset(const std::string& dir) {
@@ -20,6 +20,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <boost/make_shared.hpp>
 #include "bob/io/HDF5Utils.h"
 #include "bob/core/logging.h"
@@ -56,8 +57,40 @@ static void delete_h5p (hid_t* p) {
   delete p;
 }
 
+/**
+ * Smallest prime number that is larger or equal to n
+ */
+static size_t next_prime(size_t n) {
+  if (n <= 2) return 2;
+  if (n % 2 == 0) ++n;
+  for (;; n += 2) {
+    bool prime = true;
+    for (size_t d=3; d*d<=n; d+=2) if (n % d == 0) { prime = false; break; }
+    if (prime) return n;
+  }
+}
+
+/**
+ * Creates the file access property list. If cache_size is not zero, sets the
+ * size (in bytes) of the chunk cache of each of the datasets of the file.
+ * The number of hash slots is a prime number, of about one slot per kilobyte
+ * of cache (HDF5 recommends at least ten times the number of chunks that fit
+ * in the cache).
+ */
+static boost::shared_ptr<hid_t> create_fapl(size_t cache_size) {
+  if (!cache_size) return boost::make_shared<hid_t>(H5P_DEFAULT);
+  boost::shared_ptr<hid_t> retval(new hid_t(-1), std::ptr_fun(delete_h5p));
+  *retval = H5Pcreate(H5P_FILE_ACCESS);
+  if (*retval < 0) throw io::HDF5StatusError("H5Pcreate", *retval);
+  const size_t slots = next_prime(std::max<size_t>(521, cache_size / 1024));
+  herr_t err = H5Pset_cache(*retval, 0, slots, cache_size, 0.75);
+  if (err < 0) throw io::HDF5StatusError("H5Pset_cache", err);
+  return retval;
+}
+
 static boost::shared_ptr<hid_t> open_file(const boost::filesystem::path& path,
-    unsigned int flags, boost::shared_ptr<hid_t>& fcpl) {
+    unsigned int flags, boost::shared_ptr<hid_t>& fcpl,
+    const boost::shared_ptr<hid_t>& fapl) {
 
   boost::shared_ptr<hid_t> retval(new hid_t(-1), std::ptr_fun(delete_h5file));
 
@@ -67,7 +100,7 @@ static boost::shared_ptr<hid_t> open_file(const boost::filesystem::path& path,
   }
 
   if (boost::filesystem::exists(path) && flags != H5F_ACC_TRUNC) { //open
-    *retval = H5Fopen(path.string().c_str(), flags, H5P_DEFAULT);
+    *retval = H5Fopen(path.string().c_str(), flags, *fapl);
     if (*retval < 0) throw io::HDF5StatusError("H5Fopen", *retval);
     //replaces the file create list properties with the one from the file
     fcpl = boost::shared_ptr<hid_t>(new hid_t(-1), std::ptr_fun(delete_h5p));
@@ -76,7 +109,7 @@ static boost::shared_ptr<hid_t> open_file(const boost::filesystem::path& path,
   }
   else { //file needs to be created or truncated (can set user block)
     *retval = H5Fcreate(path.string().c_str(), H5F_ACC_TRUNC,
-        *fcpl, H5P_DEFAULT);
+        *fcpl, *fapl);
     if (*retval < 0) throw io::HDF5StatusError("H5Fcreate", *retval);
   }
   return retval;
@@ -94,11 +127,11 @@ static boost::shared_ptr<hid_t> create_fcpl(hsize_t userblock_size) {
 }
 
 h5::File::File(const boost::filesystem::path& path, unsigned int flags,
-    size_t userblock_size):
+    size_t userblock_size, size_t cache_size):
   m_path(path),
   m_flags(flags),
   m_fcpl(create_fcpl(userblock_size)),
-  m_id(open_file(m_path, m_flags, m_fcpl))
+  m_id(open_file(m_path, m_flags, m_fcpl, create_fapl(cache_size)))
 {
 }
 
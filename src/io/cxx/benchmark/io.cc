@@ -0,0 +1,148 @@
+/**
+ * @file io/cxx/benchmark/io.cc
+ * @date Fri 16 Oct 2026 18:10:37 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Benchmarks of the HDF5 and image reading and writing
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOB_BENCHMARK_SUITE "io"
+#define BOB_BENCHMARK_MAIN
+#include "bob/core/benchmark.h"
+
+#include <boost/filesystem.hpp>
+#include "bob/core/logging.h" // for bob::core::tmpfile()
+#include "bob/io/HDF5File.h"
+#include "bob/io/CodecRegistry.h"
+#include "bob/io/utils.h"
+
+namespace bench = bob::core::benchmark;
+
+struct HDF5Write {
+  std::string filename;
+  const blitz::Array<double,2>* data;
+  void operator()() const {
+    bob::io::HDF5File f(filename, bob::io::HDF5File::trunc);
+    f.setArray("data", *data);
+  }
+};
+
+struct HDF5Read {
+  std::string filename;
+  blitz::Array<double,2>* data;
+  void operator()() const {
+    bob::io::HDF5File f(filename, bob::io::HDF5File::in);
+    f.readArray("data", *data);
+  }
+};
+
+struct HDF5ReadRows {
+  std::string filename;
+  blitz::Array<double,1>* row;
+  size_t n_rows;
+  void operator()() const {
+    bob::io::HDF5File f(filename, bob::io::HDF5File::in);
+    for (size_t i=0; i<n_rows; ++i) f.readArray("rows", i, *row);
+  }
+};
+
+struct ImageWrite {
+  std::string filename;
+  const blitz::Array<uint8_t,3>* image;
+  void operator()() const { bob::io::save(filename, *image); }
+};
+
+struct ImageRead {
+  std::string filename;
+  void operator()() const { bob::io::load<uint8_t,3>(filename); }
+};
+
+static void hdf5(bench::Suite& suite) {
+  const std::string filename = bob::core::tmpfile(".hdf5");
+
+  const int sizes[] = {64, 1024};
+  for (size_t i=0; i<sizeof(sizes)/sizeof(int); ++i) {
+    const int n = sizes[i];
+    blitz::Array<double,2> data(n, n);
+    bench::randomize(data);
+    const double bytes = n * n * sizeof(double);
+
+    HDF5Write write = {filename, &data};
+    suite.run((boost::format("hdf5-write/float64/%dx%d") % n % n).str(),
+        write, 1, bytes);
+    write();
+    HDF5Read read = {filename, &data};
+    suite.run((boost::format("hdf5-read/float64/%dx%d") % n % n).str(),
+        read, 1, bytes);
+  }
+
+  // many small arrays (e.g. feature vectors) read one by one
+  const size_t n_rows = 1000;
+  const int d = 60;
+  {
+    bob::io::HDF5File f(filename, bob::io::HDF5File::trunc);
+    blitz::Array<double,1> row(d);
+    for (size_t i=0; i<n_rows; ++i) {
+      bench::randomize(row, 0., 1., i);
+      f.appendArray("rows", row);
+    }
+  }
+  blitz::Array<double,1> row(d);
+  HDF5ReadRows read_rows = {filename, &row, n_rows};
+  suite.run((boost::format("hdf5-read-rows/float64/%dx%d") % n_rows % d).str(),
+      read_rows, n_rows, n_rows*d*sizeof(double));
+
+  boost::filesystem::remove(filename);
+}
+
+static void image(bench::Suite& suite) {
+  // a smooth color image with some noise, of the size of a VGA frame
+  const int h = 480, w = 640;
+  blitz::Array<uint8_t,3> image(3, h, w);
+  blitz::Array<double,3> noise(3, h, w);
+  bench::randomize(noise, -8., 8.);
+  blitz::firstIndex c;
+  blitz::secondIndex y;
+  blitz::thirdIndex x;
+  image = blitz::cast<uint8_t>(64. * (c + 1) + 48. * blitz::sin(y / 37.) *
+      blitz::cos(x / 53.) + noise);
+  const double bytes = 3 * h * w;
+
+  const char* extensions[] = {".bmp", ".ppm", ".png", ".jpg", ".tif"};
+  boost::shared_ptr<bob::io::CodecRegistry> registry =
+    bob::io::CodecRegistry::instance();
+  for (size_t i=0; i<sizeof(extensions)/sizeof(char*); ++i) {
+    const std::string extension(extensions[i]);
+    if (!registry->isRegistered(extension)) continue;
+    const std::string filename = bob::core::tmpfile(extension);
+
+    ImageWrite write = {filename, &image};
+    suite.run((boost::format("image-write/%s/3x%dx%d") % extension.substr(1) %
+          h % w).str(), write, 1, bytes);
+    write();
+    ImageRead read = {filename};
+    suite.run((boost::format("image-read/%s/3x%dx%d") % extension.substr(1) %
+          h % w).str(), read, 1, bytes);
+
+    boost::filesystem::remove(filename);
+  }
+}
+
+void bob_benchmark(bench::Suite& suite) {
+  hdf5(suite);
+  image(suite);
+}
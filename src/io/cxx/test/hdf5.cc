@@ -146,4 +146,44 @@ BOOST_AUTO_TEST_CASE( hdf5_write_on_readonly )
   boost::filesystem::remove(filename);
 }
 
+BOOST_AUTO_TEST_CASE( hdf5_range_append_read )
+{
+  const std::string filename = bob::core::tmpfile();
+  bob::io::HDF5File config(filename, bob::io::HDF5File::trunc, 4*1024*1024);
+
+  // Appends the rows of "a" one by one, then all of them at once, with a
+  // chunk size that does not divide the number of rows
+  blitz::Range all = blitz::Range::all();
+  for (int i=0; i<a.extent(0); ++i) {
+    blitz::Array<double,1> row = a(i,all);
+    config.appendArray("rows", row, 0, 3);
+  }
+  config.appendArrays("rows", a);
+  BOOST_CHECK_EQUAL(config.describe("rows")[0].size, 2*(size_t)a.extent(0));
+
+  // Reads a range crossing the boundary between the two appends
+  blitz::Array<double,2> range = config.readArrays<double,2>("rows", 2, 4);
+  check_equal(a(blitz::Range(2,3),all), range(blitz::Range(0,1),all));
+  check_equal(a(blitz::Range(0,1),all), range(blitz::Range(2,3),all));
+
+  // Replaces a range and reads it back
+  blitz::Array<double,2> twice(2,2);
+  twice = 2. * a(blitz::Range(1,2),all);
+  config.replaceArrays("rows", 5, twice);
+  blitz::Array<double,2> twice_read(2,2);
+  config.readArrays("rows", 5, twice_read);
+  check_equal(twice, twice_read);
+
+  // Ranges of scalars
+  config.appendArrays("scalars", c);
+  config.appendArrays("scalars", c);
+  check_equal(c, config.readArrays<double,1>("scalars", 5, 5));
+
+  // Reading past the end raises
+  BOOST_CHECK_THROW(config.readArrays<double,2>("rows", 7, 2), std::exception);
+
+  // Clean-up
+  boost::filesystem::remove(filename);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
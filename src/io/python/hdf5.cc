@@ -26,8 +26,10 @@
 
 #include "bob/core/python/exception.h"
 #include "bob/core/python/ndarray.h"
+#include "bob/core/python/gil.h"
 
 #include "bob/io/HDF5File.h"
+#include <H5public.h>
 
 using namespace boost::python;
 namespace io = bob::io;
@@ -139,7 +141,14 @@ static object hdf5file_xread(io::HDF5File& f, const std::string& p,
   ca::typeinfo atype;
   type.copy_to(atype);
   tp::py_array retval(atype);
-  f.read_buffer(p, pos, atype, retval.ptr());
+  {
+#ifdef H5_HAVE_THREADSAFE
+    //the other HDF5 calls of this module keep the GIL: only a thread-safe
+    //build of the library can read concurrently with them
+    tp::no_gil unlock;
+#endif
+    f.read_buffer(p, pos, atype, retval.ptr());
+  }
   return retval.pyobject();
 }
 
@@ -29,6 +29,7 @@
 #include "bob/io/VideoUtilities.h"
 #include "bob/core/python/exception.h"
 #include "bob/core/python/ndarray.h"
+#include "bob/core/python/gil.h"
 
 using namespace boost::python;
 namespace io = bob::io;
@@ -59,9 +60,16 @@ struct iterator_wrapper {
       PYTHON_ERROR(StopIteration, "no more data");
     }
 
-    //load the next frame: if an error is detected internally, throw
+    //load the next frame: if an error is detected internally, throw. Frames
+    //are decoded without the GIL, an iterator being advanced by one Python
+    //thread at a time.
     tp::py_array retval(reader->frame_type());
-    bool ok = o.read(retval); //note that this will advance the iterator
+    bool ok = false;
+    {
+      tp::no_gil unlock;
+      tp::object_lock lock(&o);
+      ok = o.read(retval); //note that this will advance the iterator
+    }
     if (!ok) PYTHON_ERROR(StopIteration, "iteration finished");
     return retval.pyobject();
   }
@@ -91,9 +99,12 @@ static object videoreader_getitem (io::VideoReader& v, Py_ssize_t sframe) {
   }
 
   tp::py_array retval(v.frame_type());
-  io::VideoReader::const_iterator it = v.begin();
-  it += frame;
-  it.read(retval); //read and throw if a problem occurs
+  {
+    tp::no_gil unlock;
+    io::VideoReader::const_iterator it = v.begin();
+    it += frame;
+    it.read(retval); //read and throw if a problem occurs
+  }
   return retval.pyobject();
 }
 
@@ -138,7 +149,10 @@ static tuple videoreader_getslice (io::VideoReader& v, slice sobj) {
   it += start;
   for (size_t i=start; it.parent() && i<stop; i+=step, it+=(step-1)) {
     tp::py_array tmp(v.frame_type());
-    it.read(tmp); //throw if a problem occurs while reading the video
+    {
+      tp::no_gil unlock;
+      it.read(tmp); //throw if a problem occurs while reading the video
+    }
     retval.append(tmp.pyobject());
   }
  
@@ -148,7 +162,11 @@ static tuple videoreader_getslice (io::VideoReader& v, slice sobj) {
 static object videoreader_load(io::VideoReader& reader, 
   bool raise_on_error=false) {
   tp::py_array tmp(reader.video_type());
-  size_t frames_read = reader.load(tmp, raise_on_error);
+  size_t frames_read = 0;
+  {
+    tp::no_gil unlock;
+    frames_read = reader.load(tmp, raise_on_error);
+  }
   return make_tuple(frames_read, tmp.pyobject());
 }
 
@@ -43,19 +43,11 @@ bob::ip::DCTFeatures::operator=(const bob::ip::DCTFeatures& other)
 void bob::ip::DCTFeatures::resetCache() const
 {
   resetCacheBlock();
-  resetCacheDct();
 }
 
 void bob::ip::DCTFeatures::resetCacheBlock() const
 {
   m_cache_block1.resize(m_block_h, m_block_w);
-  m_cache_block2.resize(m_block_h, m_block_w);
-}
-
-void bob::ip::DCTFeatures::resetCacheDct() const
-{
-  m_cache_dct1.resize(m_n_dct_coefs);
-  m_cache_dct2.resize(m_n_dct_coefs);
 }
 
 bool 
@@ -75,6 +67,101 @@ bob::ip::DCTFeatures::operator!=(const bob::ip::DCTFeatures& b) const
   return !(this->operator==(b));
 }
 
+void bob::ip::DCTFeatures::zigzagOffsets(std::vector<int>& offsets) const
+{
+  // Applies the zigzag pattern (and its checks) to the offsets themselves
+  blitz::Array<int,2> block_offsets(m_block_h, m_block_w);
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  block_offsets = i * (int)m_block_w + j;
+  blitz::Array<int,1> zigzag_offsets(m_n_dct_coefs);
+  zigzag(block_offsets, zigzag_offsets);
+  offsets.assign(zigzag_offsets.begin(), zigzag_offsets.end());
+}
+
+void bob::ip::DCTFeatures::extract(const blitz::Array<double,2>& src,
+  blitz::Array<double,2>& dst, const std::vector<int>& zigzag,
+  blitz::Array<double,3>& blocks) const
+{
+  // Determine the number of block per row and column
+  const int block_h = m_block_h;
+  const int block_w = m_block_w;
+  const int block_size = block_h * block_w;
+  const int size_ov_h = block_h - (int)m_overlap_h;
+  const int size_ov_w = block_w - (int)m_overlap_w;
+  const int n_blocks_h = (src.extent(0) - (int)m_overlap_h) / size_ov_h;
+  const int n_blocks_w = (src.extent(1) - (int)m_overlap_w) / size_ov_w;
+  const int n_blocks = n_blocks_h * n_blocks_w;
+  if (n_blocks == 0) return;
+  if (blocks.extent(0) != n_blocks || blocks.extent(1) != block_h ||
+      blocks.extent(2) != block_w)
+    blocks.resize(n_blocks, block_h, block_w);
+
+  // Gather all the blocks (normalized if required) in the contiguous buffer
+  const int src_s0 = src.stride(0);
+  const int src_s1 = src.stride(1);
+  double* block = blocks.data();
+  for (int h=0; h<n_blocks_h; ++h)
+    for (int w=0; w<n_blocks_w; ++w, block+=block_size) {
+      const double* s = src.data() + h*size_ov_h*src_s0 + w*size_ov_w*src_s1;
+      for (int y=0; y<block_h; ++y, s+=src_s0) {
+        double* b = block + y*block_w;
+        for (int x=0; x<block_w; ++x) b[x] = s[x*src_s1];
+      }
+
+      if (m_norm_block) {
+        double sum = 0.;
+        for (int k=0; k<block_size; ++k) sum += block[k];
+        const double mean = sum / block_size;
+        double var = 0.;
+        for (int k=0; k<block_size; ++k) 
+          var += (block[k] - mean) * (block[k] - mean);
+        var /= block_size;
+        double stddev = 1.;
+        if (var != 0.) stddev = sqrt(var);
+        for (int k=0; k<block_size; ++k) block[k] = (block[k] - mean) / stddev;
+      }
+    }
+
+  // DCT of all the blocks at once, in place
+  m_dct2d->operator()(blocks, blocks);
+
+  // Extract the required number of coefficients using the zigzag pattern
+  const int n_coefs = zigzag.size();
+  const int dst_s0 = dst.stride(0);
+  const int dst_s1 = dst.stride(1);
+  block = blocks.data();
+  for (int i=0; i<n_blocks; ++i, block+=block_size) {
+    double* d = dst.data() + i*dst_s0;
+    for (int k=0; k<n_coefs; ++k) d[k*dst_s1] = block[zigzag[k]];
+  }
+
+  // Normalize dct if required, accumulating the statistics of all the
+  // coefficients row by row
+  if (m_norm_dct) {
+    std::vector<double> mean(n_coefs, 0.), stddev(n_coefs, 0.);
+    for (int i=0; i<n_blocks; ++i) {
+      const double* d = dst.data() + i*dst_s0;
+      for (int k=0; k<n_coefs; ++k) mean[k] += d[k*dst_s1];
+    }
+    for (int k=0; k<n_coefs; ++k) mean[k] /= n_blocks;
+    for (int i=0; i<n_blocks; ++i) {
+      const double* d = dst.data() + i*dst_s0;
+      for (int k=0; k<n_coefs; ++k) 
+        stddev[k] += (d[k*dst_s1] - mean[k]) * (d[k*dst_s1] - mean[k]);
+    }
+    for (int k=0; k<n_coefs; ++k) {
+      stddev[k] /= n_blocks;
+      stddev[k] = (stddev[k] == 0. ? 1. : sqrt(stddev[k]));
+    }
+    for (int i=0; i<n_blocks; ++i) {
+      double* d = dst.data() + i*dst_s0;
+      for (int k=0; k<n_coefs; ++k)
+        d[k*dst_s1] = (d[k*dst_s1] - mean[k]) / stddev[k];
+    }
+  }
+}
+
 template <> 
 void bob::ip::DCTFeatures::operator()<double>(const blitz::Array<double,2>& src, 
   blitz::Array<double, 2>& dst) const
@@ -84,44 +171,8 @@ void bob::ip::DCTFeatures::operator()<double>(const blitz::Array<double,2>& src,
   bob::core::array::assertZeroBase(dst);
   blitz::TinyVector<int,2> shape(getNBlocks(src), m_n_dct_coefs);
   bob::core::array::assertSameShape(dst, shape);
- 
-  // get all the blocks
-  std::list<blitz::Array<double,2> > blocks;
-  blockReference(src, blocks, m_block_h, m_block_w, m_overlap_h, m_overlap_w);
- 
-  /// dct extract each block
-  int i=0;
-  for(std::list<blitz::Array<double,2> >::const_iterator it = blocks.begin();
-    it != blocks.end(); ++it, ++i) 
-  {
-    // Normalize block if required and extract DCT for the current block
-    if(m_norm_block)
-    {
-      double mean = blitz::mean(*it);
-      double var = blitz::sum(blitz::pow2(*it - mean)) / (double)(m_block_h * m_block_w);
-      double std = 1.;
-      if(var != 0.) std = sqrt(var);
-      m_cache_block1 = (*it - mean) / std;
-      m_dct2d->operator()(m_cache_block1, m_cache_block2);
-    }
-    else
-      m_dct2d->operator()(bob::core::array::ccopy(*it), m_cache_block2);
-
-    // Extract the required number of coefficients using the zigzag pattern
-    // and push it in the right dst row
-    blitz::Array<double,1> dst_row = dst(i, blitz::Range::all());
-    zigzag(m_cache_block2, dst_row);
-  }
 
-  // Normalize dct if required
-  if(m_norm_dct)
-  {
-    blitz::firstIndex i;
-    blitz::secondIndex j;
-    m_cache_dct1 = blitz::mean(dst(j,i), j); // mean
-    m_cache_dct2 = blitz::sum(blitz::pow2(dst(j,i) - m_cache_dct1(i)),j) / (double)(dst.extent(0));
-    m_cache_dct2 = blitz::where(m_cache_dct2 == 0., 1., blitz::sqrt(m_cache_dct2));
-    dst = (dst(i,j) - m_cache_dct1(j)) / m_cache_dct2(j);
-  }
+  std::vector<int> zigzag;
+  zigzagOffsets(zigzag);
+  extract(src, dst, zigzag, m_cache_blocks);
 }
-
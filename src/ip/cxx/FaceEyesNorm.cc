@@ -99,3 +99,18 @@ bob::ip::FaceEyesNorm::operator!=(const bob::ip::FaceEyesNorm& b) const
 }
 
 
+
+void bob::ip::FaceEyesNorm::setupGeomNorm(bob::ip::GeomNorm& geom_norm,
+  const double e1_y, const double e1_x, const double e2_y, const double e2_x,
+  double& center_y, double& center_x) const
+{
+  // Get angle to horizontal
+  geom_norm.setRotationAngle(getAngleToHorizontal(e1_y, e1_x, e2_y, e2_x) - m_eyes_angle);
+
+  // Get scaling factor
+  geom_norm.setScalingFactor(m_eyes_distance / sqrt( (e1_y-e2_y)*(e1_y-e2_y) + (e1_x-e2_x)*(e1_x-e2_x) ));
+
+  // Get the center (of the eye centers segment)
+  center_y = (e1_y + e2_y) / 2.;
+  center_x = (e1_x + e2_x) / 2.;
+}
@@ -64,6 +64,7 @@ bob::ip::Gaussian::operator=(const bob::ip::Gaussian& other)
     m_sigma_y = other.m_sigma_y;
     m_sigma_x = other.m_sigma_x;
     m_conv_border = other.m_conv_border;
+    m_recursive = other.m_recursive;
     computeKernel();
   }
   return *this;
@@ -74,7 +75,8 @@ bob::ip::Gaussian::operator==(const bob::ip::Gaussian& b) const
 {
   return (this->m_radius_y == b.m_radius_y && this->m_radius_x == b.m_radius_x && 
           this->m_sigma_y == b.m_sigma_y && this->m_sigma_x == b.m_sigma_x && 
-          this->m_conv_border == b.m_conv_border);
+          this->m_conv_border == b.m_conv_border &&
+          this->m_recursive == b.m_recursive);
 }
 
 bool 
@@ -88,31 +90,12 @@ void bob::ip::Gaussian::operator()<double>(const blitz::Array<double,2>& src,
    blitz::Array<double,2>& dst)
 {
   // Checks are postponed to the convolution function.
-  if(m_conv_border == bob::sp::Extrapolation::Zero)
-  {
-    m_tmp_int.resize(bob::sp::getConvSepOutputSize(src, m_kernel_y, 0, bob::sp::Conv::Same));
-    bob::sp::convSep(src, m_kernel_y, m_tmp_int, 0, bob::sp::Conv::Same);
-    bob::sp::convSep(m_tmp_int, m_kernel_x, dst, 1, bob::sp::Conv::Same);
-  }
+  // Constant borders have always been handled as Mirror by this class.
+  const bob::sp::Extrapolation::BorderType border =
+    m_conv_border == bob::sp::Extrapolation::Constant ?
+    bob::sp::Extrapolation::Mirror : m_conv_border;
+  if(m_recursive && m_sigma_y >= 0.5 && m_sigma_x >= 0.5)
+    bob::sp::recursiveGaussian(src, m_sigma_y, m_sigma_x, dst, border);
   else
-  {
-    m_tmp_int1.resize(bob::sp::getConvSepOutputSize(src, m_kernel_y, 0, bob::sp::Conv::Full));
-    if(m_conv_border == bob::sp::Extrapolation::NearestNeighbour)
-      bob::sp::extrapolateNearest(src, m_tmp_int1);
-    else if(m_conv_border == bob::sp::Extrapolation::Circular)
-      bob::sp::extrapolateCircular(src, m_tmp_int1);
-    else
-      bob::sp::extrapolateMirror(src, m_tmp_int1);
-    m_tmp_int.resize(bob::sp::getConvSepOutputSize(m_tmp_int1, m_kernel_y, 0, bob::sp::Conv::Valid));
-    bob::sp::convSep(m_tmp_int1, m_kernel_y, m_tmp_int, 0, bob::sp::Conv::Valid);
-
-    m_tmp_int2.resize(bob::sp::getConvSepOutputSize(m_tmp_int, m_kernel_x, 1, bob::sp::Conv::Full));
-    if(m_conv_border == bob::sp::Extrapolation::NearestNeighbour)
-      bob::sp::extrapolateNearest(m_tmp_int, m_tmp_int2);
-    else if(m_conv_border == bob::sp::Extrapolation::Circular)
-      bob::sp::extrapolateCircular(m_tmp_int, m_tmp_int2);
-    else
-      bob::sp::extrapolateMirror(m_tmp_int, m_tmp_int2);
-    bob::sp::convSep(m_tmp_int2, m_kernel_x, dst, 1, bob::sp::Conv::Valid);
-  }
+    bob::sp::convSep2D(src, m_kernel_y, m_kernel_x, dst, border);
 }
@@ -21,6 +21,7 @@
  */
 
 #include "bob/ip/GeomNorm.h"
+#include <algorithm>
 
 bob::ip::GeomNorm::GeomNorm( const double rotation_angle, const double scaling_factor,
     const size_t crop_height, const size_t crop_width, const double crop_offset_h,
@@ -89,3 +90,123 @@ bob::ip::GeomNorm::operator()(const blitz::TinyVector<double,2>& position,
   );
 
 }
+
+void bob::ip::GeomNorm::getTransform(const double rot_c_y, const double rot_c_x,
+  double& origin_y, double& origin_x, double& dy, double& dx) const
+{
+  // transformation center in original image
+  const double original_center_x = rot_c_x, 
+               original_center_y = rot_c_y;
+  // transformation center in new image:
+  const double new_center_x = m_crop_offset_w, 
+               new_center_y = m_crop_offset_h;
+
+  // With these positions, we can define a mapping from the new image to the original image
+  const double sin_angle = -sin(m_rotation_angle * M_PI / 180.), 
+               cos_angle = cos(m_rotation_angle * M_PI / 180.);
+  // we compute the distance in the source image, when going 1 pixel in the new image
+  dx = cos_angle / m_scaling_factor;
+  dy = -sin_angle / m_scaling_factor;
+
+  // the (0,0) position of the target image in source image coordinates
+  origin_x = original_center_x - (cos_angle * new_center_x + sin_angle * new_center_y) / m_scaling_factor;
+  origin_y = original_center_y - (cos_angle * new_center_y - sin_angle * new_center_x) / m_scaling_factor;
+}
+
+/**
+ * Restricts the real interval [t0, t1) to the values of t for which
+ * lo <= a + t*d < hi
+ */
+static void clip_interval(const double a, const double d, const double lo,
+  const double hi, double& t0, double& t1)
+{
+  if (d > 0.) {
+    t0 = std::max(t0, (lo - a) / d);
+    t1 = std::min(t1, (hi - a) / d);
+  }
+  else if (d < 0.) {
+    t0 = std::max(t0, (hi - a) / d);
+    t1 = std::min(t1, (lo - a) / d);
+  }
+  else if (a < lo || a >= hi) t1 = t0 - 1.;
+}
+
+/**
+ * The upper bounds are lowered by this margin, so that the positions of the
+ * interior span are guaranteed to stay inside the image even if the
+ * compiler evaluates them slightly differently (e.g. with fused
+ * multiply-adds) in the interpolation loop
+ */
+static const double s_interior_margin = 1e-6;
+
+static inline bool is_interior(const double row_y, const double row_x,
+  const double dy, const double dx, const double max_y, const double max_x,
+  const int x)
+{
+  const double sy = row_y + x * dy;
+  const double sx = row_x + x * dx;
+  return sy >= 0. && sx >= 0. && sy < max_y && sx < max_x;
+}
+
+void bob::ip::detail::geomNormInteriorSpan(const double row_y,
+  const double row_x, const double dy, const double dx, const int height,
+  const int width, const int target_width, int& begin, int& end)
+{
+  begin = end = 0;
+  if (height < 2 || width < 2 || target_width <= 0) return;
+  const double max_y = (height - 1) - s_interior_margin;
+  const double max_x = (width - 1) - s_interior_margin;
+
+  // Estimates the span from the linear constraints, one pixel larger on
+  // each side to account for the rounding of the bounds...
+  double t0 = 0., t1 = target_width;
+  clip_interval(row_y, dy, 0., max_y, t0, t1);
+  clip_interval(row_x, dx, 0., max_x, t0, t1);
+  if (!(t0 <= t1 + 1.)) return;
+  begin = (int)std::min(std::floor(t0), (double)target_width);
+  end = (int)std::max(std::min(std::floor(t1) + 1., (double)target_width),
+    (double)begin);
+
+  // ... and adjusts it with the exact test on the rounded positions. The
+  // positions being monotonic in x, the interior pixels form a single span.
+  while (begin < end && !is_interior(row_y, row_x, dy, dx, max_y, max_x, begin))
+    ++begin;
+  while (end > begin && !is_interior(row_y, row_x, dy, dx, max_y, max_x, end-1))
+    --end;
+  if (begin == end) {
+    begin = end = 0;
+    return;
+  }
+  while (begin > 0 && is_interior(row_y, row_x, dy, dx, max_y, max_x, begin-1))
+    --begin;
+  while (end < target_width && is_interior(row_y, row_x, dy, dx, max_y, max_x, end))
+    ++end;
+}
+
+void bob::ip::detail::geomNormInterior(const blitz::Array<uint8_t,2>& source,
+  uint8_t* target, const int target_stride, const double row_y,
+  const double row_x, const double dy, const double dx, const int begin,
+  const int end)
+{
+  // weights with 10 fractional bits: the sum of the four products (at
+  // most 2^20 * 255) fits in 32 bits
+  static const int bits = 10;
+  static const int one = 1 << bits;
+  static const int half = 1 << (2*bits - 1);
+  const uint8_t* src = source.data();
+  const int s0 = source.stride(0);
+  const int s1 = source.stride(1);
+  for (int x = begin; x < end; ++x){
+    const double sy = row_y + x * dy;
+    const double sx = row_x + x * dx;
+    const int oy = (int)sy;
+    const int ox = (int)sx;
+    const int fy = (int)((sy - oy) * one + 0.5);
+    const int fx = (int)((sx - ox) * one + 0.5);
+    const uint8_t* p = src + oy * s0 + ox * s1;
+    const int top = (one - fx) * p[0] + fx * p[s1];
+    const int bottom = (one - fx) * p[s0] + fx * p[s0 + s1];
+    target[x * target_stride] = 
+      (uint8_t)(((one - fy) * top + fy * bottom + half) >> (2*bits));
+  }
+}
@@ -70,6 +70,16 @@ boost::shared_ptr<ip::LBP> ip::LBP4R::clone() const {
   return boost::make_shared<ip::LBP4R>(*this);
 }
 
+void ip::LBP4R::getSampling(double* dy, double* dx) const
+{
+  const double R = (m_circular ? m_R : m_R_rect);
+  const double R2 = (m_circular ? m_R2 : m_R2_rect);
+  dy[0] = -R; dx[0] = 0.;
+  dy[1] = 0.; dx[1] = R2;
+  dy[2] = R;  dx[2] = 0.;
+  dy[3] = 0.; dx[3] = -R2;
+}
+
 int ip::LBP4R::getMaxLabel() const
 {
   return  (m_rotation_invariant ? 6 :
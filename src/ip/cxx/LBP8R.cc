@@ -69,6 +69,48 @@ boost::shared_ptr<ip::LBP> ip::LBP8R::clone() const {
   return boost::make_shared<ip::LBP8R>(*this);
 }
 
+void ip::LBP8R::getSampling(double* dy, double* dx) const
+{
+  if(!m_circular)
+  {
+    const double R = m_R_rect, R2 = m_R2_rect;
+    dy[0] = -R; dx[0] = -R2;
+    dy[1] = -R; dx[1] = 0.;
+    dy[2] = -R; dx[2] = R2;
+    dy[3] = 0.; dx[3] = R2;
+    dy[4] = R;  dx[4] = R2;
+    dy[5] = R;  dx[5] = 0.;
+    dy[6] = R;  dx[6] = -R2;
+    dy[7] = 0.; dx[7] = -R2;
+  }
+  else if(m_R == m_R2)
+  {
+    const double R_sqrt2 = m_R / sqrt(2);
+    dy[0] = -R_sqrt2; dx[0] = -R_sqrt2;
+    dy[1] = -m_R;     dx[1] = 0.;
+    dy[2] = -R_sqrt2; dx[2] = R_sqrt2;
+    dy[3] = 0.;       dx[3] = m_R;
+    dy[4] = R_sqrt2;  dx[4] = R_sqrt2;
+    dy[5] = m_R;      dx[5] = 0.;
+    dy[6] = R_sqrt2;  dx[6] = -R_sqrt2;
+    dy[7] = 0.;       dx[7] = -m_R;
+  }
+  else
+  {
+    /*An ellipse*/
+    const double PI = 4.0*atan(1.0);
+    /*The elipse navigation was extracted from the book "Computer Vision using LocalBinary Patterns" page 56. In their implementation the first bin is the top-center and the bob implementation is top-left. By that reason the first bin initialized was 7*/
+    dy[0] = -m_R*cos(2*PI*7/m_P); dx[0] = m_R2*sin(2*PI*7/m_P);
+    dy[1] = -m_R;                 dx[1] = 0.;
+    dy[2] = -m_R*cos(2*PI*1/m_P); dx[2] = m_R2*sin(2*PI*1/m_P);
+    dy[3] = 0.;                   dx[3] = m_R;
+    dy[4] = -m_R*cos(2*PI*3/m_P); dx[4] = m_R2*sin(2*PI*3/m_P);
+    dy[5] = m_R;                  dx[5] = 0.;
+    dy[6] = -m_R*cos(2*PI*5/m_P); dx[6] = m_R2*sin(2*PI*5/m_P);
+    dy[7] = 0.;                   dx[7] = -m_R;
+  }
+}
+
 int ip::LBP8R::getMaxLabel() const
 {
 return  (m_rotation_invariant ?
@@ -103,30 +103,28 @@ bob::ip::TanTriggs::performContrastEqualization(blitz::Array<double,2>& dst)
 
 void bob::ip::TanTriggs::computeDoG(double sigma0, double sigma1, size_t size)
 {
-  // Generates two Gaussians with the given standard deviations
+  // Generates two Gaussians with the given standard deviations, as the
+  // products of 1D Gaussians (which are used by the convolution)
   // Warning: size should be odd
-  blitz::Array<double,2> g0(size,size);
-  blitz::Array<double,2> g1(size,size);
+  m_kernel0.resize(size);
+  m_kernel1.resize(size);
   const double inv_sigma0_2 = 0.5  / (sigma0*sigma0);
   const double inv_sigma1_2 = 0.5  / (sigma1*sigma1);
   int center = ((int)size) / 2;
-  for(int y=0; y<(int)size; ++y)
-    for(int x=0; x<(int)size; ++x)
-    {
-      int yy = y - center;
-      int xx = x - center;
-      int xx2 = xx*xx;
-      int yy2 = yy*yy;
-
-      g0(y,x) = exp( - inv_sigma0_2 * (xx2 + yy2) );
-      g1(y,x) = exp( - inv_sigma1_2 * (xx2 + yy2) );
-    }
+  for(int x=0; x<(int)size; ++x)
+  {
+    int xx = x - center;
+    int xx2 = xx*xx;
+    m_kernel0(x) = exp( - inv_sigma0_2 * xx2 );
+    m_kernel1(x) = exp( - inv_sigma1_2 * xx2 );
+  }
 
   // Normalize the kernels such that the sum over the area is equal to 1
   // and compute the Difference of Gaussian filter
-  const double inv_sum0 = 1. / blitz::sum(g0);
-  const double inv_sum1 = 1. / blitz::sum(g1);
+  m_kernel0 /= blitz::sum(m_kernel0);
+  m_kernel1 /= blitz::sum(m_kernel1);
+  blitz::firstIndex i;
+  blitz::secondIndex j;
   m_kernel.resize( size, size);
-  m_kernel = inv_sum0 * g0 - inv_sum1 * g1;
+  m_kernel = m_kernel0(i) * m_kernel0(j) - m_kernel1(i) * m_kernel1(j);
 }
-
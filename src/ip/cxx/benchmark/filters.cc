@@ -0,0 +1,181 @@
+/**
+ * @file ip/cxx/benchmark/filters.cc
+ * @date Fri 16 Oct 2026 18:10:37 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Benchmarks of the Gaussian, LBP, GeomNorm and Gabor wavelet
+ * operators
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOB_BENCHMARK_SUITE "ip"
+#define BOB_BENCHMARK_MAIN
+#include "bob/core/benchmark.h"
+
+#include "bob/ip/Gaussian.h"
+#include "bob/ip/LBP8R.h"
+#include "bob/ip/GeomNorm.h"
+#include "bob/ip/FaceEyesNorm.h"
+#include "bob/ip/DCTFeatures.h"
+#include "bob/ip/GaborWaveletTransform.h"
+
+namespace bench = bob::core::benchmark;
+
+template <typename U>
+struct GeomNormOp {
+  const bob::ip::GeomNorm* op;
+  const blitz::Array<uint8_t,2>* src;
+  blitz::Array<U,2>* dst;
+  double rot_c_y;
+  double rot_c_x;
+  void operator()() const { (*op)(*src, *dst, rot_c_y, rot_c_x); }
+};
+
+template <typename U>
+struct FaceEyesNormBatch {
+  const bob::ip::FaceEyesNorm* op;
+  const blitz::Array<uint8_t,2>* src;
+  const blitz::Array<double,2>* eyes;
+  blitz::Array<U,3>* dst;
+  void operator()() const { (*op)(*src, *eyes, *dst); }
+};
+
+struct GaborTransform {
+  bob::ip::GaborWaveletTransform* gwt;
+  const blitz::Array<std::complex<double>,2>* src;
+  blitz::Array<std::complex<double>,3>* dst;
+  void operator()() const { gwt->performGWT(*src, *dst); }
+};
+
+struct GaborJetImage {
+  bob::ip::GaborWaveletTransform* gwt;
+  const blitz::Array<std::complex<double>,2>* src;
+  blitz::Array<double,3>* dst;
+  void operator()() const { gwt->computeJetImage(*src, *dst, true); }
+};
+
+static void gaussian(bench::Suite& suite, const blitz::Array<uint8_t,2>& image,
+    const blitz::Array<double,2>& image_d) {
+  const int h = image.extent(0);
+  const int w = image.extent(1);
+  blitz::Array<double,2> dst(h, w);
+  const size_t radii[] = {1, 3, 7};
+  for (size_t i=0; i<sizeof(radii)/sizeof(size_t); ++i) {
+    const size_t r = radii[i];
+    bob::ip::Gaussian gaussian(r, r, r/2. + 0.5, r/2. + 0.5);
+    suite.run((boost::format("gaussian/uint8/%dx%d/r%d") % h % w % r).str(),
+        bench::apply(gaussian, image, dst), h*w, h*w*sizeof(uint8_t));
+    suite.run((boost::format("gaussian/float64/%dx%d/r%d") % h % w % r).str(),
+        bench::apply(gaussian, image_d, dst), h*w, h*w*sizeof(double));
+  }
+}
+
+static void lbp(bench::Suite& suite, const blitz::Array<uint8_t,2>& image) {
+  const int h = image.extent(0);
+  const int w = image.extent(1);
+
+  bob::ip::LBP8R lbp(1.);
+  blitz::Array<uint16_t,2> dst(lbp.getLBPShape(image));
+  suite.run((boost::format("lbp8r/%dx%d") % h % w).str(),
+      bench::apply(lbp, image, dst), h*w, h*w*sizeof(uint8_t));
+
+  bob::ip::LBP8R ulbp(2., true, false, false, true);
+  dst.resize(ulbp.getLBPShape(image));
+  suite.run((boost::format("lbp8r/%dx%d/circular-uniform-r2") % h % w).str(),
+      bench::apply(ulbp, image, dst), h*w, h*w*sizeof(uint8_t));
+}
+
+static void geomnorm(bench::Suite& suite, const blitz::Array<uint8_t,2>& image) {
+  const int crop = 80;
+  blitz::Array<double,2> dst(crop, crop);
+  bob::ip::GeomNorm geomnorm(-10., 0.65, crop, crop, crop/2, crop/2);
+  GeomNormOp<double> op = {&geomnorm, &image, &dst, image.extent(0)/2.,
+    image.extent(1)/2.};
+  suite.run((boost::format("geomnorm/%dx%d") % crop % crop).str(), op,
+      crop*crop, crop*crop*sizeof(double));
+
+  blitz::Array<uint8_t,2> dst_u(crop, crop);
+  GeomNormOp<uint8_t> op_u = {&geomnorm, &image, &dst_u, image.extent(0)/2.,
+    image.extent(1)/2.};
+  suite.run((boost::format("geomnorm/%dx%d/uint8") % crop % crop).str(), op_u,
+      crop*crop, crop*crop*sizeof(uint8_t));
+
+  // a crowded frame: 32 faces, with eyes 20 pixels apart
+  const int n_faces = 32;
+  blitz::Array<double,2> eyes(n_faces, 4);
+  for (int f=0; f<n_faces; ++f) {
+    const double y = 40. + 50. * (f / 8), x = 40. + 70. * (f % 8);
+    eyes(f,0) = y; eyes(f,1) = x; eyes(f,2) = y + 2.; eyes(f,3) = x + 20.;
+  }
+  bob::ip::FaceEyesNorm facenorm(33., crop, crop, crop/3., crop/2.);
+  blitz::Array<uint8_t,3> faces(n_faces, crop, crop);
+  FaceEyesNormBatch<uint8_t> batch = {&facenorm, &image, &eyes, &faces};
+  suite.run((boost::format("faceeyesnorm-batch/%dx%dx%d/uint8") % n_faces %
+        crop % crop).str(), batch, n_faces*crop*crop,
+      n_faces*crop*crop*sizeof(uint8_t));
+}
+
+static void dct_features(bench::Suite& suite, const blitz::Array<double,2>& face) {
+  const int h = face.extent(0);
+  const int w = face.extent(1);
+  // dense (stride 1) blocks, as used by part-based face recognition
+  const size_t blocks[] = {8, 12};
+  for (size_t i=0; i<sizeof(blocks)/sizeof(size_t); ++i) {
+    const size_t b = blocks[i];
+    bob::ip::DCTFeatures dct(b, b, b-1, b-1, 45, true, true);
+    blitz::Array<double,2> dst(dct.getNBlocks(face), 45);
+    suite.run((boost::format("dct-features/%dx%d/%dx%d-stride1") % h % w % b %
+          b).str(), bench::apply(dct, face, dst), dst.extent(0),
+        h*w*sizeof(double));
+  }
+}
+
+static void gabor(bench::Suite& suite, const blitz::Array<double,2>& image_d) {
+  const int h = image_d.extent(0);
+  const int w = image_d.extent(1);
+  blitz::Array<std::complex<double>,2> src(h, w);
+  src = image_d;
+  bob::ip::GaborWaveletTransform gwt;
+  const int k = gwt.numberOfKernels();
+
+  blitz::Array<std::complex<double>,3> trafo(k, h, w);
+  GaborTransform transform = {&gwt, &src, &trafo};
+  suite.run((boost::format("gwt/%dx%d/%dkernels") % h % w % k).str(),
+      transform, h*w, h*w*sizeof(double));
+
+  blitz::Array<double,3> jets(h, w, k);
+  GaborJetImage jet_image = {&gwt, &src, &jets};
+  suite.run((boost::format("gwt-jet-image/%dx%d/%dkernels") % h % w % k).str(),
+      jet_image, h*w, h*w*sizeof(double));
+}
+
+void bob_benchmark(bench::Suite& suite) {
+  // a synthetic 8-bit gray-scale image of the size of a VGA frame
+  blitz::Array<uint8_t,2> image(480, 640);
+  bench::randomize(image, 0., 256.);
+  blitz::Array<double,2> image_d(image.shape());
+  image_d = blitz::cast<double>(image);
+
+  gaussian(suite, image, image_d);
+  lbp(suite, image);
+  geomnorm(suite, image);
+
+  // the Gabor wavelet transform is run on a (smaller) face sized image
+  blitz::Array<double,2> face(128, 128);
+  face = image_d(blitz::Range(0,127), blitz::Range(0,127));
+  gabor(suite, face);
+  dct_features(suite, face(blitz::Range(0,79), blitz::Range(0,63)));
+}
@@ -27,6 +27,7 @@
 #include "bob/ip/LBP.h"
 #include "bob/ip/LBP4R.h"
 #include "bob/ip/LBP8R.h"
+#include "bob/core/cast.h"
 
 #include <iostream>
 
@@ -109,5 +110,62 @@ BOOST_AUTO_TEST_CASE( test_lbp81_2d_uint8 )
   BOOST_CHECK_EQUAL( c1, lbpcirc(a1,1,1) );
   BOOST_CHECK_EQUAL( c2, lbpcirc(a2,1,1) );
 }
-  
+
+template <typename T, typename U>
+void check_image(const T& lbp, const blitz::Array<U,2>& src)
+{
+  blitz::Array<uint16_t,2> dst(lbp.getLBPShape(src));
+  lbp(src, dst);
+  const int by = (src.extent(0) - dst.extent(0)) / 2;
+  const int bx = (src.extent(1) - dst.extent(1)) / 2;
+  for( int y=0; y<dst.extent(0); ++y)
+    for( int x=0; x<dst.extent(1); ++x)
+      BOOST_CHECK_EQUAL( dst(y,x), lbp(src, by+y, bx+x) );
+}
+
+template <typename T>
+void check_image_variants(const blitz::Array<uint8_t,2>& src)
+{
+  const blitz::Array<double,2> src_d = bob::core::cast<double>(src);
+  const double radii[] = {1., 1.5, 2.};
+  for( int r=0; r<3; ++r)
+    for( int v=0; v<16; ++v)
+      for( int e=0; e<3; ++e)
+      {
+        // (the average bit is only defined for the averaged variants)
+        const bool circular = v & 1, to_average = v & 2, 
+              add_average_bit = to_average && (v & 4), uniform = v & 8;
+        T lbp( radii[r], circular, to_average, add_average_bit, uniform, 
+            false, e);
+        check_image( lbp, src);
+        check_image( lbp, src_d);
+        T lbp_ri( radii[r], circular, to_average, add_average_bit, uniform, 
+            true, e);
+        check_image( lbp_ri, src);
+      }
+  // elliptic sampling
+  T lbp( 1., 2., true);
+  check_image( lbp, src);
+}
+
+BOOST_AUTO_TEST_CASE( test_lbp_2d_image )
+{
+  // Whole image computation vs. pixel by pixel computation, on an image
+  // with flat regions (where the interpolated values are close to the 
+  // central ones) and texture
+  blitz::Array<uint8_t,2> src(20,31);
+  for( int y=0; y<src.extent(0); ++y)
+    for( int x=0; x<src.extent(1); ++x)
+      src(y,x) = (y < 8 ? 100 : static_cast<uint8_t>((37*y + 11*x*x) % 251));
+
+  check_image_variants<bob::ip::LBP4R>(src);
+  check_image_variants<bob::ip::LBP8R>(src);
+
+  // non contiguous input
+  blitz::Array<uint8_t,2> src_t(src.extent(1), src.extent(0));
+  blitz::Array<uint8_t,2> src_v = src_t.transpose(1,0);
+  src_v = src;
+  check_image( bob::ip::LBP8R(1., true), src_v);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
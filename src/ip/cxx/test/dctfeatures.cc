@@ -95,6 +95,45 @@ void checkBlitzClose( const blitz::Array<T,2>& t1, const blitz::Array<T,2>& t2,
     for( int j=0; j<t1.extent(1); ++j)
       BOOST_CHECK_SMALL( fabs(t1(i,j)-t2(i,j)), eps);
 }
+/**
+ * Reference: DCT of each block one by one, followed by the normalization of
+ * the coefficients
+ */
+void dct_reference(const blitz::Array<double,2>& src, const int block_h,
+  const int block_w, const int overlap_h, const int overlap_w,
+  const int n_dct_coefs, const bool norm_block, const bool norm_dct,
+  blitz::Array<double,2>& dst)
+{
+  std::vector<blitz::Array<double,2> > blocks;
+  bob::ip::blockReference(src, blocks, block_h, block_w, overlap_h, overlap_w);
+  dst.resize(blocks.size(), n_dct_coefs);
+  bob::sp::DCT2D dct(block_h, block_w);
+  blitz::Array<double,2> block(block_h, block_w), coefs(block_h, block_w);
+  for(size_t b=0; b<blocks.size(); ++b)
+  {
+    block = blocks[b];
+    if(norm_block)
+    {
+      const double mean = blitz::mean(block);
+      const double var = blitz::mean(blitz::pow2(block - mean));
+      block = (block - mean) / (var == 0. ? 1. : sqrt(var));
+    }
+    dct(block, coefs);
+    blitz::Array<double,1> row = dst((int)b, blitz::Range::all());
+    bob::ip::zigzag(coefs, row);
+  }
+  if(norm_dct)
+  {
+    for(int k=0; k<n_dct_coefs; ++k)
+    {
+      blitz::Array<double,1> col = dst(blitz::Range::all(), k);
+      const double mean = blitz::mean(col);
+      const double var = blitz::mean(blitz::pow2(col - mean));
+      col = (col - mean) / (var == 0. ? 1. : sqrt(var));
+    }
+  }
+}
+
 BOOST_FIXTURE_TEST_SUITE( test_setup, T )
 
 
@@ -176,5 +215,52 @@ BOOST_AUTO_TEST_CASE( test_dct_feature_extract_block )
     checkBlitzClose(row, dst_mat[i], eps);
   }
 }
+
+BOOST_AUTO_TEST_CASE( test_dct_feature_extract_overlap )
+{
+  // Dense (stride 1) extraction on a non contiguous image
+  blitz::Array<double,2> image_t(23, 17);
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  image_t = 50. * blitz::sin(0.7*i + 0.1*j*j) + 3. * i;
+  blitz::Array<double,2> image = image_t.transpose(1,0);
+
+  for(int norm=0; norm<4; ++norm)
+  {
+    const bool norm_block = (norm & 1), norm_dct = (norm & 2);
+    bob::ip::DCTFeatures dctfeatures(8, 6, 7, 5, 15, norm_block, norm_dct);
+    blitz::Array<double,2> ref;
+    dct_reference(image, 8, 6, 7, 5, 15, norm_block, norm_dct, ref);
+    blitz::Array<double,2> dst(dctfeatures.getNBlocks(image), 15);
+    dctfeatures(image, dst);
+    checkBlitzClose(dst, ref, 1e-10);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_dct_feature_extract_images )
+{
+  // Several images of different sizes processed by several threads
+  std::vector<blitz::Array<uint8_t,2> > images;
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  for(int n=0; n<5; ++n)
+  {
+    blitz::Array<uint8_t,2> image(12 + n, 16 - n);
+    image = blitz::cast<uint8_t>(
+      100. + 80. * blitz::sin(0.3*(n+1)*i) * blitz::cos(0.2*j + n));
+    images.push_back(image);
+  }
+
+  bob::ip::DCTFeatures dctfeatures(4, 4, 2, 3, 10, true, true);
+  std::vector<blitz::Array<double,2> > dst;
+  dctfeatures(images, dst, 3);
+  BOOST_CHECK_EQUAL(dst.size(), images.size());
+  for(size_t n=0; n<images.size(); ++n)
+  {
+    blitz::Array<double,2> ref(dctfeatures.getNBlocks(images[n]), 10);
+    dctfeatures(images[n], ref);
+    checkBlitzClose(dst[n], ref, 1e-12);
+  }
+}
   
 BOOST_AUTO_TEST_SUITE_END()
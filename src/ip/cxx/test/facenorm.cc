@@ -191,4 +191,37 @@ BOOST_AUTO_TEST_CASE( test_facenorm3 )
   BOOST_CHECK_CLOSE(new_left_eye(1), 48., 1e-8);
 }
 
+BOOST_AUTO_TEST_CASE( test_facenorm_batch )
+{
+  // Several faces of a synthetic frame, normalized at once by several
+  // threads, should be identical to the faces normalized one by one
+  blitz::Array<uint8_t,2> frame(120, 160);
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  frame = blitz::cast<uint8_t>(127.5 + 127. * blitz::sin(0.11*i) * blitz::cos(0.07*j + 0.002*i*j));
+
+  blitz::Array<double,2> eyes(5,4);
+  eyes = 30., 40., 32., 60.,
+         50., 100., 45., 120.,
+         80., 20., 80., 45.,
+         100., 140., 110., 155.,
+         10., 10., 12., 30.;
+
+  bob::ip::FaceEyesNorm facenorm(20, 40, 40, 5/19.*40, 20);
+  blitz::Array<double,3> faces(5, 40, 40);
+  facenorm(frame, eyes, faces, 3);
+  blitz::Array<uint8_t,3> faces_u(5, 40, 40);
+  facenorm(frame, eyes, faces_u, 2);
+
+  blitz::Array<double,2> face(40, 40);
+  for (int f=0; f<5; ++f) {
+    facenorm(frame, face, eyes(f,0), eyes(f,1), eyes(f,2), eyes(f,3));
+    for (int y=0; y<40; ++y)
+      for (int x=0; x<40; ++x) {
+        BOOST_CHECK_EQUAL(faces(f,y,x), face(y,x));
+        BOOST_CHECK_SMALL(faces_u(f,y,x) - floor(face(y,x) + 0.5), 1.01);
+      }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -72,6 +72,41 @@ void checkBlitzClose( blitz::Array<T,2> t1, blitz::Array<T,2> t2,
 }
 
 
+/**
+ * Reference: bilinear interpolation of each target pixel with bounds checks
+ */
+template <typename T>
+void geomnorm_reference(const blitz::Array<T,2>& src, 
+  const blitz::Array<bool,2>& src_mask, blitz::Array<double,2>& dst,
+  blitz::Array<bool,2>& dst_mask, const double angle, const double scale,
+  const double offset_h, const double offset_w, const double rot_c_y,
+  const double rot_c_x)
+{
+  const double sin_angle = -sin(angle * M_PI / 180.),
+               cos_angle = cos(angle * M_PI / 180.);
+  const double dx = cos_angle / scale, dy = -sin_angle / scale;
+  const double origin_x = rot_c_x - (cos_angle * offset_w + sin_angle * offset_h) / scale;
+  const double origin_y = rot_c_y - (cos_angle * offset_h - sin_angle * offset_w) / scale;
+  for (int y = 0; y < dst.extent(0); ++y)
+    for (int x = 0; x < dst.extent(1); ++x) {
+      const double sy = origin_y + y * dx + x * dy;
+      const double sx = origin_x - y * dy + x * dx;
+      const int oy = (int)floor(sy), ox = (int)floor(sx);
+      const double my = sy - oy, mx = sx - ox;
+      double res = 0.;
+      bool valid = false;
+      for (int i = 0; i < 2; ++i)
+        for (int j = 0; j < 2; ++j)
+          if (oy+i >= 0 && oy+i < src.extent(0) && ox+j >= 0 && 
+              ox+j < src.extent(1) && src_mask(oy+i,ox+j)) {
+            res += (i ? my : 1.-my) * (j ? mx : 1.-mx) * src(oy+i,ox+j);
+            valid = true;
+          }
+      dst(y,x) = res;
+      dst_mask(y,x) = valid;
+    }
+}
+
 BOOST_FIXTURE_TEST_SUITE( test_setup, T )
 
 BOOST_AUTO_TEST_CASE( test_geomnorm )
@@ -177,4 +212,56 @@ BOOST_AUTO_TEST_CASE( test_geomnorm_with_points )
 
 }
 
+BOOST_AUTO_TEST_CASE( test_geomnorm_interior_and_border )
+{
+  // A synthetic image, with a mask, and crops falling partially outside of
+  // it (for several angles, including axis aligned ones)
+  blitz::Array<uint8_t,2> image(37, 45);
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  image = blitz::cast<uint8_t>(127.5 + 127. * blitz::sin(0.3*i) * blitz::cos(0.17*j + 0.01*i*j));
+  blitz::Array<double,2> image_d(image.shape());
+  image_d = blitz::cast<double>(image);
+  blitz::Array<bool,2> mask(image.shape()), full_mask(image.shape());
+  for (int y = 0; y < mask.extent(0); ++y)
+    for (int x = 0; x < mask.extent(1); ++x)
+      mask(y,x) = ((y + 2*x) % 7 != 0);
+  full_mask = true;
+
+  const double angles[] = {0., 90., -180., 10., -33.};
+  const double scales[] = {1., 0.65, 2.3};
+  for (int a = 0; a < 5; ++a)
+    for (int s = 0; s < 3; ++s) {
+      bob::ip::GeomNorm geomnorm(angles[a], scales[s], 50, 60, 25, 30);
+      blitz::Array<double,2> ref(50, 60), ref_masked(50, 60), dst(50, 60);
+      blitz::Array<bool,2> ref_mask(50, 60), dst_mask(50, 60);
+      geomnorm_reference(image, full_mask, ref, ref_mask, angles[a],
+        scales[s], 25, 30, 20, 21);
+      geomnorm_reference(image, mask, ref_masked, ref_mask, angles[a],
+        scales[s], 25, 30, 20, 21);
+
+      // double output
+      geomnorm(image, dst, 20, 21);
+      checkBlitzClose(dst, ref, 1e-8);
+      geomnorm(image_d, dst, 20, 21);
+      checkBlitzClose(dst, ref, 1e-8);
+
+      // float and uint8 outputs (the latter in fixed-point arithmetic)
+      blitz::Array<float,2> dst_f(50, 60);
+      geomnorm(image, dst_f, 20, 21);
+      blitz::Array<uint8_t,2> dst_u(50, 60);
+      geomnorm(image, dst_u, 20, 21);
+      for (int y = 0; y < 50; ++y)
+        for (int x = 0; x < 60; ++x) {
+          BOOST_CHECK_SMALL(dst_f(y,x) - ref(y,x), 1e-3);
+          BOOST_CHECK_SMALL(dst_u(y,x) - floor(ref(y,x) + 0.5), 1.01);
+        }
+
+      // with masks
+      geomnorm(image, mask, dst, dst_mask, 20, 21);
+      checkBlitzClose(dst, ref_masked, 1e-8);
+      checkBlitzEqual(dst_mask, ref_mask);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
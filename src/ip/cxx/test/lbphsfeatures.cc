@@ -28,6 +28,7 @@
 
 #include "bob/core/cast.h"
 #include "bob/ip/LBPHSFeatures.h"
+#include "bob/ip/integral.h"
 
 struct T {
   blitz::Array<uint32_t,2> src;
@@ -81,6 +82,14 @@ void checkBlitzClose( const blitz::Array<T,1>& t1, const blitz::Array<T,1>& t2,
     BOOST_CHECK_SMALL( fabs(t1(i)-t2(i)), eps);
 }
 
+template<typename T>  
+void checkBlitzEqual( const blitz::Array<T,1>& t1, const blitz::Array<T,1>& t2)
+{
+  BOOST_REQUIRE_EQUAL( t1.extent(0), t2.extent(0) );
+  for( int i=0; i<t1.extent(0); ++i)
+    BOOST_CHECK_EQUAL( t1(i), t2(i) );
+}
+
 BOOST_FIXTURE_TEST_SUITE( test_setup, T )
 
 BOOST_AUTO_TEST_CASE( test_lbphs_feature_extract )
@@ -100,5 +109,90 @@ BOOST_AUTO_TEST_CASE( test_lbphs_feature_extract )
     ++i;
   }
 }
-  
+
+/**
+ * Reference implementation: LBP codes and histogram of each block
+ */
+template <typename T>
+void lbphs_reference(const T& lbp, const blitz::Array<double,2>& src, 
+  const int block_h, const int block_w, const int overlap_h, 
+  const int overlap_w, std::vector<blitz::Array<uint64_t,1> >& dst)
+{
+  std::vector<blitz::Array<double,2> > blocks;
+  bob::ip::blockReference(src, blocks, block_h, block_w, overlap_h, overlap_w);
+  for(size_t i=0; i<blocks.size(); ++i)
+  {
+    blitz::Array<uint16_t,2> codes(lbp.getLBPShape(blocks[i]));
+    lbp(blocks[i], codes);
+    blitz::Array<uint64_t,1> histo(lbp.getMaxLabel());
+    histo = 0;
+    for(int y=0; y<codes.extent(0); ++y)
+      for(int x=0; x<codes.extent(1); ++x)
+        ++histo(codes(y,x));
+    dst.push_back(histo);
+  }
+}
+
+template <typename T>
+void check_overlap(const T& lbp, const blitz::Array<uint32_t,2>& src, 
+  const int block_h, const int block_w, const int overlap_h, 
+  const int overlap_w)
+{
+  std::vector<blitz::Array<uint64_t,1> > ref, dst;
+  lbphs_reference(lbp, bob::core::cast<double>(src), block_h, block_w, 
+    overlap_h, overlap_w, ref);
+  bob::ip::LBPHSFeatures lbphsfeatures(block_h, block_w, overlap_h, 
+    overlap_w, lbp.getRadius(), lbp.getNNeighbours(), lbp.getCircular(), 
+    lbp.getToAverage(), lbp.getAddAverageBit(), lbp.getUniform(), 
+    lbp.getRotationInvariant());
+  lbphsfeatures(src, dst);
+  BOOST_REQUIRE_EQUAL( dst.size(), ref.size() );
+  for(size_t i=0; i<dst.size(); ++i)
+    checkBlitzEqual( dst[i], ref[i] );
+}
+
+BOOST_AUTO_TEST_CASE( test_lbphs_feature_extract_overlap )
+{
+  // Overlapping blocks (the codes of the whole image are computed once)
+  const int layouts[][4] = {{5,5,0,0}, {4,6,3,2}, {6,6,5,5}, {3,3,1,1}, 
+    {10,10,0,0}, {2,2,1,1}};
+  for(int i=0; i<6; ++i)
+  {
+    const int* l = layouts[i];
+    check_overlap(bob::ip::LBP4R(1.), src, l[0], l[1], l[2], l[3]);
+    check_overlap(bob::ip::LBP4R(1., true), src, l[0], l[1], l[2], l[3]);
+    check_overlap(bob::ip::LBP8R(1.), src, l[0], l[1], l[2], l[3]);
+    check_overlap(bob::ip::LBP8R(1., false, false, false, true), src, 
+      l[0], l[1], l[2], l[3]);
+    check_overlap(bob::ip::LBP8R(2., false, false, false, true, true), src, 
+      l[0], l[1], l[2], l[3]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_integral_histogram )
+{
+  // Histograms of blocks of the integral histogram of LBP codes
+  bob::ip::LBP8R lbp(1., false, false, false, true);
+  const blitz::Array<double,2> src_d = bob::core::cast<double>(src);
+  blitz::Array<uint16_t,2> codes(lbp.getLBPShape(src_d));
+  lbp(src_d, codes);
+  blitz::Array<uint32_t,3> ih(codes.extent(0)+1, codes.extent(1)+1, 
+    lbp.getMaxLabel());
+  bob::ip::integralHistogram(codes, ih);
+
+  blitz::Array<uint64_t,1> histo(lbp.getMaxLabel()), ref(lbp.getMaxLabel());
+  for(int y=0; y<codes.extent(0); ++y)
+    for(int x=0; x<codes.extent(1); ++x)
+      for(int h=0; y+h<=codes.extent(0); h+=3)
+        for(int w=0; x+w<=codes.extent(1); w+=2)
+        {
+          bob::ip::integralHistogramBlock(ih, y, x, h, w, histo);
+          ref = 0;
+          for(int i=y; i<y+h; ++i)
+            for(int j=x; j<x+w; ++j)
+              ++ref(codes(i,j));
+          checkBlitzEqual( histo, ref );
+        }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
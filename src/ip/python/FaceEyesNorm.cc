@@ -27,15 +27,32 @@ using namespace boost::python;
 
 static const char* faceeyesnorm_doc = "Objects of this class, after configuration, can extract and normalize faces, given their eye center coordinates.";
 
-template <typename T> 
+template <typename T, typename U> 
 static void inner_call1(bob::ip::FaceEyesNorm& obj, 
   bob::python::const_ndarray input, bob::python::ndarray output,
   double e1y, double e1x, double e2y, double e2x)
 {
-  blitz::Array<double,2> output_ = output.bz<double,2>();
+  blitz::Array<U,2> output_ = output.bz<U,2>();
   obj(input.bz<T,2>(), output_, e1y, e1x, e2y, e2x);
 }
 
+template <typename T> 
+static void inner_call1(bob::ip::FaceEyesNorm& obj, 
+  bob::python::const_ndarray input, bob::python::ndarray output,
+  double e1y, double e1x, double e2y, double e2x)
+{
+  const bob::core::array::typeinfo& info = output.type();
+  switch (info.dtype) {
+    case bob::core::array::t_uint8: 
+      return inner_call1<T,uint8_t>(obj, input, output, e1y, e1x, e2y, e2x);
+    case bob::core::array::t_float32:
+      return inner_call1<T,float>(obj, input, output, e1y, e1x, e2y, e2x);
+    case bob::core::array::t_float64: 
+      return inner_call1<T,double>(obj, input, output, e1y, e1x, e2y, e2x);
+    default: PYTHON_ERROR(TypeError, "FaceEyesNorm __call__ does not support output array of type '%s'.", info.str().c_str());
+  }
+}
+
 static void call1(bob::ip::FaceEyesNorm& obj, bob::python::const_ndarray input,
     bob::python::ndarray output, double e1y, double e1x, double e2y, double e2x) 
 {
@@ -104,6 +121,53 @@ static void call2(bob::ip::FaceEyesNorm& obj, bob::python::const_ndarray input,
   }
 }
 
+template <typename T, typename U> 
+static void inner_call3(const bob::ip::FaceEyesNorm& obj, 
+  bob::python::const_ndarray input, bob::python::const_ndarray eyes,
+  bob::python::ndarray output, size_t n_threads)
+{
+  const blitz::Array<T,2> input_ = input.bz<T,2>();
+  const blitz::Array<double,2> eyes_ = eyes.bz<double,2>();
+  blitz::Array<U,3> output_ = output.bz<U,3>();
+  bob::python::no_gil unlock;
+  obj(input_, eyes_, output_, n_threads);
+}
+
+template <typename T> 
+static void inner_call3(const bob::ip::FaceEyesNorm& obj, 
+  bob::python::const_ndarray input, bob::python::const_ndarray eyes,
+  bob::python::ndarray output, size_t n_threads)
+{
+  const bob::core::array::typeinfo& info = output.type();
+  switch (info.dtype) {
+    case bob::core::array::t_uint8: 
+      return inner_call3<T,uint8_t>(obj, input, eyes, output, n_threads);
+    case bob::core::array::t_float32:
+      return inner_call3<T,float>(obj, input, eyes, output, n_threads);
+    case bob::core::array::t_float64: 
+      return inner_call3<T,double>(obj, input, eyes, output, n_threads);
+    default: PYTHON_ERROR(TypeError, "FaceEyesNorm __call__ does not support output array of type '%s'.", info.str().c_str());
+  }
+}
+
+static void call3(const bob::ip::FaceEyesNorm& obj,
+  bob::python::const_ndarray input, bob::python::const_ndarray eyes,
+  bob::python::ndarray output, size_t n_threads=1) 
+{
+  const bob::core::array::typeinfo& info = input.type();
+  switch (info.dtype) {
+    case bob::core::array::t_uint8: 
+      return inner_call3<uint8_t>(obj, input, eyes, output, n_threads);
+    case bob::core::array::t_uint16:
+      return inner_call3<uint16_t>(obj, input, eyes, output, n_threads);
+    case bob::core::array::t_float64: 
+      return inner_call3<double>(obj, input, eyes, output, n_threads);
+    default: PYTHON_ERROR(TypeError, "FaceEyesNorm __call__ does not support array of type '%s'.", info.str().c_str());
+  }
+}
+
+BOOST_PYTHON_FUNCTION_OVERLOADS(call3_overloads, call3, 4, 5)
+
 void bind_ip_faceeyesnorm() {
   class_<bob::ip::FaceEyesNorm, boost::shared_ptr<bob::ip::FaceEyesNorm> >("FaceEyesNorm", faceeyesnorm_doc, init<const double, const size_t, const size_t, const double, const double>((arg("eyes_distance"), arg("crop_height"), arg("crop_width"), arg("crop_eyecenter_offset_h"), arg("crop_eyecenter_offset_w")), "Constructs a FaceEyeNorm object."))
       .def(init<unsigned, unsigned, unsigned, unsigned, unsigned, unsigned>(args("crop_height", "crop_width", "re_y", "re_x", "le_y", "le_x"), "Creates a FaceEyesNorm class that will put the eyes to the given locations and crop the image to the desired size."))
@@ -117,8 +181,9 @@ void bind_ip_faceeyesnorm() {
       .add_property("crop_offset_w", &bob::ip::FaceEyesNorm::getCropOffsetW, &bob::ip::FaceEyesNorm::setCropOffsetW, "x-coordinate of the point in the cropping area which is the middle of the segment defined by the eyes after the geometric normalization.")
       .add_property("last_angle", &bob::ip::FaceEyesNorm::getLastAngle, "The angle value (in degrees) used by the rotation involved in the last call of the operator ()")
       .add_property("last_scale", &bob::ip::FaceEyesNorm::getLastScale, "The scaling factor used by the scaling involved in the last call of the operator ()")
-      .def("__call__", &call1, (arg("input"), arg("output"), arg("re_y"), arg("re_x"), arg("le_y"), arg("le_x")), "Extracts a face given the coordinates of the left (le_y, le_x) and right (re_y, re_x) eye centers. Please note that the horizontal position le_x of the left eye is usually larger than the position re_x of the right eye.")
+      .def("__call__", &call1, (arg("input"), arg("output"), arg("re_y"), arg("re_x"), arg("le_y"), arg("le_x")), "Extracts a face given the coordinates of the left (le_y, le_x) and right (re_y, re_x) eye centers. Please note that the horizontal position le_x of the left eye is usually larger than the position re_x of the right eye. The output array may be of type float64, float32 or uint8 (rounded).")
       .def("__call__", &call1b, (arg("input"), arg("re_y"), arg("re_x"), arg("le_y"), arg("le_x")), "Extracts a face given the coordinates of the left (le_y, le_x) and right (re_y, re_x) eye centers. Please note that the horizontal position le_x of the left eye is usually larger than the position re_x of the right eye. The output is allocated and returned.")
+      .def("__call__", &call3, call3_overloads((arg("self"), arg("input"), arg("eyes"), arg("output"), arg("n_threads")=1), "Extracts several faces of the same image. The eye centers of the i'th face are given by the row eyes[i,:] = (re_y, re_x, le_y, le_x) of a 2D float64 array, and the face is extracted into output[i,:,:]. The faces are split among n_threads threads (0 for one per core), and the GIL is released meanwhile. The output array may be of type float64, float32 or uint8 (rounded). The last_angle and last_scale attributes are not updated."))
       .def("__call__", &call2, (arg("input"), arg("input_mask"), arg("output"), arg("output_mask"), arg("re_y"), arg("re_x"), arg("le_y"), arg("le_x")), "Extracts a face given the coordinates of the left (le_y, le_x) and right (re_y, re_x) eye centers, taking mask into account.")
     ;
 }
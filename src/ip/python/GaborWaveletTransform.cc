@@ -23,6 +23,7 @@
 
 #include <boost/python.hpp>
 #include "bob/core/python/ndarray.h"
+#include "bob/core/python/gil.h"
 #include "bob/core/array_exception.h"
 #include "bob/core/array_type.h"
 
@@ -61,7 +62,13 @@ static inline const blitz::Array<std::complex<double>, 2> convert_image(bob::pyt
   }
 }
 
+// The Gabor kernels and the GWT keep internal buffers, which are re-generated
+// when the image resolution changes: they run without the GIL, but one call
+// at a time per object.
 static inline void transform (bob::ip::GaborKernel& kernel, blitz::Array<std::complex<double>,2>& input, blitz::Array<std::complex<double>,2>& output){
+  bob::python::no_gil unlock;
+  bob::python::object_lock lock(&kernel);
+
  // perform fft on input image
   bob::sp::FFT2D fft(input.extent(0), input.extent(1));
   fft(input);
@@ -106,13 +113,19 @@ static blitz::Array<std::complex<double>,3> empty_trafo_image (bob::ip::GaborWav
 static void perform_gwt_1 (bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bob::python::ndarray output_trafo_image){
   const blitz::Array<std::complex<double>,2>& image = convert_image(input_image);
   blitz::Array<std::complex<double>,3> trafo_image = output_trafo_image.bz<std::complex<double>,3>();
+  bob::python::no_gil unlock;
+  bob::python::object_lock lock(&gwt);
   gwt.performGWT(image, trafo_image);
 }
 
 static blitz::Array<std::complex<double>,3> perform_gwt_2 (bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image){
   const blitz::Array<std::complex<double>,2>& image = convert_image(input_image);
   blitz::Array<std::complex<double>,3> trafo_image(gwt.numberOfKernels(), image.shape()[0], image.shape()[1]);
-  gwt.performGWT(image, trafo_image);
+  {
+    bob::python::no_gil unlock;
+    bob::python::object_lock lock(&gwt);
+    gwt.performGWT(image, trafo_image);
+  }
   return trafo_image;
 }
 
@@ -130,9 +143,13 @@ static void compute_jets_1(bob::ip::GaborWaveletTransform& gwt, bob::python::con
   if (output_jet_image.type().nd == 3){
     // compute jet image with absolute values only
     blitz::Array<double,3> jet_image = output_jet_image.bz<double,3>();
+    bob::python::no_gil unlock;
+    bob::python::object_lock lock(&gwt);
     gwt.computeJetImage(image, jet_image, normalized);
   } else if (output_jet_image.type().nd == 4){
     blitz::Array<double,4> jet_image = output_jet_image.bz<double,4>();
+    bob::python::no_gil unlock;
+    bob::python::object_lock lock(&gwt);
     gwt.computeJetImage(image, jet_image, normalized);
   } else throw bob::core::UnexpectedShapeError();
 }
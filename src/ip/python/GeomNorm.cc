@@ -29,15 +29,36 @@ using namespace boost::python;
 static const char* GEOMNORM_DOC = "Objects of this class, after configuration, can perform a geometric normalization.";
 static const char* MAXRECTINMASK2D_DOC = "Given a 2D mask (a 2D blitz array of booleans), compute the maximum rectangle which only contains true values.";
 
-template <typename T> 
+template <typename T, typename U> 
 static void inner_call1(bob::ip::GeomNorm& obj, 
   bob::python::const_ndarray input, bob::python::ndarray output,
   const double a, const double b)
 {
-  blitz::Array<double,2> output_ = output.bz<double,2>();
+  blitz::Array<U,2> output_ = output.bz<U,2>();
   obj(input.bz<T,2>(), output_, a,b);
 }
 
+template <typename T> 
+static void inner_call1(bob::ip::GeomNorm& obj, 
+  bob::python::const_ndarray input, bob::python::ndarray output,
+  const double a, const double b)
+{
+  const bob::core::array::typeinfo& info = output.type();
+  switch (info.dtype) 
+  {
+    case bob::core::array::t_uint8: 
+      inner_call1<T,uint8_t>(obj, input, output, a,b);
+      break;
+    case bob::core::array::t_float32: 
+      inner_call1<T,float>(obj, input, output, a,b);
+      break;
+    case bob::core::array::t_float64: 
+      inner_call1<T,double>(obj, input, output, a,b);
+      break;
+    default: PYTHON_ERROR(TypeError, "geometric normalization does not support output array with type '%s'", info.str().c_str());
+  }
+}
+
 static void call1(bob::ip::GeomNorm& obj, bob::python::const_ndarray input,
   bob::python::ndarray output, const double a, const double b)
 {
@@ -107,7 +128,7 @@ void bind_ip_geomnorm()
     .add_property("crop_width", &bob::ip::GeomNorm::getCropWidth, &bob::ip::GeomNorm::setCropWidth, "Width of the cropping area/output after the geometric normalization")
     .add_property("crop_offset_h", &bob::ip::GeomNorm::getCropOffsetH, &bob::ip::GeomNorm::setCropOffsetH, "y-coordinate of the rotation center in the new cropped area")
     .add_property("crop_offset_w", &bob::ip::GeomNorm::getCropOffsetW, &bob::ip::GeomNorm::setCropOffsetW, "x-coordinate of the rotation center in the new cropped area")
-    .def("__call__", &call1, (arg("input"), arg("output"), arg("rotation_center_y"), arg("rotation_center_x")), "Call an object of this type to perform a geometric normalization of an image wrt. the given rotation center")
+    .def("__call__", &call1, (arg("input"), arg("output"), arg("rotation_center_y"), arg("rotation_center_x")), "Call an object of this type to perform a geometric normalization of an image wrt. the given rotation center. The output array may be of type float64, float32 or uint8 (rounded).")
     .def("__call__", &call2, (arg("input"), arg("input_mask"), arg("output"), arg("output_mask"), arg("rotation_center_y"), arg("rotation_center_x")), "Call an object of this type to perform a geometric normalization of an image wrt. the given rotation center, taking mask into account.")
     .def("__call__", &call3, (arg("input"), arg("rotation_center_y"), arg("rotation_center_x")), "This function performs the geometric normalization for the given input position")
   ;
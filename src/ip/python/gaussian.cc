@@ -159,6 +159,7 @@ void bind_ip_gaussian()
       .add_property("sigma_y", &bob::ip::Gaussian::getSigmaY, &bob::ip::Gaussian::setSigmaY, "The variance of the Gaussian along the y-axis")
       .add_property("sigma_x", &bob::ip::Gaussian::getSigmaX, &bob::ip::Gaussian::setSigmaX, "The variance of the Gaussian along the x-axis")
       .add_property("conv_border", &bob::ip::Gaussian::getConvBorder, &bob::ip::Gaussian::setConvBorder, "The extrapolation method used by the convolution at the border")
+      .add_property("recursive", &bob::ip::Gaussian::getRecursive, &bob::ip::Gaussian::setRecursive, "Uses a recursive approximation of the Gaussian filter (whose cost does not depend on the standard deviations, the radii being ignored) instead of the convolution with the sampled kernel, if both standard deviations are larger than or equal to 0.5")
       .add_property("kernel_y", &py_getKernelY, "The values of the y-kernel (read only access)")
       .add_property("kernel_x", &py_getKernelX, "The values of the x-kernel (read only access)")
       .def("reset", &bob::ip::Gaussian::reset, (arg("self"), arg("radius_y")=1, arg("radius_x")=1, arg("sigma_y")=sqrt(2.5), arg("sigma_x")=sqrt(2.5), arg("conv_border")=bob::sp::Extrapolation::Mirror), "Resets the parametrization of the Gaussian")
@@ -0,0 +1,116 @@
+/**
+ * @file machine/cxx/Activation.cc
+ * @date Fri 16 Oct 2026 14:47:26 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Array kernels of the activation functions
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bob/machine/Activation.h"
+#include "bob/machine/MLPException.h"
+
+namespace mach = bob::machine;
+
+/**
+ * Activation functions and their derivatives, known at compile time
+ */
+struct Linear {
+  static inline double f(double x) { return x; }
+  static inline double df(double y) { return 1.; }
+};
+
+struct Tanh {
+  static inline double f(double x) { return std::tanh(x); }
+  static inline double df(double y) { return 1. - y*y; }
+};
+
+struct Logistic {
+  static inline double f(double x) { return 1. / (1. + std::exp(-x)); }
+  static inline double df(double y) { return y * (1. - y); }
+};
+
+template <typename F>
+static void activate_(const blitz::Array<double,1>& bias,
+    blitz::Array<double,2>& x)
+{
+  const int cols = x.extent(1);
+  // fast path on the rows of C-contiguous arrays
+  if (x.stride(1) == 1 && bias.stride(0) == 1) {
+    const double* b = bias.data();
+    for (int i=0; i<x.extent(0); ++i) {
+      double* row = &x(i,0);
+      for (int j=0; j<cols; ++j) row[j] = F::f(row[j] + b[j]);
+    }
+  }
+  else {
+    for (int i=0; i<x.extent(0); ++i)
+      for (int j=0; j<cols; ++j) x(i,j) = F::f(x(i,j) + bias(j));
+  }
+}
+
+template <typename F>
+static void multiplyByDerivative_(const blitz::Array<double,2>& output,
+    blitz::Array<double,2>& error)
+{
+  const int cols = error.extent(1);
+  if (error.stride(1) == 1 && output.stride(1) == 1) {
+    for (int i=0; i<error.extent(0); ++i) {
+      const double* y = &output(i,0);
+      double* e = &error(i,0);
+      for (int j=0; j<cols; ++j) e[j] *= F::df(y[j]);
+    }
+  }
+  else {
+    for (int i=0; i<error.extent(0); ++i)
+      for (int j=0; j<cols; ++j) error(i,j) *= F::df(output(i,j));
+  }
+}
+
+void mach::activate(const mach::Activation a,
+    const blitz::Array<double,1>& bias, blitz::Array<double,2>& x)
+{
+  if (x.size() == 0) return;
+  switch (a) {
+    case mach::LINEAR: activate_<Linear>(bias, x); break;
+    case mach::TANH: activate_<Tanh>(bias, x); break;
+    case mach::LOG: activate_<Logistic>(bias, x); break;
+    default: throw mach::UnsupportedActivation(a);
+  }
+}
+
+void mach::activate(const mach::Activation a,
+    const blitz::Array<double,1>& bias, blitz::Array<double,1>& x)
+{
+  if (x.size() == 0) return;
+  // a vector is seen as a matrix with a single row
+  blitz::Array<double,2> x2(x.data(), blitz::shape(1, x.extent(0)),
+      blitz::shape(x.extent(0) * x.stride(0), x.stride(0)), 
+      blitz::neverDeleteData);
+  mach::activate(a, bias, x2);
+}
+
+void mach::multiplyByDerivative(const mach::Activation a,
+    const blitz::Array<double,2>& output, blitz::Array<double,2>& error)
+{
+  if (error.size() == 0) return;
+  switch (a) {
+    case mach::LINEAR: break; //the derivative is 1
+    case mach::TANH: multiplyByDerivative_<Tanh>(output, error); break;
+    case mach::LOG: multiplyByDerivative_<Logistic>(output, error); break;
+    default: throw mach::UnsupportedActivation(a);
+  }
+}
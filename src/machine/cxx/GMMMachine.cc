@@ -22,6 +22,47 @@
 #include "bob/core/array_assert.h"
 #include "bob/machine/Exception.h"
 #include "bob/math/log.h"
+#include "bob/math/gemm.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Number of samples scored at once by the block computations over 2D inputs
+ */
+static const int s_batch_block_size = 128;
+
+bob::machine::GMMWorkspace::GMMWorkspace()
+{
+}
+
+void bob::machine::GMMWorkspace::resize(const size_t n_gaussians,
+  const size_t n_inputs)
+{
+  const int C = n_gaussians;
+  const int D = n_inputs;
+  if(m_Px.extent(0) == C && m_Px.extent(1) == D) return;
+  m_log_weighted_gaussian_likelihoods.resize(C);
+  m_P.resize(C);
+  m_Px.resize(C, D);
+}
+
+void bob::machine::GMMWorkspace::resizeBatch(const size_t n_gaussians,
+  const size_t n_inputs, const size_t block_size)
+{
+  const int C = n_gaussians;
+  const int D = n_inputs;
+  const int B = block_size;
+  if(m_batch_W.extent(0) == 2*D && m_batch_W.extent(1) == C &&
+      m_batch_L.extent(0) == B) return;
+  m_batch_shift.resize(D);
+  m_batch_W.resize(2*D, C);
+  m_batch_const.resize(C);
+  m_batch_Z.resize(B, 2*D);
+  m_batch_L.resize(B, C);
+  m_batch_ll.resize(B);
+  m_batch_X.resize(B, D);
+  m_batch_X2.resize(B, D);
+}
 
 bob::machine::GMMMachine::GMMMachine(): m_gaussians(0) {
   resize(0,0);
@@ -147,7 +188,7 @@ void bob::machine::GMMMachine::setMeans(const blitz::Array<double,2> &means) {
   bob::core::array::assertSameDimensionLength(means.extent(1), m_n_inputs);
   for(size_t i=0; i<m_n_gaussians; ++i)
     m_gaussians[i]->updateMean() = means(i,blitz::Range::all());
-  m_cache_supervector = false;
+  updateCacheSupervectors();
 }
 
 void bob::machine::GMMMachine::getMeans(blitz::Array<double,2> &means) const {
@@ -161,7 +202,7 @@ void bob::machine::GMMMachine::setMeanSupervector(const blitz::Array<double,1> &
   bob::core::array::assertSameDimensionLength(mean_supervector.extent(0), m_n_gaussians*m_n_inputs);
   for(size_t i=0; i<m_n_gaussians; ++i)
     m_gaussians[i]->updateMean() = mean_supervector(blitz::Range(i*m_n_inputs, (i+1)*m_n_inputs-1));
-  m_cache_supervector = false;
+  updateCacheSupervectors();
 }
 
 void bob::machine::GMMMachine::getMeanSupervector(blitz::Array<double,1> &mean_supervector) const {
@@ -177,7 +218,7 @@ void bob::machine::GMMMachine::setVariances(const blitz::Array<double, 2 >& vari
     m_gaussians[i]->updateVariance() = variances(i,blitz::Range::all());
     m_gaussians[i]->applyVarianceThresholds();
   }
-  m_cache_supervector = false;
+  updateCacheSupervectors();
 }
 
 void bob::machine::GMMMachine::getVariances(blitz::Array<double, 2 >& variances) const {
@@ -193,7 +234,7 @@ void bob::machine::GMMMachine::setVarianceSupervector(const blitz::Array<double,
     m_gaussians[i]->updateVariance() = variance_supervector(blitz::Range(i*m_n_inputs, (i+1)*m_n_inputs-1));
     m_gaussians[i]->applyVarianceThresholds();
   }
-  m_cache_supervector = false;
+  updateCacheSupervectors();
 }
 
 void bob::machine::GMMMachine::getVarianceSupervector(blitz::Array<double,1> &variance_supervector) const {
@@ -206,14 +247,14 @@ void bob::machine::GMMMachine::getVarianceSupervector(blitz::Array<double,1> &va
 void bob::machine::GMMMachine::setVarianceThresholds(const double value) {
   for(size_t i=0; i<m_n_gaussians; ++i)
     m_gaussians[i]->setVarianceThresholds(value);
-  m_cache_supervector = false;
+  updateCacheSupervectors();
 }
 
 void bob::machine::GMMMachine::setVarianceThresholds(blitz::Array<double, 1> variance_thresholds) {
   bob::core::array::assertSameDimensionLength(variance_thresholds.extent(0), m_n_inputs);
   for(size_t i=0; i<m_n_gaussians; ++i)
     m_gaussians[i]->setVarianceThresholds(variance_thresholds);
-  m_cache_supervector = false;
+  updateCacheSupervectors();
 }
 
 void bob::machine::GMMMachine::setVarianceThresholds(const blitz::Array<double, 2>& variance_thresholds) {
@@ -221,7 +262,7 @@ void bob::machine::GMMMachine::setVarianceThresholds(const blitz::Array<double,
   bob::core::array::assertSameDimensionLength(variance_thresholds.extent(1), m_n_inputs);
   for(size_t i=0; i<m_n_gaussians; ++i)
     m_gaussians[i]->setVarianceThresholds(variance_thresholds(i,blitz::Range::all()));
-  m_cache_supervector = false;
+  updateCacheSupervectors();
 }
 
 void bob::machine::GMMMachine::getVarianceThresholds(blitz::Array<double, 2>& variance_thresholds) const {
@@ -258,17 +299,137 @@ double bob::machine::GMMMachine::logLikelihood_(const blitz::Array<double, 1> &x
 }
 
 double bob::machine::GMMMachine::logLikelihood(const blitz::Array<double, 1> &x) const {
+  return logLikelihood(x, m_workspace);
+}
+
+double bob::machine::GMMMachine::logLikelihood_(const blitz::Array<double, 1> &x) const {
+  return logLikelihood_(x, m_workspace);
+}
+
+double bob::machine::GMMMachine::logLikelihood(const blitz::Array<double, 1> &x,
+  bob::machine::GMMWorkspace& ws) const
+{
   // Check dimension
   bob::core::array::assertSameDimensionLength(x.extent(0), m_n_inputs);
+  return logLikelihood_(x, ws);
+}
+
+double bob::machine::GMMMachine::logLikelihood_(const blitz::Array<double, 1> &x,
+  bob::machine::GMMWorkspace& ws) const
+{
   // Call the other logLikelihood_ (overloaded) function
   // (log_weighted_gaussian_likelihoods will be discarded)
-  return logLikelihood_(x,m_cache_log_weighted_gaussian_likelihoods);
+  ws.resize(m_n_gaussians, m_n_inputs);
+  return logLikelihood_(x, ws.m_log_weighted_gaussian_likelihoods);
 }
 
-double bob::machine::GMMMachine::logLikelihood_(const blitz::Array<double, 1> &x) const {
-  // Call the other logLikelihood (overloaded) function
-  // (log_weighted_gaussian_likelihoods will be discarded)
-  return logLikelihood_(x,m_cache_log_weighted_gaussian_likelihoods);
+void bob::machine::GMMMachine::logLikelihood(const blitz::Array<double, 2> &x,
+  blitz::Array<double,1> &log_likelihoods) const
+{
+  logLikelihood(x, log_likelihoods, m_workspace);
+}
+
+void bob::machine::GMMMachine::logLikelihood_(const blitz::Array<double, 2> &x,
+  blitz::Array<double,1> &log_likelihoods) const
+{
+  logLikelihood_(x, log_likelihoods, m_workspace);
+}
+
+void bob::machine::GMMMachine::logLikelihood(const blitz::Array<double, 2> &x,
+  blitz::Array<double,1> &log_likelihoods, bob::machine::GMMWorkspace& ws) const
+{
+  // Check dimension
+  bob::core::array::assertSameDimensionLength(x.extent(1), m_n_inputs);
+  bob::core::array::assertSameDimensionLength(log_likelihoods.extent(0), x.extent(0));
+  logLikelihood_(x, log_likelihoods, ws);
+}
+
+void bob::machine::GMMMachine::logLikelihood_(const blitz::Array<double, 2> &x,
+  blitz::Array<double,1> &log_likelihoods, bob::machine::GMMWorkspace& ws) const
+{
+  updateBatch(ws);
+  blitz::Range a = blitz::Range::all();
+  const int n_samples = x.extent(0);
+  for(int b=0; b<n_samples; b+=s_batch_block_size) {
+    const int n_block = std::min(s_batch_block_size, n_samples-b);
+    blitz::Range r(b, b+n_block-1);
+    logLikelihoodBlock_(x(r,a), ws);
+    log_likelihoods(r) = ws.m_batch_ll(blitz::Range(0,n_block-1));
+  }
+}
+
+void bob::machine::GMMMachine::updateBatch(bob::machine::GMMWorkspace& ws) const
+{
+  const int C = m_n_gaussians;
+  const int D = m_n_inputs;
+  ws.resizeBatch(C, D, s_batch_block_size);
+
+  // The samples are shifted by the average of the means, which limits the
+  // cancellation errors of the expansion below
+  ws.m_batch_shift = 0.;
+  for(int i=0; i<C; ++i)
+    ws.m_batch_shift += m_gaussians[i]->getMean();
+  if(C > 0) ws.m_batch_shift /= C;
+
+  // log(weight_i*p(x|gaussian_i)) = const_i + sum_d W(d,i)*z_d + W(D+d,i)*z_d^2
+  // with z = x - shift, m = mean_i - shift and v = variance_i:
+  //   W(d,i) = m_d/v_d, W(D+d,i) = -0.5/v_d
+  //   const_i = log(weight_i) - 0.5*(g_norm_i + sum_d m_d^2/v_d)
+  for(int i=0; i<C; ++i) {
+    const blitz::Array<double,1>& mean = m_gaussians[i]->getMean();
+    const blitz::Array<double,1>& variance = m_gaussians[i]->getVariance();
+    double k = 0.;
+    for(int d=0; d<D; ++d) {
+      const double m = mean(d) - ws.m_batch_shift(d);
+      const double iv = 1. / variance(d);
+      ws.m_batch_W(d,i) = m * iv;
+      ws.m_batch_W(D+d,i) = -0.5 * iv;
+      k += m * m * iv;
+    }
+    ws.m_batch_const(i) = m_cache_log_weights(i) - 
+      0.5 * (m_gaussians[i]->getGNorm() + k);
+  }
+}
+
+void bob::machine::GMMMachine::logLikelihoodBlock_(const blitz::Array<double,2> &x,
+  bob::machine::GMMWorkspace& ws) const
+{
+  const int C = m_n_gaussians;
+  const int D = m_n_inputs;
+  const int n_block = x.extent(0);
+  blitz::Range a = blitz::Range::all();
+  blitz::Range rb(0, n_block-1);
+
+  // Builds [z, z^2] for the block
+  blitz::Array<double,2> Z = ws.m_batch_Z(rb,a);
+  for(int n=0; n<n_block; ++n) {
+    double* z = &Z(n,0);
+    for(int d=0; d<D; ++d) {
+      const double v = x(n,d) - ws.m_batch_shift(d);
+      z[d] = v;
+      z[D+d] = v * v;
+    }
+  }
+
+  // Scores the whole block against all the Gaussian components
+  blitz::Array<double,2> L = ws.m_batch_L(rb,a);
+  bob::math::gemm_(Z, ws.m_batch_W, L);
+
+  // Adds the constant terms, and computes the GMM log likelihood of each 
+  // sample with a log-sum-exp
+  const double* k = ws.m_batch_const.data();
+  for(int n=0; n<n_block; ++n) {
+    double* l = &L(n,0);
+    double l_max = bob::math::Log::LogZero;
+    for(int i=0; i<C; ++i) {
+      l[i] += k[i];
+      if(l[i] > l_max) l_max = l[i];
+    }
+    double sum = 0.;
+    for(int i=0; i<C; ++i)
+      sum += exp(l[i] - l_max);
+    ws.m_batch_ll(n) = (sum > 0. ? l_max + log(sum) : bob::math::Log::LogZero);
+  }
 }
 
 void bob::machine::GMMMachine::forward(const blitz::Array<double,1>& input, double& output) const {
@@ -286,54 +447,122 @@ void bob::machine::GMMMachine::forward_(const blitz::Array<double,1>& input,
 
 void bob::machine::GMMMachine::accStatistics(const blitz::Array<double,2>& input,
     bob::machine::GMMStats& stats) const {
-  // iterate over data
-  blitz::Range a = blitz::Range::all();
-  for(int i=0; i<input.extent(0); ++i) {
-    // Get example
-    blitz::Array<double,1> x(input(i,a));
-    // Accumulate statistics
-    accStatistics(x,stats);
-  }
+  accStatistics(input, stats, m_workspace);
+}
+
+void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double,2>& input,
+    bob::machine::GMMStats& stats) const {
+  accStatistics_(input, stats, m_workspace);
 }
 
-void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double,2>& input, bob::machine::GMMStats& stats) const {
-  // iterate over data
+void bob::machine::GMMMachine::accStatistics(const blitz::Array<double,2>& input,
+    bob::machine::GMMStats& stats, bob::machine::GMMWorkspace& ws) const {
+  // check input and GMMStats size
+  bob::core::array::assertSameDimensionLength(input.extent(1), m_n_inputs);
+  bob::core::array::assertSameDimensionLength(stats.sumPx.extent(0), m_n_gaussians);
+  bob::core::array::assertSameDimensionLength(stats.sumPx.extent(1), m_n_inputs);
+  bob::core::array::assertSameDimensionLength(stats.sumPxx.extent(0), m_n_gaussians);
+  bob::core::array::assertSameDimensionLength(stats.sumPxx.extent(1), m_n_inputs);
+
+  accStatistics_(input, stats, ws);
+}
+
+void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double,2>& input,
+    bob::machine::GMMStats& stats, bob::machine::GMMWorkspace& ws) const {
+  updateBatch(ws);
+  const int C = m_n_gaussians;
+  const int D = m_n_inputs;
+  const int n_samples = input.extent(0);
   blitz::Range a = blitz::Range::all();
-  for(int i=0; i<input.extent(0); ++i) {
-    // Get example
-    blitz::Array<double,1> x(input(i, a));
-    // Accumulate statistics
-    accStatistics_(x,stats);
+
+  // iterate over blocks of data
+  for(int b=0; b<n_samples; b+=s_batch_block_size) {
+    const int n_block = std::min(s_batch_block_size, n_samples-b);
+    blitz::Range rb(0, n_block-1);
+
+    // Copies the samples of the block and their squares into the workspace.
+    // The input is only accessed element-wise (no blitz slice of it is
+    // created), such that several threads may process distinct parts of
+    // the same input array at once.
+    blitz::Array<double,2> X = ws.m_batch_X(rb,a);
+    blitz::Array<double,2> X2 = ws.m_batch_X2(rb,a);
+    for(int n=0; n<n_block; ++n) {
+      double* xn = &X(n,0);
+      double* x2n = &X2(n,0);
+      for(int d=0; d<D; ++d) {
+        xn[d] = input(b+n,d);
+        x2n[d] = xn[d] * xn[d];
+      }
+    }
+
+    // Calculate Gaussian and GMM likelihoods of the whole block
+    logLikelihoodBlock_(X, ws);
+
+    // Calculate responsibilities (inplace)
+    blitz::Array<double,2> P = ws.m_batch_L(rb,a);
+    for(int n=0; n<n_block; ++n) {
+      const double ll = ws.m_batch_ll(n);
+      double* p = &P(n,0);
+      for(int i=0; i<C; ++i) {
+        p[i] = exp(p[i] - ll);
+        // - responsibilities
+        stats.n(i) += p[i];
+      }
+      // - total likelihood
+      stats.log_likelihood += ll;
+    }
+
+    // - number of samples
+    stats.T += n_block;
+
+    // - first and second order stats, as rank-k updates
+    bob::math::gemm_(P, X, stats.sumPx, true, false, 1., 1.);
+    bob::math::gemm_(P, X2, stats.sumPxx, true, false, 1., 1.);
   }
 }
 
 void bob::machine::GMMMachine::accStatistics(const blitz::Array<double, 1>& x, bob::machine::GMMStats& stats) const {
+  accStatistics(x, stats, m_workspace);
+}
+
+void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double, 1>& x, bob::machine::GMMStats& stats) const {
+  accStatistics_(x, stats, m_workspace);
+}
+
+void bob::machine::GMMMachine::accStatistics(const blitz::Array<double, 1>& x,
+  bob::machine::GMMStats& stats, bob::machine::GMMWorkspace& ws) const
+{
   // check GMMStats size
   bob::core::array::assertSameDimensionLength(stats.sumPx.extent(0), m_n_gaussians);
   bob::core::array::assertSameDimensionLength(stats.sumPx.extent(1), m_n_inputs);
 
   // Calculate Gaussian and GMM likelihoods
-  // - m_cache_log_weighted_gaussian_likelihoods(i) = log(weight_i*p(x|gaussian_i))
+  // - ws.m_log_weighted_gaussian_likelihoods(i) = log(weight_i*p(x|gaussian_i))
   // - log_likelihood = log(sum_i(weight_i*p(x|gaussian_i)))
-  double log_likelihood = logLikelihood(x, m_cache_log_weighted_gaussian_likelihoods);
+  ws.resize(m_n_gaussians, m_n_inputs);
+  double log_likelihood = logLikelihood(x, ws.m_log_weighted_gaussian_likelihoods);
 
-  accStatisticsInternal(x, stats, log_likelihood);
+  accStatisticsInternal(x, stats, log_likelihood, ws);
 }
 
-void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double, 1>& x, bob::machine::GMMStats& stats) const {
+void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double, 1>& x,
+  bob::machine::GMMStats& stats, bob::machine::GMMWorkspace& ws) const
+{
   // Calculate Gaussian and GMM likelihoods
-  // - m_cache_log_weighted_gaussian_likelihoods(i) = log(weight_i*p(x|gaussian_i))
+  // - ws.m_log_weighted_gaussian_likelihoods(i) = log(weight_i*p(x|gaussian_i))
   // - log_likelihood = log(sum_i(weight_i*p(x|gaussian_i)))
-  double log_likelihood = logLikelihood_(x, m_cache_log_weighted_gaussian_likelihoods);
+  ws.resize(m_n_gaussians, m_n_inputs);
+  double log_likelihood = logLikelihood_(x, ws.m_log_weighted_gaussian_likelihoods);
 
-  accStatisticsInternal(x, stats, log_likelihood);
+  accStatisticsInternal(x, stats, log_likelihood, ws);
 }
 
 void bob::machine::GMMMachine::accStatisticsInternal(const blitz::Array<double, 1>& x,
-  bob::machine::GMMStats& stats, const double log_likelihood) const
+  bob::machine::GMMStats& stats, const double log_likelihood,
+  bob::machine::GMMWorkspace& ws) const
 {
   // Calculate responsibilities
-  m_cache_P = blitz::exp(m_cache_log_weighted_gaussian_likelihoods - log_likelihood);
+  ws.m_P = blitz::exp(ws.m_log_weighted_gaussian_likelihoods - log_likelihood);
 
   // Accumulate statistics
   // - total likelihood
@@ -343,18 +572,18 @@ void bob::machine::GMMMachine::accStatisticsInternal(const blitz::Array<double,
   stats.T++;
 
   // - responsibilities
-  stats.n += m_cache_P;
+  stats.n += ws.m_P;
 
   // - first order stats
   blitz::firstIndex i;
   blitz::secondIndex j;
 
-  m_cache_Px = m_cache_P(i) * x(j);
+  ws.m_Px = ws.m_P(i) * x(j);
 
-  stats.sumPx += m_cache_Px;
+  stats.sumPx += ws.m_Px;
 
   // - second order stats
-  stats.sumPxx += (m_cache_Px(i,j) * x(j));
+  stats.sumPxx += (ws.m_Px(i,j) * x(j));
 }
 
 
@@ -407,44 +636,19 @@ void bob::machine::GMMMachine::load(bob::io::HDF5File& config) {
   initCache();
 }
 
-void bob::machine::GMMMachine::updateCacheSupervectors() const
+void bob::machine::GMMMachine::updateCacheSupervectors()
 {
   m_cache_mean_supervector.resize(m_n_gaussians*m_n_inputs);
   m_cache_variance_supervector.resize(m_n_gaussians*m_n_inputs);
-
-  for(size_t i=0; i<m_n_gaussians; ++i) {
-    blitz::Range range(i*m_n_inputs, (i+1)*m_n_inputs-1);
-    m_cache_mean_supervector(range) = m_gaussians[i]->getMean();
-    m_cache_variance_supervector(range) = m_gaussians[i]->getVariance();
-  }
-  m_cache_supervector = true;
+  getMeanSupervector(m_cache_mean_supervector);
+  getVarianceSupervector(m_cache_variance_supervector);
 }
 
-void bob::machine::GMMMachine::initCache() const {
+void bob::machine::GMMMachine::initCache() {
   // Initialise cache arrays
   m_cache_log_weights.resize(m_n_gaussians);
   recomputeLogWeights();
-  m_cache_log_weighted_gaussian_likelihoods.resize(m_n_gaussians);
-  m_cache_P.resize(m_n_gaussians);
-  m_cache_Px.resize(m_n_gaussians,m_n_inputs);
-  m_cache_supervector = false;
-}
-
-void bob::machine::GMMMachine::reloadCacheSupervectors() const {
-  if(!m_cache_supervector)
-    updateCacheSupervectors();
-}
-
-const blitz::Array<double,1>& bob::machine::GMMMachine::getMeanSupervector() const {
-  if(!m_cache_supervector)
-    updateCacheSupervectors();
-  return m_cache_mean_supervector;
-}
-
-const blitz::Array<double,1>& bob::machine::GMMMachine::getVarianceSupervector() const {
-  if(!m_cache_supervector)
-    updateCacheSupervectors();
-  return m_cache_variance_supervector;
+  updateCacheSupervectors();
 }
 
 namespace bob {
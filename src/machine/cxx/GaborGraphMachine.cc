@@ -21,6 +21,10 @@
  */
 
 #include "bob/machine/GaborGraphMachine.h"
+#include "bob/core/array_assert.h"
+#include "bob/core/array_check.h"
+#include "bob/core/array_copy.h"
+#include "bob/core/parallel.h"
 #include <complex>
 
 /**
@@ -274,14 +278,22 @@ double bob::machine::GaborGraphMachine::similarity(
   const bob::machine::GaborJetSimilarity& jet_similarity_function
 ) const
 {
+  bob::core::array::assertCZeroBaseContiguous(many_model_graph_jets);
+  bob::core::array::assertCZeroBaseContiguous(probe_graph_jets);
+  bob::core::array::assertSameDimensionLength(many_model_graph_jets.extent(1), probe_graph_jets.extent(0));
+  bob::core::array::assertSameDimensionLength(many_model_graph_jets.extent(2), probe_graph_jets.extent(1));
+  if (jet_similarity_function.usesPhases())
+    throw bob::core::NotImplementedError("Disparity similarity (and its derivatives) need Gabor jets including phases");
+
   // iterate over the nodes and average Gabor jet similarities
+  const int size = probe_graph_jets.extent(1);
   double similarity = 0.;
-  blitz::Range all = blitz::Range::all();
   for (int i = 0; i < many_model_graph_jets.extent(1); ++i){
     // maximize jet similarity over all models in the gallery
+    const double* probe = &probe_graph_jets(i,0);
     double max_similarity = 0.;
     for (int p = 0; p < many_model_graph_jets.extent(0); ++p){
-      max_similarity = std::max(max_similarity, jet_similarity_function(many_model_graph_jets(p,i,all), probe_graph_jets(i,all)));
+      max_similarity = std::max(max_similarity, jet_similarity_function.similarity_(&many_model_graph_jets(p,i,0), 0, probe, 0, size));
     }
     similarity += max_similarity;
   }
@@ -302,14 +314,21 @@ double bob::machine::GaborGraphMachine::similarity(
   const bob::machine::GaborJetSimilarity& jet_similarity_function
 ) const
 {
+  bob::core::array::assertCZeroBaseContiguous(many_model_graph_jets);
+  bob::core::array::assertCZeroBaseContiguous(probe_graph_jets);
+  for (int d = 0; d < 3; ++d)
+    bob::core::array::assertSameDimensionLength(many_model_graph_jets.extent(d+1), probe_graph_jets.extent(d));
+
   // iterate over the nodes and average Gabor jet similarities
+  const int size = probe_graph_jets.extent(2);
   double similarity = 0.;
-  blitz::Range all = blitz::Range::all();
   for (int i = 0; i < many_model_graph_jets.extent(1); ++i){
     // maximize jet similarity over all models in the gallery
+    const double* probe = &probe_graph_jets(i,0,0);
     double max_similarity = 0.;
     for (int p = 0; p < many_model_graph_jets.extent(0); ++p){
-      max_similarity = std::max(max_similarity, jet_similarity_function(many_model_graph_jets(p,i,all,all), probe_graph_jets(i,all,all)));
+      const double* model = &many_model_graph_jets(p,i,0,0);
+      max_similarity = std::max(max_similarity, jet_similarity_function.similarity_(model, model + size, probe, probe + size, size));
     }
     similarity += max_similarity;
   }
@@ -317,6 +336,102 @@ double bob::machine::GaborGraphMachine::similarity(
 }
 
 
+namespace {
+  /**
+   * Compares one probe graph with a shard of model graphs. All graphs are
+   * stored contiguously, with node_size values per node: the absolute values
+   * of the Gabor jet, followed by its phases (if any).
+   */
+  struct GraphSimilarities {
+    const bob::machine::GaborJetSimilarity* function;
+    const double* models;
+    const double* probe;
+    int n_nodes;
+    int node_size;
+    int size;
+    bool phases;
+    blitz::Array<double,1>* similarities;
+
+    void operator()(size_t, size_t start, size_t end) const {
+      const int graph_size = n_nodes * node_size;
+      for (size_t m = start; m < end; ++m){
+        const double* model = models + m * graph_size;
+        // iterate over the nodes and average Gabor jet similarities
+        double similarity = 0.;
+        for (int i = 0; i < n_nodes; ++i){
+          const double* jet1 = model + i * node_size;
+          const double* jet2 = probe + i * node_size;
+          similarity += function->similarity_(jet1, phases ? jet1 + size : 0, jet2, phases ? jet2 + size : 0, size);
+        }
+        (*similarities)((int)m) = similarity / n_nodes;
+      }
+    }
+  };
+}
+
+/**
+ * Computes the similarities of the given probe graph with each of the given model graphs;
+ * the result for each model is identical to the one of similarity(model, probe, jet_similarity_function)
+ * @param many_model_graph_jets  The set of model graphs to compare
+ * @param probe_graph_jets  The probe graph to compare
+ * @param jet_similarity_function  The similarity function to be used for comparison of two corresponding Gabor jets
+ * @param similarities  The similarity of the probe graph with each of the model graphs
+ * @param n_threads  The number of threads the models are split across (0 means one per hardware core)
+ */
+void bob::machine::GaborGraphMachine::similarities(
+  const blitz::Array<double,4>& many_model_graph_jets,
+  const blitz::Array<double,3>& probe_graph_jets,
+  const bob::machine::GaborJetSimilarity& jet_similarity_function,
+  blitz::Array<double,1>& similarities,
+  const size_t n_threads
+) const
+{
+  for (int d = 0; d < 3; ++d)
+    bob::core::array::assertSameDimensionLength(many_model_graph_jets.extent(d+1), probe_graph_jets.extent(d));
+  bob::core::array::assertSameDimensionLength(probe_graph_jets.extent(1), 2);
+  bob::core::array::assertSameDimensionLength(similarities.extent(0), many_model_graph_jets.extent(0));
+
+  // the similarity functions work on contiguous memory
+  blitz::Array<double,4> models(bob::core::array::isCZeroBaseContiguous(many_model_graph_jets) ? many_model_graph_jets : bob::core::array::ccopy(many_model_graph_jets));
+  blitz::Array<double,3> probe(bob::core::array::isCZeroBaseContiguous(probe_graph_jets) ? probe_graph_jets : bob::core::array::ccopy(probe_graph_jets));
+
+  // the phases are skipped by the similarity functions that do not use them
+  GraphSimilarities f = {&jet_similarity_function, models.data(), probe.data(), probe.extent(0), 2 * probe.extent(2), probe.extent(2), jet_similarity_function.usesPhases(), &similarities};
+  bob::core::parallelFor(models.extent(0), n_threads, f);
+}
+
+/**
+ * Computes the similarities of the given probe graph with each of the given model graphs (absolute values only);
+ * the result for each model is identical to the one of similarity(model, probe, jet_similarity_function)
+ * @param many_model_graph_jets  The set of model graphs to compare
+ * @param probe_graph_jets  The probe graph to compare
+ * @param jet_similarity_function  The similarity function to be used for comparison of two corresponding Gabor jets
+ * @param similarities  The similarity of the probe graph with each of the model graphs
+ * @param n_threads  The number of threads the models are split across (0 means one per hardware core)
+ */
+void bob::machine::GaborGraphMachine::similarities(
+  const blitz::Array<double,3>& many_model_graph_jets,
+  const blitz::Array<double,2>& probe_graph_jets,
+  const bob::machine::GaborJetSimilarity& jet_similarity_function,
+  blitz::Array<double,1>& similarities,
+  const size_t n_threads
+) const
+{
+  for (int d = 0; d < 2; ++d)
+    bob::core::array::assertSameDimensionLength(many_model_graph_jets.extent(d+1), probe_graph_jets.extent(d));
+  bob::core::array::assertSameDimensionLength(similarities.extent(0), many_model_graph_jets.extent(0));
+  if (jet_similarity_function.usesPhases())
+    throw bob::core::NotImplementedError("Disparity similarity (and its derivatives) need Gabor jets including phases");
+
+  // the similarity functions work on contiguous memory
+  blitz::Array<double,3> models(bob::core::array::isCZeroBaseContiguous(many_model_graph_jets) ? many_model_graph_jets : bob::core::array::ccopy(many_model_graph_jets));
+  blitz::Array<double,2> probe(bob::core::array::isCZeroBaseContiguous(probe_graph_jets) ? probe_graph_jets : bob::core::array::ccopy(probe_graph_jets));
+
+  GraphSimilarities f = {&jet_similarity_function, models.data(), probe.data(), probe.extent(0), probe.extent(1), probe.extent(1), false, &similarities};
+  bob::core::parallelFor(models.extent(0), n_threads, f);
+}
+
+
 void bob::machine::GaborGraphMachine::save(bob::io::HDF5File& file) const{
   file.setArray("NodePositions", m_node_positions);
 }
@@ -37,12 +37,18 @@ static double sqr(double x){return x*x;}
 
 void bob::machine::GaborJetSimilarity::init(){
   m_disparity = 0.;
-  m_confidences.resize(m_gwt.numberOfKernels());
-  std::fill(m_confidences.begin(), m_confidences.end(), 0.);
-  m_phase_differences.resize(m_gwt.numberOfKernels());
-  std::fill(m_phase_differences.begin(), m_phase_differences.end(), 0.);
+
+  // store the kernel frequencies in contiguous tables, in the order of the Gabor jet entries
+  const std::vector<blitz::TinyVector<double,2> >& kernels = m_gwt.kernelFrequencies();
+  m_kernels_y.resize(kernels.size());
+  m_kernels_x.resize(kernels.size());
+  for (unsigned j = 0; j < kernels.size(); ++j){
+    m_kernels_y[j] = kernels[j][0];
+    m_kernels_x[j] = kernels[j][1];
+  }
 
   // used for disparity-like similarity functions only...
+  m_wavelet_extends.clear();
   m_wavelet_extends.reserve(m_gwt.numberOfScales());
   for (unsigned level = 0; level < m_gwt.numberOfScales(); ++level){
     blitz::TinyVector<double,2> k = m_gwt.kernelFrequencies()[level * m_gwt.numberOfDirections()];
@@ -57,22 +63,10 @@ double bob::machine::GaborJetSimilarity::operator()(const blitz::Array<double,1>
   bob::core::array::assertCZeroBaseContiguous(jet2);
   bob::core::array::assertSameShape(jet1,jet2);
 
-  switch (m_type){
-    case SCALAR_PRODUCT:
-      // normalized scalar product
-      return std::inner_product(jet1.begin(), jet1.end(), jet2.begin(), 0.);
-    case CANBERRA:{
-      // Canberra similarity
-      double sim = 0.;
-      unsigned size = jet1.shape()[0];
-      for (unsigned j = size; j--;){
-        sim += 1. - std::abs(jet1(j) - jet2(j)) / (jet1(j) + jet2(j));
-      }
-      return sim / size;
-    }
-    default:
-      throw bob::core::NotImplementedError("Disparity similarity (and its derivatives) need Gabor jets including phases");
-  }
+  if (m_type != SCALAR_PRODUCT && m_type != CANBERRA)
+    throw bob::core::NotImplementedError("Disparity similarity (and its derivatives) need Gabor jets including phases");
+
+  return compute_similarity(jet1.data(), 0, jet2.data(), 0, jet1.shape()[0], m_disparity);
 }
 
 
@@ -87,20 +81,55 @@ double bob::machine::GaborJetSimilarity::operator()(const blitz::Array<double,2>
   bob::core::array::assertCZeroBaseContiguous(jet2);
   bob::core::array::assertSameShape(jet1,jet2);
 
-  // compute confidence vectors
-  compute_confidences(jet1, jet2);
+  const int size = jet1.shape()[1];
+  return compute_similarity(jet1.data(), jet1.data() + size, jet2.data(), jet2.data() + size, size, m_disparity);
+}
 
-  // now, compute the disparity
-  compute_disparity();
 
-  const std::vector<blitz::TinyVector<double,2> >& kernels = m_gwt.kernelFrequencies();
+double bob::machine::GaborJetSimilarity::similarity_(const double* abs1, const double* phase1, const double* abs2, const double* phase2, const int size) const{
+  blitz::TinyVector<double,2> disparity;
+  return compute_similarity(abs1, phase1, abs2, phase2, size, disparity);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  Similarity functions  /////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static double adjustPhase(double phase){
+  return phase - (2.*M_PI)*round(phase / (2.*M_PI));
+}
+
+double bob::machine::GaborJetSimilarity::compute_similarity(const double* abs1, const double* phase1, const double* abs2, const double* phase2, const int size, blitz::TinyVector<double,2>& disparity) const{
+  switch (m_type){
+    case SCALAR_PRODUCT:
+      // normalized scalar product
+      return std::inner_product(abs1, abs1 + size, abs2, 0.);
+
+    case CANBERRA:{
+      // Canberra similarity
+      double sim = 0.;
+      for (int j = size; j--;){
+        sim += 1. - std::abs(abs1[j] - abs2[j]) / (abs1[j] + abs2[j]);
+      }
+      return sim / size;
+    }
+
+    default:
+      break;
+  }
+
+  // Here, only the disparity based similarity functions are executed
+  // estimate the disparity
+  disparity = compute_disparity(abs1, phase1, abs2, phase2);
+  const double* ky = &m_kernels_y[0];
+  const double* kx = &m_kernels_x[0];
 
   switch (m_type){
     case DISPARITY:{
       // compute the similarity using the estimated disparity
       double sum = 0.;
-      for (int j = m_confidences.size(); j--;){
-        sum += m_confidences[j] * cos(m_phase_differences[j] - m_disparity[0] * kernels[j][0] - m_disparity[1] * kernels[j][1]);
+      for (int j = m_kernels_y.size(); j--;){
+        sum += abs1[j] * abs2[j] * cos(adjustPhase(phase1[j] - phase2[j]) - disparity[0] * ky[j] - disparity[1] * kx[j]);
       }
       return sum;
     } // DISPARITY
@@ -108,22 +137,22 @@ double bob::machine::GaborJetSimilarity::operator()(const blitz::Array<double,2>
     case PHASE_DIFF:{
       // compute the similarity using the estimated disparity
       double sum = 0.;
-      for (int j = m_phase_differences.size(); j--;){
-        sum += cos(m_phase_differences[j] - m_disparity[0] * kernels[j][0] - m_disparity[1] * kernels[j][1]);
+      for (int j = m_kernels_y.size(); j--;){
+        sum += cos(adjustPhase(phase1[j] - phase2[j]) - disparity[0] * ky[j] - disparity[1] * kx[j]);
       }
-      return sum / jet1.shape()[1];
+      return sum / size;
     } // PHASE_DIFF
 
     case PHASE_DIFF_PLUS_CANBERRA:{
       // compute the similarity using the estimated disparity
       double sum = 0.;
-      for (int j = m_phase_differences.size(); j--;){
+      for (int j = m_kernels_y.size(); j--;){
         // add disparity term
-        sum += cos(m_phase_differences[j] - m_disparity[0] * kernels[j][0] - m_disparity[1] * kernels[j][1]);
+        sum += cos(adjustPhase(phase1[j] - phase2[j]) - disparity[0] * ky[j] - disparity[1] * kx[j]);
         // add Canberra term
-        sum += 1. - std::abs(jet1(0,j) - jet2(0,j)) / (jet1(0,j) + jet2(0,j));
+        sum += 1. - std::abs(abs1[j] - abs2[j]) / (abs1[j] + abs2[j]);
       }
-      return sum / (2. * jet1.shape()[1]);
+      return sum / (2. * size);
     }
 
     default:
@@ -136,33 +165,20 @@ double bob::machine::GaborJetSimilarity::operator()(const blitz::Array<double,2>
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////  Disparity estimation  /////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-static double adjustPhase(double phase){
-  return phase - (2.*M_PI)*round(phase / (2.*M_PI));
-}
-
-void bob::machine::GaborJetSimilarity::compute_confidences(const blitz::Array<double,2>& jet1, const blitz::Array<double,2>& jet2) const{
-  // first, fill confidence and phase difference vectors
-  for (int j = m_confidences.size(); j--;){
-    m_confidences[j] = jet1(0,j) * jet2(0,j);
-    m_phase_differences[j] = adjustPhase(jet1(1,j) - jet2(1,j));
-  }
-}
-
-void bob::machine::GaborJetSimilarity::compute_disparity() const{
+blitz::TinyVector<double,2> bob::machine::GaborJetSimilarity::compute_disparity(const double* abs1, const double* phase1, const double* abs2, const double* phase2) const{
   // approximate the disparity from the phase differences
   double gamma_x_x = 0., gamma_x_y = 0., gamma_y_y = 0., phi_x = 0., phi_y = 0.;
   // initialize the disparity with 0
-  m_disparity = 0.;
+  blitz::TinyVector<double,2> disparity(0., 0.);
 
-  const std::vector<blitz::TinyVector<double,2> >& kernels = m_gwt.kernelFrequencies();
   // iterate backwards through the vector to start with the lowest frequency wavelets
-  for (int j = m_confidences.size()-1, level = m_gwt.numberOfScales()-1; level >= 0; --level){
+  for (int j = m_kernels_y.size()-1, level = m_gwt.numberOfScales()-1; level >= 0; --level){
     for (int direction = m_gwt.numberOfDirections()-1; direction >= 0; --direction, --j){
       double
-          kjx = kernels[j][1],
-          kjy = kernels[j][0],
-          conf = m_confidences[j],
-          diff = m_phase_differences[j];
+          kjx = m_kernels_x[j],
+          kjy = m_kernels_y[j],
+          conf = abs1[j] * abs2[j],
+          diff = adjustPhase(phase1[j] - phase2[j]);
 
       // totalize gamma matrix
       gamma_x_x += kjx * kjx * conf;
@@ -171,7 +187,7 @@ void bob::machine::GaborJetSimilarity::compute_disparity() const{
 
       // totalize phi vector
       // estimate the number of cycles that we are off
-      double nL = round((diff - m_disparity[1] * kjx - m_disparity[0] * kjy) / (2.*M_PI));
+      double nL = round((diff - disparity[1] * kjx - disparity[0] * kjy) / (2.*M_PI));
       // totalize corrected phi vector elements
       phi_x += (diff - nL * 2. * M_PI) * conf * kjx;
       phi_y += (diff - nL * 2. * M_PI) * conf * kjy;
@@ -179,10 +195,12 @@ void bob::machine::GaborJetSimilarity::compute_disparity() const{
 
     // re-calculate disparity as d=\Gamma^{-1}\Phi of the (low frequency) wavelet scales that we used up to now
     double gamma_det = gamma_x_x * gamma_y_y - sqr(gamma_x_y);
-    m_disparity[1] = (gamma_y_y * phi_x - gamma_x_y * phi_y) / gamma_det;
-    m_disparity[0] = (gamma_x_x * phi_y - gamma_x_y * phi_x) / gamma_det;
+    disparity[1] = (gamma_y_y * phi_x - gamma_x_y * phi_y) / gamma_det;
+    disparity[0] = (gamma_x_x * phi_y - gamma_x_y * phi_x) / gamma_det;
 
   } // for level
+
+  return disparity;
 }
 
 
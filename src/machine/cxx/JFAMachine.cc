@@ -26,6 +26,7 @@
 #include "bob/math/inv.h"
 #include "bob/machine/Exception.h"
 #include "bob/machine/LinearScoring.h"
+#include "bob/core/parallel.h"
 #include <cmath>
 
 
@@ -448,3 +449,128 @@ void bob::machine::JFAMachine::forward(boost::shared_ptr<const bob::machine::GMM
   score = scores(0,0);
 }
 
+
+namespace bob { namespace machine { namespace detail {
+
+  /**
+   * Estimates the channel factors x and offsets Ux of a shard of the 
+   * probes. The probe independent terms U_{c}^T.Sigma_{c}^-1.U_{c} and 
+   * U^T.Sigma^-1 are shared by all the threads. The shared arrays (and the
+   * statistics) are only read element-wise or through expressions, as
+   * slicing them would update their reference counts from several threads.
+   */
+  struct JFAChannelEstimator {
+    const blitz::Array<double,2>* U;
+    const blitz::Array<double,2>* UtSigmaInv;
+    const std::vector<blitz::Array<double,2> >* UtSigmaInvU_c;
+    const blitz::Array<double,1>* mean;
+    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >* probes;
+    blitz::Array<double,2>* x;
+    std::vector<blitz::Array<double,1> >* Ux;
+
+    void operator()(size_t, size_t start, size_t end) const {
+      const int C = UtSigmaInvU_c->size();
+      const int ru = U->extent(1);
+      const int D = (C > 0 ? mean->extent(0) / C : 0);
+      blitz::Array<double,2> A(ru, ru), A_inv(ru, ru);
+      blitz::Array<double,1> Fn_x(mean->extent(0)), b(ru), x_p(ru);
+
+      for (size_t p=start; p<end; ++p) {
+        const bob::machine::GMMStats& stats = *(*probes)[p];
+        blitz::Array<double,1>& Ux_p = (*Ux)[p];
+        if (ru == 0) {
+          Ux_p = 0.;
+          continue;
+        }
+
+        // (Id + sum_{c=1..C} N_{i,h}.U_{c}^T.Sigma_{c}^-1.U_{c})^-1
+        bob::math::eye(A);
+        for (int c=0; c<C; ++c) A += (*UtSigmaInvU_c)[c] * stats.n(c);
+        bob::math::inv(A, A_inv);
+
+        // N*(o - m)
+        for (int c=0; c<C; ++c)
+          for (int d=0; d<D; ++d)
+            Fn_x(c*D+d) = stats.sumPx(c,d) - (*mean)(c*D+d) * stats.n(c);
+
+        // x = (Id + ...)^-1.U^T.Sigma^-1.N*(o - m) and Ux
+        bob::math::prod(*UtSigmaInv, Fn_x, b);
+        bob::math::prod(A_inv, b, x_p);
+        for (int k=0; k<ru; ++k) (*x)((int)p,k) = x_p(k);
+        bob::math::prod(*U, x_p, Ux_p);
+      }
+    }
+  };
+
+}}}
+
+bob::machine::JFAScorer::JFAScorer(
+    const boost::shared_ptr<const bob::machine::JFABaseMachine> jfa_base,
+    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+    const size_t n_threads):
+  m_jfa_base(jfa_base), m_probes(probes), m_n_threads(n_threads)
+{
+  if (!m_jfa_base) throw bob::machine::JFAMachineNoJFABaseSet();
+  if (!m_jfa_base->getUbm()) throw bob::machine::JFABaseNoUBMSet();
+
+  const int C = m_jfa_base->getDimC();
+  const int D = m_jfa_base->getDimD();
+  const int CD = m_jfa_base->getDimCD();
+  const int ru = m_jfa_base->getDimRu();
+  for (size_t p=0; p<m_probes.size(); ++p) {
+    bob::core::array::assertSameDimensionLength(m_probes[p]->sumPx.extent(0), C);
+    bob::core::array::assertSameDimensionLength(m_probes[p]->sumPx.extent(1), D);
+  }
+
+  const blitz::Array<double,2>& U = m_jfa_base->getU();
+  blitz::Array<double,1> mean(CD), sigma(CD);
+  m_jfa_base->getUbm()->getMeanSupervector(mean);
+  m_jfa_base->getUbm()->getVarianceSupervector(sigma);
+
+  // U^T.Sigma^-1 and U_{c}^T.Sigma_{c}^-1.U_{c}, computed once for all 
+  // the probes
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  blitz::Range rall = blitz::Range::all();
+  blitz::Array<double,2> UtSigmaInv(ru, CD);
+  UtSigmaInv = U(j,i) / sigma(j);
+  std::vector<blitz::Array<double,2> > UtSigmaInvU_c(C);
+  for (int c=0; c<C; ++c) {
+    blitz::Range rc(c*D, (c+1)*D-1);
+    blitz::Array<double,2> UtSigmaInv_c = UtSigmaInv(rall,rc);
+    blitz::Array<double,2> U_c = U(rc,rall);
+    UtSigmaInvU_c[c].resize(ru, ru);
+    bob::math::prod(UtSigmaInv_c, U_c, UtSigmaInvU_c[c]);
+  }
+
+  m_x.resize(m_probes.size(), ru);
+  m_Ux.resize(m_probes.size());
+  for (size_t p=0; p<m_probes.size(); ++p) m_Ux[p].resize(CD);
+
+  bob::machine::detail::JFAChannelEstimator f = {&U, &UtSigmaInv, 
+    &UtSigmaInvU_c, &mean, &m_probes, &m_x, &m_Ux};
+  bob::core::parallelFor(m_probes.size(), m_n_threads, f);
+}
+
+void bob::machine::JFAScorer::score(
+    const std::vector<boost::shared_ptr<const bob::machine::JFAMachine> >& models,
+    blitz::Array<double,2>& scores) const
+{
+  // m + Vy + Dz, for each model
+  const blitz::Array<double,1>& mean = m_jfa_base->getUbm()->getMeanSupervector();
+  std::vector<blitz::Array<double,1> > mVyDz(models.size());
+  for (size_t m=0; m<models.size(); ++m) {
+    const boost::shared_ptr<bob::machine::JFABaseMachine> base = models[m]->getJFABase();
+    if (!base) throw bob::machine::JFAMachineNoJFABaseSet();
+    if (base.get() != m_jfa_base.get() && !(*base == *m_jfa_base))
+      throw std::runtime_error("The JFAMachine's should share the JFABaseMachine of the JFAScorer");
+    mVyDz[m].resize(m_jfa_base->getDimCD());
+    bob::math::prod(m_jfa_base->getV(), models[m]->getY(), mVyDz[m]);
+    mVyDz[m] += m_jfa_base->getD() * models[m]->getZ() + mean;
+  }
+
+  // Linear scoring of all the probes against all the models at once
+  bob::machine::linearScoring(mVyDz, mean, 
+    m_jfa_base->getUbm()->getVarianceSupervector(), m_probes, m_Ux, true, 
+    scores, m_n_threads);
+}
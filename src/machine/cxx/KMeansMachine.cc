@@ -24,6 +24,7 @@
 #include "bob/core/array_assert.h"
 #include "bob/core/array_copy.h"
 #include "bob/machine/Exception.h"
+#include "bob/math/gemm.h"
 #include <limits>
 
 bob::machine::KMeansMachine::KMeansMachine(): 
@@ -120,7 +121,15 @@ void bob::machine::KMeansMachine::getMean(const size_t i, blitz::Array<double,1>
 double bob::machine::KMeansMachine::getDistanceFromMean(const blitz::Array<double,1> &x, 
   const size_t i) const 
 {
-  return blitz::sum(blitz::pow2(m_means(i,blitz::Range::all()) - x));
+  // The means are accessed element-wise rather than through a slice, which
+  // would modify their (non thread-safe) reference count: the machine can
+  // hence be shared by several threads.
+  double distance = 0.;
+  for(int k=0; k<x.extent(0); ++k) {
+    const double v = m_means((int)i,k) - x(k);
+    distance += v * v;
+  }
+  return distance;
 }
 
 void bob::machine::KMeansMachine::getClosestMean(const blitz::Array<double,1> &x, 
@@ -145,26 +154,67 @@ double bob::machine::KMeansMachine::getMinDistance(const blitz::Array<double,1>&
   return min_distance;
 }
 
+void bob::machine::KMeansMachine::getDistancesFromMeans(const blitz::Array<double,2>& data,
+  blitz::Array<double,2>& distances) const
+{
+  // check arguments
+  bob::core::array::assertSameDimensionLength(data.extent(1), m_n_inputs);
+  bob::core::array::assertSameDimensionLength(distances.extent(0), data.extent(0));
+  bob::core::array::assertSameDimensionLength(distances.extent(1), m_n_means);
+  getDistancesFromMeans_(data, distances);
+}
+
+void bob::machine::KMeansMachine::getDistancesFromMeans_(const blitz::Array<double,2>& data,
+  blitz::Array<double,2>& distances) const
+{
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+
+  // -2 x.m for all the pairs at once
+  bob::math::gemm_(data, m_means, distances, false, true, -2.);
+
+  // + ||x||^2 + ||m||^2 (rounding errors may lead to tiny negative values)
+  blitz::Array<double,1> data_norms(blitz::sum(blitz::pow2(data(i,j)), j));
+  blitz::Array<double,1> mean_norms(blitz::sum(blitz::pow2(m_means(i,j)), j));
+  distances = distances(i,j) + data_norms(i) + mean_norms(j);
+  distances = blitz::where(distances < 0., 0., distances);
+}
+
 void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterInit(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const 
+{
+  getVariancesAndWeightsForEachClusterInit(variances, weights, m_cache_means);
+}
+
+void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterAcc(const blitz::Array<double,2>& data, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const 
+{
+  getVariancesAndWeightsForEachClusterAcc(data, variances, weights, m_cache_means);
+}
+
+void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterFin(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const 
+{
+  getVariancesAndWeightsForEachClusterFin(variances, weights, m_cache_means);
+}
+
+void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterInit(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights, blitz::Array<double,2>& means) const 
 {
   // check arguments
   bob::core::array::assertSameShape(variances, m_means);
+  bob::core::array::assertSameShape(means, m_means);
   bob::core::array::assertSameDimensionLength(weights.extent(0), m_n_means);
 
   // initialise output arrays
-  bob::core::array::assertSameShape(variances, m_means);
-  bob::core::array::assertSameDimensionLength(weights.extent(0), m_n_means);
   variances = 0;
   weights = 0;
   
   // initialise (temporary) mean array
-  m_cache_means = 0;
+  means = 0;
 }
   
-void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterAcc(const blitz::Array<double,2>& data, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const 
+void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterAcc(const blitz::Array<double,2>& data, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights, blitz::Array<double,2>& means) const 
 {
   // check arguments
   bob::core::array::assertSameShape(variances, m_means);
+  bob::core::array::assertSameShape(means, m_means);
   bob::core::array::assertSameDimensionLength(weights.extent(0), m_n_means);
 
   // iterate over data
@@ -179,16 +229,17 @@ void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterAcc(const
     getClosestMean(x,closest_mean,min_distance);
     
     // - accumulate stats
-    m_cache_means(closest_mean, blitz::Range::all()) += x;
+    means(closest_mean, blitz::Range::all()) += x;
     variances(closest_mean, blitz::Range::all()) += blitz::pow2(x);
     ++weights(closest_mean);
   }
 }
   
-void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterFin(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const 
+void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterFin(blitz::Array<double,2>& variances, blitz::Array<double,1>& weights, blitz::Array<double,2>& means) const 
 {
   // check arguments
   bob::core::array::assertSameShape(variances, m_means);
+  bob::core::array::assertSameShape(means, m_means);
   bob::core::array::assertSameDimensionLength(weights.extent(0), m_n_means);
 
   // calculate final variances and weights
@@ -196,11 +247,11 @@ void bob::machine::KMeansMachine::getVariancesAndWeightsForEachClusterFin(blitz:
   blitz::secondIndex idx2;
   
   // find means
-  m_cache_means = m_cache_means(idx1,idx2) / weights(idx1);
+  means = means(idx1,idx2) / weights(idx1);
   
   // find variances
   variances = variances(idx1,idx2) / weights(idx1);
-  variances -= blitz::pow2(m_cache_means);
+  variances -= blitz::pow2(means);
   
   // find weights
   weights = weights / blitz::sum(weights);
@@ -214,12 +265,15 @@ void bob::machine::KMeansMachine::setCacheMeans(const blitz::Array<double,2> &ca
 
 void bob::machine::KMeansMachine::getVariancesAndWeightsForEachCluster(const blitz::Array<double,2>& data, blitz::Array<double,2>& variances, blitz::Array<double,1>& weights) const 
 {
+  // the means are accumulated into a local array, so that this method can
+  // be called concurrently
+  blitz::Array<double,2> means(m_means.shape());
   // initialise
-  getVariancesAndWeightsForEachClusterInit(variances, weights);
+  getVariancesAndWeightsForEachClusterInit(variances, weights, means);
   // accumulate
-  getVariancesAndWeightsForEachClusterAcc(data, variances, weights);
+  getVariancesAndWeightsForEachClusterAcc(data, variances, weights, means);
   // merge/finalize
-  getVariancesAndWeightsForEachClusterFin(variances, weights);
+  getVariancesAndWeightsForEachClusterFin(variances, weights, means);
 }
 
 void bob::machine::KMeansMachine::forward(const blitz::Array<double,1>& input, double& output) const 
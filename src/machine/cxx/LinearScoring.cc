@@ -18,7 +18,13 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "bob/machine/LinearScoring.h"
-#include "bob/math/linear.h"
+#include "bob/math/gemm.h"
+#include "bob/core/array_assert.h"
+#include "bob/core/array_check.h"
+#include "bob/core/array_copy.h"
+#include "bob/core/parallel.h"
+#include <algorithm>
+#include <limits>
 
 namespace ca = bob::core::array;
 
@@ -27,106 +33,250 @@ namespace bob { namespace machine {
 
 namespace detail {
 
-  void linearScoring(const std::vector<blitz::Array<double,1> >& models,
+  /**
+   * Number of test statistics processed at once by each thread. The
+   * corresponding block of centered statistics (block x CD) and of scores
+   * (models x block) stays small, while the product with the model matrix
+   * remains large enough for dgemm to run at full speed.
+   */
+  static const int s_probe_block_size = 128;
+
+  /**
+   * Scores a shard of the test statistics, block by block. The columns of
+   * the scores of each shard are sliced by the calling thread, and the
+   * shared arrays are only accessed element-wise (or given to dgemm when
+   * C-contiguous), as creating blitz views modifies their (non thread-safe)
+   * reference counts.
+   */
+  struct LinearScorer {
+    const blitz::Array<double,2>* A;
+    const double* ubm_mean;
+    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >* test_stats;
+    const std::vector<blitz::Array<double,1> >* test_channelOffset;
+    bool frame_length_normalisation;
+    std::vector<blitz::Array<double,2> >* scores;
+
+    void operator()(size_t thread, size_t start, size_t end) const {
+      const int Tm = A->extent(0);
+      const int C = (*test_stats)[0]->sumPx.extent(0);
+      const int D = (*test_stats)[0]->sumPx.extent(1);
+      const int block = std::min<int>(s_probe_block_size, end - start);
+      blitz::Array<double,2> B(block, C*D);
+      blitz::Array<double,2> S(Tm, block);
+      blitz::Array<double,2>& shard_scores = (*scores)[thread];
+
+      for (int t0=start; t0<(int)end; t0+=block) {
+        const int n = std::min<int>(block, end - t0);
+        for (int k=0; k<n; ++k) {
+          const bob::machine::GMMStats& stats = *(*test_stats)[t0+k];
+          double* b = B.data() + (size_t)k * C * D;
+
+          // frame length normalisation, if requested
+          double sum_N = 1.;
+          if (frame_length_normalisation) {
+            sum_N = stats.T;
+            if (sum_N <= std::numeric_limits<double>::epsilon() && sum_N >= -std::numeric_limits<double>::epsilon()) {
+              std::fill(b, b + C*D, 0.);
+              continue;
+            }
+          }
+
+          // centered first order statistics, in the natural (C,D) layout
+          const double* mean = ubm_mean;
+          if (test_channelOffset == 0) {
+            for (int c=0; c<C; ++c, b+=D, mean+=D) {
+              const double n_c = stats.n(c);
+              for (int d=0; d<D; ++d)
+                b[d] = (stats.sumPx(c,d) - mean[d] * n_c) / sum_N;
+            }
+          }
+          else {
+            const blitz::Array<double,1>& o = (*test_channelOffset)[t0+k];
+            for (int c=0, cd=0; c<C; ++c, b+=D, mean+=D) {
+              const double n_c = stats.n(c);
+              for (int d=0; d<D; ++d, ++cd)
+                b[d] = (stats.sumPx(c,d) - n_c * (mean[d] + o(cd))) / sum_N;
+            }
+          }
+        }
+
+        // LLR of all the models against this block
+        blitz::Array<double,2> B_ = B(blitz::Range(0,n-1), blitz::Range::all());
+        blitz::Array<double,2> S_ = S(blitz::Range::all(), blitz::Range(0,n-1));
+        bob::math::gemm_(*A, B_, S_, false, true);
+        for (int m=0; m<Tm; ++m)
+          for (int k=0; k<n; ++k)
+            shard_scores(m, t0-(int)start+k) = S_(m,k);
+      }
+    }
+  };
+
+  void linearScoring(const blitz::Array<double,2>& A,
                      const blitz::Array<double,1>& ubm_mean,
-                     const blitz::Array<double,1>& ubm_variance,
                      const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
                      const std::vector<blitz::Array<double,1> >* test_channelOffset,
                      const bool frame_length_normalisation,
-                     blitz::Array<double,2>& scores) 
+                     blitz::Array<double,2>& scores,
+                     const size_t n_threads)
   {
-    int C = test_stats[0]->sumPx.extent(0);
-    int D = test_stats[0]->sumPx.extent(1);
-    int CD = C*D;
     int Tt = test_stats.size();
-    int Tm = models.size();
+    int Tm = A.extent(0);
 
     // Check output size
-    ca::assertSameDimensionLength(scores.extent(0), models.size());
-    ca::assertSameDimensionLength(scores.extent(1), test_stats.size());
+    ca::assertSameDimensionLength(scores.extent(0), Tm);
+    ca::assertSameDimensionLength(scores.extent(1), Tt);
+    if (Tt == 0 || Tm == 0) return;
 
-    blitz::Array<double,2> A(Tm, CD);
-    blitz::Array<double,2> B(CD, Tt);
-
-    // 1) Compute A
-    for(int t=0; t<Tm; ++t) {
-      blitz::Array<double, 1> tmp = A(t, blitz::Range::all());
-      tmp = (models[t] - ubm_mean) / ubm_variance;
-    }
-
-    // 2) Compute B
-    if(test_channelOffset == 0) {
-      for(int t=0; t<Tt; ++t) 
-        for(int s=0; s<CD; ++s)
-          B(s, t) = test_stats[t]->sumPx(s/D, s%D) - (ubm_mean(s) * test_stats[t]->n(s/D));
+    int C = test_stats[0]->sumPx.extent(0);
+    int D = test_stats[0]->sumPx.extent(1);
+    int CD = C*D;
+    ca::assertSameDimensionLength(A.extent(1), CD);
+    ca::assertSameDimensionLength(ubm_mean.extent(0), CD);
+    for (int t=0; t<Tt; ++t) {
+      ca::assertSameDimensionLength(test_stats[t]->sumPx.extent(0), C);
+      ca::assertSameDimensionLength(test_stats[t]->sumPx.extent(1), D);
     }
-    else {
+    if (test_channelOffset != 0) {
       ca::assertSameDimensionLength((*test_channelOffset).size(), Tt);
-      
-      for(int t=0; t<Tt; ++t) {
+      for (int t=0; t<Tt; ++t)
         ca::assertSameDimensionLength((*test_channelOffset)[t].extent(0), CD);
-        for(int s=0; s<CD; ++s) 
-          B(s, t) = test_stats[t]->sumPx(s/D, s%D) - (test_stats[t]->n(s/D) * (ubm_mean(s) + (*test_channelOffset)[t](s)));
-      }
     }
 
-    // Apply the normalisation if needed
-    if(frame_length_normalisation) {
-      for(int t=0; t<Tt; ++t) {
-        double sum_N = test_stats[t]->T;
-        blitz::Array<double, 1> v_t = B(blitz::Range::all(),t);
+    // The model matrix is shared by all the threads (and not copied again
+    // by each call to dgemm)
+    blitz::Array<double,2> A_ = (ca::isCZeroBaseContiguous(A) ? A : ca::ccopy(A));
+    blitz::Array<double,1> mean = (ca::isCZeroBaseContiguous(ubm_mean) ? ubm_mean : ca::ccopy(ubm_mean));
+
+    // The columns of the scores computed by each thread
+    const size_t n = bob::core::getNThreads(n_threads, Tt);
+    std::vector<blitz::Array<double,2> > shard_scores(n);
+    for (size_t t=0; t<n; ++t)
+      shard_scores[t].reference(scores(blitz::Range::all(), 
+        blitz::Range(bob::core::shardStart(t, n, Tt), 
+                     bob::core::shardStart(t+1, n, Tt)-1)));
+
+    LinearScorer scorer = {&A_, mean.data(), &test_stats, test_channelOffset,
+      frame_length_normalisation, &shard_scores};
+    bob::core::parallelFor(Tt, n, scorer);
+  }
+
+  /**
+   * Normalised offsets of the models of a shard, one model per row of A.
+   * The arrays are accessed element-wise, without creating views of them.
+   */
+  struct ModelNormaliser {
+    const std::vector<const blitz::Array<double,1>*>* models;
+    const blitz::Array<double,1>* ubm_mean;
+    const blitz::Array<double,1>* ubm_variance;
+    blitz::Array<double,2>* A;
 
-        if (sum_N <= std::numeric_limits<double>::epsilon() && sum_N >= -std::numeric_limits<double>::epsilon())
-          v_t = 0;
-        else 
-          v_t /= sum_N;
+    void operator()(size_t, size_t start, size_t end) const {
+      const int CD = A->extent(1);
+      for (int t=start; t<(int)end; ++t) {
+        const blitz::Array<double,1>& model = *(*models)[t];
+        for (int k=0; k<CD; ++k)
+          (*A)(t,k) = (model(k) - (*ubm_mean)(k)) / (*ubm_variance)(k);
       }
     }
+  };
 
-    // 3) Compute LLR
-    bob::math::prod(A, B, scores);
-  } 
+  static void linearScoringModels(const std::vector<const blitz::Array<double,1>*>& models,
+                                  const blitz::Array<double,1>& ubm_mean,
+                                  const blitz::Array<double,1>& ubm_variance,
+                                  blitz::Array<double,2>& A,
+                                  const size_t n_threads)
+  {
+    const int CD = ubm_mean.extent(0);
+    ca::assertSameDimensionLength(ubm_variance.extent(0), CD);
+    ca::assertSameDimensionLength(A.extent(0), models.size());
+    ca::assertSameDimensionLength(A.extent(1), CD);
+    for (size_t t=0; t<models.size(); ++t)
+      ca::assertSameDimensionLength(models[t]->extent(0), CD);
+
+    ModelNormaliser normaliser = {&models, &ubm_mean, &ubm_variance, &A};
+    bob::core::parallelFor(models.size(), n_threads, normaliser);
+  }
+}
+
+
+void linearScoringModels(const std::vector<blitz::Array<double,1> >& models,
+                         const blitz::Array<double,1>& ubm_mean, const blitz::Array<double,1>& ubm_variance,
+                         blitz::Array<double,2>& A,
+                         const size_t n_threads)
+{
+  std::vector<const blitz::Array<double,1>*> models_p(models.size());
+  for(size_t i=0; i<models.size(); ++i) models_p[i] = &models[i];
+  detail::linearScoringModels(models_p, ubm_mean, ubm_variance, A, n_threads);
+}
+
+void linearScoringModels(const std::vector<boost::shared_ptr<const bob::machine::GMMMachine> >& models,
+                         const bob::machine::GMMMachine& ubm,
+                         blitz::Array<double,2>& A,
+                         const size_t n_threads)
+{
+  // Uses the (cached) mean supervectors of the models, without copying them
+  std::vector<const blitz::Array<double,1>*> models_p(models.size());
+  for(size_t i=0; i<models.size(); ++i) models_p[i] = &models[i]->getMeanSupervector();
+  detail::linearScoringModels(models_p, ubm.getMeanSupervector(), ubm.getVarianceSupervector(), A, n_threads);
+}
+
+void linearScoring(const blitz::Array<double,2>& models_normalised,
+                   const blitz::Array<double,1>& ubm_mean,
+                   const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
+                   const std::vector<blitz::Array<double,1> >& test_channelOffset,
+                   const bool frame_length_normalisation,
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads)
+{
+  detail::linearScoring(models_normalised, ubm_mean, test_stats, &test_channelOffset, frame_length_normalisation, scores, n_threads);
 }
 
+void linearScoring(const blitz::Array<double,2>& models_normalised,
+                   const blitz::Array<double,1>& ubm_mean,
+                   const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
+                   const bool frame_length_normalisation,
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads)
+{
+  detail::linearScoring(models_normalised, ubm_mean, test_stats, 0, frame_length_normalisation, scores, n_threads);
+}
 
 void linearScoring(const std::vector<blitz::Array<double,1> >& models,
                    const blitz::Array<double,1>& ubm_mean, const blitz::Array<double,1>& ubm_variance,
                    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
                    const std::vector<blitz::Array<double,1> >& test_channelOffset,
                    const bool frame_length_normalisation,
-                   blitz::Array<double, 2>& scores)
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads)
 {
-  detail::linearScoring(models, ubm_mean, ubm_variance, test_stats, &test_channelOffset, frame_length_normalisation, scores);
+  blitz::Array<double,2> A(models.size(), ubm_mean.extent(0));
+  linearScoringModels(models, ubm_mean, ubm_variance, A, n_threads);
+  detail::linearScoring(A, ubm_mean, test_stats, &test_channelOffset, frame_length_normalisation, scores, n_threads);
 }
 
 void linearScoring(const std::vector<blitz::Array<double,1> >& models,
                    const blitz::Array<double,1>& ubm_mean, const blitz::Array<double,1>& ubm_variance,
                    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
                    const bool frame_length_normalisation,
-                   blitz::Array<double, 2>& scores)
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads)
 {
-  detail::linearScoring(models, ubm_mean, ubm_variance, test_stats, 0, frame_length_normalisation, scores);
+  blitz::Array<double,2> A(models.size(), ubm_mean.extent(0));
+  linearScoringModels(models, ubm_mean, ubm_variance, A, n_threads);
+  detail::linearScoring(A, ubm_mean, test_stats, 0, frame_length_normalisation, scores, n_threads);
 }
 
 void linearScoring(const std::vector<boost::shared_ptr<const bob::machine::GMMMachine> >& models,
                    const bob::machine::GMMMachine& ubm,
                    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
                    const bool frame_length_normalisation,
-                   blitz::Array<double, 2>& scores) 
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads)
 {
-  int C = test_stats[0]->sumPx.extent(0);
-  int D = test_stats[0]->sumPx.extent(1);
-  int CD = C*D;
-  std::vector<blitz::Array<double,1> > models_b;
-  // Allocate and get the mean supervector
-  for(size_t i=0; i<models.size(); ++i) {
-    blitz::Array<double,1> mod(CD);
-    models[i]->getMeanSupervector(mod);
-    models_b.push_back(mod);
-  }
   const blitz::Array<double,1>& ubm_mean = ubm.getMeanSupervector();
-  const blitz::Array<double,1>& ubm_variance = ubm.getVarianceSupervector();
-  detail::linearScoring(models_b, ubm_mean, ubm_variance, test_stats, 0, frame_length_normalisation, scores);
+  blitz::Array<double,2> A(models.size(), ubm_mean.extent(0));
+  linearScoringModels(models, ubm, A, n_threads);
+  detail::linearScoring(A, ubm_mean, test_stats, 0, frame_length_normalisation, scores, n_threads);
 }
 
 void linearScoring(const std::vector<boost::shared_ptr<const bob::machine::GMMMachine> >& models,
@@ -134,21 +284,13 @@ void linearScoring(const std::vector<boost::shared_ptr<const bob::machine::GMMMa
                    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& test_stats,
                    const std::vector<blitz::Array<double,1> >& test_channelOffset,
                    const bool frame_length_normalisation,
-                   blitz::Array<double, 2>& scores) 
+                   blitz::Array<double, 2>& scores,
+                   const size_t n_threads)
 {
-  int C = test_stats[0]->sumPx.extent(0);
-  int D = test_stats[0]->sumPx.extent(1);
-  int CD = C*D;
-  std::vector<blitz::Array<double,1> > models_b;
-  // Allocate and get the mean supervector
-  for(size_t i=0; i<models.size(); ++i) {
-    blitz::Array<double,1> mod(CD);
-    models[i]->getMeanSupervector(mod);
-    models_b.push_back(mod);
-  }
   const blitz::Array<double,1>& ubm_mean = ubm.getMeanSupervector();
-  const blitz::Array<double,1>& ubm_variance = ubm.getVarianceSupervector();
-  detail::linearScoring(models_b, ubm_mean, ubm_variance, test_stats, &test_channelOffset, frame_length_normalisation, scores);
+  blitz::Array<double,2> A(models.size(), ubm_mean.extent(0));
+  linearScoringModels(models, ubm, A, n_threads);
+  detail::linearScoring(A, ubm_mean, test_stats, &test_channelOffset, frame_length_normalisation, scores, n_threads);
 }
 
 }}
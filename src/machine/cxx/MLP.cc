@@ -22,6 +22,7 @@
 
 #include <sys/time.h>
 #include <cmath>
+#include <algorithm>
 #include <boost/format.hpp>
 
 #include "bob/core/array_check.h"
@@ -30,6 +31,7 @@
 #include "bob/machine/MLP.h"
 #include "bob/machine/MLPException.h"
 #include "bob/math/linear.h"
+#include "bob/math/gemm.h"
 
 namespace mach = bob::machine;
 namespace math = bob::math;
@@ -189,17 +191,12 @@ void mach::MLP::forward_ (const blitz::Array<double,1>& input,
   //input -> hidden[0]; hidden[0] -> hidden[1], ..., hidden[N-2] -> hidden[N-1]
   for (size_t j=1; j<m_weight.size(); ++j) {
     math::prod_(m_buffer[j-1], m_weight[j-1], m_buffer[j]);
-    for (int i=0; i<m_buffer[j].extent(0); ++i) {
-      m_buffer[j](i) = m_actfun(m_buffer[j](i) + m_bias[j-1](i));
-    }
+    mach::activate(m_activation, m_bias[j-1], m_buffer[j]);
   }
 
   //hidden[N-1] -> output
   math::prod_(m_buffer.back(), m_weight.back(), output);
-  const blitz::Array<double,1>& last_bias = m_bias.back(); //opt. access
-  for (int i=0; i<output.extent(0); ++i) {
-    output(i) = m_actfun(output(i) + last_bias(i));
-  }
+  mach::activate(m_activation, m_bias.back(), output);
 }
 
 void mach::MLP::forward (const blitz::Array<double,1>& input,
@@ -215,14 +212,45 @@ void mach::MLP::forward (const blitz::Array<double,1>& input,
   forward_(input, output); 
 }
 
+/**
+ * Number of inputs forwarded at once by the 2D variant of forward_(): large
+ * enough for the matrix-matrix products to be efficient, small enough for
+ * the intermediate layers to fit in the cache.
+ */
+static const int s_forward_block_size = 256;
+
 void mach::MLP::forward_ (const blitz::Array<double,2>& input,
     blitz::Array<double,2>& output) const {
 
+  const int n_samples = input.extent(0);
+  m_batch_buffer.resize(m_weight.size());
   blitz::Range all = blitz::Range::all();
-  for (int i=0; i<input.extent(0); ++i) {
-    blitz::Array<double,1> inref(input(i,all));
-    blitz::Array<double,1> outref(output(i,all));
-    forward_(inref, outref);
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+
+  for (int start=0; start<n_samples; start+=s_forward_block_size) {
+    const int size = std::min(s_forward_block_size, n_samples - start);
+    const blitz::Range r(start, start + size - 1);
+    for (size_t k=0; k<m_weight.size(); ++k) {
+      if (m_batch_buffer[k].extent(0) != size ||
+          m_batch_buffer[k].extent(1) != m_weight[k].extent(0))
+        m_batch_buffer[k].resize(size, m_weight[k].extent(0));
+    }
+
+    //normalizes the inputs
+    const blitz::Array<double,2> input_r = input(r,all);
+    m_batch_buffer[0] = (input_r(i,j) - m_input_sub(j)) / m_input_div(j);
+
+    //input -> hidden[0]; ..., hidden[N-2] -> hidden[N-1]
+    for (size_t k=1; k<m_weight.size(); ++k) {
+      math::gemm_(m_batch_buffer[k-1], m_weight[k-1], m_batch_buffer[k]);
+      mach::activate(m_activation, m_bias[k-1], m_batch_buffer[k]);
+    }
+
+    //hidden[N-1] -> output
+    blitz::Array<double,2> output_r = output(r,all);
+    math::gemm_(m_batch_buffer.back(), m_weight.back(), output_r);
+    mach::activate(m_activation, m_bias.back(), output_r);
   }
 }
 
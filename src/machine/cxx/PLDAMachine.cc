@@ -27,10 +27,14 @@
 #include "bob/math/linear.h"
 #include "bob/math/det.h"
 #include "bob/math/inv.h"
+#include "bob/math/gemm.h"
+#include "bob/core/parallel.h"
 
 #include <cmath>
 #include <boost/lexical_cast.hpp>
 #include <string>
+#include <map>
+#include <algorithm>
 
 #include "bob/core/logging.h"
 
@@ -449,9 +453,9 @@ void bob::machine::PLDABaseMachine::precomputeISigma()
 void bob::machine::PLDABaseMachine::precomputeGtISigma() 
 {
   // m_Gt_isigma = G^T \Sigma^{-1}
+  blitz::Array<double,2> Gt = m_G.transpose(1,0);
   blitz::firstIndex i;
   blitz::secondIndex j;
-  blitz::Array<double,2> Gt = m_G.transpose(1,0);
   m_Gt_isigma = Gt(i,j) * m_isigma(j);
 }
 
@@ -948,3 +952,181 @@ void bob::machine::PLDAMachine::clearMaps()
   m_loglike_constterm.clear();
 }
 
+
+
+namespace bob { namespace machine { namespace detail {
+
+  /**
+   * Number of probes processed at once by each thread of the PLDAScorer
+   */
+  static const int s_plda_probe_block_size = 128;
+
+  /**
+   * Scores a shard of the probes against all the models, block by block
+   */
+  struct PLDAScoreBlocks {
+    const blitz::Array<double,2>* probes;
+    const blitz::Array<double,1>* mu;
+    const blitz::Array<double,2>* Ft_beta;
+    const blitz::Array<double,2>* gamma_1;
+    const std::vector<std::vector<int> >* group_models;
+    const std::vector<blitz::Array<double,2> >* group_gamma;
+    const std::vector<blitz::Array<double,2> >* group_weighted_sums;
+    const std::vector<blitz::Array<double,1> >* group_offsets;
+    blitz::Array<double,2>* scores;
+
+    void operator()(size_t, size_t start, size_t end) const {
+      const int D = mu->extent(0);
+      const int F = Ft_beta->extent(0);
+      const int block = std::min<int>(s_plda_probe_block_size, end - start);
+      const int p0 = probes->stride(0);
+      const int p1 = probes->stride(1);
+      const double* mu_data = mu->data();
+      const int m0 = mu->stride(0);
+      blitz::Range a = blitz::Range::all();
+      blitz::Array<double,2> X(block, D);
+      blitz::Array<double,2> P(block, F);
+      blitz::Array<double,2> PG(block, F);
+      blitz::Array<double,1> q_1(block);
+      blitz::Array<double,1> q_a(block);
+      blitz::Array<double,2> S;
+
+      for (int t0=start; t0<(int)end; t0+=block) {
+        const int n = std::min<int>(block, end - t0);
+        blitz::Range r(0, n-1);
+        blitz::Array<double,2> X_ = X(r,a);
+        blitz::Array<double,2> P_ = P(r,a);
+        blitz::Array<double,2> PG_ = PG(r,a);
+
+        // P = (x - mu)^T.beta.F, for all the probes of the block. The
+        // shared arrays are read through their data pointers, as creating
+        // blitz slices of them would modify their (non thread-safe)
+        // reference counts.
+        for (int k=0; k<n; ++k) {
+          const double* x = probes->data() + (t0+k) * p0;
+          for (int d=0; d<D; ++d) X_(k,d) = x[d*p1] - mu_data[d*m0];
+        }
+        bob::math::gemm_(X_, *Ft_beta, P_, false, true);
+
+        // 'no match' term of the probe alone: p^T.gamma_1.p
+        bob::math::gemm_(P_, *gamma_1, PG_);
+        for (int k=0; k<n; ++k) q_1(k) = blitz::sum(PG_(k,a) * P_(k,a));
+
+        for (size_t g=0; g<group_models->size(); ++g) {
+          const std::vector<int>& models = (*group_models)[g];
+          const blitz::Array<double,1>& offsets = (*group_offsets)[g];
+          const int M = models.size();
+
+          // 'match' term of the probe alone: p^T.gamma_a.p
+          bob::math::gemm_(P_, (*group_gamma)[g], PG_);
+          for (int k=0; k<n; ++k) 
+            q_a(k) = 0.5 * (blitz::sum(PG_(k,a) * P_(k,a)) - q_1(k));
+
+          // cross terms between the models and the probes
+          S.resize(M, n);
+          bob::math::gemm_((*group_weighted_sums)[g], P_, S, false, true);
+          for (int i=0; i<M; ++i) {
+            const int m = models[i];
+            for (int k=0; k<n; ++k)
+              (*scores)(m,t0+k) = offsets(i) + 0.5 * S(i,k) + q_a(k);
+          }
+        }
+      }
+    }
+  };
+
+}}}
+
+bob::machine::PLDAScorer::PLDAScorer(
+    const std::vector<boost::shared_ptr<const bob::machine::PLDAMachine> >& models,
+    const size_t n_threads):
+  m_n_threads(n_threads), m_n_models(models.size())
+{
+  if (models.size() == 0) return;
+  const boost::shared_ptr<bob::machine::PLDABaseMachine> base = models[0]->getPLDABase();
+  if (!base) 
+    throw std::runtime_error("The PLDAMachine's should have an attached PLDABaseMachine");
+  for (size_t m=1; m<models.size(); ++m) {
+    const boost::shared_ptr<bob::machine::PLDABaseMachine> b = models[m]->getPLDABase();
+    if (b != base && (!b || *b != *base))
+      throw std::runtime_error("All the PLDAMachine's should share the same PLDABaseMachine");
+  }
+
+  const int F = base->getDimF();
+  m_mu.reference(bob::core::array::ccopy(base->getMu()));
+  m_Ft_beta.reference(bob::core::array::ccopy(base->getFtBeta()));
+
+  // gamma_a = (Id + a.F^T.beta.F)^-1 and the related constant terms are
+  // computed here rather than through the (lazily filled) maps of the 
+  // machines, so that nothing shared is modified.
+  blitz::Array<double,2> Ft_beta_F(F, F);
+  bob::math::prod(m_Ft_beta, base->getF(), Ft_beta_F);
+  blitz::Array<double,2> tmp(F, F);
+  std::map<size_t, size_t> groups; // number of enrolled samples -> group
+  for (size_t m=0; m<models.size(); ++m) {
+    const size_t n = models[m]->getNSamples();
+    if (groups.find(n) == groups.end()) {
+      groups[n] = m_group_models.size();
+      m_group_models.push_back(std::vector<int>());
+    }
+    m_group_models[groups[n]].push_back(m);
+  }
+
+  tmp = Ft_beta_F;
+  for (int i=0; i<F; ++i) tmp(i,i) += 1.;
+  m_gamma_1.resize(F, F);
+  bob::math::inv(tmp, m_gamma_1);
+  const double constterm_1 = base->computeLogLikeConstTerm(1, m_gamma_1);
+
+  m_group_gamma.resize(m_group_models.size());
+  m_group_weighted_sums.resize(m_group_models.size());
+  m_group_offsets.resize(m_group_models.size());
+  for (std::map<size_t, size_t>::const_iterator it=groups.begin(); 
+      it!=groups.end(); ++it) 
+  {
+    const size_t a = it->first + 1;
+    const std::vector<int>& group = m_group_models[it->second];
+    const int M = group.size();
+
+    blitz::Array<double,2> gamma_a(F, F);
+    tmp = static_cast<double>(a) * Ft_beta_F;
+    for (int k=0; k<F; ++k) tmp(k,k) += 1.;
+    bob::math::inv(tmp, gamma_a);
+    const double constterm_a = base->computeLogLikeConstTerm(a, gamma_a);
+    tmp = gamma_a + gamma_a.transpose(1,0);
+
+    blitz::Array<double,2> weighted_sums(M, F);
+    blitz::Array<double,1> offsets(M);
+    blitz::Array<double,1> ws(F), gws(F);
+    for (int k=0; k<M; ++k) {
+      const bob::machine::PLDAMachine& model = *models[group[k]];
+      if (model.getNSamples() > 0) ws = model.getWeightedSum();
+      else ws = 0.;
+      // (gamma_a + gamma_a^T).s, as s^T.gamma_a.p + p^T.gamma_a.s is the
+      // cross term of the 'match' log-likelihood
+      bob::math::prod(tmp, ws, gws);
+      weighted_sums(k,blitz::Range::all()) = gws;
+      // l_a - l_1 + nh_sum_xit_beta_xi + 1/2.s^T.gamma_a.s - loglikelihood
+      offsets(k) = constterm_a - constterm_1 + model.getWSumXitBetaXi() +
+        0.25 * blitz::sum(ws * gws) - model.getLogLikelihood();
+    }
+
+    m_group_gamma[it->second].reference(gamma_a);
+    m_group_weighted_sums[it->second].reference(weighted_sums);
+    m_group_offsets[it->second].reference(offsets);
+  }
+}
+
+void bob::machine::PLDAScorer::score(const blitz::Array<double,2>& probes,
+  blitz::Array<double,2>& scores) const
+{
+  bob::core::array::assertSameDimensionLength(scores.extent(0), m_n_models);
+  bob::core::array::assertSameDimensionLength(scores.extent(1), probes.extent(0));
+  if (m_n_models == 0 || probes.extent(0) == 0) return;
+  bob::core::array::assertSameDimensionLength(probes.extent(1), m_mu.extent(0));
+
+  bob::machine::detail::PLDAScoreBlocks f = {&probes, &m_mu, &m_Ft_beta,
+    &m_gamma_1, &m_group_models, &m_group_gamma, &m_group_weighted_sums,
+    &m_group_offsets, &scores};
+  bob::core::parallelFor(probes.extent(0), m_n_threads, f);
+}
@@ -214,13 +214,33 @@ void mach::SupportVector::reset() {
     }
   }
 
-  //create and reset cache
-  m_input_cache.reset(new svm_node[1 + m_input_size]);
-
   m_input_sub.resize(inputSize());
   m_input_sub = 0.0;
   m_input_div.resize(inputSize());
   m_input_div = 1.0;
+
+  //dense copy of the support vectors and of their coefficients, so that the
+  //kernel values are computed on contiguous memory rather than by walking
+  //libsvm's node lists
+  const int l = m_model->l;
+  m_sv.resize(l, m_input_size);
+  m_sv = 0.;
+  if (kernelType() != PRECOMPUTED) { //SVs only hold serial numbers otherwise
+    for (int k=0; k<l; ++k)
+      for (svm_node* n = m_model->SV[k]; n->index != -1; ++n)
+        m_sv(k, n->index-1) = n->value;
+  }
+  const int n_coef = std::max(m_model->nr_class - 1, 0);
+  m_sv_coef.resize(n_coef, l);
+  for (int r=0; r<n_coef; ++r)
+    for (int k=0; k<l; ++k) m_sv_coef(r,k) = m_model->sv_coef[r][k];
+
+  m_start.clear();
+  if (m_model->nSV) { //classification only
+    m_start.resize(m_model->nr_class, 0);
+    for (int c=1; c<m_model->nr_class; ++c)
+      m_start[c] = m_start[c-1] + m_model->nSV[c-1];
+  }
 }
 
 mach::SupportVector::SupportVector(const std::string& model_file):
@@ -325,11 +345,11 @@ void mach::SupportVector::setInputDivision(const blitz::Array<double,1>& v) {
 }
 
 /**
- * Copies the user input to a locally pre-allocated cache. Apply normalization
- * at the same occasion.
+ * Copies the user input to a pre-allocated libsvm node array. Apply
+ * normalization at the same occasion.
  */
 static inline void copy(const blitz::Array<double,1>& input,
-    boost::shared_array<svm_node>& cache, const blitz::Array<double,1>& sub,
+    std::vector<svm_node>& cache, const blitz::Array<double,1>& sub,
     const blitz::Array<double,1>& div) {
 
   size_t cur = 0; ///< currently used index
@@ -345,11 +365,185 @@ static inline void copy(const blitz::Array<double,1>& input,
   cache[cur].index = -1; //libsvm detects end of input if index==-1
 }
 
+/**
+ * Same as libsvm's powi(), used for polynomial kernels
+ */
+static inline double powi(double base, int times) {
+  double tmp = base, ret = 1.0;
+  for (int t=times; t>0; t/=2) {
+    if (t%2==1) ret*=tmp;
+    tmp = tmp * tmp;
+  }
+  return ret;
+}
+
+/**
+ * Number of decision values libsvm computes for a given model
+ */
+static int n_decision_values(const svm_model* model) {
+  if (model->param.svm_type == ONE_CLASS || 
+      model->param.svm_type == EPSILON_SVR ||
+      model->param.svm_type == NU_SVR) return 1;
+  return model->nr_class * (model->nr_class - 1) / 2;
+}
+
+/**
+ * Does what svm_predict_values() of libsvm does, given the values of the
+ * kernel between an input and all the support vectors of the model.
+ */
+static double decide(const svm_model* model, const blitz::Array<double,2>& coef,
+    const std::vector<int>& start, const blitz::Array<double,1>& kvalue,
+    std::vector<int>& vote, double* dec_values) {
+
+  if (model->param.svm_type == ONE_CLASS || 
+      model->param.svm_type == EPSILON_SVR ||
+      model->param.svm_type == NU_SVR) {
+    double sum = 0;
+    for (int k=0; k<model->l; ++k) sum += coef(0,k) * kvalue(k);
+    sum -= model->rho[0];
+    *dec_values = sum;
+    if (model->param.svm_type == ONE_CLASS) return (sum>0)? 1 : -1;
+    return sum;
+  }
+
+  const int nr_class = model->nr_class;
+  std::fill(vote.begin(), vote.end(), 0);
+  int p = 0;
+  for (int i=0; i<nr_class; ++i) {
+    for (int j=i+1; j<nr_class; ++j) {
+      double sum = 0;
+      const int si = start[i];
+      const int sj = start[j];
+      for (int k=0; k<model->nSV[i]; ++k) sum += coef(j-1,si+k) * kvalue(si+k);
+      for (int k=0; k<model->nSV[j]; ++k) sum += coef(i,sj+k) * kvalue(sj+k);
+      sum -= model->rho[p];
+      dec_values[p] = sum;
+      if (sum > 0) ++vote[i];
+      else ++vote[j];
+      ++p;
+    }
+  }
+
+  int vote_max_idx = 0;
+  for (int i=1; i<nr_class; ++i)
+    if (vote[i] > vote[vote_max_idx]) vote_max_idx = i;
+  return model->label[vote_max_idx];
+}
+
+/**
+ * Number of inputs processed at once by the dense prediction engine
+ */
+static const int SVM_BLOCK_SIZE = 256;
+
+void mach::SupportVector::predictBlock(const blitz::Array<double,2>& input,
+    blitz::Array<int,1>& labels, blitz::Array<double,2>* scores) const {
+
+  const int n_inputs = input.extent(0);
+  if (n_inputs == 0) return;
+
+  const int n_dec = n_decision_values(m_model.get());
+  std::vector<double> dec_values(std::max(n_dec, 1));
+  const int n_scores = scores ? std::min(scores->extent(1), n_dec) : 0;
+  blitz::Range all = blitz::Range::all();
+
+  if (kernelType() == PRECOMPUTED) {
+    //the kernel values are the input themselves: let libsvm handle them
+    std::vector<svm_node> nodes(1 + m_input_size);
+    for (int r=0; r<n_inputs; ++r) {
+      copy(input(r,all), nodes, m_input_sub, m_input_div);
+#if LIBSVM_VERSION > 290
+      labels(r) = round(svm_predict_values(m_model.get(), &nodes[0], &dec_values[0]));
+#else
+      svm_predict_values(m_model.get(), &nodes[0], &dec_values[0]);
+      labels(r) = round(svm_predict(m_model.get(), &nodes[0]));
+#endif
+      for (int c=0; c<n_scores; ++c) (*scores)(r,c) = dec_values[c];
+    }
+    return;
+  }
+
+  const int l = m_model->l;
+  const double gamma = m_model->param.gamma;
+  const double coef0 = m_model->param.coef0;
+  const int degree = m_model->param.degree;
+  std::vector<int> vote(m_model->nr_class);
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  const int dim = m_input_size;
+  const int block = std::min(n_inputs, SVM_BLOCK_SIZE);
+  blitz::Array<double,2> x_block(block, dim);
+  blitz::Array<double,2> k_block(block, l);
+
+  for (int b=0; b<n_inputs; b+=block) {
+    const int n = std::min(block, n_inputs-b);
+    blitz::Range rows(0, n-1);
+    blitz::Array<double,2> x = x_block(rows, all);
+    blitz::Array<double,2> k = k_block(rows, all);
+    const blitz::Array<double,2> in = input(blitz::Range(b, b+n-1), all);
+
+    //scaling of the inputs
+    x = (in(i,j) - m_input_sub(j)) / m_input_div(j);
+
+    //dot products (or squared distances, for RBF) with all the support
+    //vectors. Components are summed in the same order as libsvm does (the
+    //zeros it skips do not change the sums), so that results are identical.
+    const double* xd = x.data();
+    const double* svd = m_sv.data();
+    double* kd = k.data();
+    const bool rbf = (kernelType() == RBF);
+    for (int r=0; r<n; ++r) {
+      const double* xr = xd + r*dim;
+      for (int s=0; s<l; ++s) {
+        const double* sv = svd + s*dim;
+        double sum = 0.;
+        if (rbf) {
+          for (int c=0; c<dim; ++c) { 
+            const double d = xr[c] - sv[c];
+            sum += d*d;
+          }
+        }
+        else {
+          for (int c=0; c<dim; ++c) sum += xr[c] * sv[c];
+        }
+        kd[r*l+s] = sum;
+      }
+    }
+
+    //kernel values, for the whole block at once
+    switch (kernelType()) {
+      case LINEAR:
+        break;
+      case POLY:
+        k = gamma * k + coef0;
+        for (int r=0; r<n*l; ++r) kd[r] = powi(kd[r], degree);
+        break;
+      case RBF:
+        k = blitz::exp(-gamma * k);
+        break;
+      case SIGMOID:
+        k = blitz::tanh(gamma * k + coef0);
+        break;
+      default:
+        break;
+    }
+
+    //decisions
+    for (int r=0; r<n; ++r) {
+      labels(b+r) = round(decide(m_model.get(), m_sv_coef, m_start, k(r,all),
+            vote, &dec_values[0]));
+      for (int c=0; c<n_scores; ++c) (*scores)(b+r,c) = dec_values[c];
+    }
+  }
+}
+
 int mach::SupportVector::predictClass_
 (const blitz::Array<double,1>& input) const {
-  copy(input, m_input_cache, m_input_sub, m_input_div);
-  int retval = round(svm_predict(m_model.get(), m_input_cache.get()));
-  return retval;
+  blitz::Array<double,2> input_(1, input.extent(0));
+  input_(0, blitz::Range::all()) = input;
+  blitz::Array<int,1> label(1);
+  predictBlock(input_, label, 0);
+  return label(0);
 }
 
 int mach::SupportVector::predictClass
@@ -367,14 +561,13 @@ int mach::SupportVector::predictClass
 int mach::SupportVector::predictClassAndScores_
 (const blitz::Array<double,1>& input,
  blitz::Array<double,1>& scores) const {
-  copy(input, m_input_cache, m_input_sub, m_input_div);
-#if LIBSVM_VERSION > 290
-  int retval = round(svm_predict_values(m_model.get(), m_input_cache.get(), scores.data()));
-#else
-  svm_predict_values(m_model.get(), m_input_cache.get(), scores.data());
-  int retval = round(svm_predict(m_model.get(), m_input_cache.get()));
-#endif
-  return retval;
+  blitz::Array<double,2> input_(1, input.extent(0));
+  input_(0, blitz::Range::all()) = input;
+  blitz::Array<int,1> label(1);
+  blitz::Array<double,2> scores_(1, scores.extent(0));
+  predictBlock(input_, label, &scores_);
+  scores = scores_(0, blitz::Range::all());
+  return label(0);
 }
 
 int mach::SupportVector::predictClassAndScores
@@ -403,8 +596,9 @@ int mach::SupportVector::predictClassAndScores
 int mach::SupportVector::predictClassAndProbabilities_
 (const blitz::Array<double,1>& input,
  blitz::Array<double,1>& probabilities) const {
-  copy(input, m_input_cache, m_input_sub, m_input_div);
-  int retval = round(svm_predict_probability(m_model.get(), m_input_cache.get(), probabilities.data()));
+  std::vector<svm_node> nodes(1 + m_input_size);
+  copy(input, nodes, m_input_sub, m_input_div);
+  int retval = round(svm_predict_probability(m_model.get(), &nodes[0], probabilities.data()));
   return retval;
 }
 
@@ -435,6 +629,61 @@ int mach::SupportVector::predictClassAndProbabilities
   return predictClassAndProbabilities_(input, probabilities);
 }
 
+void mach::SupportVector::predictClass_
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& labels) const {
+  predictBlock(input, labels, 0);
+}
+
+void mach::SupportVector::predictClass
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& labels) const {
+
+  if ((size_t)input.extent(1) != inputSize()) {
+    boost::format s("input for this SVM should have %d columns, but you provided an array with %d columns instead");
+    s % inputSize() % input.extent(1);
+    throw std::invalid_argument(s.str());
+  }
+
+  if (labels.extent(0) != input.extent(0)) {
+    boost::format s("output labels for this SVM should have %d entries (one per input), but you provided an array with %d elements instead");
+    s % input.extent(0) % labels.extent(0);
+    throw std::invalid_argument(s.str());
+  }
+
+  predictClass_(input, labels);
+}
+
+void mach::SupportVector::predictClassAndScores_
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& labels,
+ blitz::Array<double,2>& scores) const {
+  predictBlock(input, labels, &scores);
+}
+
+void mach::SupportVector::predictClassAndScores
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& labels,
+ blitz::Array<double,2>& scores) const {
+
+  if ((size_t)input.extent(1) != inputSize()) {
+    boost::format s("input for this SVM should have %d columns, but you provided an array with %d columns instead");
+    s % inputSize() % input.extent(1);
+    throw std::invalid_argument(s.str());
+  }
+
+  if (labels.extent(0) != input.extent(0)) {
+    boost::format s("output labels for this SVM should have %d entries (one per input), but you provided an array with %d elements instead");
+    s % input.extent(0) % labels.extent(0);
+    throw std::invalid_argument(s.str());
+  }
+
+  if (scores.extent(0) != input.extent(0) || 
+      (size_t)scores.extent(1) != outputSize()) {
+    boost::format s("output scores for this SVM should have shape (%d, %d), but you provided an array with shape (%d, %d) instead");
+    s % input.extent(0) % outputSize() % scores.extent(0) % scores.extent(1);
+    throw std::invalid_argument(s.str());
+  }
+
+  predictClassAndScores_(input, labels, scores);
+}
+
 void mach::SupportVector::save(const std::string& filename) const {
   if (svm_save_model(filename.c_str(), m_model.get())) {
     boost::format s("cannot save SVM model to file '%s'");
@@ -20,122 +20,189 @@
 
 #include "bob/machine/ZTNorm.h"
 #include "bob/core/array_assert.h"
+#include "bob/core/parallel.h"
+#include <cmath>
 #include <limits>
 
 namespace bob { 
 namespace machine {
 
 namespace detail {
-  void ztNorm(const blitz::Array<double, 2>& rawscores_probes_vs_models,
-              const blitz::Array<double, 2>& rawscores_zprobes_vs_models,
-              const blitz::Array<double, 2>& rawscores_probes_vs_tmodels,
-              const blitz::Array<double, 2>& rawscores_zprobes_vs_tmodels,
-              const blitz::Array<bool, 2>*  mask_zprobes_vs_tmodels_istruetrial,
-              blitz::Array<double, 2>& scores)
-  {
-    // Rename variables
-    const blitz::Array<double, 2>& A = rawscores_probes_vs_models;
-    const blitz::Array<double, 2>& B = rawscores_zprobes_vs_models;
-    const blitz::Array<double, 2>& C = rawscores_probes_vs_tmodels;
-    const blitz::Array<double, 2>& D = rawscores_zprobes_vs_tmodels;
-
-    // Compute the sizes
-    int size_eval  = A.extent(0);
-    int size_enrol = A.extent(1);
-    int size_tnorm = C.extent(0);
-    int size_znorm = B.extent(1);
-
-    // Check the inputs
-    bob::core::array::assertSameDimensionLength(A.extent(0), size_eval);
-    bob::core::array::assertSameDimensionLength(A.extent(1), size_enrol);
-
-    bob::core::array::assertSameDimensionLength(B.extent(0), size_eval);
-    bob::core::array::assertSameDimensionLength(B.extent(1), size_znorm);
-
-    bob::core::array::assertSameDimensionLength(C.extent(0), size_tnorm);
-    bob::core::array::assertSameDimensionLength(C.extent(1), size_enrol);
-
-    bob::core::array::assertSameDimensionLength(D.extent(0), size_tnorm);
-    bob::core::array::assertSameDimensionLength(D.extent(1), size_znorm);
-
-    if (mask_zprobes_vs_tmodels_istruetrial) {
-      bob::core::array::assertSameDimensionLength(mask_zprobes_vs_tmodels_istruetrial->extent(0), size_tnorm);
-      bob::core::array::assertSameDimensionLength(mask_zprobes_vs_tmodels_istruetrial->extent(1), size_znorm);
-    }
 
-    bob::core::array::assertSameDimensionLength(scores.extent(0), size_eval);
-    bob::core::array::assertSameDimensionLength(scores.extent(1), size_enrol);
-
-    // Declare needed IndexPlaceholder
-    blitz::firstIndex i;
-    blitz::secondIndex j;
-
-    // Constant to check if the std is close to 0. 
-    const double eps = std::numeric_limits<double>::min();
-    
-    // Znorm  -->      zA  = (A - mean(B) ) / std(B)    [znorm on oringinal scores]
-    // mean(B)
-    blitz::Array<double, 1> mean_B(blitz::mean(B, j));
-    // std(B)
-    blitz::Array<double, 2> B2n(B.shape());
-    B2n = blitz::pow2(B(i, j) - mean_B(i));
-    blitz::Array<double, 1> std_B(B.extent(0));
-    if(size_znorm>1)
-      std_B = blitz::sqrt(blitz::sum(B2n, j) / (size_znorm - 1));
-    else // 1 single value -> std = 0
-      std_B = 0; 
-    std_B = blitz::where( std_B <= eps, 1., std_B);
-
-    // zA
-    blitz::Array<double, 2> zA(A.shape());
-    zA = (A(i, j) - mean_B(i)) / std_B(i);
-
-    blitz::Array<double, 1> mean_Dimp(size_tnorm);
-    blitz::Array<double, 1> std_Dimp(size_tnorm);
-
-    // Compute mean_Dimp and std_Dimp = D only with impostors
-    for(int i = 0; i < size_tnorm; ++i) {
-      double sum = 0;
-      double sumsq = 0;
-      double count = 0;
-      for(int j = 0; j < size_znorm; ++j) {
-        bool keep;
-        // The second part is never executed if mask_zprobes_vs_tmodels_istruetrial==NULL
-        keep = (mask_zprobes_vs_tmodels_istruetrial == NULL) || !(*mask_zprobes_vs_tmodels_istruetrial)(i, j); //tnorm_models_spk_ids(i) != znorm_tests_spk_ids(j);
-        
-        double value = keep * D(i, j);
-        sum += value;
-        sumsq += value*value;
-        count += keep;
+  // Constant to check if the std is close to 0. 
+  static const double eps = std::numeric_limits<double>::min();
+
+  /**
+   * Mean and (unbiased) standard deviation of the rows of D, only with the
+   * impostors if a mask of the true trials is given.
+   */
+  struct TModelStatistics {
+    const blitz::Array<double,2>* D;
+    const blitz::Array<bool,2>* mask;
+    blitz::Array<double,1>* mean;
+    blitz::Array<double,1>* std;
+
+    void operator()(size_t, size_t start, size_t end) const {
+      const int size_znorm = D->extent(1);
+      for (int i=start; i<(int)end; ++i) {
+        double sum = 0.;
+        double count = 0.;
+        for (int j=0; j<size_znorm; ++j) {
+          if (mask && (*mask)(i,j)) continue;
+          sum += (*D)(i,j);
+          count += 1.;
+        }
+        const double m = sum / count;
+        double sumsq = 0.;
+        for (int j=0; j<size_znorm; ++j) {
+          if (mask && (*mask)(i,j)) continue;
+          const double d = (*D)(i,j) - m;
+          sumsq += d*d;
+        }
+        (*mean)(i) = m;
+        const double s = (count > 1 ? std::sqrt(sumsq / (count - 1)) : 0.);
+        (*std)(i) = (s <= eps ? 1. : s);
+      }
+    }
+  };
+
+  /**
+   * Mean and standard deviation of the columns of the Z-normalised
+   * T-scores zC = (C - mean(D)) / std(D), for a range of columns. zC is
+   * never stored: each pass recomputes it row by row.
+   */
+  struct TNormStatistics {
+    const blitz::Array<double,2>* C;
+    const blitz::Array<double,1>* mean_D;
+    const blitz::Array<double,1>* std_D;
+    blitz::Array<double,1>* mean;
+    blitz::Array<double,1>* std;
+
+    void operator()(size_t, size_t start, size_t end) const {
+      const int size_tnorm = C->extent(0);
+      for (int j=start; j<(int)end; ++j) (*mean)(j) = 0.;
+      for (int k=0; k<size_tnorm; ++k) {
+        const double m = (*mean_D)(k), s = (*std_D)(k);
+        for (int j=start; j<(int)end; ++j) (*mean)(j) += ((*C)(k,j) - m) / s;
+      }
+      for (int j=start; j<(int)end; ++j) {
+        (*mean)(j) /= size_tnorm;
+        (*std)(j) = 0.;
+      }
+      if (size_tnorm > 1) {
+        for (int k=0; k<size_tnorm; ++k) {
+          const double m = (*mean_D)(k), s = (*std_D)(k);
+          for (int j=start; j<(int)end; ++j) {
+            const double d = ((*C)(k,j) - m) / s - (*mean)(j);
+            (*std)(j) += d*d;
+          }
+        }
+      }
+      for (int j=start; j<(int)end; ++j) {
+        const double s = (size_tnorm > 1 ? std::sqrt((*std)(j) / (size_tnorm - 1)) : 0.);
+        (*std)(j) = (s <= eps ? 1. : s);
       }
-
-      double mean = sum / count;
-      mean_Dimp(i) = mean;
-      if(count > 1)
-        std_Dimp(i) = sqrt((sumsq - count * mean * mean) / (count -1));
-      else // 1 single value -> std = 0
-        std_Dimp(i) = 0;
     }
-    std_Dimp = blitz::where( std_Dimp <= eps, 1., std_Dimp);
-
-    // zC  = (C - mean(D)) / std(D)     [znorm the tnorm scores]
-    blitz::Array<double, 2> zC(size_tnorm, size_enrol);
-    zC = (C(i, j) - mean_Dimp(i)) / std_Dimp(i);
-
-    blitz::Array<double, 1> mean_zC(size_enrol);
-    blitz::Array<double, 1> std_zC(size_enrol);
-    
-    // ztA = (zA - mean(zC)) / std(zC)  [ztnorm on eval scores]
-    mean_zC = blitz::mean(zC(j, i), j);
-    if(size_tnorm > 1)
-      std_zC = sqrt(blitz::sum(pow(zC(j, i) - mean_zC(i), 2) , j) / (size_tnorm - 1));
-    else // 1 single value -> std = 0
-      std_zC = 0;
-    std_zC = blitz::where( std_zC <= eps, 1., std_zC);
-
-    // Normalised scores
-    scores = (zA(i, j) - mean_zC(j)) /  std_zC(j);
+  };
+
+  /**
+   * Z-normalises and then T-normalises a range of rows of A, computing the
+   * Z statistics of each row on the fly from the same row of B.
+   */
+  struct ZTNormRows {
+    const blitz::Array<double,2>* A;
+    const blitz::Array<double,2>* B;
+    const blitz::Array<double,1>* mean_zC;
+    const blitz::Array<double,1>* std_zC;
+    blitz::Array<double,2>* scores;
+
+    void operator()(size_t, size_t start, size_t end) const {
+      const int size_enrol = A->extent(1);
+      const int size_znorm = B->extent(1);
+      for (int i=start; i<(int)end; ++i) {
+        double sum = 0.;
+        for (int j=0; j<size_znorm; ++j) sum += (*B)(i,j);
+        const double m = sum / size_znorm;
+        double sumsq = 0.;
+        for (int j=0; j<size_znorm; ++j) {
+          const double d = (*B)(i,j) - m;
+          sumsq += d*d;
+        }
+        double s = (size_znorm > 1 ? std::sqrt(sumsq / (size_znorm - 1)) : 0.);
+        if (s <= eps) s = 1.;
+
+        // A and scores may be the same array
+        for (int j=0; j<size_enrol; ++j)
+          (*scores)(i,j) = (((*A)(i,j) - m) / s - (*mean_zC)(j)) / (*std_zC)(j);
+      }
+    }
+  };
+
+}
+
+
+ZTNormalizer::ZTNormalizer(const blitz::Array<double, 2>& rawscores_probes_vs_tmodels,
+                           const blitz::Array<double, 2>& rawscores_zprobes_vs_tmodels,
+                           const blitz::Array<bool,   2>& mask_zprobes_vs_tmodels_istruetrial,
+                           const size_t n_threads):
+  m_n_threads(n_threads)
+{
+  init(rawscores_probes_vs_tmodels, rawscores_zprobes_vs_tmodels,
+       &mask_zprobes_vs_tmodels_istruetrial);
+}
+
+ZTNormalizer::ZTNormalizer(const blitz::Array<double, 2>& rawscores_probes_vs_tmodels,
+                           const blitz::Array<double, 2>& rawscores_zprobes_vs_tmodels,
+                           const size_t n_threads):
+  m_n_threads(n_threads)
+{
+  init(rawscores_probes_vs_tmodels, rawscores_zprobes_vs_tmodels, 0);
+}
+
+void ZTNormalizer::init(const blitz::Array<double, 2>& C,
+                        const blitz::Array<double, 2>& D,
+                        const blitz::Array<bool, 2>* mask)
+{
+  // Compute the sizes
+  const int size_tnorm = C.extent(0);
+  const int size_enrol = C.extent(1);
+  const int size_znorm = D.extent(1);
+
+  // Check the inputs
+  bob::core::array::assertSameDimensionLength(D.extent(0), size_tnorm);
+  if (mask) {
+    bob::core::array::assertSameDimensionLength(mask->extent(0), size_tnorm);
+    bob::core::array::assertSameDimensionLength(mask->extent(1), size_znorm);
   }
+
+  // mean(D) and std(D), only with impostors
+  blitz::Array<double,1> mean_D(size_tnorm), std_D(size_tnorm);
+  detail::TModelStatistics tmodels = {&D, mask, &mean_D, &std_D};
+  bob::core::parallelFor(size_tnorm, m_n_threads, tmodels);
+
+  // mean(zC) and std(zC), with zC = (C - mean(D)) / std(D)
+  m_mean_zC.resize(size_enrol);
+  m_std_zC.resize(size_enrol);
+  detail::TNormStatistics tnorm = {&C, &mean_D, &std_D, &m_mean_zC, &m_std_zC};
+  bob::core::parallelFor(size_enrol, m_n_threads, tnorm);
+}
+
+void ZTNormalizer::normalize(const blitz::Array<double, 2>& rawscores_probes_vs_models,
+                             const blitz::Array<double, 2>& rawscores_zprobes_vs_models,
+                             blitz::Array<double, 2>& normalizedscores) const
+{
+  const blitz::Array<double, 2>& A = rawscores_probes_vs_models;
+  const blitz::Array<double, 2>& B = rawscores_zprobes_vs_models;
+
+  // Check the inputs
+  const int size_eval = A.extent(0);
+  bob::core::array::assertSameDimensionLength(A.extent(1), m_mean_zC.extent(0));
+  bob::core::array::assertSameDimensionLength(B.extent(0), size_eval);
+  bob::core::array::assertSameDimensionLength(normalizedscores.extent(0), size_eval);
+  bob::core::array::assertSameDimensionLength(normalizedscores.extent(1), A.extent(1));
+
+  detail::ZTNormRows rows = {&A, &B, &m_mean_zC, &m_std_zC, &normalizedscores};
+  bob::core::parallelFor(size_eval, m_n_threads, rows);
 }
 
 
@@ -144,20 +211,25 @@ void ztNorm(const blitz::Array<double, 2>& rawscores_probes_vs_models,
             const blitz::Array<double, 2>& rawscores_probes_vs_tmodels,
             const blitz::Array<double, 2>& rawscores_zprobes_vs_tmodels,
             const blitz::Array<bool,   2>& mask_zprobes_vs_tmodels_istruetrial,
-            blitz::Array<double, 2>& scores)
+            blitz::Array<double, 2>& scores,
+            const size_t n_threads)
 {
-  detail::ztNorm(rawscores_probes_vs_models, rawscores_zprobes_vs_models, rawscores_probes_vs_tmodels,
-                 rawscores_zprobes_vs_tmodels, &mask_zprobes_vs_tmodels_istruetrial, scores);
+  bob::core::array::assertSameDimensionLength(rawscores_zprobes_vs_tmodels.extent(1), rawscores_zprobes_vs_models.extent(1));
+  ZTNormalizer ztnorm(rawscores_probes_vs_tmodels, rawscores_zprobes_vs_tmodels,
+                      mask_zprobes_vs_tmodels_istruetrial, n_threads);
+  ztnorm.normalize(rawscores_probes_vs_models, rawscores_zprobes_vs_models, scores);
 }
 
 void ztNorm(const blitz::Array<double, 2>& rawscores_probes_vs_models,
             const blitz::Array<double, 2>& rawscores_zprobes_vs_models,
             const blitz::Array<double, 2>& rawscores_probes_vs_tmodels,
             const blitz::Array<double, 2>& rawscores_zprobes_vs_tmodels,
-            blitz::Array<double, 2>& scores)
+            blitz::Array<double, 2>& scores,
+            const size_t n_threads)
 {
-  detail::ztNorm(rawscores_probes_vs_models, rawscores_zprobes_vs_models, rawscores_probes_vs_tmodels,
-                 rawscores_zprobes_vs_tmodels, NULL, scores);
+  bob::core::array::assertSameDimensionLength(rawscores_zprobes_vs_tmodels.extent(1), rawscores_zprobes_vs_models.extent(1));
+  ZTNormalizer ztnorm(rawscores_probes_vs_tmodels, rawscores_zprobes_vs_tmodels, n_threads);
+  ztnorm.normalize(rawscores_probes_vs_models, rawscores_zprobes_vs_models, scores);
 }
 
 
@@ -0,0 +1,269 @@
+/**
+ * @file machine/cxx/benchmark/scoring.cc
+ * @date Fri 16 Oct 2026 18:10:37 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Benchmarks of the GMM, K-Means, linear, PLDA and JFA scoring
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOB_BENCHMARK_SUITE "machine"
+#define BOB_BENCHMARK_MAIN
+#include "bob/core/benchmark.h"
+
+#include "bob/machine/GMMMachine.h"
+#include "bob/machine/KMeansMachine.h"
+#include "bob/machine/LinearScoring.h"
+#include "bob/machine/PLDAMachine.h"
+#include "bob/machine/JFAMachine.h"
+
+namespace bench = bob::core::benchmark;
+
+typedef std::vector<boost::shared_ptr<const bob::machine::GMMStats> > stats_t;
+
+// Sizes typical of speaker and face verification with GMMs
+static const size_t C = 256; ///< Gaussians
+static const size_t D = 40; ///< feature dimensionality
+static const size_t N_FRAMES = 1000; ///< frames per sample
+static const size_t N_MODELS = 100;
+static const size_t N_PROBES = 100;
+
+struct GMMLogLikelihood {
+  const bob::machine::GMMMachine* gmm;
+  const blitz::Array<double,2>* x;
+  blitz::Array<double,1>* ll;
+  bob::machine::GMMWorkspace* ws;
+  void operator()() const { gmm->logLikelihood(*x, *ll, *ws); }
+};
+
+struct GMMAccStatistics {
+  const bob::machine::GMMMachine* gmm;
+  const blitz::Array<double,2>* x;
+  bob::machine::GMMStats* stats;
+  bob::machine::GMMWorkspace* ws;
+  void operator()() const { gmm->accStatistics(*x, *stats, *ws); }
+};
+
+struct KMeansDistances {
+  const bob::machine::KMeansMachine* kmeans;
+  const blitz::Array<double,2>* x;
+  blitz::Array<double,2>* distances;
+  void operator()() const { kmeans->getDistancesFromMeans_(*x, *distances); }
+};
+
+struct LinearScoring {
+  const std::vector<blitz::Array<double,1> >* models;
+  const blitz::Array<double,1>* ubm_mean;
+  const blitz::Array<double,1>* ubm_variance;
+  const stats_t* probes;
+  blitz::Array<double,2>* scores;
+  size_t n_threads;
+  void operator()() const {
+    bob::machine::linearScoring(*models, *ubm_mean, *ubm_variance, *probes,
+        true, *scores, n_threads);
+  }
+};
+
+struct PLDAScoring {
+  const bob::machine::PLDAScorer* scorer;
+  const blitz::Array<double,2>* probes;
+  blitz::Array<double,2>* scores;
+  void operator()() const { scorer->score(*probes, *scores); }
+};
+
+struct JFAEstimation {
+  boost::shared_ptr<const bob::machine::JFABaseMachine> base;
+  const stats_t* probes;
+  void operator()() const { bob::machine::JFAScorer scorer(base, *probes); }
+};
+
+struct JFAScoring {
+  const bob::machine::JFAScorer* scorer;
+  const std::vector<boost::shared_ptr<const bob::machine::JFAMachine> >* models;
+  blitz::Array<double,2>* scores;
+  void operator()() const { scorer->score(*models, *scores); }
+};
+
+static boost::shared_ptr<bob::machine::GMMMachine> make_ubm() {
+  boost::shared_ptr<bob::machine::GMMMachine> ubm(
+      new bob::machine::GMMMachine(C, D));
+  blitz::Array<double,2> means(C, D), variances(C, D);
+  blitz::Array<double,1> weights(C);
+  bench::randomize(means, -1., 1., 0);
+  bench::randomize(variances, 0.5, 1.5, 1);
+  bench::randomize(weights, 0.5, 1.5, 2);
+  weights /= blitz::sum(weights);
+  ubm->setMeans(means);
+  ubm->setVariances(variances);
+  ubm->setWeights(weights);
+  return ubm;
+}
+
+static stats_t make_stats(const bob::machine::GMMMachine& ubm, const size_t n,
+    const uint32_t seed) {
+  stats_t retval;
+  blitz::Array<double,2> x(100, D);
+  for (size_t i=0; i<n; ++i) {
+    boost::shared_ptr<bob::machine::GMMStats> stats(
+        new bob::machine::GMMStats(C, D));
+    bench::randomize(x, -1., 1., seed + i);
+    ubm.accStatistics(x, *stats);
+    retval.push_back(stats);
+  }
+  return retval;
+}
+
+static std::string threads(const size_t n_threads) {
+  return n_threads ? (boost::format("%d") % n_threads).str() : "all";
+}
+
+static void gmm(bench::Suite& suite, const bob::machine::GMMMachine& ubm) {
+  blitz::Array<double,2> x(N_FRAMES, D);
+  bench::randomize(x, -1., 1.);
+  blitz::Array<double,1> ll(N_FRAMES);
+  bob::machine::GMMWorkspace ws;
+  const std::string size = (boost::format("%dx%d/%dframes") % C % D %
+      N_FRAMES).str();
+
+  GMMLogLikelihood loglike = {&ubm, &x, &ll, &ws};
+  suite.run("gmm-loglikelihood/" + size, loglike, N_FRAMES,
+      N_FRAMES*D*sizeof(double));
+
+  bob::machine::GMMStats stats(C, D);
+  GMMAccStatistics acc = {&ubm, &x, &stats, &ws};
+  suite.run("gmm-accstatistics/" + size, acc, N_FRAMES,
+      N_FRAMES*D*sizeof(double));
+}
+
+static void kmeans(bench::Suite& suite) {
+  blitz::Array<double,2> means(C, D), x(N_FRAMES, D), distances(N_FRAMES, C);
+  bench::randomize(means, -1., 1., 0);
+  bench::randomize(x, -1., 1., 1);
+  bob::machine::KMeansMachine kmeans(means);
+
+  KMeansDistances op = {&kmeans, &x, &distances};
+  suite.run((boost::format("kmeans-distances/%dx%d/%dsamples") % C % D %
+        N_FRAMES).str(), op, N_FRAMES, N_FRAMES*D*sizeof(double));
+}
+
+static void linear(bench::Suite& suite, const bob::machine::GMMMachine& ubm) {
+  std::vector<blitz::Array<double,1> > models;
+  for (size_t i=0; i<N_MODELS; ++i) {
+    blitz::Array<double,1> model(C*D);
+    bench::randomize(model, -1., 1., i);
+    models.push_back(model);
+  }
+  const stats_t probes = make_stats(ubm, N_PROBES, 1000);
+  blitz::Array<double,2> scores(N_MODELS, N_PROBES);
+
+  const size_t n_threads[] = {1, 0};
+  for (size_t i=0; i<2; ++i) {
+    LinearScoring op = {&models, &ubm.getMeanSupervector(),
+      &ubm.getVarianceSupervector(), &probes, &scores, n_threads[i]};
+    suite.run((boost::format("linear-scoring/%dx%d/%dmodels/%dprobes/threads=%s")
+          % C % D % N_MODELS % N_PROBES % threads(n_threads[i])).str(), op,
+        N_MODELS*N_PROBES);
+  }
+}
+
+static void plda(bench::Suite& suite) {
+  const size_t dim_d = 200, dim_f = 50, dim_g = 50;
+  boost::shared_ptr<bob::machine::PLDABaseMachine> base(
+      new bob::machine::PLDABaseMachine(dim_d, dim_f, dim_g));
+  blitz::Array<double,2> F(dim_d, dim_f), G(dim_d, dim_g);
+  blitz::Array<double,1> sigma(dim_d), mu(dim_d);
+  bench::randomize(F, -1., 1., 0);
+  bench::randomize(G, -1., 1., 1);
+  bench::randomize(sigma, 0.5, 1.5, 2);
+  bench::randomize(mu, -1., 1., 3);
+  base->setF(F);
+  base->setG(G);
+  base->setSigma(sigma);
+  base->setMu(mu);
+
+  std::vector<boost::shared_ptr<const bob::machine::PLDAMachine> > models;
+  blitz::Array<double,1> weighted_sum(dim_f);
+  for (size_t i=0; i<N_MODELS; ++i) {
+    boost::shared_ptr<bob::machine::PLDAMachine> model(
+        new bob::machine::PLDAMachine(base));
+    bench::randomize(weighted_sum, -1., 1., i);
+    model->setNSamples(1 + i % 3);
+    model->setWeightedSum(weighted_sum);
+    model->setWSumXitBetaXi(-1.);
+    models.push_back(model);
+  }
+  blitz::Array<double,2> probes(N_FRAMES, dim_d);
+  bench::randomize(probes, -1., 1.);
+  blitz::Array<double,2> scores(N_MODELS, N_FRAMES);
+
+  const size_t n_threads[] = {1, 0};
+  for (size_t i=0; i<2; ++i) {
+    bob::machine::PLDAScorer scorer(models, n_threads[i]);
+    PLDAScoring op = {&scorer, &probes, &scores};
+    suite.run((boost::format("plda-scoring/%dx%dx%d/%dmodels/%dprobes/threads=%s")
+          % dim_d % dim_f % dim_g % N_MODELS % N_FRAMES %
+          threads(n_threads[i])).str(), op, N_MODELS*N_FRAMES);
+  }
+}
+
+static void jfa(bench::Suite& suite,
+    const boost::shared_ptr<bob::machine::GMMMachine> ubm) {
+  const size_t ru = 20, rv = 20;
+  boost::shared_ptr<bob::machine::JFABaseMachine> base(
+      new bob::machine::JFABaseMachine(ubm, ru, rv));
+  blitz::Array<double,2> U(C*D, ru), V(C*D, rv);
+  blitz::Array<double,1> d(C*D);
+  bench::randomize(U, -0.1, 0.1, 0);
+  bench::randomize(V, -0.1, 0.1, 1);
+  bench::randomize(d, 0., 0.1, 2);
+  base->setU(U);
+  base->setV(V);
+  base->setD(d);
+
+  std::vector<boost::shared_ptr<const bob::machine::JFAMachine> > models;
+  blitz::Array<double,1> y(rv), z(C*D);
+  for (size_t i=0; i<N_MODELS; ++i) {
+    boost::shared_ptr<bob::machine::JFAMachine> model(
+        new bob::machine::JFAMachine(base));
+    bench::randomize(y, -1., 1., i);
+    bench::randomize(z, -1., 1., N_MODELS + i);
+    model->setY(y);
+    model->setZ(z);
+    models.push_back(model);
+  }
+  const stats_t probes = make_stats(*ubm, N_PROBES, 1000);
+  const std::string size = (boost::format("%dx%d/ru=%d/rv=%d") % C % D % ru %
+      rv).str();
+
+  JFAEstimation estimation = {base, &probes};
+  suite.run((boost::format("jfa-channel-estimation/%s/%dprobes") % size %
+        N_PROBES).str(), estimation, N_PROBES);
+
+  bob::machine::JFAScorer scorer(base, probes);
+  blitz::Array<double,2> scores(N_MODELS, N_PROBES);
+  JFAScoring op = {&scorer, &models, &scores};
+  suite.run((boost::format("jfa-scoring/%s/%dmodels/%dprobes") % size %
+        N_MODELS % N_PROBES).str(), op, N_MODELS*N_PROBES);
+}
+
+void bob_benchmark(bench::Suite& suite) {
+  boost::shared_ptr<bob::machine::GMMMachine> ubm = make_ubm();
+  gmm(suite, *ubm);
+  kmeans(suite);
+  linear(suite, *ubm);
+  plda(suite);
+  jfa(suite, ubm);
+}
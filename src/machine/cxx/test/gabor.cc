@@ -124,4 +124,31 @@ BOOST_AUTO_TEST_CASE( test_gabor_graph_machine )
     double similarity = machine.similarity(graph, graph_jets, *sim_fcts[i]);
     BOOST_CHECK_CLOSE(similarity, 1., epsilon);
   }
+
+  // compare the graph with a gallery of graphs with permuted nodes, in parallel,
+  // and check that the results are identical to the pairwise similarities
+  const int n_models = 7, n_nodes = machine.numberOfNodes();
+  blitz::Range all = blitz::Range::all();
+  blitz::Array<double,4> models(n_models, n_nodes, 2, gwt.numberOfKernels());
+  for (int m = 0; m < n_models; ++m)
+    for (int i = 0; i < n_nodes; ++i)
+      models(m,i,all,all) = graph((i + m) % n_nodes, all, all);
+  blitz::Array<double,3> abs_models(models(all,all,0,all).copy());
+  blitz::Array<double,2> abs_graph(graph(all,0,all).copy());
+
+  blitz::Array<double,1> similarities(n_models);
+  for (int i = sim_fcts.size(); i--;){
+    machine.similarities(models, graph, *sim_fcts[i], similarities, 3);
+    for (int m = 0; m < n_models; ++m){
+      blitz::Array<double,3> model(models(m,all,all,all).copy());
+      BOOST_CHECK_EQUAL(similarities(m), machine.similarity(model, graph, *sim_fcts[i]));
+    }
+    if (!sim_fcts[i]->usesPhases()){
+      machine.similarities(abs_models, abs_graph, *sim_fcts[i], similarities, 3);
+      for (int m = 0; m < n_models; ++m){
+        blitz::Array<double,2> model(abs_models(m,all,all).copy());
+        BOOST_CHECK_EQUAL(similarities(m), machine.similarity(model, abs_graph, *sim_fcts[i]));
+      }
+    }
+  }
 }
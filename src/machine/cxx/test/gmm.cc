@@ -0,0 +1,201 @@
+/**
+ * @file machine/cxx/test/gmm.cc
+ * @date Fri 16 Oct 2026 11:48:09 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Tests the concurrent scoring of a GMMMachine and of a
+ * KMeansMachine shared by several threads
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE GMM Machine Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/random.hpp>
+#include <blitz/array.h>
+#include <cmath>
+
+#include "bob/machine/GMMMachine.h"
+#include "bob/machine/KMeansMachine.h"
+#include "bob/core/parallel.h"
+
+static const int N_GAUSSIANS = 16;
+static const int N_INPUTS = 8;
+static const int N_SAMPLES = 1000;
+static const size_t N_THREADS = 4;
+
+struct T {
+  bob::machine::GMMMachine gmm;
+  bob::machine::KMeansMachine kmeans;
+  blitz::Array<double,2> data;
+
+  T(): gmm(N_GAUSSIANS, N_INPUTS), kmeans(N_GAUSSIANS, N_INPUTS),
+    data(N_SAMPLES, N_INPUTS)
+  {
+    boost::mt19937 rng;
+    boost::normal_distribution<double> normal;
+    boost::variate_generator<boost::mt19937&, boost::normal_distribution<double> >
+      gen(rng, normal);
+
+    blitz::Array<double,2> means(N_GAUSSIANS, N_INPUTS);
+    blitz::Array<double,2> variances(N_GAUSSIANS, N_INPUTS);
+    blitz::Array<double,1> weights(N_GAUSSIANS);
+    for (int i=0; i<N_GAUSSIANS; ++i) {
+      weights(i) = 1. + i;
+      for (int d=0; d<N_INPUTS; ++d) {
+        means(i,d) = 3. * gen();
+        variances(i,d) = 0.5 + std::fabs(gen());
+      }
+    }
+    weights /= blitz::sum(weights);
+    gmm.setMeans(means);
+    gmm.setVariances(variances);
+    gmm.setWeights(weights);
+    kmeans.setMeans(means);
+
+    // samples around each mean, so that no cluster is empty
+    for (int n=0; n<N_SAMPLES; ++n)
+      for (int d=0; d<N_INPUTS; ++d)
+        data(n,d) = means(n % N_GAUSSIANS, d) + 0.5 * gen();
+  }
+};
+
+/**
+ * Scores a shard of the samples with a machine shared by all the threads
+ */
+struct Scorer {
+  const bob::machine::GMMMachine* gmm;
+  const blitz::Array<double,2>* data;
+  blitz::Array<double,1>* scores;
+  blitz::Array<double,1>* batch_scores;
+  std::vector<bob::machine::GMMStats>* stats;
+
+  void operator()(size_t t, size_t start, size_t end) const {
+    bob::machine::GMMWorkspace ws;
+    blitz::Range a = blitz::Range::all();
+    for (int n=start; n<(int)end; ++n)
+      (*scores)(n) = gmm->logLikelihood((*data)(n,a), ws);
+    blitz::Range r(start, end-1);
+    blitz::Array<double,1> bs = (*batch_scores)(r);
+    gmm->logLikelihood((*data)(r,a), bs, ws);
+    gmm->accStatistics((*data)(r,a), (*stats)[t], ws);
+  }
+};
+
+struct KMeansAccumulator {
+  const bob::machine::KMeansMachine* kmeans;
+  const blitz::Array<double,2>* data;
+  std::vector<blitz::Array<double,2> >* variances;
+  std::vector<blitz::Array<double,1> >* weights;
+  std::vector<blitz::Array<double,2> >* means;
+
+  void operator()(size_t t, size_t start, size_t end) const {
+    blitz::Range r(start, end-1);
+    kmeans->getVariancesAndWeightsForEachClusterAcc((*data)(r,blitz::Range::all()),
+      (*variances)[t], (*weights)[t], (*means)[t]);
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( test_gmm_concurrent_scoring )
+{
+  // Serial reference, with the internal workspace
+  blitz::Array<double,1> ref(N_SAMPLES);
+  blitz::Range a = blitz::Range::all();
+  for (int n=0; n<N_SAMPLES; ++n) ref(n) = gmm.logLikelihood(data(n,a));
+  bob::machine::GMMStats ref_stats(N_GAUSSIANS, N_INPUTS);
+  gmm.accStatistics(data, ref_stats);
+
+  // Concurrent scoring with the same machine
+  blitz::Array<double,1> scores(N_SAMPLES), batch_scores(N_SAMPLES);
+  std::vector<bob::machine::GMMStats> stats(N_THREADS,
+    bob::machine::GMMStats(N_GAUSSIANS, N_INPUTS));
+  const bob::machine::GMMMachine& cgmm = gmm;
+  Scorer scorer = {&cgmm, &data, &scores, &batch_scores, &stats};
+  bob::core::parallelFor(N_SAMPLES, N_THREADS, scorer);
+
+  BOOST_CHECK( blitz::all(scores == ref) );
+  BOOST_CHECK( blitz::all(blitz::abs(batch_scores - ref) < 1e-10 * blitz::abs(ref)) );
+
+  bob::machine::GMMStats sum(N_GAUSSIANS, N_INPUTS);
+  for (size_t t=0; t<N_THREADS; ++t) sum += stats[t];
+  BOOST_CHECK_EQUAL( sum.T, ref_stats.T );
+  BOOST_CHECK( std::fabs(sum.log_likelihood - ref_stats.log_likelihood) < 1e-8 * std::fabs(ref_stats.log_likelihood) );
+  BOOST_CHECK( blitz::all(blitz::abs(sum.n - ref_stats.n) < 1e-8) );
+  BOOST_CHECK( blitz::all(blitz::abs(sum.sumPx - ref_stats.sumPx) < 1e-8) );
+  BOOST_CHECK( blitz::all(blitz::abs(sum.sumPxx - ref_stats.sumPxx) < 1e-8) );
+}
+
+BOOST_AUTO_TEST_CASE( test_kmeans_concurrent_accumulation )
+{
+  blitz::Array<double,2> ref_variances(N_GAUSSIANS, N_INPUTS);
+  blitz::Array<double,1> ref_weights(N_GAUSSIANS);
+  kmeans.getVariancesAndWeightsForEachCluster(data, ref_variances, ref_weights);
+
+  std::vector<blitz::Array<double,2> > variances(N_THREADS), means(N_THREADS);
+  std::vector<blitz::Array<double,1> > weights(N_THREADS);
+  for (size_t t=0; t<N_THREADS; ++t) {
+    variances[t].resize(N_GAUSSIANS, N_INPUTS);
+    means[t].resize(N_GAUSSIANS, N_INPUTS);
+    weights[t].resize(N_GAUSSIANS);
+    kmeans.getVariancesAndWeightsForEachClusterInit(variances[t], weights[t], means[t]);
+  }
+  KMeansAccumulator acc = {&kmeans, &data, &variances, &weights, &means};
+  bob::core::parallelFor(N_SAMPLES, N_THREADS, acc);
+  for (size_t t=1; t<N_THREADS; ++t) {
+    variances[0] += variances[t];
+    weights[0] += weights[t];
+    means[0] += means[t];
+  }
+  kmeans.getVariancesAndWeightsForEachClusterFin(variances[0], weights[0], means[0]);
+
+  BOOST_CHECK( blitz::all(blitz::abs(variances[0] - ref_variances) < 1e-8) );
+  BOOST_CHECK( blitz::all(blitz::abs(weights[0] - ref_weights) < 1e-12) );
+}
+
+BOOST_AUTO_TEST_CASE( test_gmm_cached_supervectors )
+{
+  blitz::Array<double,1> mean(N_GAUSSIANS*N_INPUTS), variance(N_GAUSSIANS*N_INPUTS);
+  gmm.getMeanSupervector(mean);
+  gmm.getVarianceSupervector(variance);
+  BOOST_CHECK( blitz::all(gmm.getMeanSupervector() == mean) );
+  BOOST_CHECK( blitz::all(gmm.getVarianceSupervector() == variance) );
+
+  // the cache follows the setters
+  mean *= 2.;
+  gmm.setMeanSupervector(mean);
+  BOOST_CHECK( blitz::all(gmm.getMeanSupervector() == mean) );
+  gmm.setVarianceThresholds(1.);
+  gmm.getVarianceSupervector(variance);
+  BOOST_CHECK( blitz::all(gmm.getVarianceSupervector() == variance) );
+  BOOST_CHECK( blitz::all(gmm.getVarianceSupervector() >= 1.) );
+
+  // and the copies
+  const bob::machine::GMMMachine copy(gmm);
+  BOOST_CHECK( blitz::all(copy.getMeanSupervector() == mean) );
+  BOOST_CHECK( blitz::all(copy.getVarianceSupervector() == variance) );
+
+  // the components updated in place need an explicit update
+  gmm.getGaussian(1)->updateMean() = -1.;
+  gmm.updateCacheSupervectors();
+  gmm.getMeanSupervector(mean);
+  BOOST_CHECK( blitz::all(gmm.getMeanSupervector() == mean) );
+  BOOST_CHECK_EQUAL( gmm.getMeanSupervector()(N_INPUTS), -1. );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
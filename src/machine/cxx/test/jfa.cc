@@ -0,0 +1,166 @@
+/**
+ * @file machine/cxx/test/jfa.cc
+ * @date Fri 16 Oct 2026 23:48:12 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Tests the multi-threaded estimation of the channel offsets of the
+ * JFAScorer, for JFA and ISV models
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE JFA Machine Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/random.hpp>
+#include <blitz/array.h>
+#include <cmath>
+
+#include "bob/machine/JFAMachine.h"
+
+static const int N_GAUSSIANS = 8;
+static const int N_INPUTS = 4;
+static const int RU = 3;
+static const int RV = 2;
+static const int N_PROBES = 97;
+static const int N_MODELS = 5;
+
+typedef boost::variate_generator<boost::mt19937&,
+  boost::normal_distribution<double> > generator_t;
+
+static void randomize(blitz::Array<double,1>& a, generator_t& gen) {
+  for (int i=0; i<a.extent(0); ++i) a(i) = gen();
+}
+
+static void randomize(blitz::Array<double,2>& a, generator_t& gen) {
+  for (int i=0; i<a.extent(0); ++i)
+    for (int j=0; j<a.extent(1); ++j) a(i,j) = gen();
+}
+
+struct T {
+  boost::mt19937 rng;
+  boost::normal_distribution<double> normal;
+  generator_t gen;
+  boost::shared_ptr<bob::machine::GMMMachine> ubm;
+  std::vector<boost::shared_ptr<const bob::machine::GMMStats> > probes;
+
+  T(): gen(rng, normal),
+    ubm(new bob::machine::GMMMachine(N_GAUSSIANS, N_INPUTS))
+  {
+    blitz::Array<double,2> means(N_GAUSSIANS, N_INPUTS);
+    blitz::Array<double,2> variances(N_GAUSSIANS, N_INPUTS);
+    blitz::Array<double,1> weights(N_GAUSSIANS);
+    randomize(means, gen);
+    randomize(variances, gen);
+    variances = 0.5 + blitz::abs(variances);
+    weights = 1. / N_GAUSSIANS;
+    ubm->setMeans(means);
+    ubm->setVariances(variances);
+    ubm->setWeights(weights);
+
+    for (int p=0; p<N_PROBES; ++p) {
+      boost::shared_ptr<bob::machine::GMMStats> stats(
+          new bob::machine::GMMStats(N_GAUSSIANS, N_INPUTS));
+      randomize(stats->n, gen);
+      stats->n = 0.1 + 10. * blitz::abs(stats->n);
+      randomize(stats->sumPx, gen);
+      stats->T = 100;
+      probes.push_back(stats);
+    }
+  }
+
+  /**
+   * A JFA base machine (or an ISV one, if with_v is false, i.e. without
+   * any speaker subspace)
+   */
+  boost::shared_ptr<bob::machine::JFABaseMachine> base(bool with_v) {
+    boost::shared_ptr<bob::machine::JFABaseMachine> b(
+        new bob::machine::JFABaseMachine(ubm, RU, RV));
+    const int CD = N_GAUSSIANS * N_INPUTS;
+    blitz::Array<double,2> U(CD, RU), V(CD, RV);
+    blitz::Array<double,1> d(CD);
+    randomize(U, gen);
+    randomize(V, gen);
+    if (!with_v) V = 0.;
+    randomize(d, gen);
+    b->setU(U);
+    b->setV(V);
+    b->setD(d);
+    return b;
+  }
+
+  std::vector<boost::shared_ptr<const bob::machine::JFAMachine> > models(
+      boost::shared_ptr<bob::machine::JFABaseMachine> b) {
+    std::vector<boost::shared_ptr<const bob::machine::JFAMachine> > m;
+    blitz::Array<double,1> y(RV), z(N_GAUSSIANS * N_INPUTS);
+    for (int i=0; i<N_MODELS; ++i) {
+      boost::shared_ptr<bob::machine::JFAMachine> model(
+          new bob::machine::JFAMachine(b));
+      randomize(y, gen);
+      randomize(z, gen);
+      model->setY(y);
+      model->setZ(z);
+      m.push_back(model);
+    }
+    return m;
+  }
+};
+
+/**
+ * Compares the channel factors, offsets and scores of the scorers with
+ * several threads to the ones of a single thread
+ */
+static void check_threads(T& t, bool with_v) {
+  boost::shared_ptr<bob::machine::JFABaseMachine> b = t.base(with_v);
+  const std::vector<boost::shared_ptr<const bob::machine::JFAMachine> >
+    models = t.models(b);
+
+  bob::machine::JFAScorer ref(b, t.probes, 1);
+  blitz::Array<double,2> ref_scores(N_MODELS, N_PROBES);
+  ref.score(models, ref_scores);
+
+  const size_t n_threads[] = {2, 4, 0};
+  for (size_t i=0; i<sizeof(n_threads)/sizeof(n_threads[0]); ++i) {
+    // several times, to give the threads more chances to interfere
+    for (int run=0; run<5; ++run) {
+      bob::machine::JFAScorer scorer(b, t.probes, n_threads[i]);
+      BOOST_REQUIRE_EQUAL(scorer.getNProbes(), (size_t)N_PROBES);
+      BOOST_CHECK(blitz::all(scorer.getX() == ref.getX()));
+      for (int p=0; p<N_PROBES; ++p)
+        BOOST_CHECK(blitz::all(scorer.getUx()[p] == ref.getUx()[p]));
+
+      blitz::Array<double,2> scores(N_MODELS, N_PROBES);
+      scorer.score(models, scores);
+      for (int m=0; m<N_MODELS; ++m)
+        for (int p=0; p<N_PROBES; ++p)
+          BOOST_CHECK_SMALL(scores(m,p) - ref_scores(m,p), 1e-10);
+    }
+  }
+}
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( test_jfa_scorer_threads )
+{
+  check_threads(*this, true);
+}
+
+BOOST_AUTO_TEST_CASE( test_isv_scorer_threads )
+{
+  check_threads(*this, false);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,130 @@
+/**
+ * @file machine/cxx/test/linearscoring.cc
+ * @date Fri 16 Oct 2026 17:42:18 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Tests the linear scoring with precomputed models and several
+ * threads
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE LinearScoring Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/make_shared.hpp>
+#include <blitz/array.h>
+#include <vector>
+
+#include "bob/machine/LinearScoring.h"
+
+struct T {
+  boost::shared_ptr<bob::machine::GMMMachine> ubm;
+  std::vector<boost::shared_ptr<const bob::machine::GMMMachine> > models;
+  std::vector<boost::shared_ptr<const bob::machine::GMMStats> > stats;
+  std::vector<blitz::Array<double,1> > offsets;
+  blitz::Array<double,2> ref_00, ref_01, ref_10, ref_11;
+
+  T(): ubm(boost::make_shared<bob::machine::GMMMachine>(2,2)),
+    ref_00(2,3), ref_01(2,3), ref_10(2,3), ref_11(2,3)
+  {
+    blitz::Array<double,1> weights(2);
+    weights = 0.5, 0.5;
+    blitz::Array<double,2> m(2,2), v(2,2);
+    m = 3, 70, 4, 72;
+    v = 1, 10, 2, 5;
+    ubm->setWeights(weights);
+    ubm->setMeans(m);
+    ubm->setVariances(v);
+
+    for (int i=0; i<2; ++i) {
+      boost::shared_ptr<bob::machine::GMMMachine> model =
+        boost::make_shared<bob::machine::GMMMachine>(2,2);
+      m = 1+4*i, 2+4*i, 3+4*i, 4+4*i;
+      v = 9+4*i, 10+4*i, 11+4*i, 12+4*i;
+      model->setWeights(weights);
+      model->setMeans(m);
+      model->setVariances(v);
+      models.push_back(model);
+    }
+
+    double px[3][4] = {{1,2,3,4}, {5,6,7,8}, {5,6,7,3}};
+    double n[3][2] = {{1,2}, {3,4}, {3,4}};
+    for (int t=0; t<3; ++t) {
+      boost::shared_ptr<bob::machine::GMMStats> s =
+        boost::make_shared<bob::machine::GMMStats>(2,2);
+      s->sumPx = px[t][0], px[t][1], px[t][2], px[t][3];
+      s->n = n[t][0], n[t][1];
+      s->T = n[t][0] + n[t][1];
+      stats.push_back(s);
+    }
+
+    blitz::Array<double,1> o(4);
+    o = 9, 8, 7, 6; offsets.push_back(o.copy());
+    o = 5, 4, 3, 2; offsets.push_back(o.copy());
+    o = 1, 0, 1, 2; offsets.push_back(o.copy());
+
+    // Reference scores (from Idiap internal matlab implementation)
+    ref_00 = 2372.9, 5207.7, 5275.7, 2215.7, 4868.1, 4932.1;
+    ref_01 = 790.9666666666667, 743.9571428571428, 753.6714285714285,
+      738.5666666666667, 695.4428571428572, 704.5857142857144;
+    ref_10 = 2615.5, 5434.1, 5392.5, 2381.5, 4999.3, 5022.5;
+    ref_11 = 871.8333333333332, 776.3000000000001, 770.3571428571427,
+      793.8333333333333, 714.1857142857143, 717.5000000000000;
+  }
+};
+
+static bool is_close(const blitz::Array<double,2>& a, const blitz::Array<double,2>& b) {
+  return blitz::all(blitz::abs(a - b) < 1e-7);
+}
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( test_linearscoring_gmm )
+{
+  blitz::Array<double,2> scores(2,3);
+  bob::machine::linearScoring(models, *ubm, stats, false, scores);
+  BOOST_CHECK( is_close(scores, ref_00) );
+  bob::machine::linearScoring(models, *ubm, stats, true, scores);
+  BOOST_CHECK( is_close(scores, ref_01) );
+  bob::machine::linearScoring(models, *ubm, stats, offsets, false, scores);
+  BOOST_CHECK( is_close(scores, ref_10) );
+  bob::machine::linearScoring(models, *ubm, stats, offsets, true, scores);
+  BOOST_CHECK( is_close(scores, ref_11) );
+}
+
+BOOST_AUTO_TEST_CASE( test_linearscoring_precomputed_threaded )
+{
+  blitz::Array<double,2> A(2,4);
+  bob::machine::linearScoringModels(models, *ubm, A);
+
+  // the same models are scored several times, with 1 to 3 threads
+  for (size_t n_threads=1; n_threads<=3; ++n_threads) {
+    blitz::Array<double,2> scores(2,3);
+    bob::machine::linearScoring(A, ubm->getMeanSupervector(), stats, false, scores, n_threads);
+    BOOST_CHECK( is_close(scores, ref_00) );
+    bob::machine::linearScoring(A, ubm->getMeanSupervector(), stats, offsets, true, scores, n_threads);
+    BOOST_CHECK( is_close(scores, ref_11) );
+  }
+
+  // non-contiguous output
+  blitz::Array<double,2> scores_t(3,2);
+  blitz::Array<double,2> scores = scores_t.transpose(1,0);
+  bob::machine::linearScoring(A, ubm->getMeanSupervector(), stats, offsets, false, scores, 2);
+  BOOST_CHECK( is_close(scores, ref_10) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
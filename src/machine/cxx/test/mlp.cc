@@ -0,0 +1,171 @@
+/**
+ * @file machine/cxx/test/mlp.cc
+ * @date Fri 16 Oct 2026 21:12:48 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Tests the batched forward pass of the MLP and the array kernels of
+ * the activation functions
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE machine-mlp Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/random.hpp>
+#include <blitz/array.h>
+#include <cmath>
+#include <vector>
+
+#include "bob/machine/MLP.h"
+#include "bob/machine/Activation.h"
+
+static const bob::machine::Activation ACTIVATIONS[] =
+  {bob::machine::LINEAR, bob::machine::TANH, bob::machine::LOG};
+
+typedef boost::variate_generator<boost::mt19937&,
+  boost::uniform_real<double> > generator_t;
+
+/**
+ * The activation functions and their derivatives, one element at a time
+ */
+static double f(bob::machine::Activation a, double x) {
+  switch (a) {
+    case bob::machine::TANH: return std::tanh(x);
+    case bob::machine::LOG: return bob::machine::logistic(x);
+    default: return bob::machine::linear(x);
+  }
+}
+
+static double df(bob::machine::Activation a, double y) {
+  switch (a) {
+    case bob::machine::TANH: return bob::machine::tanh_derivative(y);
+    case bob::machine::LOG: return bob::machine::logistic_derivative(y);
+    default: return bob::machine::linear_derivative(y);
+  }
+}
+
+struct T {
+  boost::mt19937 rng;
+  boost::uniform_real<double> uniform;
+  generator_t gen;
+
+  T(): uniform(-3., 3.), gen(rng, uniform) { }
+
+  void randomize(blitz::Array<double,2>& a) {
+    for (int i=0; i<a.extent(0); ++i)
+      for (int j=0; j<a.extent(1); ++j) a(i,j) = gen();
+  }
+
+  void randomize(blitz::Array<double,1>& a) {
+    for (int i=0; i<a.extent(0); ++i) a(i) = gen();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( test_activate )
+{
+  blitz::Array<double,2> x(7, 5), y(7, 5);
+  blitz::Array<double,1> bias(5);
+  randomize(x);
+  randomize(bias);
+  for (size_t k=0; k<3; ++k) {
+    const bob::machine::Activation a = ACTIVATIONS[k];
+
+    // contiguous rows
+    y = x;
+    bob::machine::activate(a, bias, y);
+    for (int i=0; i<x.extent(0); ++i)
+      for (int j=0; j<x.extent(1); ++j)
+        BOOST_CHECK_CLOSE(y(i,j), f(a, x(i,j) + bias(j)), 1e-12);
+
+    // strided rows (the transpose of a C-contiguous array)
+    blitz::Array<double,2> xt(5, 7);
+    xt = x.transpose(1,0);
+    blitz::Array<double,2> yt = xt.transpose(1,0);
+    bob::machine::activate(a, bias, yt);
+    BOOST_CHECK( blitz::all(yt == y) );
+
+    // a single vector
+    blitz::Array<double,1> v(5);
+    v = x(2, blitz::Range::all());
+    bob::machine::activate(a, bias, v);
+    for (int j=0; j<v.extent(0); ++j)
+      BOOST_CHECK_EQUAL(v(j), y(2,j));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_multiply_by_derivative )
+{
+  blitz::Array<double,2> output(6, 4), error(6, 4), result(6, 4);
+  randomize(error);
+  for (size_t k=0; k<3; ++k) {
+    const bob::machine::Activation a = ACTIVATIONS[k];
+    randomize(output);
+    // the derivatives are given the activated values
+    if (a == bob::machine::TANH) output = blitz::tanh(output);
+    if (a == bob::machine::LOG) output = 1. / (1. + blitz::exp(-output));
+
+    result = error;
+    bob::machine::multiplyByDerivative(a, output, result);
+    for (int i=0; i<error.extent(0); ++i)
+      for (int j=0; j<error.extent(1); ++j)
+        BOOST_CHECK_CLOSE(result(i,j), error(i,j) * df(a, output(i,j)), 1e-12);
+
+    // strided rows
+    blitz::Array<double,2> errort(4, 6);
+    errort = error.transpose(1,0);
+    blitz::Array<double,2> resultt = errort.transpose(1,0);
+    bob::machine::multiplyByDerivative(a, output, resultt);
+    BOOST_CHECK( blitz::all(resultt == result) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_forward_blocks )
+{
+  std::vector<size_t> hidden(2);
+  hidden[0] = 9;
+  hidden[1] = 5;
+  bob::machine::MLP machine(6, hidden, 3);
+  machine.randomize(rng, -0.5, 0.5);
+  blitz::Array<double,1> sub(6), div(6);
+  randomize(sub);
+  randomize(div);
+  div = 1. + blitz::abs(div);
+  machine.setInputSubtraction(sub);
+  machine.setInputDivision(div);
+
+  // below, at and above the block size of 256, with a remainder block
+  const int n_samples[] = {1, 100, 256, 257, 600};
+  for (size_t k=0; k<3; ++k) {
+    machine.setActivation(ACTIVATIONS[k]);
+    for (size_t n=0; n<sizeof(n_samples)/sizeof(n_samples[0]); ++n) {
+      blitz::Array<double,2> input(n_samples[n], 6), output(n_samples[n], 3);
+      randomize(input);
+      machine.forward(input, output);
+
+      blitz::Array<double,1> sample_output(3);
+      for (int i=0; i<input.extent(0); ++i) {
+        machine.forward(input(i, blitz::Range::all()), sample_output);
+        for (int j=0; j<3; ++j)
+          BOOST_CHECK_SMALL(output(i,j) - sample_output(j), 1e-12);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,139 @@
+/**
+ * @file machine/cxx/test/svm.cc
+ * @date Fri 16 Oct 2026 23:31:05 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Tests the prediction of blocks of samples with stored SVM models
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE machine-svm Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <blitz/array.h>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+#include "bob/machine/SVM.h"
+
+/**
+ * Returns the path of a file of the SVM test data
+ */
+static std::string data_file(const std::string& name) {
+  const char* dir = getenv("BOB_SVM_DATA_DIR");
+  if (!dir) throw std::runtime_error("BOB_SVM_DATA_DIR is not set");
+  return (boost::filesystem::path(dir) / name).string();
+}
+
+/**
+ * Reads all the samples of a libsvm data file, one sample per row
+ */
+static blitz::Array<double,2> read_data(const std::string& filename) {
+  bob::machine::SVMFile file(filename);
+  blitz::Array<double,2> data(file.samples(), file.shape());
+  blitz::Array<double,1> values(file.shape());
+  int label;
+  for (size_t i=0; i<file.samples(); ++i) {
+    BOOST_REQUIRE(file.read(label, values));
+    data(i, blitz::Range::all()) = values;
+  }
+  return data;
+}
+
+static void svm_model_free(svm_model*& m) {
+#if LIBSVM_VERSION >= 300
+  svm_free_and_destroy_model(&m);
+#else
+  svm_destroy_model(m);
+#endif
+}
+
+/**
+ * Checks the predictions on a block of samples against the predictions of
+ * each sample alone, and against libsvm
+ */
+static void check_model(const std::string& model_file,
+    const std::string& data) {
+  const bob::machine::SupportVector machine(data_file(model_file));
+  const blitz::Array<double,2> samples = read_data(data_file(data));
+  const int n_samples = samples.extent(0);
+  const int n_dims = samples.extent(1);
+  const int n_scores = machine.outputSize();
+  BOOST_REQUIRE_EQUAL((size_t)n_dims, machine.inputSize());
+
+  // the whole block at once
+  blitz::Array<int,1> labels(n_samples);
+  machine.predictClass(samples, labels);
+  blitz::Array<int,1> labels2(n_samples);
+  blitz::Array<double,2> scores(n_samples, n_scores);
+  machine.predictClassAndScores(samples, labels2, scores);
+  BOOST_CHECK(blitz::all(labels == labels2));
+
+  // libsvm, on the same model
+  svm_model* model = svm_load_model(data_file(model_file).c_str());
+  BOOST_REQUIRE(model);
+  std::vector<svm_node> nodes(n_dims + 1);
+  std::vector<double> dec_values(n_scores);
+
+  blitz::Array<double,1> sample_scores(n_scores);
+  for (int i=0; i<n_samples; ++i) {
+    const blitz::Array<double,1> sample = samples(i, blitz::Range::all());
+
+    // one sample at a time
+    BOOST_CHECK_EQUAL(machine.predictClass(sample), labels(i));
+    BOOST_CHECK_EQUAL(machine.predictClassAndScores(sample, sample_scores),
+        labels(i));
+    for (int c=0; c<n_scores; ++c)
+      BOOST_CHECK_EQUAL(sample_scores(c), scores(i,c));
+
+    int n = 0;
+    for (int d=0; d<n_dims; ++d) {
+      if (samples(i,d) == 0.) continue;
+      nodes[n].index = d + 1;
+      nodes[n].value = samples(i,d);
+      ++n;
+    }
+    nodes[n].index = -1;
+#if LIBSVM_VERSION > 290
+    const int label = round(svm_predict_values(model, &nodes[0], &dec_values[0]));
+#else
+    svm_predict_values(model, &nodes[0], &dec_values[0]);
+    const int label = round(svm_predict(model, &nodes[0]));
+#endif
+    BOOST_CHECK_EQUAL(labels(i), label);
+    for (int c=0; c<n_scores; ++c)
+      BOOST_CHECK_SMALL(scores(i,c) - dec_values[c], 1e-10);
+  }
+
+  svm_model_free(model);
+}
+
+BOOST_AUTO_TEST_CASE( test_predict_block_heart )
+{
+  // 270 samples: more than one block of the dense prediction engine
+  check_model("heart.svmmodel", "heart.svmdata");
+  check_model("heart_no_probs.svmmodel", "heart.svmdata");
+}
+
+BOOST_AUTO_TEST_CASE( test_predict_block_iris )
+{
+  // 3 classes, several decision values per sample
+  check_model("iris.svmmodel", "iris.svmdata");
+}
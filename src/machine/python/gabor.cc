@@ -23,6 +23,7 @@
 
 #include <boost/python.hpp>
 #include "bob/core/python/ndarray.h"
+#include "bob/core/python/gil.h"
 
 #include "bob/ip/GaborWaveletTransform.h"
 #include "bob/machine/GaborGraphMachine.h"
@@ -103,6 +104,37 @@ static double bob_similarity(bob::machine::GaborGraphMachine& self, bob::python:
   }
 }
 
+static bob::python::ndarray bob_similarities(bob::machine::GaborGraphMachine& self, bob::python::const_ndarray many_model_graphs, bob::python::const_ndarray probe_graph, const bob::machine::GaborJetSimilarity& similarity_function, const size_t n_threads){
+  switch (probe_graph.type().nd){
+    case 2:{ // Gabor graphs including jets without phases
+      const blitz::Array<double,3> models = many_model_graphs.bz<double,3>();
+      const blitz::Array<double,2> probe = probe_graph.bz<double,2>();
+      bob::python::ndarray result(bob::core::array::t_float64, models.extent(0));
+      blitz::Array<double,1> result_ = result.bz<double,1>();
+      {
+        bob::python::no_gil unlock;
+        self.similarities(models, probe, similarity_function, result_, n_threads);
+      }
+      return result;
+    }
+
+    case 3:{ // Gabor graphs including jets with phases
+      const blitz::Array<double,4> models = many_model_graphs.bz<double,4>();
+      const blitz::Array<double,3> probe = probe_graph.bz<double,3>();
+      bob::python::ndarray result(bob::core::array::t_float64, models.extent(0));
+      blitz::Array<double,1> result_ = result.bz<double,1>();
+      {
+        bob::python::no_gil unlock;
+        self.similarities(models, probe, similarity_function, result_, n_threads);
+      }
+      return result;
+    }
+
+    default: // unknown graph shape
+      throw bob::core::UnexpectedShapeError();
+  }
+}
+
 static double bob_jet_sim(const bob::machine::GaborJetSimilarity& self, bob::python::const_ndarray jet1, bob::python::const_ndarray jet2){
   switch (jet1.type().nd){
     case 1:{
@@ -259,6 +291,13 @@ void bind_machine_gabor(){
       &bob_similarity,
       (boost::python::arg("self"), boost::python::arg("model_graph_jets"), boost::python::arg("probe_graph_jets"), boost::python::arg("jet_similarity_function")),
       "Computes the similarity between the given probe graph and the gallery, which might be a single graph or a collection of graphs"
+    )
+
+    .def(
+      "similarities",
+      &bob_similarities,
+      (boost::python::arg("self"), boost::python::arg("many_model_graph_jets"), boost::python::arg("probe_graph_jets"), boost::python::arg("jet_similarity_function"), boost::python::arg("n_threads")=1),
+      "Computes the similarities between the given probe graph and each of the given model graphs (stacked along the first dimension), splitting the models across n_threads threads (0 means one per hardware core). Each similarity is identical to the one computed by similarity() for the corresponding model graph."
   );
 
 }
@@ -25,6 +25,7 @@
 #include <blitz/array.h>
 
 #include "bob/core/python/ndarray.h"
+#include "bob/core/python/gil.h"
 
 using namespace boost::python;
 
@@ -193,12 +194,38 @@ static double py_gmmmachine_loglikelihoodA_(const bob::machine::GMMMachine& mach
   return machine.logLikelihood_(x.bz<double,1>(), ll_);
 }
 
-static double py_gmmmachine_loglikelihoodB(const bob::machine::GMMMachine& machine, bob::python::const_ndarray x) {
-  return machine.logLikelihood(x.bz<double,1>());
+static object py_gmmmachine_loglikelihoodB(const bob::machine::GMMMachine& machine, bob::python::const_ndarray x) {
+  const bob::core::array::typeinfo& info = x.type();
+  if(info.nd == 2) {
+    bob::python::ndarray ll(bob::core::array::t_float64, info.shape[0]);
+    blitz::Array<double,1> ll_ = ll.bz<double,1>();
+    const blitz::Array<double,2> x_ = x.bz<double,2>();
+    {
+      // a local workspace, as other Python threads might use the same machine
+      bob::machine::GMMWorkspace ws;
+      bob::python::no_gil unlock;
+      machine.logLikelihood(x_, ll_, ws);
+    }
+    return ll.self();
+  }
+  return object(machine.logLikelihood(x.bz<double,1>()));
 }
 
-static double py_gmmmachine_loglikelihoodB_(const bob::machine::GMMMachine& machine, bob::python::const_ndarray x) {
-  return machine.logLikelihood_(x.bz<double,1>());
+static object py_gmmmachine_loglikelihoodB_(const bob::machine::GMMMachine& machine, bob::python::const_ndarray x) {
+  const bob::core::array::typeinfo& info = x.type();
+  if(info.nd == 2) {
+    bob::python::ndarray ll(bob::core::array::t_float64, info.shape[0]);
+    blitz::Array<double,1> ll_ = ll.bz<double,1>();
+    const blitz::Array<double,2> x_ = x.bz<double,2>();
+    {
+      // a local workspace, as other Python threads might use the same machine
+      bob::machine::GMMWorkspace ws;
+      bob::python::no_gil unlock;
+      machine.logLikelihood_(x_, ll_, ws);
+    }
+    return ll.self();
+  }
+  return object(machine.logLikelihood_(x.bz<double,1>()));
 }
 
 static void py_gmmmachine_accStatistics(const bob::machine::GMMMachine& machine, bob::python::const_ndarray x, bob::machine::GMMStats& gs) {
@@ -209,6 +236,18 @@ static void py_gmmmachine_accStatistics_(const bob::machine::GMMMachine& machine
   machine.accStatistics_(x.bz<double,1>(), gs);
 }
 
+static void py_gmmmachine_accStatisticsB(const bob::machine::GMMMachine& machine, const blitz::Array<double,2>& x, bob::machine::GMMStats& gs) {
+  bob::machine::GMMWorkspace ws;
+  bob::python::no_gil unlock;
+  machine.accStatistics(x, gs, ws);
+}
+
+static void py_gmmmachine_accStatisticsB_(const bob::machine::GMMMachine& machine, const blitz::Array<double,2>& x, bob::machine::GMMStats& gs) {
+  bob::machine::GMMWorkspace ws;
+  bob::python::no_gil unlock;
+  machine.accStatistics_(x, gs, ws);
+}
+
 void bind_machine_gmm()
 {
   class_<bob::machine::GMMStats, boost::shared_ptr<bob::machine::GMMStats> >("GMMStats",
@@ -274,18 +313,16 @@ void bind_machine_gmm()
     .def("log_likelihood_", &py_gmmmachine_loglikelihoodA_, args("self", "x", "log_weighted_gaussian_likelihoods"),
          "Output the log likelihood of the sample, x, i.e. log(p(x|bob::machine::GMMMachine)). Inputs are NOT checked.")
     .def("log_likelihood", &py_gmmmachine_loglikelihoodB, args("self", "x"),
-         " Output the log likelihood of the sample, x, i.e. log(p(x|GMM)). Inputs are checked.")
+         " Output the log likelihood of the sample, x, i.e. log(p(x|GMM)). If x is a 2D array, the log likelihood of each sample (row) is returned as a 1D array. Inputs are checked.")
     .def("log_likelihood_", &py_gmmmachine_loglikelihoodB_, args("self", "x"),
-         " Output the log likelihood of the sample, x, i.e. log(p(x|GMM)). Inputs are checked.")
+         " Output the log likelihood of the sample, x, i.e. log(p(x|GMM)). If x is a 2D array, the log likelihood of each sample (row) is returned as a 1D array. Inputs are NOT checked.")
     .def("acc_statistics", &py_gmmmachine_accStatistics, args("self", "x", "stats"),
          "Accumulate the GMM statistics for this sample. Inputs are checked.")
     .def("acc_statistics_", &py_gmmmachine_accStatistics_, args("self", "x", "stats"),
          "Accumulate the GMM statistics for this sample. Inputs are NOT checked.")
-    .def("acc_statistics",
-         (void (bob::machine::GMMMachine::*)(const blitz::Array<double,2>&, bob::machine::GMMStats&) const)&bob::machine::GMMMachine::accStatistics,
+    .def("acc_statistics", &py_gmmmachine_accStatisticsB,
          args("sampler", "stats"), "Accumulates the GMM statistics over a set of samples. Inputs are checked.")
-    .def("acc_statistics_",
-         (void (bob::machine::GMMMachine::*)(const blitz::Array<double,2>&, bob::machine::GMMStats&) const)&bob::machine::GMMMachine::accStatistics_,
+    .def("acc_statistics_", &py_gmmmachine_accStatisticsB_,
          args("sampler", "stats"), "Accumulates the GMM statistics over a set of samples. Inputs are NOT checked.")
     .def("load", &bob::machine::GMMMachine::load, "Load from a Configuration")
     .def("save", &bob::machine::GMMMachine::save, "Save to a Configuration")
@@ -166,6 +166,50 @@ static double jfa_forward_sample_Ux(bob::machine::JFAMachine& m, object stats, b
   return score;
 }
 
+static boost::shared_ptr<bob::machine::JFAScorer> jfascorer_new(
+    const boost::shared_ptr<bob::machine::JFABaseMachine> jfa_base, list stats,
+    const size_t n_threads)
+{
+  // Extracts the vector of GMMStats from the python list
+  std::vector<boost::shared_ptr<const bob::machine::GMMStats> > gmm_stats;
+  for(int s=0; s<len(stats); ++s)
+    gmm_stats.push_back(extract<boost::shared_ptr<bob::machine::GMMStats> >(stats[s]));
+  return boost::shared_ptr<bob::machine::JFAScorer>(
+      new bob::machine::JFAScorer(jfa_base, gmm_stats, n_threads));
+}
+
+static void convertJFAMachineList(list models, 
+    std::vector<boost::shared_ptr<const bob::machine::JFAMachine> >& models_c)
+{
+  for(int i=0; i<len(models); ++i)
+    models_c.push_back(extract<boost::shared_ptr<bob::machine::JFAMachine> >(models[i]));
+}
+
+static object jfascorer_score(const bob::machine::JFAScorer& s, list models)
+{
+  std::vector<boost::shared_ptr<const bob::machine::JFAMachine> > models_c;
+  convertJFAMachineList(models, models_c);
+  bob::python::ndarray scores(bob::core::array::t_float64, models_c.size(), s.getNProbes());
+  blitz::Array<double,2> scores_ = scores.bz<double,2>();
+  s.score(models_c, scores_);
+  return scores.self();
+}
+
+static void jfascorer_score_(const bob::machine::JFAScorer& s, list models,
+    bob::python::ndarray scores)
+{
+  std::vector<boost::shared_ptr<const bob::machine::JFAMachine> > models_c;
+  convertJFAMachineList(models, models_c);
+  blitz::Array<double,2> scores_ = scores.bz<double,2>();
+  s.score(models_c, scores_);
+}
+
+static object jfascorer_getUx(const bob::machine::JFAScorer& s)
+{
+  list ret;
+  for(size_t p=0; p<s.getNProbes(); ++p) ret.append(s.getUx()[p]);
+  return ret;
+}
 
 
 void bind_machine_jfa() 
@@ -213,4 +257,15 @@ void bind_machine_jfa()
     .add_property("dim_rv", &bob::machine::JFAMachine::getDimRv)
   ;
 
+  class_<bob::machine::JFAScorer, boost::shared_ptr<bob::machine::JFAScorer> >("JFAScorer", "Scores a set of probes against many JFA (or ISV) machines. The channel offsets Ux of the probes, which do not depend on the models, are estimated once at construction time and kept, so that the probes can be scored against any number of JFAMachine's sharing the same JFABaseMachine in a single (blocked) linear scoring call.", no_init)
+    .def("__init__", make_constructor(&jfascorer_new, default_call_policies(), (arg("jfa_base"), arg("gmm_stats"), arg("n_threads")=1)), "Estimates the channel offsets of the given list of GMM statistics. n_threads is the number of threads to use (0 for one per core).")
+    .def("__call__", &jfascorer_score, (arg("self"), arg("models")), "Returns the scores of the probes against the given list of JFAMachine's, as a 2D array with one row per model.")
+    .def("score", &jfascorer_score, (arg("self"), arg("models")), "Returns the scores of the probes against the given list of JFAMachine's, as a 2D array with one row per model.")
+    .def("score", &jfascorer_score_, (arg("self"), arg("models"), arg("scores")), "Computes the scores of the probes against the given list of JFAMachine's into the given 2D array (one row per model).")
+    .add_property("n_probes", &bob::machine::JFAScorer::getNProbes, "The number of probes")
+    .add_property("x", make_function(&bob::machine::JFAScorer::getX, return_value_policy<copy_const_reference>()), "The estimated channel factors x, one row per probe")
+    .add_property("ux", &jfascorer_getUx, "The estimated channel offsets Ux, one per probe")
+    .add_property("n_threads", &bob::machine::JFAScorer::getNThreads, &bob::machine::JFAScorer::setNThreads, "The number of threads to use (0 for one per core)")
+  ;
+
 }
@@ -119,6 +119,17 @@ static double py_getMinDistance(const bob::machine::KMeansMachine& machine, bob:
   return machine.getMinDistance(input.bz<double,1>());
 }
 
+static object py_getDistancesFromMeans(const bob::machine::KMeansMachine& machine, bob::python::const_ndarray data) 
+{
+  const bob::core::array::typeinfo& info = data.type();
+  if(info.dtype != bob::core::array::t_float64 || info.nd != 2)
+    PYTHON_ERROR(TypeError, "cannot use array of type '%s'", info.str().c_str());
+  bob::python::ndarray distances(bob::core::array::t_float64, info.shape[0], machine.getNMeans());
+  blitz::Array<double,2> distances_ = distances.bz<double,2>();
+  machine.getDistancesFromMeans(data.bz<double,2>(), distances_);
+  return distances.self();
+}
+
 static object py_getCacheMeans(const bob::machine::KMeansMachine& kMeansMachine) {
   size_t n_means = kMeansMachine.getNMeans();
   size_t n_inputs = kMeansMachine.getNInputs();
@@ -156,6 +167,8 @@ void bind_machine_kmeans()
     .def("set_mean", &py_setMean, (arg("i"), arg("mean")), "Set the i'th mean")
     .def("get_distance_from_mean", &py_getDistanceFromMean, (arg("x"), arg("i")),
         "Return the power of two of the Euclidean distance of the sample, x, to the i'th mean")
+    .def("get_distances_from_means", &py_getDistancesFromMeans, (arg("data")),
+        "Return the power of two of the Euclidean distance of each sample (row) of data to each mean, computed for all the pairs at once with a matrix product")
     .def("get_closest_mean", &py_getClosestMean, (arg("x")),
         "Calculate the index of the mean that is closest (in terms of Euclidean distance) to the data sample, x")
     .def("get_min_distance", &py_getMinDistance, (arg("input")),
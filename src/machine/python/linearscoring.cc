@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "bob/core/python/ndarray.h"
+#include "bob/core/python/gil.h"
 
 using namespace boost::python;
 namespace tp = bob::python;
@@ -61,7 +62,7 @@ static void convertGMMMachineList(list models, std::vector<boost::shared_ptr<con
 static blitz::Array<double, 2> linearScoring1(list models,
     tp::const_ndarray ubm_mean, tp::const_ndarray ubm_variance,
     list test_stats, list test_channelOffset = list(), // Empty list
-    bool frame_length_normalisation = false) 
+    bool frame_length_normalisation = false, size_t n_threads = 1) 
 {
   blitz::Array<double,1> ubm_mean_ = ubm_mean.bz<double,1>();
   blitz::Array<double,1> ubm_variance_ = ubm_variance.bz<double,1>();
@@ -72,14 +73,18 @@ static blitz::Array<double, 2> linearScoring1(list models,
   std::vector<boost::shared_ptr<const mach::GMMStats> > test_stats_c;
   convertGMMStatsList(test_stats, test_stats_c);
 
+  std::vector<blitz::Array<double,1> > test_channelOffset_c;
+  convertChannelOffsetList(test_channelOffset, test_channelOffset_c);
+
   blitz::Array<double, 2> ret(len(models), len(test_stats));
-  if (len(test_channelOffset) == 0) { //list is empty
-    mach::linearScoring(models_c, ubm_mean_, ubm_variance_, test_stats_c, frame_length_normalisation, ret);
-  }
-  else { 
-    std::vector<blitz::Array<double,1> > test_channelOffset_c;
-    convertChannelOffsetList(test_channelOffset, test_channelOffset_c);
-    mach::linearScoring(models_c, ubm_mean_, ubm_variance_, test_stats_c, test_channelOffset_c, frame_length_normalisation, ret);
+  {
+    tp::no_gil unlock;
+    if (test_channelOffset_c.empty()) { //list is empty
+      mach::linearScoring(models_c, ubm_mean_, ubm_variance_, test_stats_c, frame_length_normalisation, ret, n_threads);
+    }
+    else { 
+      mach::linearScoring(models_c, ubm_mean_, ubm_variance_, test_stats_c, test_channelOffset_c, frame_length_normalisation, ret, n_threads);
+    }
   }
  
   return ret;
@@ -88,7 +93,7 @@ static blitz::Array<double, 2> linearScoring1(list models,
 static blitz::Array<double, 2> linearScoring2(list models,
     mach::GMMMachine& ubm,
     list test_stats, list test_channelOffset = list(), // Empty list
-    bool frame_length_normalisation = false) 
+    bool frame_length_normalisation = false, size_t n_threads = 1) 
 {
   std::vector<boost::shared_ptr<const mach::GMMMachine> > models_c;
   convertGMMMachineList(models, models_c);
@@ -96,24 +101,106 @@ static blitz::Array<double, 2> linearScoring2(list models,
   std::vector<boost::shared_ptr<const mach::GMMStats> > test_stats_c;
   convertGMMStatsList(test_stats, test_stats_c);
 
+  std::vector<blitz::Array<double,1> > test_channelOffset_c;
+  convertChannelOffsetList(test_channelOffset, test_channelOffset_c);
+
   blitz::Array<double, 2> ret(len(models), len(test_stats));
-  if (len(test_channelOffset) == 0) { //list is empty
-    mach::linearScoring(models_c, ubm, test_stats_c, frame_length_normalisation, ret);
+  {
+    tp::no_gil unlock;
+    if (test_channelOffset_c.empty()) { //list is empty
+      mach::linearScoring(models_c, ubm, test_stats_c, frame_length_normalisation, ret, n_threads);
+    }
+    else { 
+      mach::linearScoring(models_c, ubm, test_stats_c, test_channelOffset_c, frame_length_normalisation, ret, n_threads);
+    }
   }
-  else { 
-    std::vector<blitz::Array<double,1> > test_channelOffset_c;
-    convertChannelOffsetList(test_channelOffset, test_channelOffset_c);
-    mach::linearScoring(models_c, ubm, test_stats_c, test_channelOffset_c, frame_length_normalisation, ret);
+  
+  return ret;
+}
+
+static blitz::Array<double, 2> linearScoring3(tp::const_ndarray models_normalised,
+    tp::const_ndarray ubm_mean,
+    list test_stats, list test_channelOffset = list(), // Empty list
+    bool frame_length_normalisation = false, size_t n_threads = 1) 
+{
+  blitz::Array<double,2> models_normalised_ = models_normalised.bz<double,2>();
+  blitz::Array<double,1> ubm_mean_ = ubm_mean.bz<double,1>();
+
+  std::vector<boost::shared_ptr<const mach::GMMStats> > test_stats_c;
+  convertGMMStatsList(test_stats, test_stats_c);
+
+  std::vector<blitz::Array<double,1> > test_channelOffset_c;
+  convertChannelOffsetList(test_channelOffset, test_channelOffset_c);
+
+  blitz::Array<double, 2> ret(models_normalised_.extent(0), len(test_stats));
+  {
+    tp::no_gil unlock;
+    if (test_channelOffset_c.empty()) { //list is empty
+      mach::linearScoring(models_normalised_, ubm_mean_, test_stats_c, frame_length_normalisation, ret, n_threads);
+    }
+    else { 
+      mach::linearScoring(models_normalised_, ubm_mean_, test_stats_c, test_channelOffset_c, frame_length_normalisation, ret, n_threads);
+    }
   }
   
   return ret;
 }
 
-BOOST_PYTHON_FUNCTION_OVERLOADS(linearScoring1_overloads, linearScoring1, 4, 6)
-BOOST_PYTHON_FUNCTION_OVERLOADS(linearScoring2_overloads, linearScoring2, 3, 5)
+static blitz::Array<double, 2> linearScoringModels1(list models,
+    tp::const_ndarray ubm_mean, tp::const_ndarray ubm_variance,
+    size_t n_threads = 1) 
+{
+  blitz::Array<double,1> ubm_mean_ = ubm_mean.bz<double,1>();
+  blitz::Array<double,1> ubm_variance_ = ubm_variance.bz<double,1>();
+
+  std::vector<blitz::Array<double,1> > models_c;
+  convertGMMMeanList(models, models_c);
+
+  blitz::Array<double, 2> ret(len(models), ubm_mean_.extent(0));
+  {
+    tp::no_gil unlock;
+    mach::linearScoringModels(models_c, ubm_mean_, ubm_variance_, ret, n_threads);
+  }
+
+  return ret;
+}
+
+static blitz::Array<double, 2> linearScoringModels2(list models,
+    mach::GMMMachine& ubm, size_t n_threads = 1) 
+{
+  std::vector<boost::shared_ptr<const mach::GMMMachine> > models_c;
+  convertGMMMachineList(models, models_c);
+
+  blitz::Array<double, 2> ret(len(models), ubm.getNGaussians() * ubm.getNInputs());
+  {
+    tp::no_gil unlock;
+    mach::linearScoringModels(models_c, ubm, ret, n_threads);
+  }
+
+  return ret;
+}
+
+BOOST_PYTHON_FUNCTION_OVERLOADS(linearScoring1_overloads, linearScoring1, 4, 7)
+BOOST_PYTHON_FUNCTION_OVERLOADS(linearScoring2_overloads, linearScoring2, 3, 6)
+BOOST_PYTHON_FUNCTION_OVERLOADS(linearScoring3_overloads, linearScoring3, 3, 6)
+BOOST_PYTHON_FUNCTION_OVERLOADS(linearScoringModels1_overloads, linearScoringModels1, 3, 4)
+BOOST_PYTHON_FUNCTION_OVERLOADS(linearScoringModels2_overloads, linearScoringModels2, 2, 3)
 
 void bind_machine_linear_scoring() {
-  def("linear_scoring", linearScoring1, linearScoring1_overloads(args("models", "ubm_mean", "ubm_variance", "test_stats", "test_channelOffset", "frame_length_normalisation"),
+  // registered first, so that it is tried last: a list of mean supervectors
+  // could otherwise be converted into a 2D array
+  def("linear_scoring", linearScoring3, linearScoring3_overloads(args("models_normalised", "ubm_mean", "test_stats", "test_channel_offset", "frame_length_normalisation", "n_threads"),
+    "Compute a matrix of scores using linear scoring, with models given as the matrix of their normalised offsets (see linear_scoring_models()).\n"
+    "Return a 2D matrix of scores, scores[m, s] is the score for model m against statistics s\n"
+    "\n"
+    "models_normalised -- 2D matrix of the normalised offsets of the models, one model per row\n"
+    "ubm_mean    -- mean supervector for the world model\n"
+    "test_stats  -- list of accumulate statistics for each test trial\n"
+    "test_channel_offset -- \n"
+    "frame_length_normlisation -- perform a normalisation by the number of feature vectors\n"
+    "n_threads   -- number of threads the test statistics are split across (0 for one per core)\n"
+  ));
+  def("linear_scoring", linearScoring1, linearScoring1_overloads(args("models", "ubm_mean", "ubm_variance", "test_stats", "test_channelOffset", "frame_length_normalisation", "n_threads"),
     "Compute a matrix of scores using linear scoring.\n"
     "Return a 2D matrix of scores, scores[m, s] is the score for model m against statistics s\n"
     "\n"
@@ -125,8 +212,9 @@ void bind_machine_linear_scoring() {
     "test_stats   -- list of accumulate statistics for each test trial\n"
     "test_channelOffset -- \n"
     "frame_length_normlisation -- perform a normalisation by the number of feature vectors\n"
+    "n_threads    -- number of threads the test statistics are split across (0 for one per core)\n"
     ));
-  def("linear_scoring", linearScoring2, linearScoring2_overloads(args("models", "ubm", "test_stats", "test_channel_offset", "frame_length_normalisation"),
+  def("linear_scoring", linearScoring2, linearScoring2_overloads(args("models", "ubm", "test_stats", "test_channel_offset", "frame_length_normalisation", "n_threads"),
     "Compute a matrix of scores using linear scoring.\n"
     "Return a 2D matrix of scores, scores[m, s] is the score for model m against statistics s\n"
     "\n"
@@ -137,5 +225,21 @@ void bind_machine_linear_scoring() {
     "test_stats  -- list of accumulate statistics for each test trial\n"
     "test_channel_offset -- \n"
     "frame_length_normlisation -- perform a normalisation by the number of feature vectors\n"
+    "n_threads   -- number of threads the test statistics are split across (0 for one per core)\n"
+  ));
+  def("linear_scoring_models", linearScoringModels1, linearScoringModels1_overloads(args("models", "ubm_mean", "ubm_variance", "n_threads"),
+    "Compute the matrix of the normalised offsets of the models, one model per row: A[m,:] = (models[m] - ubm_mean) / ubm_variance. This matrix can be given to linear_scoring() to score several sets of test statistics against the same models.\n"
+    "\n"
+    "models       -- list of mean supervectors for the client models\n"
+    "ubm_mean     -- mean supervector for the world model\n"
+    "ubm_variance -- variance supervector for the world model\n"
+    "n_threads    -- number of threads the models are split across (0 for one per core)\n"
+  ));
+  def("linear_scoring_models", linearScoringModels2, linearScoringModels2_overloads(args("models", "ubm", "n_threads"),
+    "Compute the matrix of the normalised offsets of the models, one model per row, from GMMMachines. This matrix can be given to linear_scoring() to score several sets of test statistics against the same models.\n"
+    "\n"
+    "models      -- list of client models\n"
+    "ubm         -- world model\n"
+    "n_threads   -- number of threads the models are split across (0 for one per core)\n"
   ));
 }
@@ -26,6 +26,8 @@
 #include "bob/machine/PLDAMachine.h"
 
 using namespace boost::python;
+namespace tp = bob::python;
+namespace ca = bob::core::array;
 
 
 // Set and Get methods that uses blitz::Arrays
@@ -185,6 +187,33 @@ static object plda_getGamma(bob::machine::PLDAMachine& m, const size_t a) {
   return object(res);
 }
 
+static boost::shared_ptr<bob::machine::PLDAScorer> pldascorer_new(list models,
+    const size_t n_threads)
+{
+  std::vector<boost::shared_ptr<const bob::machine::PLDAMachine> > models_c;
+  for (int i=0; i<len(models); ++i)
+    models_c.push_back(extract<boost::shared_ptr<bob::machine::PLDAMachine> >(models[i]));
+  return boost::shared_ptr<bob::machine::PLDAScorer>(
+      new bob::machine::PLDAScorer(models_c, n_threads));
+}
+
+static object pldascorer_score(const bob::machine::PLDAScorer& s,
+    tp::const_ndarray probes)
+{
+  const blitz::Array<double,2> probes_ = probes.bz<double,2>();
+  tp::ndarray ret(ca::t_float64, s.getNModels(), probes_.extent(0));
+  blitz::Array<double,2> ret_ = ret.bz<double,2>();
+  s.score(probes_, ret_);
+  return ret.self();
+}
+
+static void pldascorer_score_(const bob::machine::PLDAScorer& s,
+    tp::const_ndarray probes, tp::ndarray scores)
+{
+  blitz::Array<double,2> scores_ = scores.bz<double,2>();
+  s.score(probes.bz<double,2>(), scores_);
+}
+
 BOOST_PYTHON_FUNCTION_OVERLOADS(computeLogLikelihood1_overloads, computeLogLikelihood1, 2, 3)
 BOOST_PYTHON_FUNCTION_OVERLOADS(computeLogLikelihood2_overloads, computeLogLikelihood2, 2, 3)
 
@@ -259,4 +288,14 @@ void bind_machine_plda()
     .def("__call__", &plda_forward_sample, (arg("self"), arg("sample")), "Processes a sample and returns a score.")
     .def("forward", &plda_forward_sample, (arg("self"), arg("sample")), "Processes a sample and returns a score.")
   ;
+
+  class_<bob::machine::PLDAScorer, boost::shared_ptr<bob::machine::PLDAScorer> >("PLDAScorer", "Scores many probe samples against many enrolled PLDAMachine's at once. Everything that only depends on the models is precomputed at construction time (from the state of the models at that time), and the projections of the probes are shared by all the models. The scores are the same as the ones returned by PLDAMachine.forward(), up to rounding errors.", no_init)
+    .def("__init__", make_constructor(&pldascorer_new, default_call_policies(), (arg("models"), arg("n_threads")=1)), "Precomputes the terms that only depend on the given list of PLDAMachine's, which should all share the same PLDABaseMachine. n_threads is the number of threads to use (0 for one per core).")
+    .def("__call__", &pldascorer_score, (arg("self"), arg("probes")), "Returns the log-likelihood ratios of the probes (one per row) against all the models, as a 2D array with one row per model.")
+    .def("score", &pldascorer_score, (arg("self"), arg("probes")), "Returns the log-likelihood ratios of the probes (one per row) against all the models, as a 2D array with one row per model.")
+    .def("score", &pldascorer_score_, (arg("self"), arg("probes"), arg("scores")), "Computes the log-likelihood ratios of the probes (one per row) against all the models into the given 2D array (one row per model).")
+    .add_property("n_models", &bob::machine::PLDAScorer::getNModels, "The number of models")
+    .add_property("dim_d", &bob::machine::PLDAScorer::getDimD, "Dimensionality of the input feature vectors")
+    .add_property("n_threads", &bob::machine::PLDAScorer::getNThreads, &bob::machine::PLDAScorer::setNThreads, "The number of threads to use (0 for one per core)")
+  ;
 }
@@ -21,6 +21,7 @@
  */
 
 #include "bob/core/python/ndarray.h"
+#include "bob/core/python/gil.h"
 #include "bob/machine/SVM.h"
 
 using namespace boost::python;
@@ -48,12 +49,13 @@ static object predict_class_n(const mach::SupportVector& m,
   if ((size_t)i_.extent(1) != m.inputSize()) {
     PYTHON_ERROR(RuntimeError, "Input array should have " SIZE_T_FMT " columns, but you have given me one with %d instead", m.inputSize(), i_.extent(1));
   }
-  blitz::Range all = blitz::Range::all();
-  list retval;
-  for (int k=0; k<i_.extent(0); ++k) {
-    blitz::Array<double,1> tmp = i_(k,all);
-    retval.append(m.predictClass_(tmp));
+  blitz::Array<int,1> labels(i_.extent(0));
+  {
+    tp::no_gil unlock;
+    m.predictClass_(i_, labels);
   }
+  list retval;
+  for (int k=0; k<labels.extent(0); ++k) retval.append(labels(k));
   return tuple(retval);
 }
 
@@ -95,13 +97,19 @@ static object predict_class_and_scores_n(const mach::SupportVector& m,
   if ((size_t)i_.extent(1) != m.inputSize()) {
     PYTHON_ERROR(RuntimeError, "Input array should have " SIZE_T_FMT " columns, but you have given me one with %d instead", m.inputSize(), i_.extent(1));
   }
+  blitz::Array<int,1> labels(i_.extent(0));
+  blitz::Array<double,2> scores_(i_.extent(0), m.outputSize());
+  {
+    tp::no_gil unlock;
+    m.predictClassAndScores_(i_, labels, scores_);
+  }
   blitz::Range all = blitz::Range::all();
   list classes, scores;
   for (int k=0; k<i_.extent(0); ++k) {
-    blitz::Array<double,1> tmp = i_(k,all);
+    classes.append(labels(k));
     tp::ndarray s(ca::t_float64, m.outputSize());
     blitz::Array<double,1> s_ = s.bz<double,1>();
-    classes.append(m.predictClassAndScores_(tmp, s_));
+    s_ = scores_(k,all);
     scores.append(s.self());
   }
   return make_tuple(tuple(classes), tuple(scores));
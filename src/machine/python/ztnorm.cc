@@ -89,8 +89,61 @@ static object ztnorm2(
   return ret.self();
 }
 
+static boost::shared_ptr<bob::machine::ZTNormalizer> ztnormalizer_from_mask(
+    tp::const_ndarray rawscores_probes_vs_tmodels,
+    tp::const_ndarray rawscores_zprobes_vs_tmodels,
+    tp::const_ndarray mask_zprobes_vs_tmodels_istruetrial,
+    size_t n_threads)
+{
+  return boost::shared_ptr<bob::machine::ZTNormalizer>(
+      new bob::machine::ZTNormalizer(rawscores_probes_vs_tmodels.bz<double,2>(),
+        rawscores_zprobes_vs_tmodels.bz<double,2>(),
+        mask_zprobes_vs_tmodels_istruetrial.bz<bool,2>(), n_threads));
+}
+
+static boost::shared_ptr<bob::machine::ZTNormalizer> ztnormalizer_new(
+    tp::const_ndarray rawscores_probes_vs_tmodels,
+    tp::const_ndarray rawscores_zprobes_vs_tmodels,
+    size_t n_threads)
+{
+  return boost::shared_ptr<bob::machine::ZTNormalizer>(
+      new bob::machine::ZTNormalizer(rawscores_probes_vs_tmodels.bz<double,2>(),
+        rawscores_zprobes_vs_tmodels.bz<double,2>(), n_threads));
+}
+
+static object ztnormalizer_normalize(const bob::machine::ZTNormalizer& z,
+    tp::const_ndarray rawscores_probes_vs_models,
+    tp::const_ndarray rawscores_zprobes_vs_models)
+{
+  const blitz::Array<double,2> A = rawscores_probes_vs_models.bz<double,2>();
+  tp::ndarray ret(ca::t_float64, A.extent(0), A.extent(1));
+  blitz::Array<double, 2> ret_ = ret.bz<double,2>();
+  z.normalize(A, rawscores_zprobes_vs_models.bz<double,2>(), ret_);
+  return ret.self();
+}
+
+static void ztnormalizer_normalize_(const bob::machine::ZTNormalizer& z,
+    tp::const_ndarray rawscores_probes_vs_models,
+    tp::const_ndarray rawscores_zprobes_vs_models,
+    tp::ndarray normalizedscores)
+{
+  blitz::Array<double, 2> scores_ = normalizedscores.bz<double,2>();
+  z.normalize(rawscores_probes_vs_models.bz<double,2>(),
+      rawscores_zprobes_vs_models.bz<double,2>(), scores_);
+}
+
 void bind_machine_ztnorm() 
 {
+  class_<bob::machine::ZTNormalizer, boost::shared_ptr<bob::machine::ZTNormalizer> >("ZTNormalizer", "ZT-Norm of raw scores that can be processed block by block. The T-Norm statistics are computed once, at construction time. normalize() can then be called on consecutive blocks of rows (models) of the raw scores, for instance read from a chunked HDF5 file, so that the whole score matrix never has to be held in memory.", no_init)
+    .def("__init__", make_constructor(&ztnormalizer_from_mask, default_call_policies(), (arg("rawscores_probes_vs_tmodels"), arg("rawscores_zprobes_vs_tmodels"), arg("mask_zprobes_vs_tmodels_istruetrial"), arg("n_threads")=1)), "Computes the T-Norm statistics, only with the impostor scores of the T-Norm models against the Z-Norm probes. n_threads is the number of threads to use (0 for one per core).")
+    .def("__init__", make_constructor(&ztnormalizer_new, default_call_policies(), (arg("rawscores_probes_vs_tmodels"), arg("rawscores_zprobes_vs_tmodels"), arg("n_threads")=1)), "Computes the T-Norm statistics, assuming that znorm and tnorm have no common subject id. n_threads is the number of threads to use (0 for one per core).")
+    .def("normalize", &ztnormalizer_normalize, (arg("self"), arg("rawscores_probes_vs_models"), arg("rawscores_zprobes_vs_models")), "Normalises a block of rows of the raw scores, with the corresponding rows of the Z-Norm scores, and returns the normalised scores.")
+    .def("normalize", &ztnormalizer_normalize_, (arg("self"), arg("rawscores_probes_vs_models"), arg("rawscores_zprobes_vs_models"), arg("normalizedscores")), "Normalises a block of rows of the raw scores, with the corresponding rows of the Z-Norm scores, into the given array. The output array may be the array of raw scores itself, for an in-place normalisation.")
+    .add_property("tnorm_mean", make_function(&bob::machine::ZTNormalizer::getTNormMean, return_value_policy<copy_const_reference>()), "The mean of the Z-normalised scores of the T-Norm models, for each probe")
+    .add_property("tnorm_std", make_function(&bob::machine::ZTNormalizer::getTNormStd, return_value_policy<copy_const_reference>()), "The standard deviation of the Z-normalised scores of the T-Norm models, for each probe")
+    .add_property("n_threads", &bob::machine::ZTNormalizer::getNThreads, &bob::machine::ZTNormalizer::setNThreads, "The number of threads to use (0 for one per core)")
+    ;
+
   def("ztnorm",
       ztnorm1,
       args("rawscores_probes_vs_models",
@@ -0,0 +1,101 @@
+/**
+ * @file math/cxx/gemm.cc
+ * @date Fri 16 Oct 2026 14:02:11 CEST
+ * @author agent <agent@local>
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bob/math/gemm.h"
+#include "bob/core/array_assert.h"
+#include "bob/core/array_check.h"
+#include "bob/core/array_copy.h"
+
+namespace math = bob::math;
+namespace ca = bob::core::array;
+
+// Declaration of the external BLAS function
+// General matrix-matrix product (dgemm)
+extern "C" void dgemm_( const char *transa, const char *transb, const int *M,
+  const int *N, const int *K, const double *alpha, const double *A,
+  const int *lda, const double *B, const int *ldb, const double *beta,
+  double *C, const int *ldc);
+
+void math::gemm(const blitz::Array<double,2>& A, 
+  const blitz::Array<double,2>& B, blitz::Array<double,2>& C,
+  const bool transA, const bool transB, const double alpha, const double beta)
+{
+  ca::assertZeroBase(A);
+  ca::assertZeroBase(B);
+  ca::assertZeroBase(C);
+
+  const int M = transA ? A.extent(1) : A.extent(0);
+  const int K = transA ? A.extent(0) : A.extent(1);
+  const int K2 = transB ? B.extent(1) : B.extent(0);
+  const int N = transB ? B.extent(0) : B.extent(1);
+  ca::assertSameDimensionLength(K, K2);
+  ca::assertSameDimensionLength(C.extent(0), M);
+  ca::assertSameDimensionLength(C.extent(1), N);
+
+  math::gemm_(A, B, C, transA, transB, alpha, beta);
+}
+
+void math::gemm_(const blitz::Array<double,2>& A, 
+  const blitz::Array<double,2>& B, blitz::Array<double,2>& C,
+  const bool transA, const bool transB, const double alpha, const double beta)
+{
+  const int M = C.extent(0);
+  const int N = C.extent(1);
+  const int K = transA ? A.extent(0) : A.extent(1);
+  if (M == 0 || N == 0) return;
+  if (K == 0) {
+    C *= beta;
+    return;
+  }
+
+  // BLAS works on column-major matrices: a C-contiguous row-major matrix is
+  // seen as its transpose. C' = op(B)' * op(A)' is hence computed, which
+  // does not require any copy if the operands are C-contiguous. Such
+  // operands are used through their data pointer only, without creating
+  // blitz references, so that their (non thread-safe) reference counts are
+  // not touched, and that shared operands can be used by several threads.
+  blitz::Array<double,2> A_copy, B_copy, C_copy;
+  const double* a = A.data();
+  if (!ca::isCZeroBaseContiguous(A)) {
+    A_copy.reference(ca::ccopy(A));
+    a = A_copy.data();
+  }
+  const double* b = B.data();
+  if (!ca::isCZeroBaseContiguous(B)) {
+    B_copy.reference(ca::ccopy(B));
+    b = B_copy.data();
+  }
+  const bool C_direct_use = ca::isCZeroBaseContiguous(C);
+  double* c = C.data();
+  if (!C_direct_use) {
+    C_copy.resize(M, N);
+    if (beta != 0.) C_copy = C;
+    c = C_copy.data();
+  }
+
+  const char ta = transA ? 'T' : 'N';
+  const char tb = transB ? 'T' : 'N';
+  const int lda = A.extent(1);
+  const int ldb = B.extent(1);
+  const int ldc = N;
+  dgemm_(&tb, &ta, &N, &M, &K, &alpha, b, &ldb, a, &lda, &beta, c, &ldc);
+
+  if (!C_direct_use) C = C_copy;
+}
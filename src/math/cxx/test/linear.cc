@@ -25,6 +25,7 @@
 #define BOOST_TEST_MAIN
 #include <boost/test/unit_test.hpp>
 #include "bob/math/linear.h"
+#include "bob/math/gemm.h"
 
 
 struct T {
@@ -106,6 +107,29 @@ BOOST_AUTO_TEST_CASE( test_matrix_matrix_prod )
   checkBlitzClose( A_23, sol, eps);
 }
 
+BOOST_AUTO_TEST_CASE( test_matrix_matrix_gemm )
+{
+  blitz::Array<double,2> sol(2,3);
+  bob::math::gemm( A_24, A_43, sol);
+  checkBlitzClose( A_23, sol, eps);
+
+  // Transposed operands
+  blitz::Array<double,2> A_42(4,2), A_34(3,4);
+  A_42 = A_24.transpose(1,0);
+  A_34 = A_43.transpose(1,0);
+  sol = 0.;
+  bob::math::gemm( A_42, A_34, sol, true, true);
+  checkBlitzClose( A_23, sol, eps);
+
+  // Non-contiguous operands and output, scaling factors
+  blitz::Array<double,2> sol_t(3,2);
+  blitz::Array<double,2> sol_nc = sol_t.transpose(1,0);
+  sol_nc = A_23;
+  bob::math::gemm( A_42.transpose(1,0), A_34.transpose(1,0), sol_nc, false, 
+    false, 2., -1.);
+  checkBlitzClose( A_23, sol_nc, eps);
+}
+
 BOOST_AUTO_TEST_CASE( test_matrix_vector_prod )
 {
   blitz::Array<double,1> sol(2);
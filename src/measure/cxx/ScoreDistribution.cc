@@ -0,0 +1,551 @@
+/**
+ * @file measure/cxx/ScoreDistribution.cc
+ * @date Fri 16 Oct 2026 17:02:14 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Implements the sorted/binned score distributions
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <boost/format.hpp>
+#include "bob/measure/ScoreDistribution.h"
+#include "bob/measure/error.h"
+#include "bob/core/Exception.h"
+#include "bob/math/pavx.h"
+
+namespace err = bob::measure;
+
+/**
+ * Maps a double onto an unsigned integer with the same ordering: positive
+ * numbers get their sign bit set, negative ones are bit-inverted.
+ */
+static inline uint64_t radix_key(const double v) {
+  uint64_t u;
+  std::memcpy(&u, &v, sizeof(u));
+  return (u & 0x8000000000000000ULL) ? ~u : (u | 0x8000000000000000ULL);
+}
+
+static inline double radix_value(uint64_t u) {
+  u = (u & 0x8000000000000000ULL) ? (u & ~0x8000000000000000ULL) : ~u;
+  double v;
+  std::memcpy(&v, &u, sizeof(v));
+  return v;
+}
+
+/**
+ * Sorts scores ascendingly. Large sets go through a least-significant-digit
+ * radix sort on 16-bit digits, skipping the digits all scores share (e.g.
+ * the exponent bits of scores in a narrow range).
+ */
+static void sort_scores(std::vector<double>& v) {
+  static const size_t RADIX_MIN_SIZE = 1 << 16;
+  if (v.size() < RADIX_MIN_SIZE) {
+    std::sort(v.begin(), v.end());
+    return;
+  }
+
+  const size_t n = v.size();
+  std::vector<uint64_t> keys(n), tmp(n);
+  std::vector<size_t> counts(4 << 16, 0);
+  for (size_t i=0; i<n; ++i) {
+    const uint64_t k = radix_key(v[i]);
+    keys[i] = k;
+    for (int d=0; d<4; ++d) ++counts[(d << 16) + ((k >> (16*d)) & 0xffff)];
+  }
+
+  for (int d=0; d<4; ++d) {
+    size_t* c = &counts[d << 16];
+    // all keys in the same bucket: this digit does not change the order
+    if (c[(keys[0] >> (16*d)) & 0xffff] == n) continue;
+    size_t offset = 0;
+    for (size_t b=0; b<(1<<16); ++b) {
+      const size_t cb = c[b];
+      c[b] = offset;
+      offset += cb;
+    }
+    for (size_t i=0; i<n; ++i)
+      tmp[c[(keys[i] >> (16*d)) & 0xffff]++] = keys[i];
+    keys.swap(tmp);
+  }
+
+  for (size_t i=0; i<n; ++i) v[i] = radix_value(keys[i]);
+}
+
+/**
+ * Sorts a new chunk of scores and merges it with the sorted ones
+ */
+static void merge_scores(std::vector<double>& sorted,
+    const blitz::Array<double,1>& chunk) {
+  std::vector<double> chunk_(chunk.extent(0));
+  std::copy(chunk.begin(), chunk.end(), chunk_.begin());
+  sort_scores(chunk_);
+  if (sorted.empty()) {
+    sorted.swap(chunk_);
+    return;
+  }
+  const size_t middle = sorted.size();
+  sorted.insert(sorted.end(), chunk_.begin(), chunk_.end());
+  std::inplace_merge(sorted.begin(), sorted.begin() + middle, sorted.end());
+}
+
+err::ScoreDistribution::ScoreDistribution():
+  m_n_negatives(0), m_n_positives(0),
+  m_score_min(std::numeric_limits<double>::max()),
+  m_score_max(-std::numeric_limits<double>::max()),
+  m_n_bins(0), m_min(0.), m_max(0.)
+{
+}
+
+err::ScoreDistribution::ScoreDistribution(
+    const blitz::Array<double,1>& negatives,
+    const blitz::Array<double,1>& positives):
+  m_n_negatives(0), m_n_positives(0),
+  m_score_min(std::numeric_limits<double>::max()),
+  m_score_max(-std::numeric_limits<double>::max()),
+  m_n_bins(0), m_min(0.), m_max(0.)
+{
+  add(negatives, positives);
+}
+
+err::ScoreDistribution::ScoreDistribution(const size_t n_bins,
+    const double min, const double max):
+  m_n_negatives(0), m_n_positives(0),
+  m_score_min(std::numeric_limits<double>::max()),
+  m_score_max(-std::numeric_limits<double>::max()),
+  m_n_bins(n_bins), m_min(min), m_max(max),
+  m_negatives_cum(n_bins+1, 0), m_positives_cum(n_bins+1, 0)
+{
+  if (n_bins == 0)
+    throw bob::core::InvalidArgumentException("The number of bins must be positive!");
+  if (!(min < max)) {
+    boost::format m("The range of the histogram [%f, %f) is empty");
+    m % min % max;
+    throw bob::core::InvalidArgumentException(m.str());
+  }
+}
+
+/**
+ * Index of the bin a score falls in, out-of-range scores falling in the
+ * first or in the last bin
+ */
+static inline size_t score_bin(const double s, const double min,
+    const double width, const size_t n_bins) {
+  if (!(s > min)) return 0;
+  const size_t b = static_cast<size_t>((s - min) / width);
+  return std::min(b, n_bins-1);
+}
+
+static void add_to_histogram(std::vector<uint64_t>& cum,
+    const blitz::Array<double,1>& chunk, const double min, const double width,
+    double& score_min, double& score_max) {
+  const size_t n_bins = cum.size() - 1;
+  std::vector<uint64_t> hist(n_bins, 0);
+  for (int i=0; i<chunk.extent(0); ++i) {
+    const double s = chunk(i);
+    ++hist[score_bin(s, min, width, n_bins)];
+    score_min = std::min(score_min, s);
+    score_max = std::max(score_max, s);
+  }
+  uint64_t running = 0;
+  for (size_t b=0; b<n_bins; ++b) {
+    running += hist[b];
+    cum[b+1] += running;
+  }
+}
+
+void err::ScoreDistribution::add(const blitz::Array<double,1>& negatives,
+    const blitz::Array<double,1>& positives) {
+  if (isHistogram()) {
+    const double width = (m_max - m_min) / m_n_bins;
+    add_to_histogram(m_negatives_cum, negatives, m_min, width, m_score_min,
+      m_score_max);
+    add_to_histogram(m_positives_cum, positives, m_min, width, m_score_min,
+      m_score_max);
+  }
+  else {
+    merge_scores(m_negatives, negatives);
+    merge_scores(m_positives, positives);
+    if (!m_negatives.empty()) {
+      m_score_min = std::min(m_score_min, m_negatives.front());
+      m_score_max = std::max(m_score_max, m_negatives.back());
+    }
+    if (!m_positives.empty()) {
+      m_score_min = std::min(m_score_min, m_positives.front());
+      m_score_max = std::max(m_score_max, m_positives.back());
+    }
+  }
+  m_n_negatives += negatives.extent(0);
+  m_n_positives += positives.extent(0);
+}
+
+void err::ScoreDistribution::assertExact(const char* method) const {
+  if (isHistogram()) {
+    boost::format m("ScoreDistribution::%s() is not available in histogram mode");
+    m % method;
+    throw bob::core::NotImplementedError(m.str());
+  }
+}
+
+/**
+ * The index of the bin edge a threshold is rounded down to
+ */
+size_t err::ScoreDistribution::bin(const double threshold) const {
+  if (!(threshold > m_min)) return 0;
+  if (threshold >= m_max) return m_n_bins;
+  // same arithmetic as score_bin(), so that scores on an edge are counted
+  // consistently
+  const double width = (m_max - m_min) / m_n_bins;
+  const size_t e = static_cast<size_t>((threshold - m_min) / width);
+  return std::min(e, m_n_bins);
+}
+
+size_t err::ScoreDistribution::negativesBelow(const double threshold) const {
+  if (isHistogram()) return m_negatives_cum[bin(threshold)];
+  return std::lower_bound(m_negatives.begin(), m_negatives.end(), threshold)
+    - m_negatives.begin();
+}
+
+size_t err::ScoreDistribution::positivesBelow(const double threshold) const {
+  if (isHistogram()) return m_positives_cum[bin(threshold)];
+  return std::lower_bound(m_positives.begin(), m_positives.end(), threshold)
+    - m_positives.begin();
+}
+
+/**
+ * FAR and FRR from the number of scores below a threshold, computed as in
+ * bob::measure::farfrr()
+ */
+static inline std::pair<double, double> ratios(const size_t n_negatives,
+    const size_t n_positives, const size_t negatives_below,
+    const size_t positives_below) {
+  const size_t total_negatives = (n_negatives ? n_negatives : 1);
+  const size_t total_positives = (n_positives ? n_positives : 1);
+  return std::make_pair((n_negatives - negatives_below)/(double)total_negatives,
+      positives_below/(double)total_positives);
+}
+
+std::pair<double, double> err::ScoreDistribution::farfrr(
+    const double threshold) const {
+  return ratios(m_n_negatives, m_n_positives, negativesBelow(threshold),
+    positivesBelow(threshold));
+}
+
+static double eer_predicate(double far, double frr) {
+  return std::abs(far - frr);
+}
+
+double err::ScoreDistribution::eerThreshold() const {
+  return minimizingThreshold(eer_predicate);
+}
+
+/**
+ * Provides a functor predicate for weighted error calculation
+ */
+class weighted_error {
+
+  double m_weight; ///< The weighting factor
+
+  public: //api
+
+  weighted_error(double weight): m_weight(weight) {
+    if (weight > 1.0) m_weight = 1.0;
+    if (weight < 0.0) m_weight = 0.0;
+  }
+
+  inline double operator() (double far, double frr) const {
+    return (m_weight*far) + ((1.0-m_weight)*frr);
+  }
+
+};
+
+double err::ScoreDistribution::minWeightedErrorRateThreshold(
+    const double cost) const {
+  weighted_error predicate(cost);
+  return minimizingThreshold(predicate);
+}
+
+double err::ScoreDistribution::farThreshold(const double far_value) const {
+  // check the parameters are valid
+  if (far_value < 0. || far_value > 1.){
+    throw bob::core::InvalidArgumentException("far_value", far_value, 0., 1.);
+  }
+  if (m_n_negatives < 2){
+    throw bob::core::InvalidArgumentException("The number of negatives must at least be two!");
+  }
+
+  if (isHistogram()) {
+    // the FAR decreases with the bin edge: finds the first one below far_value
+    const double max_accepts = far_value * m_n_negatives;
+    size_t lo = 0, hi = m_n_bins;
+    while (lo < hi) {
+      const size_t mid = (lo + hi) / 2;
+      if (m_n_negatives - m_negatives_cum[mid] <= max_accepts) hi = mid;
+      else lo = mid + 1;
+    }
+    return m_min + lo * (m_max - m_min) / m_n_bins;
+  }
+
+  const std::vector<double>& negatives_ = m_negatives;
+
+  // compute position of the threshold
+  double crr = 1.-far_value; // (Correct Rejection Rate; = 1 - FAR)
+  double crr_index = crr * negatives_.size();
+  // compute the index above the current CRR value
+  int index = std::min((int)std::floor(crr_index), (int)negatives_.size()-1);
+
+  // correct index if we have multiple score values at the requested position
+  while (index && negatives_[index] == negatives_[index-1]) --index;
+
+  // we compute a correction term
+  double correction;
+  if (index){
+    // assure that we are in the middle of two cases
+    correction = 0.5 * (negatives_[index] - negatives_[index-1]);
+  } else {
+    // add an overall correction term
+    correction = 0.5 * (negatives_.back() - negatives_.front()) / negatives_.size();
+  }
+
+  return negatives_[index] - correction;
+}
+
+double err::ScoreDistribution::frrThreshold(const double frr_value) const {
+  // check the parameters are valid
+  if (frr_value < 0. || frr_value > 1.){
+    throw bob::core::InvalidArgumentException("frr_value", frr_value, 0., 1.);
+  }
+  if (m_n_positives < 2){
+    throw bob::core::InvalidArgumentException("The number of positives must at least be two!");
+  }
+
+  if (isHistogram()) {
+    // the FRR increases with the bin edge: finds the last one below frr_value
+    const double max_rejects = frr_value * m_n_positives;
+    size_t lo = 0, hi = m_n_bins;
+    while (lo < hi) {
+      const size_t mid = (lo + hi + 1) / 2;
+      if (m_positives_cum[mid] <= max_rejects) lo = mid;
+      else hi = mid - 1;
+    }
+    return m_min + lo * (m_max - m_min) / m_n_bins;
+  }
+
+  // positive scores, descendingly
+  const std::vector<double>::const_reverse_iterator positives_ =
+    m_positives.rbegin();
+  const int n_positives = m_positives.size();
+
+  // compute position of the threshold
+  double car = 1.-frr_value; // (Correct Acceptance Rate; = 1 - FRR)
+  double car_index = car * n_positives;
+  // compute the index above the current CRR value
+  int index = std::min((int)std::floor(car_index), n_positives-1);
+
+  // correct index if we have multiple score values at the requested position
+  while (index && positives_[index] == positives_[index-1]) --index;
+
+  // we compute a correction term
+  double correction;
+  if (index){
+    // assure that we are in the middle of two cases
+    correction = 0.5 * (positives_[index-1] - positives_[index]);
+  } else {
+    // add an overall correction term
+    correction = 0.5 * (m_positives.back() - m_positives.front()) / n_positives;
+  }
+
+  return positives_[index] + correction;
+}
+
+blitz::Array<double,2> err::ScoreDistribution::roc(const size_t points) const {
+  double min = m_score_min;
+  double max = m_score_max;
+  double step = (max-min)/((double)points-1.0);
+  blitz::Array<double,2> retval(2, points);
+
+  // the thresholds increase: each search starts from the previous position
+  std::vector<double>::const_iterator neg_it = m_negatives.begin();
+  std::vector<double>::const_iterator pos_it = m_positives.begin();
+  double previous = -std::numeric_limits<double>::infinity();
+  for (int i=0; i<(int)points; ++i) {
+    const double threshold = min + i*step;
+    std::pair<double, double> ratios_;
+    if (isHistogram()) ratios_ = farfrr(threshold);
+    else {
+      if (!(threshold >= previous)) {
+        neg_it = m_negatives.begin();
+        pos_it = m_positives.begin();
+      }
+      neg_it = std::lower_bound(neg_it, m_negatives.end(), threshold);
+      pos_it = std::lower_bound(pos_it, m_positives.end(), threshold);
+      ratios_ = ratios(m_n_negatives, m_n_positives,
+        neg_it - m_negatives.begin(), pos_it - m_positives.begin());
+      previous = threshold;
+    }
+    //note: inversion to preserve X x Y ordering (FRR x FAR)
+    retval(0,i) = ratios_.second;
+    retval(1,i) = ratios_.first;
+  }
+  return retval;
+}
+
+blitz::Array<double,2> err::ScoreDistribution::det(const size_t points) const {
+  blitz::Array<double,2> retval = roc(points);
+  for (int i=0; i<retval.extent(0); ++i)
+    for (int j=0; j<retval.extent(1); ++j)
+      retval(i,j) = err::ppndf(retval(i,j));
+  return retval;
+}
+
+blitz::Array<double,2> err::ScoreDistribution::roc_for_far(
+    const blitz::Array<double,1>& far_list) const {
+  assertExact("roc_for_far");
+  int n_points = far_list.extent(0);
+  const std::vector<double>& negatives_ = m_negatives;
+  const std::vector<double>& positives_ = m_positives;
+
+  // do some magic to compute the FRR list
+  blitz::Array<double,2> retval(2, n_points);
+
+  // index into the FAR and FRR list
+  int far_index = n_points-1;
+  int pos_index = 0, neg_index = 0;
+  int n_pos = positives_.size(), n_neg = negatives_.size();
+
+  // iterators into the result lists
+  std::vector<double>::const_iterator pos_it = positives_.begin(), neg_it = negatives_.begin();
+  // do some fast magic to compute the FRR values ;-)
+  do{
+    // check whether the current positive value is less than the current negative one
+    if (*pos_it <= *neg_it){
+      // increase the positive count
+      ++pos_index;
+      // go to the next positive value
+      ++pos_it;
+    }else{
+      // increase the negative count
+      ++neg_index;
+      // go to the next negative value
+      ++neg_it;
+    }
+    // check, if we have reached a new FAR limit,
+    // i.e. if the relative number of negative similarities is greater than 1-FAR (which is the CRR)
+    if ((double)neg_index / (double)n_neg > 1. - far_list(far_index)){
+      // copy the far value
+      retval(0,far_index) = far_list(far_index);
+      // calculate the CAR (i.e., 1.-frr) for the current FAR
+      retval(1,far_index) = 1. - (double)pos_index / (double)n_pos;
+      // go to the next FAR value
+      --far_index;
+    }
+
+  // do this, as long as there are elements in both lists left and not all FRR elements where calculated yet
+  } while (pos_it != positives_.end() && neg_it != negatives_.end() && far_index >= 0);
+
+  // check if all CAR values have been set
+  if (far_index >= 0){
+    // walk to the end of both lists; at least one of both lists should already have reached its limit.
+    pos_index += positives_.end() - pos_it;
+    neg_index += negatives_.end() - neg_it;
+    // fill in the remaining elements of the CAR list
+    do {
+      // copy the FAR value
+      retval(0,far_index) = far_list(far_index);
+      // check if the criterion is fulfilled (should be, as long as the lowest far is not below 0)
+      if ((double)neg_index / (double)n_neg > 1. - far_list(far_index)){
+        // calculate the CAR (i.e., 1.-FRR) for the current FAR
+        retval(1,far_index) = 1. - (double)pos_index / (double)n_pos;
+      } else {
+        // set CAR to zero (this should never happen, but might be due to numerical issues)
+        retval(1,far_index) = 0.;
+      }
+    } while (far_index--);
+  }
+
+  return retval;
+}
+
+blitz::Array<double,2> err::ScoreDistribution::rocch() const {
+  assertExact("rocch");
+  // Number of positive and negative scores
+  const size_t Nt = m_n_positives;
+  const size_t Nn = m_n_negatives;
+  const size_t N = Nt + Nn;
+
+  // Labels of all scores, sorted ascendingly. Scores that are the same
+  // should not be swapped: positives come first, as they would after a
+  // stable sort of the positives followed by the negatives.
+  blitz::Array<double,1> Pideal(N);
+  size_t p = 0, n = 0;
+  for (size_t i=0; i<N; ++i) {
+    if (p < Nt && (n == Nn || m_positives[p] <= m_negatives[n])) {
+      Pideal(i) = 1.;
+      ++p;
+    }
+    else {
+      Pideal(i) = 0.;
+      ++n;
+    }
+  }
+
+  // Apply the PAVA algorithm
+  blitz::Array<double,1> Popt(N);
+  blitz::Array<size_t,1> width = bob::math::pavxWidth(Pideal, Popt);
+
+  // Allocate output
+  int nbins = width.extent(0);
+  blitz::Array<double,2> retval(2,nbins+1); // FAR, FRR
+
+  // Fill in output: the number of positives among the first 'left' scores
+  // is accumulated along the bins
+  size_t left = 0;
+  size_t fa = Nn;
+  size_t miss = 0;
+  for(int i=0; i<nbins; ++i)
+  {
+    retval(0,i) = miss / (double)Nt; // pmiss
+    retval(1,i) = fa / (double)Nn; // pfa
+    for (size_t k=left; k<left+width(i); ++k)
+      if (Pideal((int)k) != 0.) ++miss;
+    left += width(i);
+    fa = N - left - (Nt - miss);
+  }
+  retval(0,nbins) = miss / (double)Nt; // pmiss
+  retval(1,nbins) = fa / (double)Nn; // pfa
+
+  return retval;
+}
+
+double err::ScoreDistribution::eerRocch() const {
+  return err::rocch2eer(rocch());
+}
+
+blitz::Array<double,2> err::epc(const err::ScoreDistribution& dev,
+    const err::ScoreDistribution& test, const size_t points) {
+  double step = 1.0/((double)points-1.0);
+  blitz::Array<double,2> retval(2, points);
+  for (int i=0; i<(int)points; ++i) {
+    double alpha = (double)i*step;
+    retval(0,i) = alpha;
+    double threshold = dev.minWeightedErrorRateThreshold(alpha);
+    std::pair<double, double> ratios_ = test.farfrr(threshold);
+    retval(1,i) = (ratios_.first + ratios_.second) / 2;
+  }
+  return retval;
+}
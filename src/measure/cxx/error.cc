@@ -27,8 +27,6 @@
 #include "bob/core/blitz_compat.h"
 #include "bob/core/Exception.h"
 #include "bob/core/array_assert.h"
-#include "bob/core/cast.h"
-#include "bob/math/pavx.h"
 #include "bob/math/linsolve.h"
 
 namespace err = bob::measure;
@@ -45,232 +43,41 @@ std::pair<double, double> err::farfrr(const blitz::Array<double,1>& negatives,
       false_rejects/(double)total_positives);
 }
 
-double eer_predicate(double far, double frr) {
-  return std::abs(far - frr);
-}
-
 double err::eerThreshold(const blitz::Array<double,1>& negatives,
     const blitz::Array<double,1>& positives) {
-  return err::minimizingThreshold(negatives, positives, eer_predicate);
+  return err::ScoreDistribution(negatives, positives).eerThreshold();
 }
 
 double err::eerRocch(const blitz::Array<double,1>& negatives,
     const blitz::Array<double,1>& positives) {
-  return err::rocch2eer(err::rocch(negatives, positives));
+  return err::ScoreDistribution(negatives, positives).eerRocch();
 }
 
 double err::farThreshold(const blitz::Array<double,1>& negatives,
   const blitz::Array<double,1>&, double far_value) {
-  // check the parameters are valid
-  if (far_value < 0. || far_value > 1.){
-    std::ostringstream s;
-    throw bob::core::InvalidArgumentException("far_value", far_value, 0., 1.);
-  }
-  if (negatives.size() < 2){
-    throw bob::core::InvalidArgumentException("The number of negatives must at least be two!");
-  }
-
-  // sort negative scores ascendingly
-  std::vector<double> negatives_(negatives.shape()[0]);
-  std::copy(negatives.begin(), negatives.end(), negatives_.begin());
-  std::sort(negatives_.begin(), negatives_.end(), std::less<double>());
-
-  // compute position of the threshold
-  double crr = 1.-far_value; // (Correct Rejection Rate; = 1 - FAR)
-  double crr_index = crr * negatives_.size();
-  // compute the index above the current CRR value
-  int index = std::min((int)std::floor(crr_index), (int)negatives_.size()-1);
-
-  // correct index if we have multiple score values at the requested position
-  while (index && negatives_[index] == negatives_[index-1]) --index;
-
-  // we compute a correction term
-  double correction;
-  if (index){
-    // assure that we are in the middle of two cases
-    correction = 0.5 * (negatives_[index] - negatives_[index-1]);
-  } else {
-    // add an overall correction term
-    correction = 0.5 * (negatives_.back() - negatives_.front()) / negatives_.size();
-  }
-
-  return negatives_[index] - correction;
+  return err::ScoreDistribution(negatives, blitz::Array<double,1>()).farThreshold(far_value);
 }
 
 double err::frrThreshold(const blitz::Array<double,1>&,
   const blitz::Array<double,1>& positives, double frr_value) {
-
-  // check the parameters are valid
-  if (frr_value < 0. || frr_value > 1.){
-    std::ostringstream s;
-    throw bob::core::InvalidArgumentException("frr_value", frr_value, 0., 1.);
-  }
-  if (positives.size() < 2){
-    throw bob::core::InvalidArgumentException("The number of positives must at least be two!");
-  }
-
-  // sort positive scores descendingly
-  std::vector<double> positives_(positives.shape()[0]);
-  std::copy(positives.begin(), positives.end(), positives_.begin());
-  std::sort(positives_.begin(), positives_.end(), std::greater<double>());
-
-  // compute position of the threshold
-  double car = 1.-frr_value; // (Correct Acceptance Rate; = 1 - FRR)
-  double car_index = car * positives_.size();
-  // compute the index above the current CRR value
-  int index = std::min((int)std::floor(car_index), (int)positives_.size()-1);
-
-  // correct index if we have multiple score values at the requested position
-  while (index && positives_[index] == positives_[index-1]) --index;
-
-  // we compute a correction term to assure that we are in the middle of two cases
-  // we compute a correction term
-  double correction;
-  if (index){
-    // assure that we are in the middle of two cases
-    correction = 0.5 * (positives_[index-1] - positives_[index]);
-  } else {
-    // add an overall correction term
-    correction = 0.5 * (positives_.front() - positives_.back()) / positives_.size();
-  }
-
-  return positives_[index] + correction;
+  return err::ScoreDistribution(blitz::Array<double,1>(), positives).frrThreshold(frr_value);
 }
 
-/**
- * Provides a functor predicate for weighted error calculation
- */
-class weighted_error {
-
-  double m_weight; ///< The weighting factor
-
-  public: //api
-
-  weighted_error(double weight): m_weight(weight) {
-    if (weight > 1.0) m_weight = 1.0;
-    if (weight < 0.0) m_weight = 0.0;
-  }
-
-  inline double operator() (double far, double frr) const {
-    return (m_weight*far) + ((1.0-m_weight)*frr);
-  }
-
-};
-
 double err::minWeightedErrorRateThreshold
 (const blitz::Array<double,1>& negatives,
  const blitz::Array<double,1>& positives, double cost) {
-  weighted_error predicate(cost);
-  return err::minimizingThreshold(negatives, positives, predicate);
+  return err::ScoreDistribution(negatives, positives).minWeightedErrorRateThreshold(cost);
 }
 
 blitz::Array<double,2> err::roc(const blitz::Array<double,1>& negatives,
  const blitz::Array<double,1>& positives, size_t points) {
-  double min = std::min(blitz::min(negatives), blitz::min(positives));
-  double max = std::max(blitz::max(negatives), blitz::max(positives));
-  double step = (max-min)/((double)points-1.0);
-  blitz::Array<double,2> retval(2, points);
-  for (int i=0; i<(int)points; ++i) {
-    std::pair<double, double> ratios =
-      err::farfrr(negatives, positives, min + i*step);
-    //note: inversion to preserve X x Y ordering (FRR x FAR)
-    retval(0,i) = ratios.second;
-    retval(1,i) = ratios.first;
-  }
-  return retval;
-}
-
-/**
-  * Structure for getting permutations when sorting an array
-  */
-struct ComparePairs 
-{
-  ComparePairs(const blitz::Array<double,1> &v): 
-    m_v(v) 
-  {
-  }
-
-  bool operator()(size_t a, size_t b)
-  { 
-    return m_v(a) < m_v(b); 
-  }
-
-  blitz::Array<double,1> m_v;
-};
-
-ComparePairs CreateComparePairs(const blitz::Array<double,1>& v) 
-{ 
-  return ComparePairs(v); 
-}
-
-/**
-  * Sort an array and get the permutations (using stable_sort)
-  */
-void sortWithPermutation(const blitz::Array<double,1>& values, std::vector<size_t>& v)
-{
-  int N = values.extent(0);
-  bob::core::array::assertSameDimensionLength(N, v.size());
-  for(int i=0; i<N; ++i)
-    v[i] = i;
-
-  std::stable_sort(v.begin(), v.end(), CreateComparePairs(values));
+  return err::ScoreDistribution(negatives, positives).roc(points);
 }
 
 blitz::Array<double,2> err::rocch(const blitz::Array<double,1>& negatives,
  const blitz::Array<double,1>& positives) 
 {
-  // Number of positive and negative scores
-  size_t Nt = positives.extent(0);
-  size_t Nn = negatives.extent(0);
-  size_t N = Nt + Nn;
-
-  // Create a big array with all scores
-  blitz::Array<double,1> scores(N);
-  blitz::Range rall = blitz::Range::all();
-  scores(blitz::Range(0,Nt-1)) = positives(rall);
-  scores(blitz::Range(Nt,N-1)) = negatives(rall);
-
-  // It is important here that scores that are the same (i.e. already in order) should NOT be swapped.
-  // std::stable_sort has this property.
-  std::vector<size_t> perturb(N);
-  sortWithPermutation(scores, perturb);
-
-  // Apply permutation
-  blitz::Array<size_t,1> Pideal(N);
-  for(size_t i=0; i<N; ++i)
-    Pideal(i) = (perturb[i] < Nt ? 1 : 0);
-  blitz::Array<double,1> Pideal_d = bob::core::cast<double>(Pideal);
-
-  // Apply the PAVA algorithm
-  blitz::Array<double,1> Popt(N);
-  blitz::Array<size_t,1> width = bob::math::pavxWidth(Pideal_d, Popt);
-
-  // Allocate output
-  int nbins = width.extent(0);
-  blitz::Array<double,2> retval(2,nbins+1); // FAR, FRR
-
-  // Fill in output
-  size_t left = 0;
-  size_t fa = Nn;
-  size_t miss = 0;
-  for(int i=0; i<nbins; ++i)
-  {
-    retval(0,i) = miss / (double)Nt; // pmiss
-    retval(1,i) = fa / (double)Nn; // pfa
-    left += width(i);
-    if(left >= 1)
-      miss = blitz::sum(Pideal(blitz::Range(0,left-1)));
-    else
-      miss = 0;
-    if(Pideal.extent(0)-1 >= (int)left)
-      fa = N - left - blitz::sum(Pideal(blitz::Range(left,Pideal.extent(0)-1)));
-    else
-      fa = 0;
-  }
-  retval(0,nbins) = miss / (double)Nt; // pmiss
-  retval(1,nbins) = fa / (double)Nn; // pfa
-
-  return retval;
+  return err::ScoreDistribution(negatives, positives).rocch();
 }
 
 double err::rocch2eer(const blitz::Array<double,2>& pmiss_pfa) 
@@ -330,79 +137,9 @@ double err::rocch2eer(const blitz::Array<double,2>& pmiss_pfa)
  */
 blitz::Array<double,2> err::roc_for_far(const blitz::Array<double,1>& negatives,
  const blitz::Array<double,1>& positives, const blitz::Array<double,1>& far_list) {
-  int n_points = far_list.extent(0);
-
-  // sort negative scores ascendingly
-  std::vector<double> negatives_(negatives.extent(0));;
-  std::copy(negatives.begin(), negatives.end(), negatives_.begin());
-  std::sort(negatives_.begin(), negatives_.end());
-  // sort positive scores ascendingly
-  std::vector<double> positives_(positives.extent(0));;
-  std::copy(positives.begin(), positives.end(), positives_.begin());
-  std::sort(positives_.begin(), positives_.end());
-
-  // do some magic to compute the FRR list
-  blitz::Array<double,2> retval(2, n_points);
-
-  // index into the FAR and FRR list
-  int far_index = n_points-1;
-  int pos_index = 0, neg_index = 0;
-  int n_pos = positives_.size(), n_neg = negatives_.size();
-
-  // iterators into the result lists
-  std::vector<double>::const_iterator pos_it = positives_.begin(), neg_it = negatives_.begin();
-  // do some fast magic to compute the FRR values ;-)
-  do{
-    // check whether the current positive value is less than the current negative one
-    if (*pos_it <= *neg_it){
-      // increase the positive count
-      ++pos_index;
-      // go to the next positive value
-      ++pos_it;
-    }else{
-      // increase the negative count
-      ++neg_index;
-      // go to the next negative value
-      ++neg_it;
-    }
-    // check, if we have reached a new FAR limit,
-    // i.e. if the relative number of negative similarities is greater than 1-FAR (which is the CRR)
-    if ((double)neg_index / (double)n_neg > 1. - far_list(far_index)){
-      // copy the far value
-      retval(0,far_index) = far_list(far_index);
-      // calculate the CAR (i.e., 1.-frr) for the current FAR
-      retval(1,far_index) = 1. - (double)pos_index / (double)n_pos;
-      // go to the next FAR value
-      --far_index;
-    }
-
-  // do this, as long as there are elements in both lists left and not all FRR elements where calculated yet
-  } while (pos_it != positives_.end() && neg_it != negatives_.end() && far_index >= 0);
-
-  // check if all CAR values have been set
-  if (far_index >= 0){
-    // walk to the end of both lists; at least one of both lists should already have reached its limit.
-    pos_index += positives_.end() - pos_it;
-    neg_index += negatives_.end() - neg_it;
-    // fill in the remaining elements of the CAR list
-    do {
-      // copy the FAR value
-      retval(0,far_index) = far_list(far_index);
-      // check if the criterion is fulfilled (should be, as long as the lowest far is not below 0)
-      if ((double)neg_index / (double)n_neg > 1. - far_list(far_index)){
-        // calculate the CAR (i.e., 1.-FRR) for the current FAR
-        retval(1,far_index) = 1. - (double)pos_index / (double)n_pos;
-      } else {
-        // set CAR to zero (this should never happen, but might be due to numerical issues)
-        retval(1,far_index) = 0.;
-      }
-    } while (far_index--);
-  }
-
-  return retval;
+  return err::ScoreDistribution(negatives, positives).roc_for_far(far_list);
 }
 
-
 /**
  * The input to this function is a cumulative probability.  The output from
  * this function is the Normal deviate that corresponds to that probability.
@@ -462,17 +199,11 @@ static double _ppndf(double p) {
   return retval;
 }
 
-namespace blitz {
-  BZ_DECLARE_FUNCTION(_ppndf) ///< A blitz::Array binding
-}
-
 double err::ppndf (double value) { return _ppndf(value); }
 
 blitz::Array<double,2> err::det(const blitz::Array<double,1>& negatives,
     const blitz::Array<double,1>& positives, size_t points) {
-  blitz::Array<double,2> retval(2, points);
-  retval = blitz::_ppndf(err::roc(negatives, positives, points));
-  return retval;
+  return err::ScoreDistribution(negatives, positives).det(points);
 }
 
 blitz::Array<double,2> err::epc
@@ -480,16 +211,6 @@ blitz::Array<double,2> err::epc
  const blitz::Array<double,1>& dev_positives,
  const blitz::Array<double,1>& test_negatives,
  const blitz::Array<double,1>& test_positives, size_t points) {
-  double step = 1.0/((double)points-1.0);
-  blitz::Array<double,2> retval(2, points);
-  for (int i=0; i<(int)points; ++i) {
-    double alpha = (double)i*step;
-    retval(0,i) = alpha;
-    double threshold = err::minWeightedErrorRateThreshold(dev_negatives,
-        dev_positives, alpha);
-    std::pair<double, double> ratios =
-      err::farfrr(test_negatives, test_positives, threshold);
-    retval(1,i) = (ratios.first + ratios.second) / 2;
-  }
-  return retval;
+  return err::epc(err::ScoreDistribution(dev_negatives, dev_positives),
+    err::ScoreDistribution(test_negatives, test_positives), points);
 }
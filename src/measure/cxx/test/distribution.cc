@@ -0,0 +1,146 @@
+/**
+ * @file measure/cxx/test/distribution.cc
+ * @date Fri 16 Oct 2026 21:41:07 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Tests the sorting of large sets of scores by the ScoreDistribution
+ * against std::sort
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE measure-distribution Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/random.hpp>
+#include <blitz/array.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "bob/measure/ScoreDistribution.h"
+
+// more scores than the threshold of the radix sort (1 << 16)
+static const int N_SCORES = 100003;
+
+struct T {
+  boost::mt19937 rng;
+  boost::normal_distribution<double> normal;
+  boost::uniform_int<> uniform;
+
+  T(): uniform(0, 9) { }
+
+  /**
+   * Scores around 0, with negative ones, signed zeros, duplicates and
+   * infinite values
+   */
+  blitz::Array<double,1> mixed(const int n) {
+    boost::variate_generator<boost::mt19937&,
+      boost::normal_distribution<double> > gen(rng, normal);
+    const double inf = std::numeric_limits<double>::infinity();
+    const double special[] = {0., -0., inf, -inf, 1.5, -1.5, 1e-300, -1e-300};
+    blitz::Array<double,1> scores(n);
+    for (int i=0; i<n; ++i) {
+      const int u = uniform(rng);
+      if (u < 8) scores(i) = 100. * gen();
+      else scores(i) = special[(i / 10) % 8];
+    }
+    return scores;
+  }
+
+  /**
+   * Scores in [1, 2), whose exponent bits are all the same
+   */
+  blitz::Array<double,1> narrow(const int n) {
+    boost::uniform_real<double> real(1., 2.);
+    boost::variate_generator<boost::mt19937&,
+      boost::uniform_real<double> > gen(rng, real);
+    blitz::Array<double,1> scores(n);
+    for (int i=0; i<n; ++i) scores(i) = gen();
+    return scores;
+  }
+};
+
+/**
+ * Compares the numbers of negative and positive scores below each score
+ * (and just above it) to the ones in the scores sorted by std::sort
+ */
+static void check_sorted(const bob::measure::ScoreDistribution& d,
+    const blitz::Array<double,1>& negatives,
+    const blitz::Array<double,1>& positives) {
+  std::vector<double> neg(negatives.extent(0)), pos(positives.extent(0));
+  std::copy(negatives.begin(), negatives.end(), neg.begin());
+  std::copy(positives.begin(), positives.end(), pos.begin());
+  std::sort(neg.begin(), neg.end());
+  std::sort(pos.begin(), pos.end());
+
+  BOOST_CHECK_EQUAL(d.getNNegatives(), neg.size());
+  BOOST_CHECK_EQUAL(d.getNPositives(), pos.size());
+  BOOST_CHECK_EQUAL(d.getMin(), std::min(neg.front(), pos.front()));
+  BOOST_CHECK_EQUAL(d.getMax(), std::max(neg.back(), pos.back()));
+
+  std::vector<double> thresholds(neg);
+  thresholds.insert(thresholds.end(), pos.begin(), pos.end());
+  const double inf = std::numeric_limits<double>::infinity();
+  for (size_t i=0; i<thresholds.size(); ++i) {
+    const double t[] = {thresholds[i], nextafter(thresholds[i], inf)};
+    for (int k=0; k<2; ++k) {
+      const size_t n_neg =
+        std::lower_bound(neg.begin(), neg.end(), t[k]) - neg.begin();
+      const size_t n_pos =
+        std::lower_bound(pos.begin(), pos.end(), t[k]) - pos.begin();
+      if (d.negativesBelow(t[k]) != n_neg || d.positivesBelow(t[k]) != n_pos)
+      {
+        BOOST_ERROR("wrong number of scores below " << t[k]);
+        return;
+      }
+    }
+  }
+}
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( test_radix_sort_mixed )
+{
+  const blitz::Array<double,1> negatives = mixed(N_SCORES);
+  const blitz::Array<double,1> positives = mixed(N_SCORES + 17);
+  const bob::measure::ScoreDistribution d(negatives, positives);
+  check_sorted(d, negatives, positives);
+}
+
+BOOST_AUTO_TEST_CASE( test_radix_sort_narrow )
+{
+  // a small set of positives, sorted by std::sort
+  const blitz::Array<double,1> negatives = narrow(N_SCORES);
+  const blitz::Array<double,1> positives = narrow(1000);
+  const bob::measure::ScoreDistribution d(negatives, positives);
+  check_sorted(d, negatives, positives);
+}
+
+BOOST_AUTO_TEST_CASE( test_radix_sort_chunks )
+{
+  // large chunks, merged with the scores already sorted
+  const blitz::Array<double,1> negatives = mixed(2 * N_SCORES);
+  const blitz::Array<double,1> positives = narrow(2 * N_SCORES);
+  const blitz::Range r1(0, N_SCORES-1), r2(N_SCORES, 2*N_SCORES-1);
+  bob::measure::ScoreDistribution d;
+  d.add(negatives(r1), positives(r1));
+  d.add(negatives(r2), positives(r2));
+  check_sorted(d, negatives, positives);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,93 @@
+/**
+ * @file measure/python/distribution.cc
+ * @date Fri 16 Oct 2026 17:02:14 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Python bindings to bob::measure::ScoreDistribution
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/make_shared.hpp>
+#include "bob/measure/ScoreDistribution.h"
+#include "bob/core/python/ndarray.h"
+#include "bob/core/python/gil.h"
+
+using namespace boost::python;
+namespace err = bob::measure;
+
+static boost::shared_ptr<err::ScoreDistribution> make_exact(
+    bob::python::const_ndarray negatives, bob::python::const_ndarray positives)
+{
+  const blitz::Array<double,1> negatives_ = negatives.cast<double,1>();
+  const blitz::Array<double,1> positives_ = positives.cast<double,1>();
+  bob::python::no_gil unlock;
+  return boost::make_shared<err::ScoreDistribution>(negatives_, positives_);
+}
+
+static void add(err::ScoreDistribution& d,
+    bob::python::const_ndarray negatives, bob::python::const_ndarray positives)
+{
+  const blitz::Array<double,1> negatives_ = negatives.cast<double,1>();
+  const blitz::Array<double,1> positives_ = positives.cast<double,1>();
+  bob::python::no_gil unlock;
+  d.add(negatives_, positives_);
+}
+
+static tuple farfrr(const err::ScoreDistribution& d, double threshold)
+{
+  std::pair<double, double> retval = d.farfrr(threshold);
+  return make_tuple(retval.first, retval.second);
+}
+
+static blitz::Array<double,2> roc_for_far(const err::ScoreDistribution& d,
+    bob::python::const_ndarray far_list)
+{
+  return d.roc_for_far(far_list.cast<double,1>());
+}
+
+void bind_measure_distribution() {
+  class_<err::ScoreDistribution, boost::shared_ptr<err::ScoreDistribution> >(
+      "ScoreDistribution",
+      "The distributions of the negative and of the positive scores of a system, on which the FAR and FRR are evaluated at any threshold. Use it instead of the free functions of this module to compute several error measures or curves on the same scores, as these sort the scores at each call.\n\nIn the default (exact) mode, each score set is sorted once and all results are identical to the ones of the free functions. In histogram mode, scores are counted in bins of equal width, with a memory use that does not depend on the number of scores: the FAR and FRR are exact at bin edges, other thresholds being rounded down to the closest edge.\n\nIn both modes, scores can be added by chunks with add().",
+      init<>((arg("self")), "Creates an empty distribution in exact mode"))
+    .def("__init__", make_constructor(&make_exact, default_call_policies(), (arg("negatives"), arg("positives"))), "Creates a distribution in exact mode from the given negative and positive scores")
+    .def(init<size_t, double, double>((arg("self"), arg("n_bins"), arg("min"), arg("max")), "Creates an empty distribution in histogram mode, with n_bins bins of equal width covering [min, max). Scores outside of this range are counted in the first or in the last bin."))
+    .def("add", &add, (arg("self"), arg("negatives"), arg("positives")), "Adds negative and positive scores to the distribution")
+    .add_property("is_histogram", &err::ScoreDistribution::isHistogram, "True if the scores are binned")
+    .add_property("n_negatives", &err::ScoreDistribution::getNNegatives, "The number of negative scores")
+    .add_property("n_positives", &err::ScoreDistribution::getNPositives, "The number of positive scores")
+    .add_property("min", &err::ScoreDistribution::getMin, "The smallest score")
+    .add_property("max", &err::ScoreDistribution::getMax, "The largest score")
+    .def("farfrr", &farfrr, (arg("self"), arg("threshold")), "Returns the FAR and the FRR at the given threshold, see bob.measure.farfrr()")
+    .def("eer_threshold", &err::ScoreDistribution::eerThreshold, (arg("self")), "See bob.measure.eer_threshold()")
+    .def("eer_rocch", &err::ScoreDistribution::eerRocch, (arg("self")), "See bob.measure.eer_rocch(). Exact mode only.")
+    .def("min_weighted_error_rate_threshold", &err::ScoreDistribution::minWeightedErrorRateThreshold, (arg("self"), arg("cost")), "See bob.measure.min_weighted_error_rate_threshold()")
+    .def("min_hter_threshold", &err::ScoreDistribution::minHterThreshold, (arg("self")), "See bob.measure.min_hter_threshold()")
+    .def("far_threshold", &err::ScoreDistribution::farThreshold, (arg("self"), arg("far_value")=0.001), "See bob.measure.far_threshold(). In histogram mode, returns the lowest bin edge at which the FAR is not larger than far_value.")
+    .def("frr_threshold", &err::ScoreDistribution::frrThreshold, (arg("self"), arg("frr_value")=0.001), "See bob.measure.frr_threshold(). In histogram mode, returns the highest bin edge at which the FRR is not larger than frr_value.")
+    .def("roc", &err::ScoreDistribution::roc, (arg("self"), arg("n_points")), "See bob.measure.roc()")
+    .def("det", &err::ScoreDistribution::det, (arg("self"), arg("n_points")), "See bob.measure.det()")
+    .def("rocch", &err::ScoreDistribution::rocch, (arg("self")), "See bob.measure.rocch(). Exact mode only.")
+    .def("roc_for_far", &roc_for_far, (arg("self"), arg("far_list")), "See bob.measure.roc_for_far(). Exact mode only.")
+    ;
+
+  def(
+    "epc",
+    (blitz::Array<double,2> (*)(const err::ScoreDistribution&, const err::ScoreDistribution&, const size_t))&err::epc,
+    (arg("dev"), arg("test"), arg("n_points")),
+    "Calculates the EPC curve on the given development and test score distributions, see the other variant of this function."
+  );
+}
@@ -26,3 +26,21 @@ bob::python::no_gil::no_gil()
 bob::python::no_gil::~no_gil() {
   PyEval_RestoreThread(m_state);
 }
+
+static const size_t N_OBJECT_LOCKS = 64;
+static boost::mutex s_object_locks[N_OBJECT_LOCKS];
+
+static boost::mutex& object_mutex(const void* object) {
+  // objects are at least 16-byte aligned on the heap
+  return s_object_locks[(reinterpret_cast<size_t>(object) >> 4) % N_OBJECT_LOCKS];
+}
+
+bob::python::object_lock::object_lock(const void* object)
+  : m_mutex(object_mutex(object))
+{
+  m_mutex.lock();
+}
+
+bob::python::object_lock::~object_lock() {
+  m_mutex.unlock();
+}
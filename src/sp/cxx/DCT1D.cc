@@ -23,7 +23,6 @@
 
 #include "bob/sp/DCT1D.h"
 #include "bob/core/array_assert.h"
-#include <fftw3.h>
 
 bob::sp::DCT1DAbstract::DCT1DAbstract( const size_t length):
   m_length(length)
@@ -81,6 +80,8 @@ void bob::sp::DCT1DAbstract::reset()
 {
   // Precompute some normalization factors
   initNormFactors();
+  // Drop the plans of the previous length
+  m_plans.clear();
 }
 
 void bob::sp::DCT1DAbstract::initNormFactors()
@@ -136,16 +137,10 @@ void bob::sp::DCT1D::operator()(const blitz::Array<double,1>& src,
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape( dst, src);
 
-  // Reinterpret cast to fftw format
-  double* src_ = const_cast<double*>(src.data());
-  double* dst_ = dst.data();
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_r2r_1d(src.extent(0), src_, dst_, FFTW_REDFT10, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Execute the (cached) plan for this shape and memory alignment
+  const int n = src.extent(0);
+  m_plans.r2r(1, &n, const_cast<double*>(src.data()), dst.data(),
+    bob::sp::detail::FFTWPlanCache::DCTII);
 
   // Normalize
   dst(0) *= m_sqrt_1byl/2.;
@@ -211,14 +206,9 @@ void bob::sp::IDCT1D::operator()(const blitz::Array<double,1>& src,
     dst(r_dst) /= m_sqrt_2l;
   }
 
-  // Reinterpret cast to fftw format
-  double* dst_ = dst.data();
- 
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_r2r_1d(src.extent(0), dst_, dst_, FFTW_REDFT01, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Execute the (cached) inplace plan for this shape and memory alignment
+  const int n = src.extent(0);
+  m_plans.r2r(1, &n, dst.data(), dst.data(),
+    bob::sp::detail::FFTWPlanCache::DCTIII);
 }
 
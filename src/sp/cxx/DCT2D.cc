@@ -23,8 +23,15 @@
 
 #include "bob/sp/DCT2D.h"
 #include "bob/core/array_assert.h"
-#include <fftw3.h>
+#include <vector>
 
+/**
+ * Number of slices transformed by each execution of the batch plan of the
+ * 3D operator(). The remaining slices are transformed one by one, so that
+ * at most two plans are created per slice shape, whatever the number of
+ * slices of the arrays.
+ */
+static const int s_batch_slices = 64;
 
 bob::sp::DCT2DAbstract::DCT2DAbstract( const size_t height, const size_t width):
   m_height(height), m_width(width)
@@ -88,6 +95,8 @@ void bob::sp::DCT2DAbstract::reset()
 {
   // Precompute some normalization factors
   initNormFactors();
+  // Drop the plans of the previous shape
+  m_plans.clear();
 }
 
 void bob::sp::DCT2DAbstract::initNormFactors() 
@@ -143,16 +152,10 @@ void bob::sp::DCT2D::operator()(const blitz::Array<double,2>& src,
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape( dst, src);
 
-  // Reinterpret cast to fftw format
-  double* src_ = const_cast<double*>(src.data());
-  double* dst_ = dst.data();
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_r2r_2d(src.extent(0), src.extent(1), src_, dst_, FFTW_REDFT10, FFTW_REDFT10, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Execute the (cached) plan for this shape and memory alignment
+  const int n[2] = {src.extent(0), src.extent(1)};
+  m_plans.r2r(2, n, const_cast<double*>(src.data()), dst.data(),
+    bob::sp::detail::FFTWPlanCache::DCTII);
 
   // Rescale the result
   for(int i=0; i<(int)m_height; ++i)
@@ -160,6 +163,47 @@ void bob::sp::DCT2D::operator()(const blitz::Array<double,2>& src,
       dst(i,j) = dst(i,j)/4.*(i==0?m_sqrt_1h:m_sqrt_2h)*(j==0?m_sqrt_1w:m_sqrt_2w);
 }
 
+void bob::sp::DCT2D::operator()(const blitz::Array<double,3>& src, 
+  blitz::Array<double,3>& dst)
+{
+  // check input
+  bob::core::array::assertCZeroBaseContiguous(src);
+
+  // Check output
+  bob::core::array::assertCZeroBaseContiguous(dst);
+  bob::core::array::assertSameShape( dst, src);
+  const int h = m_height;
+  const int w = m_width;
+  bob::core::array::assertSameDimensionLength(src.extent(1), h);
+  bob::core::array::assertSameDimensionLength(src.extent(2), w);
+
+  // Execute the (cached) plan for batches of s_batch_slices slices, then
+  // the one for a single slice on the remaining ones
+  const int n[2] = {h, w};
+  const int n_slices = src.extent(0);
+  const size_t slice_size = static_cast<size_t>(h) * w;
+  double* s = const_cast<double*>(src.data());
+  double* d = dst.data();
+  int b = 0;
+  for(; b+s_batch_slices<=n_slices; b+=s_batch_slices)
+    m_plans.r2r(2, n, s_batch_slices, s + b*slice_size, d + b*slice_size,
+      bob::sp::detail::FFTWPlanCache::DCTII);
+  for(; b<n_slices; ++b)
+    m_plans.r2r(2, n, s + b*slice_size, d + b*slice_size,
+      bob::sp::detail::FFTWPlanCache::DCTII);
+
+  // Rescale the result, with unit stride loops over the rows of the slices
+  std::vector<double> row_factor(h), col_factor(w);
+  for(int i=0; i<h; ++i) row_factor[i] = (i==0?m_sqrt_1h:m_sqrt_2h) / 4.;
+  for(int j=0; j<w; ++j) col_factor[j] = (j==0?m_sqrt_1w:m_sqrt_2w);
+  d = dst.data();
+  for(int b=0; b<n_slices; ++b)
+    for(int i=0; i<h; ++i, d+=w) {
+      const double f = row_factor[i];
+      for(int j=0; j<w; ++j) d[j] *= f * col_factor[j];
+    }
+}
+
 
 bob::sp::IDCT2D::IDCT2D( const size_t height, const size_t width):
   bob::sp::DCT2DAbstract::DCT2DAbstract(height, width)
@@ -213,15 +257,10 @@ void bob::sp::IDCT2D::operator()(const blitz::Array<double,2>& src,
       dst(i,j) = src(i,j)*4/(i==0?m_sqrt_1h:m_sqrt_2h)/(j==0?m_sqrt_1w:m_sqrt_2w);
   }
 
-  // Reinterpret cast to fftw format
-  double* dst_ = dst.data();
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_r2r_2d(src.extent(0), src.extent(1), dst_, dst_, FFTW_REDFT01, FFTW_REDFT01, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Execute the (cached) inplace plan for this shape and memory alignment
+  const int n[2] = {src.extent(0), src.extent(1)};
+  m_plans.r2r(2, n, dst.data(), dst.data(),
+    bob::sp::detail::FFTWPlanCache::DCTIII);
   
   // Rescale the result by the size of the input 
   // (as this is not performed by FFTPACK)
@@ -114,3 +114,27 @@ const char* sp::SeparableConvolutionInvalidDim::what() const throw() {
   }
 }
 
+
+sp::FFTWWisdomError::FFTWWisdomError(const std::string& source) throw():
+  m_source(source)
+{
+}
+
+sp::FFTWWisdomError::~FFTWWisdomError() throw()
+{
+}
+
+const char* sp::FFTWWisdomError::what() const throw() {
+  try {
+    boost::format message(
+      "Cannot transfer FFTW wisdom from/to %s. Please check that it exists, \
+       is accessible and, when importing, that it contains valid wisdom.");
+    message % m_source;
+    m_message = message.str();
+    return m_message.c_str();
+  } catch (...) {
+    static const char* emergency = "sp::FFTWWisdomError: cannot \
+      format, exception raised";
+    return emergency;
+  }
+}
@@ -23,7 +23,6 @@
 
 #include "bob/sp/FFT1D.h"
 #include "bob/core/array_assert.h"
-#include <fftw3.h>
 
 
 namespace sp = bob::sp;
@@ -63,7 +62,8 @@ bool bob::sp::FFT1DAbstract::operator!=(const bob::sp::FFT1DAbstract& b) const
 
 void bob::sp::FFT1DAbstract::reset(const size_t length)
 {
-  // Update the length
+  // Update the length and drop the plans of the previous one
+  if (m_length != length) m_plans.clear();
   m_length = length;
 }
 
@@ -116,16 +116,10 @@ void bob::sp::FFT1D::operator()(const blitz::Array<std::complex<double>,1>& src,
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape( dst, src);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
-  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_1d(src.extent(0), src_, dst_, FFTW_FORWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Execute the (cached) plan for this shape and memory alignment
+  const int n = src.extent(0);
+  m_plans.dft(1, &n, const_cast<std::complex<double>*>(src.data()),
+    dst.data(), -1);
 }
 
 
@@ -172,16 +166,10 @@ void bob::sp::IFFT1D::operator()(const blitz::Array<std::complex<double>,1>& src
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape( dst, src);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
-  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_1d(src.extent(0), src_, dst_, FFTW_BACKWARD, FFTW_ESTIMATE);
-  fftw_execute(p); /* repeat as needed */
-  fftw_destroy_plan(p);
+  // Execute the (cached) plan for this shape and memory alignment
+  const int n = src.extent(0);
+  m_plans.dft(1, &n, const_cast<std::complex<double>*>(src.data()),
+    dst.data(), 1);
 
   // Rescale as FFTW is not doing it
   dst /= static_cast<double>(m_length);
@@ -23,7 +23,6 @@
 
 #include "bob/sp/FFT2D.h"
 #include "bob/core/array_assert.h"
-#include <fftw3.h>
 
 
 bob::sp::FFT2DAbstract::FFT2DAbstract( const size_t height, const size_t width):
@@ -61,7 +60,8 @@ bool bob::sp::FFT2DAbstract::operator!=(const bob::sp::FFT2DAbstract& b) const
 
 void bob::sp::FFT2DAbstract::reset(const size_t height, const size_t width)
 {
-  // Update the height and width
+  // Update the height and width and drop the plans of the previous shape
+  if (m_height != height || m_width != width) m_plans.clear();
   m_height = height;
   m_width = width;
 }
@@ -110,16 +110,10 @@ void bob::sp::FFT2D::operator()(const blitz::Array<std::complex<double>,2>& src,
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape( dst, src);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
-  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_2d(src.extent(0), src.extent(1), src_, dst_, FFTW_FORWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Execute the (cached) plan for this shape and memory alignment
+  const int n[2] = {src.extent(0), src.extent(1)};
+  m_plans.dft(2, n, const_cast<std::complex<double>*>(src.data()),
+    dst.data(), -1);
 }
 
 
@@ -128,15 +122,9 @@ void bob::sp::FFT2D::operator()(blitz::Array<std::complex<double>,2>& src_dst)
   // check data
   bob::core::array::assertCZeroBaseContiguous(src_dst);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_dst_ = reinterpret_cast<fftw_complex*>(src_dst.data());
-
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized
-  // for large arrays
-  p = fftw_plan_dft_2d(src_dst.extent(0), src_dst.extent(1), src_dst_, src_dst_, FFTW_FORWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Execute the (cached) inplace plan for this shape and memory alignment
+  const int n[2] = {src_dst.extent(0), src_dst.extent(1)};
+  m_plans.dft(2, n, src_dst.data(), src_dst.data(), -1);
 }
 
 
@@ -183,16 +171,10 @@ void bob::sp::IFFT2D::operator()(const blitz::Array<std::complex<double>,2>& src
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape( dst, src);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
-  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_2d(src.extent(0), src.extent(1), src_, dst_, FFTW_BACKWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Execute the (cached) plan for this shape and memory alignment
+  const int n[2] = {src.extent(0), src.extent(1)};
+  m_plans.dft(2, n, const_cast<std::complex<double>*>(src.data()),
+    dst.data(), 1);
 
   // Rescale the result by the size of the input 
   // (as this is not performed by FFTW)
@@ -204,15 +186,9 @@ void bob::sp::IFFT2D::operator()(blitz::Array<std::complex<double>,2>& src_dst)
   // check data
   bob::core::array::assertCZeroBaseContiguous(src_dst);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_dst_ = reinterpret_cast<fftw_complex*>(src_dst.data());
-
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized
-  // for large arrays
-  p = fftw_plan_dft_2d(src_dst.extent(0), src_dst.extent(1), src_dst_, src_dst_, FFTW_BACKWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Execute the (cached) inplace plan for this shape and memory alignment
+  const int n[2] = {src_dst.extent(0), src_dst.extent(1)};
+  m_plans.dft(2, n, src_dst.data(), src_dst.data(), 1);
 
   // Rescale the result by the size of the input
   // (as this is not performed by FFTW)
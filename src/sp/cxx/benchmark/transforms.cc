@@ -0,0 +1,127 @@
+/**
+ * @file sp/cxx/benchmark/transforms.cc
+ * @date Fri 16 Oct 2026 18:10:37 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Benchmarks of the FFT, DCT and convolution operators
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOB_BENCHMARK_SUITE "sp"
+#define BOB_BENCHMARK_MAIN
+#include "bob/core/benchmark.h"
+
+#include "bob/sp/FFT1D.h"
+#include "bob/sp/FFT2D.h"
+#include "bob/sp/DCT1D.h"
+#include "bob/sp/DCT2D.h"
+#include "bob/sp/conv.h"
+
+namespace bench = bob::core::benchmark;
+
+struct Conv2D {
+  const blitz::Array<double,2>* a;
+  const blitz::Array<double,2>* b;
+  blitz::Array<double,2>* c;
+  void operator()() const { bob::sp::conv(*a, *b, *c, bob::sp::Conv::Same); }
+};
+
+struct ConvSep {
+  const blitz::Array<double,2>* a;
+  const blitz::Array<double,1>* b;
+  blitz::Array<double,2>* tmp;
+  blitz::Array<double,2>* c;
+  void operator()() const {
+    bob::sp::convSep(*a, *b, *tmp, 0, bob::sp::Conv::Same);
+    bob::sp::convSep(*tmp, *b, *c, 1, bob::sp::Conv::Same);
+  }
+};
+
+static void fft(bench::Suite& suite) {
+  const int lengths[] = {64, 1024, 4096};
+  for (size_t i=0; i<sizeof(lengths)/sizeof(int); ++i) {
+    const int n = lengths[i];
+    blitz::Array<std::complex<double>,1> src(n), dst(n);
+    bench::randomize(src, -1., 1.);
+    bob::sp::FFT1D fft(n);
+    bob::sp::IFFT1D ifft(n);
+    const double bytes = n * sizeof(std::complex<double>);
+    suite.run((boost::format("fft1d/%d") % n).str(),
+        bench::apply(fft, src, dst), n, bytes);
+    suite.run((boost::format("ifft1d/%d") % n).str(),
+        bench::apply(ifft, src, dst), n, bytes);
+  }
+
+  const int sizes[] = {64, 256, 1024};
+  for (size_t i=0; i<sizeof(sizes)/sizeof(int); ++i) {
+    const int n = sizes[i];
+    blitz::Array<std::complex<double>,2> src(n, n), dst(n, n);
+    bench::randomize(src, -1., 1.);
+    bob::sp::FFT2D fft(n, n);
+    const std::string name = (boost::format("fft2d/%dx%d") % n % n).str();
+    suite.run(name, bench::apply(fft, src, dst), n*n,
+        n*n*sizeof(std::complex<double>));
+  }
+}
+
+static void dct(bench::Suite& suite) {
+  const int lengths[] = {64, 1024};
+  for (size_t i=0; i<sizeof(lengths)/sizeof(int); ++i) {
+    const int n = lengths[i];
+    blitz::Array<double,1> src(n), dst(n);
+    bench::randomize(src, -1., 1.);
+    bob::sp::DCT1D dct(n);
+    suite.run((boost::format("dct1d/%d") % n).str(),
+        bench::apply(dct, src, dst), n, n*sizeof(double));
+  }
+
+  // 8x8 is the block size of the DCT features of bob::ip
+  const int sizes[] = {8, 256};
+  for (size_t i=0; i<sizeof(sizes)/sizeof(int); ++i) {
+    const int n = sizes[i];
+    blitz::Array<double,2> src(n, n), dst(n, n);
+    bench::randomize(src, -1., 1.);
+    bob::sp::DCT2D dct(n, n);
+    bob::sp::IDCT2D idct(n, n);
+    const double bytes = n * n * sizeof(double);
+    suite.run((boost::format("dct2d/%dx%d") % n % n).str(),
+        bench::apply(dct, src, dst), n*n, bytes);
+    suite.run((boost::format("idct2d/%dx%d") % n % n).str(),
+        bench::apply(idct, src, dst), n*n, bytes);
+  }
+}
+
+static void conv(bench::Suite& suite) {
+  const int n = 256;
+  const int k = 9;
+  blitz::Array<double,2> a(n, n), c(n, n), tmp(n, n), b(k, k);
+  blitz::Array<double,1> b1(k);
+  bench::randomize(a);
+  bench::randomize(b);
+  bench::randomize(b1);
+  const double bytes = n * n * sizeof(double);
+
+  Conv2D c2 = {&a, &b, &c};
+  suite.run("conv2d/256x256*9x9", c2, n*n, bytes);
+  ConvSep cs = {&a, &b1, &tmp, &c};
+  suite.run("convsep/256x256*9", cs, n*n, bytes);
+}
+
+void bob_benchmark(bench::Suite& suite) {
+  fft(suite);
+  dct(suite);
+  conv(suite);
+}
@@ -0,0 +1,266 @@
+/**
+ * @file sp/cxx/fftw.cc
+ * @date Fri 16 Oct 2026 10:12:31 CEST
+ * @author agent <agent@local>
+ *
+ * @brief FFTW plan management: planning rigor, wisdom persistence and the
+ * per-object plan cache used by the FFT/DCT classes of bob::sp.
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bob/sp/fftw.h"
+#include "bob/sp/Exception.h"
+
+#include <map>
+#include <cstdlib>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <fftw3.h>
+
+/**
+ * The FFTW planner (plan creation/destruction and wisdom handling) is not
+ * thread-safe, contrary to fftw_execute_*(). All calls to the former go
+ * through this lock.
+ */
+static boost::mutex& planner_mutex() {
+  static boost::mutex mutex;
+  return mutex;
+}
+
+static bob::sp::fftw::PlanningRigor s_rigor = bob::sp::fftw::Estimate;
+
+static unsigned rigor_to_flag(const bob::sp::fftw::PlanningRigor rigor) {
+  switch (rigor) {
+    case bob::sp::fftw::Measure: return FFTW_MEASURE;
+    case bob::sp::fftw::Patient: return FFTW_PATIENT;
+    case bob::sp::fftw::Exhaustive: return FFTW_EXHAUSTIVE;
+    case bob::sp::fftw::Estimate:
+    default: return FFTW_ESTIMATE;
+  }
+}
+
+void bob::sp::fftw::setPlanningRigor(const bob::sp::fftw::PlanningRigor rigor)
+{
+  boost::lock_guard<boost::mutex> lock(planner_mutex());
+  s_rigor = rigor;
+}
+
+bob::sp::fftw::PlanningRigor bob::sp::fftw::getPlanningRigor()
+{
+  boost::lock_guard<boost::mutex> lock(planner_mutex());
+  return s_rigor;
+}
+
+void bob::sp::fftw::importWisdom(const std::string& filename)
+{
+  boost::lock_guard<boost::mutex> lock(planner_mutex());
+  if (!fftw_import_wisdom_from_filename(filename.c_str()))
+    throw bob::sp::FFTWWisdomError(filename);
+}
+
+void bob::sp::fftw::importWisdomFromString(const std::string& wisdom)
+{
+  boost::lock_guard<boost::mutex> lock(planner_mutex());
+  if (!fftw_import_wisdom_from_string(wisdom.c_str()))
+    throw bob::sp::FFTWWisdomError("a string");
+}
+
+void bob::sp::fftw::exportWisdom(const std::string& filename)
+{
+  boost::lock_guard<boost::mutex> lock(planner_mutex());
+  if (!fftw_export_wisdom_to_filename(filename.c_str()))
+    throw bob::sp::FFTWWisdomError(filename);
+}
+
+std::string bob::sp::fftw::exportWisdomToString()
+{
+  boost::lock_guard<boost::mutex> lock(planner_mutex());
+  char* wisdom = fftw_export_wisdom_to_string();
+  if (!wisdom) return std::string();
+  std::string retval(wisdom);
+  free(wisdom);
+  return retval;
+}
+
+void bob::sp::fftw::forgetWisdom()
+{
+  boost::lock_guard<boost::mutex> lock(planner_mutex());
+  fftw_forget_wisdom();
+}
+
+
+/**
+ * Everything a plan depends on. FFTW only allows executing a plan on new
+ * arrays that have the same alignment and in-place-ness as the ones it
+ * was created for.
+ */
+struct PlanKey {
+  int rank;
+  int n0;
+  int n1;
+  int howmany;
+  int type; //dft sign or r2r kind
+  int src_alignment;
+  int dst_alignment;
+  bool inplace;
+  bob::sp::fftw::PlanningRigor rigor;
+
+  bool operator<(const PlanKey& o) const {
+    if (rank != o.rank) return rank < o.rank;
+    if (n0 != o.n0) return n0 < o.n0;
+    if (n1 != o.n1) return n1 < o.n1;
+    if (howmany != o.howmany) return howmany < o.howmany;
+    if (type != o.type) return type < o.type;
+    if (src_alignment != o.src_alignment) return src_alignment < o.src_alignment;
+    if (dst_alignment != o.dst_alignment) return dst_alignment < o.dst_alignment;
+    if (inplace != o.inplace) return inplace < o.inplace;
+    return rigor < o.rigor;
+  }
+};
+
+/**
+ * Scratch buffer used at planning time, so that measuring plans never
+ * overwrites user data. The buffer is shifted to reproduce the alignment
+ * of the user array the plan will later be executed on.
+ */
+class ScratchBuffer {
+  public:
+    ScratchBuffer(size_t bytes, int alignment):
+      m_base(static_cast<char*>(fftw_malloc(bytes + 64))),
+      m_ptr(m_base + alignment) {}
+    ~ScratchBuffer() { fftw_free(m_base); }
+    template <typename T> T* get() { return reinterpret_cast<T*>(m_ptr); }
+  private:
+    char* m_base;
+    char* m_ptr;
+};
+
+/**
+ * The map is guarded by its own lock, so that a transform object can be
+ * shared by several threads. It is always taken before planner_mutex().
+ */
+struct bob::sp::detail::FFTWPlanCache::Impl {
+  boost::mutex mutex;
+  std::map<PlanKey, fftw_plan> plans;
+};
+
+bob::sp::detail::FFTWPlanCache::FFTWPlanCache():
+  m_impl(new Impl)
+{
+}
+
+bob::sp::detail::FFTWPlanCache::~FFTWPlanCache()
+{
+  clear();
+}
+
+void bob::sp::detail::FFTWPlanCache::clear()
+{
+  boost::lock_guard<boost::mutex> cache_lock(m_impl->mutex);
+  if (m_impl->plans.empty()) return;
+  boost::lock_guard<boost::mutex> lock(planner_mutex());
+  for (std::map<PlanKey, fftw_plan>::iterator it = m_impl->plans.begin();
+      it != m_impl->plans.end(); ++it)
+    fftw_destroy_plan(it->second);
+  m_impl->plans.clear();
+}
+
+/**
+ * Fills the shape/alignment part of a key, returning the number of
+ * elements of the (howmany) transforms
+ */
+static size_t make_key(PlanKey& key, const int rank, const int* n,
+  const int howmany, int type, double* src, double* dst)
+{
+  key.rank = rank;
+  key.n0 = n[0];
+  key.n1 = (rank > 1 ? n[1] : 1);
+  key.howmany = howmany;
+  key.type = type;
+  key.src_alignment = fftw_alignment_of(src);
+  key.dst_alignment = fftw_alignment_of(dst);
+  key.inplace = (src == dst);
+  key.rigor = bob::sp::fftw::getPlanningRigor();
+  return static_cast<size_t>(key.n0) * key.n1 * key.howmany;
+}
+
+void bob::sp::detail::FFTWPlanCache::dft(const int rank, const int* n,
+  std::complex<double>* src, std::complex<double>* dst, const int sign)
+{
+  PlanKey key;
+  const size_t size = make_key(key, rank, n, 1, sign,
+    reinterpret_cast<double*>(src), reinterpret_cast<double*>(dst));
+  if (size == 0) return;
+
+  fftw_complex* src_ = reinterpret_cast<fftw_complex*>(src);
+  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst);
+
+  boost::unique_lock<boost::mutex> cache_lock(m_impl->mutex);
+  std::map<PlanKey, fftw_plan>::iterator it = m_impl->plans.find(key);
+  if (it == m_impl->plans.end()) {
+    const size_t bytes = size * sizeof(fftw_complex);
+    ScratchBuffer sin(bytes, key.src_alignment);
+    ScratchBuffer sout(key.inplace ? 0 : bytes, key.dst_alignment);
+    fftw_complex* in = sin.get<fftw_complex>();
+    fftw_complex* out = key.inplace ? in : sout.get<fftw_complex>();
+    const int fsign = (sign < 0 ? FFTW_FORWARD : FFTW_BACKWARD);
+    boost::lock_guard<boost::mutex> lock(planner_mutex());
+    fftw_plan p = fftw_plan_dft(rank, n, in, out, fsign,
+      rigor_to_flag(key.rigor));
+    it = m_impl->plans.insert(std::make_pair(key, p)).first;
+  }
+  fftw_plan plan = it->second;
+  cache_lock.unlock();
+
+  fftw_execute_dft(plan, src_, dst_);
+}
+
+void bob::sp::detail::FFTWPlanCache::r2r(const int rank, const int* n,
+  double* src, double* dst, const bob::sp::detail::FFTWPlanCache::R2RKind kind)
+{
+  r2r(rank, n, 1, src, dst, kind);
+}
+
+void bob::sp::detail::FFTWPlanCache::r2r(const int rank, const int* n,
+  const int howmany, double* src, double* dst,
+  const bob::sp::detail::FFTWPlanCache::R2RKind kind)
+{
+  PlanKey key;
+  const size_t size = make_key(key, rank, n, howmany, kind, src, dst);
+  if (size == 0) return;
+
+  boost::unique_lock<boost::mutex> cache_lock(m_impl->mutex);
+  std::map<PlanKey, fftw_plan>::iterator it = m_impl->plans.find(key);
+  if (it == m_impl->plans.end()) {
+    const size_t bytes = size * sizeof(double);
+    ScratchBuffer sin(bytes, key.src_alignment);
+    ScratchBuffer sout(key.inplace ? 0 : bytes, key.dst_alignment);
+    double* in = sin.get<double>();
+    double* out = key.inplace ? in : sout.get<double>();
+    const fftw_r2r_kind fkind = (kind == DCTII ? FFTW_REDFT10 : FFTW_REDFT01);
+    const fftw_r2r_kind kinds[2] = {fkind, fkind};
+    boost::lock_guard<boost::mutex> lock(planner_mutex());
+    // the transforms are contiguous: unit stride, one transform apart
+    const int dist = key.n0 * key.n1;
+    fftw_plan p = fftw_plan_many_r2r(rank, n, howmany, in, 0, 1, dist,
+      out, 0, 1, dist, kinds, rigor_to_flag(key.rigor));
+    it = m_impl->plans.insert(std::make_pair(key, p)).first;
+  }
+  fftw_plan plan = it->second;
+  cache_lock.unlock();
+
+  fftw_execute_r2r(plan, src, dst);
+}
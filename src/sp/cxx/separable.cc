@@ -0,0 +1,312 @@
+/**
+ * @file sp/cxx/separable.cc
+ * @date Fri 16 Oct 2026 19:02:51 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Separable 2D filters with inline border extrapolation
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bob/sp/separable.h"
+#include "bob/sp/Exception.h"
+#include "bob/core/array_assert.h"
+#include "bob/core/array_copy.h"
+#include "bob/core/Exception.h"
+#include <algorithm>
+#include <vector>
+#include <cmath>
+
+namespace {
+
+  /**
+   * Number of columns processed at once by the column pass: the row of
+   * partial sums of a tile (2 KiB) stays in the L1 cache while the input
+   * rows are accumulated into it.
+   */
+  const int TILE = 256;
+
+  /**
+   * Index of the input sample used in place of sample i of a signal of
+   * length n, or -1 if this sample is zero. This matches the extrapolation
+   * functions of bob/sp/extrapolate.h, whatever the distance to the signal.
+   */
+  inline int border_index(int i, const int n,
+      const bob::sp::Extrapolation::BorderType border_type)
+  {
+    if (i >= 0 && i < n) return i;
+    switch (border_type) {
+      case bob::sp::Extrapolation::NearestNeighbour:
+        return i < 0 ? 0 : n-1;
+      case bob::sp::Extrapolation::Circular:
+        i %= n;
+        return i < 0 ? i+n : i;
+      case bob::sp::Extrapolation::Mirror:
+        {
+          const int p = 2*n;
+          i %= p;
+          if (i < 0) i += p;
+          return i < n ? i : p-1-i;
+        }
+      default: // Zero and Constant
+        return -1;
+    }
+  }
+
+  /**
+   * Tells if the memory spanned by two 2D arrays overlaps
+   */
+  bool overlap(const blitz::Array<double,2>& a, const blitz::Array<double,2>& b)
+  {
+    const double* a_lo = a.data();
+    const double* a_hi = a.data();
+    const double* b_lo = b.data();
+    const double* b_hi = b.data();
+    for (int d=0; d<2; ++d) {
+      const ptrdiff_t a_span = (ptrdiff_t)(a.extent(d)-1) * a.stride(d);
+      const ptrdiff_t b_span = (ptrdiff_t)(b.extent(d)-1) * b.stride(d);
+      if (a_span < 0) a_lo += a_span; else a_hi += a_span;
+      if (b_span < 0) b_lo += b_span; else b_hi += b_span;
+    }
+    return a_lo <= b_hi && b_lo <= a_hi;
+  }
+
+  /**
+   * Returns src if its rows are contiguous and it does not overlap with dst,
+   * and a contiguous copy of it otherwise
+   */
+  blitz::Array<double,2> usable_input(const blitz::Array<double,2>& src,
+      const blitz::Array<double,2>& dst)
+  {
+    if (src.stride(1) == 1 && !overlap(src, dst)) return src;
+    return bob::core::array::ccopy(src);
+  }
+
+  /**
+   * Extrapolates the first and last samples of a line buffer, which holds
+   * the signal of length n at offset left
+   */
+  void extrapolate_line(double* buffer, const int n, const int left,
+      const int right, const bob::sp::Extrapolation::BorderType border_type)
+  {
+    double* line = buffer + left;
+    for (int t=-left; t<0; ++t) {
+      const int i = border_index(t, n, border_type);
+      line[t] = i >= 0 ? line[i] : 0.;
+    }
+    for (int t=n; t<n+right; ++t) {
+      const int i = border_index(t, n, border_type);
+      line[t] = i >= 0 ? line[i] : 0.;
+    }
+  }
+
+  /**
+   * The coefficients of the recursive Gaussian filter of Young and van
+   * Vliet: w[n] = b*x[n] + a1*w[n-1] + a2*w[n-2] + a3*w[n-3]
+   */
+  struct IIRCoefficients {
+    double b, a1, a2, a3;
+
+    IIRCoefficients(const double sigma) {
+      const double q = sigma >= 2.5 ? 0.98711*sigma - 0.96330 :
+        3.97156 - 4.14554*std::sqrt(1. - 0.26891*sigma);
+      const double q2 = q*q;
+      const double q3 = q2*q;
+      const double b0 = 1.57825 + 2.44413*q + 1.4281*q2 + 0.422205*q3;
+      a1 = (2.44413*q + 2.85619*q2 + 1.26661*q3) / b0;
+      a2 = -(1.4281*q2 + 1.26661*q3) / b0;
+      a3 = 0.422205*q3 / b0;
+      b = 1. - (a1 + a2 + a3);
+    }
+  };
+
+  /**
+   * Number of samples extrapolated on each side of a signal before it is
+   * smoothed with the recursive filter of standard deviation sigma
+   */
+  int iir_border(const double sigma) {
+    return (int)std::ceil(4.*sigma) + 3;
+  }
+
+  /**
+   * Causal and anti-causal passes of the recursive filter on a line, in
+   * place. The filter states are initialized with the first (resp. last)
+   * samples, as if the line was extended by a constant.
+   */
+  void iir_line(double* x, const int n, const IIRCoefficients& c)
+  {
+    double w1 = x[0], w2 = x[0], w3 = x[0];
+    for (int i=0; i<n; ++i) {
+      const double w = c.b*x[i] + c.a1*w1 + c.a2*w2 + c.a3*w3;
+      x[i] = w; w3 = w2; w2 = w1; w1 = w;
+    }
+    w1 = w2 = w3 = x[n-1];
+    for (int i=n-1; i>=0; --i) {
+      const double w = c.b*x[i] + c.a1*w1 + c.a2*w2 + c.a3*w3;
+      x[i] = w; w3 = w2; w2 = w1; w1 = w;
+    }
+  }
+
+  /**
+   * Same as iir_line(), on the columns of a (contiguous) array of n rows of
+   * width w, processed one row at a time. The first (resp. last) row is left
+   * unchanged by the constant initialization of the states.
+   */
+  void iir_columns(double* x, const int n, const int w,
+      const IIRCoefficients& c)
+  {
+    for (int i=1; i<n; ++i) {
+      double* r = x + (ptrdiff_t)i*w;
+      const double* r1 = x + (ptrdiff_t)(i-1)*w;
+      const double* r2 = x + (ptrdiff_t)std::max(i-2, 0)*w;
+      const double* r3 = x + (ptrdiff_t)std::max(i-3, 0)*w;
+      for (int j=0; j<w; ++j)
+        r[j] = c.b*r[j] + c.a1*r1[j] + c.a2*r2[j] + c.a3*r3[j];
+    }
+    for (int i=n-2; i>=0; --i) {
+      double* r = x + (ptrdiff_t)i*w;
+      const double* r1 = x + (ptrdiff_t)(i+1)*w;
+      const double* r2 = x + (ptrdiff_t)std::min(i+2, n-1)*w;
+      const double* r3 = x + (ptrdiff_t)std::min(i+3, n-1)*w;
+      for (int j=0; j<w; ++j)
+        r[j] = c.b*r[j] + c.a1*r1[j] + c.a2*r2[j] + c.a3*r3[j];
+    }
+  }
+
+}
+
+void bob::sp::convSep2D(const blitz::Array<double,2>& src,
+  const blitz::Array<double,1>& kernel_y,
+  const blitz::Array<double,1>& kernel_x, blitz::Array<double,2>& dst,
+  const bob::sp::Extrapolation::BorderType border_type)
+{
+  bob::core::array::assertZeroBase(src);
+  bob::core::array::assertZeroBase(kernel_y);
+  bob::core::array::assertZeroBase(kernel_x);
+  bob::core::array::assertZeroBase(dst);
+  bob::core::array::assertSameShape(src, dst);
+
+  const int H = src.extent(0);
+  const int W = src.extent(1);
+  const int Ky = kernel_y.extent(0);
+  const int Kx = kernel_x.extent(0);
+  const bool zero = border_type == bob::sp::Extrapolation::Zero ||
+    border_type == bob::sp::Extrapolation::Constant;
+  if (zero && H < Ky) throw ConvolutionKernelTooLarge(0, H, Ky);
+  if (zero && W < Kx) throw ConvolutionKernelTooLarge(1, W, Kx);
+  if (H == 0 || W == 0) return;
+
+  const blitz::Array<double,2> input = usable_input(src, dst);
+  const blitz::Array<double,1> ky = bob::core::array::ccopy(kernel_y);
+  const blitz::Array<double,1> kx = bob::core::array::ccopy(kernel_x);
+
+  // Output sample i depends on the input samples i+h-k, k in [0,K)
+  const int hy = (Ky-1) / 2;
+  const int hx = (Kx-1) / 2;
+  const int left = Kx-1-hx;
+
+  std::vector<const double*> rows(Ky);
+  std::vector<double> weights(Ky);
+  std::vector<double> buffer(W + Kx - 1);
+  std::vector<double> out(W);
+  double* line = &buffer[left];
+  for (int i=0; i<H; ++i) {
+    // Input rows (and their weights) of output row i
+    int n = 0;
+    for (int k=0; k<Ky; ++k) {
+      const int r = border_index(i+hy-k, H, border_type);
+      if (r < 0) continue;
+      rows[n] = input.data() + (ptrdiff_t)r * input.stride(0);
+      weights[n] = ky(k);
+      ++n;
+    }
+
+    // Column pass, into the middle of the line buffer
+    for (int j0=0; j0<W; j0+=TILE) {
+      const int j1 = std::min(W, j0+TILE);
+      if (n == 0) {
+        for (int j=j0; j<j1; ++j) line[j] = 0.;
+        continue;
+      }
+      const double* a = rows[0];
+      const double w0 = weights[0];
+      for (int j=j0; j<j1; ++j) line[j] = w0 * a[j];
+      for (int k=1; k<n; ++k) {
+        a = rows[k];
+        const double w = weights[k];
+        for (int j=j0; j<j1; ++j) line[j] += w * a[j];
+      }
+    }
+
+    // Row pass, on the extrapolated line
+    extrapolate_line(&buffer[0], W, left, hx, border_type);
+    const double* b = &buffer[Kx-1];
+    const double w0 = kx(0);
+    for (int j=0; j<W; ++j) out[j] = w0 * b[j];
+    for (int k=1; k<Kx; ++k) {
+      b = &buffer[Kx-1-k];
+      const double w = kx(k);
+      for (int j=0; j<W; ++j) out[j] += w * b[j];
+    }
+
+    double* d = dst.data() + (ptrdiff_t)i * dst.stride(0);
+    const ptrdiff_t s = dst.stride(1);
+    for (int j=0; j<W; ++j) d[j*s] = out[j];
+  }
+}
+
+void bob::sp::recursiveGaussian(const blitz::Array<double,2>& src,
+  const double sigma_y, const double sigma_x, blitz::Array<double,2>& dst,
+  const bob::sp::Extrapolation::BorderType border_type)
+{
+  bob::core::array::assertZeroBase(src);
+  bob::core::array::assertZeroBase(dst);
+  bob::core::array::assertSameShape(src, dst);
+  if (!(sigma_y >= 0.5))
+    throw bob::core::InvalidArgumentException("sigma_y", sigma_y);
+  if (!(sigma_x >= 0.5))
+    throw bob::core::InvalidArgumentException("sigma_x", sigma_x);
+
+  const int H = src.extent(0);
+  const int W = src.extent(1);
+  if (H == 0 || W == 0) return;
+
+  // Column pass: the extrapolated rows are stored contiguously and
+  // filtered together, one row at a time
+  const int Py = iir_border(sigma_y);
+  const int Hp = H + 2*Py;
+  std::vector<double> columns((size_t)Hp * W);
+  for (int t=0; t<Hp; ++t) {
+    double* r = &columns[(size_t)t * W];
+    const int i = border_index(t-Py, H, border_type);
+    if (i < 0)
+      for (int j=0; j<W; ++j) r[j] = 0.;
+    else
+      for (int j=0; j<W; ++j) r[j] = src(i,j);
+  }
+  iir_columns(&columns[0], Hp, W, IIRCoefficients(sigma_y));
+
+  // Row pass, on each extrapolated line
+  const int Px = iir_border(sigma_x);
+  const IIRCoefficients cx(sigma_x);
+  std::vector<double> buffer(W + 2*Px);
+  for (int i=0; i<H; ++i) {
+    const double* r = &columns[(size_t)(i+Py) * W];
+    std::copy(r, r+W, buffer.begin()+Px);
+    extrapolate_line(&buffer[0], W, Px, Px, border_type);
+    iir_line(&buffer[0], W + 2*Px, cx);
+    for (int j=0; j<W; ++j) dst(i,j) = buffer[Px+j];
+  }
+}
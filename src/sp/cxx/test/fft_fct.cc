@@ -36,6 +36,8 @@
 #include "bob/sp/DCT1DNaive.h"
 #include "bob/sp/DCT2D.h"
 #include "bob/sp/DCT2DNaive.h"
+#include "bob/sp/fftw.h"
+#include "bob/sp/Exception.h"
 // Random number
 #include <cstdlib>
 
@@ -393,6 +395,129 @@ BOOST_AUTO_TEST_CASE( test_fft2D_range1x1to64x64_random )
 }
 
 
+/*************** Plan cache Tests *****************/
+BOOST_AUTO_TEST_CASE( test_fft_dct_plan_reuse )
+{
+  // The same objects are called on several arrays, some of them being
+  // shifted by one element to get a different memory alignment
+  bob::sp::fftw::setPlanningRigor(bob::sp::fftw::Measure);
+  const int M = 12, N = 10;
+  bob::sp::FFT1D fft1d(N);
+  bob::sp::FFT2D fft2d(M, N);
+  bob::sp::DCT1D dct1d(N);
+  bob::sp::DCT2D dct2d(M, N);
+  bob::sp::detail::FFT1DNaive fft1d_naive(N);
+  bob::sp::detail::FFT2DNaive fft2d_naive(M, N);
+  bob::sp::detail::DCT1DNaive dct1d_naive(N);
+  bob::sp::detail::DCT2DNaive dct2d_naive(M, N);
+  blitz::Array<std::complex<double>,1> c_buf(M*N+1), c_out(M*N+1);
+  blitz::Array<double,1> r_buf(M*N+1), r_out(M*N+1);
+  for(int loop=0; loop < 4; ++loop) {
+    const int offset = loop % 2;
+    for(int i=0; i<M*N+1; ++i) {
+      c_buf(i) = std::complex<double>((rand()/(double)RAND_MAX)*10., 
+        (rand()/(double)RAND_MAX)*10.);
+      r_buf(i) = (rand()/(double)RAND_MAX)*10.;
+    }
+
+    blitz::Array<std::complex<double>,1> c1(c_buf.data()+offset, 
+      blitz::shape(N), blitz::neverDeleteData);
+    blitz::Array<std::complex<double>,1> c1_out(c_out.data()+offset, 
+      blitz::shape(N), blitz::neverDeleteData);
+    blitz::Array<std::complex<double>,1> c1_ref(N);
+    fft1d(c1, c1_out);
+    fft1d_naive(c1, c1_ref);
+    for(int i=0; i<N; ++i)
+      BOOST_CHECK_SMALL( abs(c1_out(i)-c1_ref(i)), eps);
+
+    blitz::Array<std::complex<double>,2> c2(c_buf.data()+offset, 
+      blitz::shape(M,N), blitz::neverDeleteData);
+    blitz::Array<std::complex<double>,2> c2_out(c_out.data()+offset, 
+      blitz::shape(M,N), blitz::neverDeleteData);
+    blitz::Array<std::complex<double>,2> c2_ref(M,N);
+    fft2d(c2, c2_out);
+    fft2d_naive(c2, c2_ref);
+    for(int i=0; i<M; ++i)
+      for(int j=0; j<N; ++j)
+        BOOST_CHECK_SMALL( abs(c2_out(i,j)-c2_ref(i,j)), eps);
+
+    blitz::Array<double,1> r1(r_buf.data()+offset, 
+      blitz::shape(N), blitz::neverDeleteData);
+    blitz::Array<double,1> r1_out(r_out.data()+offset, 
+      blitz::shape(N), blitz::neverDeleteData);
+    blitz::Array<double,1> r1_ref(N);
+    dct1d(r1, r1_out);
+    dct1d_naive(r1, r1_ref);
+    for(int i=0; i<N; ++i)
+      BOOST_CHECK_SMALL( fabs(r1_out(i)-r1_ref(i)), eps);
+
+    blitz::Array<double,2> r2(r_buf.data()+offset, 
+      blitz::shape(M,N), blitz::neverDeleteData);
+    blitz::Array<double,2> r2_out(r_out.data()+offset, 
+      blitz::shape(M,N), blitz::neverDeleteData);
+    blitz::Array<double,2> r2_ref(M,N);
+    dct2d(r2, r2_out);
+    dct2d_naive(r2, r2_ref);
+    for(int i=0; i<M; ++i)
+      for(int j=0; j<N; ++j)
+        BOOST_CHECK_SMALL( fabs(r2_out(i,j)-r2_ref(i,j)), eps);
+  }
+  bob::sp::fftw::setPlanningRigor(bob::sp::fftw::Estimate);
+}
+
+BOOST_AUTO_TEST_CASE( test_dct2D_batch )
+{
+  // The slices are transformed in batches of fixed size and one by one
+  // for the remaining ones (odd slice sizes, so that the remaining slices
+  // have different memory alignments)
+  const int M = 3, N = 5;
+  bob::sp::DCT2D dct2d(M, N);
+  bob::sp::detail::DCT2DNaive dct2d_naive(M, N);
+  const int n_slices[] = {1, 63, 64, 65, 130, 200};
+  for(size_t k=0; k<sizeof(n_slices)/sizeof(int); ++k) {
+    const int S = n_slices[k];
+    blitz::Array<double,3> src(S, M, N), dst(S, M, N), inplace(S, M, N);
+    for(int s=0; s<S; ++s)
+      for(int i=0; i<M; ++i)
+        for(int j=0; j<N; ++j)
+          src(s,i,j) = (rand()/(double)RAND_MAX)*10.;
+    inplace = src;
+    dct2d(src, dst);
+    dct2d(inplace, inplace);
+
+    blitz::Array<double,2> ref(M,N);
+    for(int s=0; s<S; ++s) {
+      blitz::Array<double,2> src_s = src(s, blitz::Range::all(), blitz::Range::all());
+      dct2d_naive(src_s, ref);
+      for(int i=0; i<M; ++i)
+        for(int j=0; j<N; ++j) {
+          BOOST_CHECK_SMALL( fabs(dst(s,i,j)-ref(i,j)), eps);
+          BOOST_CHECK_SMALL( fabs(inplace(s,i,j)-ref(i,j)), eps);
+        }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_fftw_wisdom )
+{
+  // Measured plans generate wisdom, which survives an export/import cycle
+  bob::sp::fftw::setPlanningRigor(bob::sp::fftw::Measure);
+  blitz::Array<std::complex<double>,2> t(16,16), t_fft(16,16);
+  t = std::complex<double>(1.,0.);
+  bob::sp::FFT2D fft(16,16);
+  fft(t, t_fft);
+  bob::sp::fftw::setPlanningRigor(bob::sp::fftw::Estimate);
+
+  std::string wisdom = bob::sp::fftw::exportWisdomToString();
+  BOOST_CHECK( !wisdom.empty() );
+  bob::sp::fftw::forgetWisdom();
+  BOOST_CHECK_NO_THROW( bob::sp::fftw::importWisdomFromString(wisdom) );
+  BOOST_CHECK( !bob::sp::fftw::exportWisdomToString().empty() );
+
+  BOOST_CHECK_THROW( bob::sp::fftw::importWisdomFromString("not wisdom"), 
+    bob::sp::FFTWWisdomError );
+}
+
 BOOST_AUTO_TEST_CASE( test_fftshift1D_simple )
 {
   // set up simple 1D random tensor 
@@ -0,0 +1,176 @@
+/**
+ * @file sp/cxx/test/separable.cc
+ * @date Fri 16 Oct 2026 19:02:51 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Test the separable 2D filters against the extrapolation and
+ * convolution functions
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE sp-separable Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+#include "bob/sp/separable.h"
+#include "bob/sp/conv.h"
+#include "bob/sp/Exception.h"
+#include "bob/core/Exception.h"
+
+namespace sp = bob::sp;
+
+struct T {
+  blitz::Array<double,2> A; // image
+  blitz::Array<double,2> B; // small image (smaller than the large kernels)
+  blitz::Array<double,1> k3;
+  blitz::Array<double,1> k5;
+  blitz::Array<double,1> k11;
+  double eps_d;
+
+  T(): A(17,300), B(3,4), k3(3), k5(5), k11(11), eps_d(1e-10) {
+    blitz::firstIndex i;
+    blitz::secondIndex j;
+    A = blitz::sin(0.3*i + 0.01*j*j) + 0.05*blitz::cos(1.7*i*j);
+    B = 1., 2., 3., 4., 5., 6., 7., 8., 9., 10., 11., 12.;
+    k3 = 0.25, 0.5, 0.25;
+    k5 = 1., -2., 4., 3., 0.5;
+    k11 = 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.5, 0.4, 0.3, 0.2, 0.1;
+  }
+
+  ~T() {}
+};
+
+/**
+ * Reference: extrapolation into a padded array followed by two 1D
+ * convolutions (or two 1D convolutions keeping the same size for the zero
+ * border)
+ */
+void reference(const blitz::Array<double,2>& a,
+  const blitz::Array<double,1>& ky, const blitz::Array<double,1>& kx,
+  blitz::Array<double,2>& c, const sp::Extrapolation::BorderType border_type)
+{
+  if (border_type == sp::Extrapolation::Zero) {
+    blitz::Array<double,2> tmp(a.shape());
+    sp::convSep(a, ky, tmp, 0, sp::Conv::Same);
+    sp::convSep(tmp, kx, c, 1, sp::Conv::Same);
+  }
+  else {
+    blitz::Array<double,2> padded(a.extent(0) + ky.extent(0) - 1,
+      a.extent(1) + kx.extent(0) - 1);
+    sp::extrapolate(a, padded, border_type);
+    blitz::Array<double,2> tmp(a.extent(0), padded.extent(1));
+    sp::convSep(padded, ky, tmp, 0, sp::Conv::Valid);
+    sp::convSep(tmp, kx, c, 1, sp::Conv::Valid);
+  }
+}
+
+void check(const double eps, const blitz::Array<double,2>& a,
+  const blitz::Array<double,1>& ky, const blitz::Array<double,1>& kx,
+  const sp::Extrapolation::BorderType border_type)
+{
+  blitz::Array<double,2> ref(a.shape()), res(a.shape());
+  reference(a, ky, kx, ref, border_type);
+  sp::convSep2D(a, ky, kx, res, border_type);
+  for (int i=0; i<res.extent(0); ++i)
+    for (int j=0; j<res.extent(1); ++j)
+      BOOST_CHECK_SMALL(res(i,j) - ref(i,j), eps);
+}
+
+static const sp::Extrapolation::BorderType borders[] = {
+  sp::Extrapolation::Zero, sp::Extrapolation::NearestNeighbour,
+  sp::Extrapolation::Circular, sp::Extrapolation::Mirror};
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( test_convsep2d_borders )
+{
+  for (size_t b=0; b<4; ++b) {
+    check(eps_d, A, k3, k3, borders[b]);
+    check(eps_d, A, k5, k3, borders[b]);
+    check(eps_d, A, k3, k11, borders[b]);
+    check(eps_d, A, k11, k5, borders[b]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_convsep2d_large_kernel )
+{
+  // Kernels larger than the image (several times the image for the mirror)
+  for (size_t b=1; b<4; ++b) {
+    check(eps_d, B, k5, k5, borders[b]);
+    check(eps_d, B, k11, k11, borders[b]);
+  }
+  blitz::Array<double,2> res(B.shape());
+  BOOST_CHECK_THROW(sp::convSep2D(B, k5, k3, res, sp::Extrapolation::Zero),
+    sp::ConvolutionKernelTooLarge);
+}
+
+BOOST_AUTO_TEST_CASE( test_convsep2d_inplace_and_strided )
+{
+  for (size_t b=0; b<4; ++b) {
+    blitz::Array<double,2> ref(A.shape());
+    reference(A, k5, k3, ref, borders[b]);
+
+    // in place
+    blitz::Array<double,2> a = A.copy();
+    sp::convSep2D(a, k5, k3, a, borders[b]);
+    for (int i=0; i<a.extent(0); ++i)
+      for (int j=0; j<a.extent(1); ++j)
+        BOOST_CHECK_SMALL(a(i,j) - ref(i,j), eps_d);
+
+    // transposed (non unit stride) input and output
+    blitz::Array<double,2> st(A.extent(1), A.extent(0));
+    blitz::Array<double,2> s = st.transpose(1,0);
+    s = A;
+    blitz::Array<double,2> dt(A.extent(1), A.extent(0));
+    blitz::Array<double,2> d = dt.transpose(1,0);
+    sp::convSep2D(s, k5, k3, d, borders[b]);
+    for (int i=0; i<d.extent(0); ++i)
+      for (int j=0; j<d.extent(1); ++j)
+        BOOST_CHECK_SMALL(d(i,j) - ref(i,j), eps_d);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_recursive_gaussian )
+{
+  // Compares with the convolution by a sampled Gaussian of radius 4 sigma
+  blitz::Array<double,2> a(64,64);
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  a = 100. * blitz::sin(0.2*i) * blitz::cos(0.15*j) + blitz::sin(2.1*i + 3.3*j);
+
+  const double sigmas[] = {1., 3., 6.};
+  for (size_t s=0; s<3; ++s) {
+    const double sigma = sigmas[s];
+    const int radius = (int)ceil(4*sigma);
+    blitz::Array<double,1> k(2*radius+1);
+    k = blitz::exp(-0.5 * blitz::pow2(i - radius) / (sigma*sigma));
+    k /= blitz::sum(k);
+
+    blitz::Array<double,2> ref(a.shape()), res(a.shape());
+    sp::convSep2D(a, k, k, ref, sp::Extrapolation::Mirror);
+    sp::recursiveGaussian(a, sigma, sigma, res, sp::Extrapolation::Mirror);
+    // the approximation error is within 5% of the amplitude of the signal
+    BOOST_CHECK_SMALL(blitz::max(blitz::abs(res - ref)), 5.);
+  }
+
+  blitz::Array<double,2> res(a.shape());
+  BOOST_CHECK_THROW(sp::recursiveGaussian(a, 0.3, 1., res),
+    bob::core::InvalidArgumentException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -28,6 +28,7 @@
 #include "bob/sp/DCT2DNaive.h"
 
 #include "bob/core/python/ndarray.h"
+#include "bob/core/python/gil.h"
 
 using namespace boost::python;
 
@@ -42,18 +43,30 @@ static const char* DCT_DOC = "Compute the direct DCT of a 1 or 2D array/signal o
 static const char* IDCT_DOC = "Compute the inverse DCT of a 1 or 2D array/signal of type float64.";
 
 
+/**
+ * Runs a transform without the Python GIL: the input is converted (and
+ * checked) beforehand, and the plan cache of the operator is thread-safe.
+ */
+template <typename Op, typename T, int N>
+static void transform(Op& op, const blitz::Array<T,N>& src,
+  blitz::Array<T,N>& dst)
+{
+  bob::python::no_gil unlock;
+  op(src, dst);
+}
+
 static void py_dct1d_c(bob::sp::DCT1D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<double,1> dst_ = dst.bz<double,1>();
-  op(src.bz<double,1>(), dst_);
+  transform(op, src.bz<double,1>(), dst_);
 }
 
 static object py_dct1d_p(bob::sp::DCT1D& op, bob::python::const_ndarray src)
 {
   bob::python::ndarray dst(bob::core::array::t_float64, op.getLength());
   blitz::Array<double,1> dst_ = dst.bz<double,1>();
-  op(src.bz<double,1>(), dst_);
+  transform(op, src.bz<double,1>(), dst_);
   return dst.self();
 }
 
@@ -61,14 +74,14 @@ static void py_idct1d_c(bob::sp::IDCT1D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<double,1> dst_ = dst.bz<double,1>();
-  op(src.bz<double,1>(), dst_);
+  transform(op, src.bz<double,1>(), dst_);
 }
 
 static object py_idct1d_p(bob::sp::IDCT1D& op, bob::python::const_ndarray src)
 {
   bob::python::ndarray dst(bob::core::array::t_float64, op.getLength());
   blitz::Array<double,1> dst_ = dst.bz<double,1>();
-  op(src.bz<double,1>(), dst_);
+  transform(op, src.bz<double,1>(), dst_);
   return dst.self();
 }
 
@@ -77,7 +90,7 @@ static void py_dct2d_c(bob::sp::DCT2D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<double,2> dst_ = dst.bz<double,2>();
-  op(src.bz<double,2>(), dst_);
+  transform(op, src.bz<double,2>(), dst_);
 }
 
 static object py_dct2d_p(bob::sp::DCT2D& op, bob::python::const_ndarray src)
@@ -85,7 +98,7 @@ static object py_dct2d_p(bob::sp::DCT2D& op, bob::python::const_ndarray src)
   bob::python::ndarray dst(bob::core::array::t_float64, op.getHeight(), 
     op.getWidth());
   blitz::Array<double,2> dst_ = dst.bz<double,2>();
-  op(src.bz<double,2>(), dst_);
+  transform(op, src.bz<double,2>(), dst_);
   return dst.self();
 }
 
@@ -93,7 +106,7 @@ static void py_idct2d_c(bob::sp::IDCT2D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<double,2> dst_ = dst.bz<double,2>();
-  op(src.bz<double,2>(), dst_);
+  transform(op, src.bz<double,2>(), dst_);
 }
 
 static object py_idct2d_p(bob::sp::IDCT2D& op, bob::python::const_ndarray src)
@@ -101,7 +114,7 @@ static object py_idct2d_p(bob::sp::IDCT2D& op, bob::python::const_ndarray src)
   bob::python::ndarray dst(bob::core::array::t_float64, op.getHeight(), 
     op.getWidth());
   blitz::Array<double,2> dst_ = dst.bz<double,2>();
-  op(src.bz<double,2>(), dst_);
+  transform(op, src.bz<double,2>(), dst_);
   return dst.self();
 }
 
@@ -118,14 +131,14 @@ static object script_dct(bob::python::const_ndarray ar)
       {
         bob::sp::DCT1D op(info.shape[0]);
         blitz::Array<double,1> res_ = res.bz<double,1>();
-        op(ar.bz<double,1>(), res_);
+        transform(op, ar.bz<double,1>(), res_);
       }
       break;
     case 2:
       {
         bob::sp::DCT2D op(info.shape[0], info.shape[1]);
         blitz::Array<double,2> res_ = res.bz<double,2>();
-        op(ar.bz<double,2>(), res_);
+        transform(op, ar.bz<double,2>(), res_);
       }
       break;
     default:
@@ -145,14 +158,14 @@ static object script_idct(bob::python::const_ndarray ar) {
       {
         bob::sp::IDCT1D op(info.shape[0]);
         blitz::Array<double,1> res_ = res.bz<double,1>();
-        op(ar.bz<double,1>(), res_);
+        transform(op, ar.bz<double,1>(), res_);
       }
       break;
     case 2:
       {
         bob::sp::IDCT2D op(info.shape[0], info.shape[1]);
         blitz::Array<double,2> res_ = res.bz<double,2>();
-        op(ar.bz<double,2>(), res_);
+        transform(op, ar.bz<double,2>(), res_);
       }
       break;
     default:
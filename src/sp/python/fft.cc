@@ -30,6 +30,7 @@
 #include "bob/sp/fftshift.h"
 
 #include "bob/core/python/ndarray.h"
+#include "bob/core/python/gil.h"
 
 using namespace boost::python;
 
@@ -47,18 +48,30 @@ static const char* FFTSHIFT_DOC = "If a 1D complex128 array is passed, inverses
 static const char* IFFTSHIFT_DOC = "This method undo what fftshift() does. Accepts 1 or 2D array of type complex128.";
 
 
+/**
+ * Runs a transform without the Python GIL: the input is converted (and
+ * checked) beforehand, and the plan cache of the operator is thread-safe.
+ */
+template <typename Op, typename T, int N>
+static void transform(Op& op, const blitz::Array<T,N>& src,
+  blitz::Array<T,N>& dst)
+{
+  bob::python::no_gil unlock;
+  op(src, dst);
+}
+
 static void py_fft1d_c(bob::sp::FFT1D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<std::complex<double>,1> dst_ = dst.bz<std::complex<double>,1>();
-  op(src.bz<std::complex<double>,1>(), dst_);
+  transform(op, src.bz<std::complex<double>,1>(), dst_);
 }
 
 static object py_fft1d_p(bob::sp::FFT1D& op, bob::python::const_ndarray src)
 {
   bob::python::ndarray dst(bob::core::array::t_complex128, op.getLength());
   blitz::Array<std::complex<double>,1> dst_ = dst.bz<std::complex<double>,1>();
-  op(src.bz<std::complex<double>,1>(), dst_);
+  transform(op, src.bz<std::complex<double>,1>(), dst_);
   return dst.self();
 }
 
@@ -66,14 +79,14 @@ static void py_ifft1d_c(bob::sp::IFFT1D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<std::complex<double>,1> dst_ = dst.bz<std::complex<double>,1>();
-  op(src.bz<std::complex<double>,1>(), dst_);
+  transform(op, src.bz<std::complex<double>,1>(), dst_);
 }
 
 static object py_ifft1d_p(bob::sp::IFFT1D& op, bob::python::const_ndarray src)
 {
   bob::python::ndarray dst(bob::core::array::t_complex128, op.getLength());
   blitz::Array<std::complex<double>,1> dst_ = dst.bz<std::complex<double>,1>();
-  op(src.bz<std::complex<double>,1>(), dst_);
+  transform(op, src.bz<std::complex<double>,1>(), dst_);
   return dst.self();
 }
 
@@ -82,7 +95,7 @@ static void py_fft2d_c(bob::sp::FFT2D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<std::complex<double>,2> dst_ = dst.bz<std::complex<double>,2>();
-  op(src.bz<std::complex<double>,2>(), dst_);
+  transform(op, src.bz<std::complex<double>,2>(), dst_);
 }
 
 static object py_fft2d_p(bob::sp::FFT2D& op, bob::python::const_ndarray src)
@@ -90,7 +103,7 @@ static object py_fft2d_p(bob::sp::FFT2D& op, bob::python::const_ndarray src)
   bob::python::ndarray dst(bob::core::array::t_complex128, op.getHeight(), 
     op.getWidth());
   blitz::Array<std::complex<double>,2> dst_ = dst.bz<std::complex<double>,2>();
-  op(src.bz<std::complex<double>,2>(), dst_);
+  transform(op, src.bz<std::complex<double>,2>(), dst_);
   return dst.self();
 }
 
@@ -98,7 +111,7 @@ static void py_ifft2d_c(bob::sp::IFFT2D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
   blitz::Array<std::complex<double>,2> dst_ = dst.bz<std::complex<double>,2>();
-  op(src.bz<std::complex<double>,2>(), dst_);
+  transform(op, src.bz<std::complex<double>,2>(), dst_);
 }
 
 static object py_ifft2d_p(bob::sp::IFFT2D& op, bob::python::const_ndarray src)
@@ -106,7 +119,7 @@ static object py_ifft2d_p(bob::sp::IFFT2D& op, bob::python::const_ndarray src)
   bob::python::ndarray dst(bob::core::array::t_complex128, op.getHeight(), 
     op.getWidth());
   blitz::Array<std::complex<double>,2> dst_ = dst.bz<std::complex<double>,2>();
-  op(src.bz<std::complex<double>,2>(), dst_);
+  transform(op, src.bz<std::complex<double>,2>(), dst_);
   return dst.self();
 }
 
@@ -124,14 +137,14 @@ static object script_fft(bob::python::const_ndarray ar)
       {
         bob::sp::FFT1D op(info.shape[0]);
         blitz::Array<dcplx,1> res_ = res.bz<dcplx,1>();
-        op(ar.bz<dcplx,1>(), res_);
+        transform(op, ar.bz<dcplx,1>(), res_);
       }
       break;
     case 2:
       {
         bob::sp::FFT2D op(info.shape[0], info.shape[1]);
         blitz::Array<dcplx,2> res_ = res.bz<dcplx,2>();
-        op(ar.bz<dcplx,2>(), res_);
+        transform(op, ar.bz<dcplx,2>(), res_);
       }
       break;
     default:
@@ -153,14 +166,14 @@ static object script_ifft(bob::python::const_ndarray ar)
       {
         bob::sp::IFFT1D op(info.shape[0]);
         blitz::Array<dcplx,1> res_ = res.bz<dcplx,1>();
-        op(ar.bz<dcplx,1>(), res_);
+        transform(op, ar.bz<dcplx,1>(), res_);
       }
       break;
     case 2:
       {
         bob::sp::IFFT2D op(info.shape[0], info.shape[1]);
         blitz::Array<dcplx,2> res_ = res.bz<dcplx,2>();
-        op(ar.bz<dcplx,2>(), res_);
+        transform(op, ar.bz<dcplx,2>(), res_);
       }
       break;
     default:
@@ -0,0 +1,52 @@
+/**
+ * @file sp/python/fftw.cc
+ * @date Fri 16 Oct 2026 10:12:31 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Binds FFTW planning rigor and wisdom handling to python
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/python.hpp>
+#include "bob/sp/fftw.h"
+
+using namespace boost::python;
+
+static const char* SET_RIGOR_DOC = "Sets the effort spent by FFTW when planning new transforms for the FFT and DCT objects of this module. Anything but 'Estimate' times several algorithms the first time a given size is processed, which pays off when the same size is used many times. Plans are cached by each object and reused for all calls with the same size.";
+static const char* GET_RIGOR_DOC = "Returns the effort currently spent by FFTW when planning new transforms.";
+static const char* IMPORT_WISDOM_DOC = "Loads the FFTW wisdom saved in the given file (by fftw_export_wisdom() in this or in a previous process), so that tuned plans are created at no cost.";
+static const char* IMPORT_WISDOM_STR_DOC = "Loads the FFTW wisdom from the given string, as returned by fftw_export_wisdom_to_string().";
+static const char* EXPORT_WISDOM_DOC = "Saves the FFTW wisdom accumulated so far into the given file.";
+static const char* EXPORT_WISDOM_STR_DOC = "Returns the FFTW wisdom accumulated so far as a string.";
+static const char* FORGET_WISDOM_DOC = "Forgets all the FFTW wisdom accumulated so far.";
+
+void bind_sp_fftw()
+{
+  enum_<bob::sp::fftw::PlanningRigor>("FFTWPlanningRigor")
+    .value("Estimate", bob::sp::fftw::Estimate)
+    .value("Measure", bob::sp::fftw::Measure)
+    .value("Patient", bob::sp::fftw::Patient)
+    .value("Exhaustive", bob::sp::fftw::Exhaustive)
+    ;
+
+  def("fftw_set_planning_rigor", &bob::sp::fftw::setPlanningRigor, (arg("rigor")), SET_RIGOR_DOC);
+  def("fftw_get_planning_rigor", &bob::sp::fftw::getPlanningRigor, GET_RIGOR_DOC);
+  def("fftw_import_wisdom", &bob::sp::fftw::importWisdom, (arg("filename")), IMPORT_WISDOM_DOC);
+  def("fftw_import_wisdom_from_string", &bob::sp::fftw::importWisdomFromString, (arg("wisdom")), IMPORT_WISDOM_STR_DOC);
+  def("fftw_export_wisdom", &bob::sp::fftw::exportWisdom, (arg("filename")), EXPORT_WISDOM_DOC);
+  def("fftw_export_wisdom_to_string", &bob::sp::fftw::exportWisdomToString, EXPORT_WISDOM_STR_DOC);
+  def("fftw_forget_wisdom", &bob::sp::fftw::forgetWisdom, FORGET_WISDOM_DOC);
+}
@@ -49,8 +49,7 @@ bob::trainer::EMPCATrainer::EMPCATrainer(int dimensionality,
 }
 
 bob::trainer::EMPCATrainer::EMPCATrainer(const bob::trainer::EMPCATrainer& other):
-  EMTrainer<bob::machine::LinearMachine, blitz::Array<double,2> >(other.m_convergence_threshold, 
-    other.m_max_iterations, other.m_compute_likelihood),
+  EMTrainer<bob::machine::LinearMachine, blitz::Array<double,2> >(other),
   m_dimensionality(other.m_dimensionality), 
   m_S(bob::core::array::ccopy(other.m_S)),
   m_z_first_order(bob::core::array::ccopy(other.m_z_first_order)), 
@@ -19,6 +19,9 @@
  */
 #include "bob/trainer/GMMTrainer.h"
 #include "bob/core/array_assert.h"
+#include "bob/core/parallel.h"
+#include <vector>
+#include <boost/shared_ptr.hpp>
 
 namespace train = bob::trainer;
 namespace mach = bob::machine;
@@ -40,10 +43,53 @@ void train::GMMTrainer::initialization(mach::GMMMachine& gmm, const blitz::Array
   m_ss.resize(gmm.getNGaussians(),gmm.getNInputs());
 }
 
+namespace {
+  /**
+   * Accumulates the statistics of a contiguous shard of the data. All the
+   * threads share the machine, each one with its own workspace and its own
+   * statistics. The shards are views built by the calling thread, as
+   * creating blitz views modifies the (non thread-safe) reference count of
+   * the data.
+   */
+  struct GMMShardAccumulator {
+    const mach::GMMMachine* gmm;
+    std::vector<boost::shared_ptr<mach::GMMWorkspace> >* workspaces;
+    std::vector<boost::shared_ptr<mach::GMMStats> >* stats;
+    const std::vector<blitz::Array<double,2> >* shards;
+
+    void operator()(size_t t, size_t, size_t) const {
+      gmm->accStatistics_((*shards)[t], *(*stats)[t], *(*workspaces)[t]);
+    }
+  };
+}
+
 void train::GMMTrainer::eStep(mach::GMMMachine& gmm, const blitz::Array<double,2>& data) {
   m_ss.init();
-  // Calculate the sufficient statistics and save in m_ss
-  gmm.accStatistics(data, m_ss);
+  const size_t n_threads = bob::core::getNThreads(m_n_threads, data.extent(0));
+  if (n_threads <= 1) {
+    // Calculate the sufficient statistics and save in m_ss
+    gmm.accStatistics(data, m_ss);
+    return;
+  }
+
+  // Parallel version: checks the input once, then each thread accumulates
+  // the statistics of its shard, which are merged in shard order
+  bob::core::array::assertSameDimensionLength(data.extent(1), gmm.getNInputs());
+  std::vector<boost::shared_ptr<mach::GMMWorkspace> > workspaces(n_threads);
+  std::vector<boost::shared_ptr<mach::GMMStats> > stats(n_threads);
+  std::vector<blitz::Array<double,2> > shards(n_threads);
+  const size_t n_samples = data.extent(0);
+  for (size_t t=0; t<n_threads; ++t) {
+    workspaces[t].reset(new mach::GMMWorkspace());
+    stats[t].reset(new mach::GMMStats(gmm.getNGaussians(), gmm.getNInputs()));
+    shards[t].reference(data(blitz::Range(
+      (int)bob::core::shardStart(t, n_threads, n_samples),
+      (int)bob::core::shardStart(t+1, n_threads, n_samples)-1),
+      blitz::Range::all()));
+  }
+  GMMShardAccumulator acc = {&gmm, &workspaces, &stats, &shards};
+  bob::core::parallelFor(n_samples, n_threads, acc);
+  for (size_t t=0; t<n_threads; ++t) m_ss += *stats[t];
 }
 
 double train::GMMTrainer::computeLikelihood(mach::GMMMachine& gmm) {
@@ -26,6 +26,7 @@
 #include "bob/core/array_check.h"
 #include "bob/core/Exception.h"
 #include "bob/core/repmat.h"
+#include "bob/core/parallel.h"
 #include <algorithm>
 #include <random/normal.h>
 
@@ -655,6 +656,252 @@ void train::JFABaseTrainerBase::initializeXYZ(const std::vector<std::vector<boos
 
 
 
+namespace {
+  typedef std::vector<std::vector<boost::shared_ptr<const bob::machine::GMMStats> > > StatsList;
+
+  /**
+   * Computes (I+sum_c N(c)*Prod_c)^-1, where Prod_c is the c'th slice of
+   * prod (e.g. Vt_{c}*diag(sigma)^-1*V_{c}). tmp is of the same size as res.
+   * Elements are accessed one by one, rather than through slices, so that
+   * prod can be shared by several threads.
+   */
+  void idPlusProdInv(const blitz::Array<double,3>& prod, 
+    const blitz::Array<double,1>& N, blitz::Array<double,2>& tmp,
+    blitz::Array<double,2>& res)
+  {
+    math::eye(tmp); // tmp = I
+    for(int c=0; c<prod.extent(0); ++c)
+      for(int r=0; r<prod.extent(1); ++r)
+        for(int s=0; s<prod.extent(2); ++s)
+          tmp(r,s) += prod(c,r,s) * N(c);
+    math::inv(tmp, res); // res = (I+sum_c N(c)*Prod_c)^-1
+  }
+
+  /**
+   * Computes (I+Dt*diag(sigma)^-1*N*D)^-1 (diagonal)
+   */
+  void idPlusDProdInv(const blitz::Array<double,1>& DProd, 
+    const blitz::Array<double,1>& N, blitz::Array<double,1>& tmp_CD,
+    blitz::Array<double,1>& res)
+  {
+    core::repelem(N, tmp_CD); // tmp_CD = N 'repmat'
+    res = 1.; // res = Id
+    res += DProd * tmp_CD; // res = I+Dt*diag(sigma)^-1*N*D
+    res = 1 / res; // res = (I+Dt*diag(sigma)^-1*N*D)^-1
+  }
+
+  /**
+   * Computes Fn_y_i = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - D*z_{i} - U*x_{i,h})
+   */
+  void computeFn_y(const blitz::Array<double,1>& Fi, 
+    const blitz::Array<double,1>& Ni, const blitz::Array<double,1>& m, 
+    const blitz::Array<double,1>& d, const blitz::Array<double,1>& z,
+    const blitz::Array<double,2>& X, const blitz::Array<double,2>& U,
+    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& stats_i,
+    blitz::Array<double,1>& tmp_CD, blitz::Array<double,1>& tmp_CD_b,
+    blitz::Array<double,1>& Fn)
+  {
+    core::repelem(Ni, tmp_CD);
+    Fn = Fi - tmp_CD * (m + d * z); // Fn = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - D*z_{i}) 
+    for(int h=0; h<X.extent(1); ++h) // Loops over the sessions
+    {
+      blitz::Array<double,1> Xh = X(blitz::Range::all(), h); // Xh = x_{i,h} (length: ru)
+      math::prod(U, Xh, tmp_CD_b); // tmp_CD_b = U*x_{i,h}
+      core::repelem(stats_i[h]->n, tmp_CD);
+      Fn -= tmp_CD * tmp_CD_b; // N_{i,h} * U * x_{i,h}
+    }
+  }
+
+  /**
+   * Computes Fn_x_ih = N_{i,h}*(o_{i,h} - m - D*z_{i} - V*y_{i})
+   */
+  void computeFn_x(const blitz::Array<double,2>& Fih, 
+    const blitz::Array<double,1>& Nih, const blitz::Array<double,1>& m, 
+    const blitz::Array<double,1>& d, const blitz::Array<double,1>& z,
+    const blitz::Array<double,2>& V, const blitz::Array<double,1>& y,
+    blitz::Array<double,1>& tmp_CD, blitz::Array<double,1>& tmp_CD_b,
+    blitz::Array<double,1>& Fn)
+  {
+    core::repelem(Nih, tmp_CD); 
+    const int dim_d = Fih.extent(1);
+    for(int c=0; c<Fih.extent(0); ++c)
+      for(int k=0; k<dim_d; ++k)
+        Fn(c*dim_d+k) = Fih(c,k);
+    Fn -= tmp_CD * (m + d * z); // Fn = N_{i,h}*(o_{i,h} - m - D*z_{i}) 
+    math::prod(V, y, tmp_CD_b);
+    Fn -= tmp_CD * tmp_CD_b;
+  }
+
+  /**
+   * Computes Fn_z_i = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - V*y_{i} - U*x_{i,h})
+   */
+  void computeFn_z(const blitz::Array<double,1>& Fi, 
+    const blitz::Array<double,1>& Ni, const blitz::Array<double,1>& m, 
+    const blitz::Array<double,2>& V, const blitz::Array<double,1>& y,
+    const blitz::Array<double,2>& X, const blitz::Array<double,2>& U,
+    const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& stats_i,
+    blitz::Array<double,1>& tmp_CD, blitz::Array<double,1>& tmp_CD_b,
+    blitz::Array<double,1>& Fn)
+  {
+    core::repelem(Ni, tmp_CD);
+    math::prod(V, y, tmp_CD_b); // tmp_CD_b = V * y
+    Fn = Fi - tmp_CD * (m + tmp_CD_b); // Fn = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - V*y_{i}) 
+    for(int h=0; h<X.extent(1); ++h) // Loops over the sessions
+    {
+      core::repelem(stats_i[h]->n, tmp_CD); // N_{i,h} (length: C)
+      blitz::Array<double,1> Xh = X(blitz::Range::all(), h); // Xh = x_{i,h} (length: ru)
+      math::prod(U, Xh, tmp_CD_b);
+      Fn -= tmp_CD * tmp_CD_b;
+    }
+  }
+
+  /**
+   * Processes a shard of the identities: either updates their y, or 
+   * accumulates (in the accumulators of the thread) the statistics used to
+   * estimate V. The y of an identity only depends on its own statistics.
+   */
+  struct JFAYStep {
+    const StatsList* stats;
+    const std::vector<blitz::Array<double,1> >* Nacc;
+    const std::vector<blitz::Array<double,1> >* Facc;
+    const blitz::Array<double,1>* m;
+    const blitz::Array<double,1>* d;
+    const blitz::Array<double,2>* U;
+    const std::vector<blitz::Array<double,2> >* x;
+    const std::vector<blitz::Array<double,1> >* z;
+    const blitz::Array<double,3>* VProd;
+    const blitz::Array<double,2>* VtSigmaInv;
+    std::vector<blitz::Array<double,1> >* y;
+    std::vector<blitz::Array<double,3> >* A1;
+    std::vector<blitz::Array<double,2> >* A2;
+    bool update;
+
+    void operator()(size_t t, size_t start, size_t end) const {
+      const int rv = VtSigmaInv->extent(0);
+      const int CD = m->extent(0);
+      blitz::Array<double,2> tmp_rvrv(rv,rv), IdPlusVProd_i(rv,rv);
+      blitz::Array<double,1> Fn_y_i(CD), tmp_CD(CD), tmp_CD_b(CD), tmp_rv(rv);
+      blitz::firstIndex i;
+      blitz::secondIndex j;
+      for(size_t id=start; id<end; ++id) {
+        idPlusProdInv(*VProd, (*Nacc)[id], tmp_rvrv, IdPlusVProd_i);
+        computeFn_y((*Facc)[id], (*Nacc)[id], *m, *d, (*z)[id], (*x)[id], *U,
+          (*stats)[id], tmp_CD, tmp_CD_b, Fn_y_i);
+        if(update) {
+          // Computes yi = Ayi * Cvs * Fn_yi
+          math::prod(*VtSigmaInv, Fn_y_i, tmp_rv); 
+          math::prod(IdPlusVProd_i, tmp_rv, (*y)[id]);
+        }
+        else {
+          const blitz::Array<double,1>& y_i = (*y)[id];
+          tmp_rvrv = IdPlusVProd_i;
+          tmp_rvrv += y_i(i) * y_i(j); 
+          for(int c=0; c<VProd->extent(0); ++c)
+          {
+            blitz::Array<double,2> A1_y_c = (*A1)[t](c,blitz::Range::all(),blitz::Range::all());
+            A1_y_c += tmp_rvrv * (*Nacc)[id](c);
+          }
+          (*A2)[t] += Fn_y_i(i) * y_i(j);
+        }
+      }
+    }
+  };
+
+  /**
+   * Processes a shard of the identities: either updates the x of their 
+   * sessions, or accumulates the statistics used to estimate U.
+   */
+  struct JFAXStep {
+    const StatsList* stats;
+    const blitz::Array<double,1>* m;
+    const blitz::Array<double,1>* d;
+    const blitz::Array<double,2>* V;
+    const std::vector<blitz::Array<double,1> >* y;
+    const std::vector<blitz::Array<double,1> >* z;
+    const blitz::Array<double,3>* UProd;
+    const blitz::Array<double,2>* UtSigmaInv;
+    std::vector<blitz::Array<double,2> >* x;
+    std::vector<blitz::Array<double,3> >* A1;
+    std::vector<blitz::Array<double,2> >* A2;
+    bool update;
+
+    void operator()(size_t t, size_t start, size_t end) const {
+      const int ru = UtSigmaInv->extent(0);
+      const int CD = m->extent(0);
+      blitz::Array<double,2> tmp_ruru(ru,ru), IdPlusUProd_ih(ru,ru);
+      blitz::Array<double,1> Fn_x_ih(CD), tmp_CD(CD), tmp_CD_b(CD), tmp_ru(ru);
+      blitz::firstIndex i;
+      blitz::secondIndex j;
+      for(size_t id=start; id<end; ++id) {
+        const int n_session_i = (*x)[id].extent(1);
+        for(int h=0; h<n_session_i; ++h) {
+          const bob::machine::GMMStats& stats_ih = *(*stats)[id][h];
+          idPlusProdInv(*UProd, stats_ih.n, tmp_ruru, IdPlusUProd_ih);
+          computeFn_x(stats_ih.sumPx, stats_ih.n, *m, *d, (*z)[id], *V, 
+            (*y)[id], tmp_CD, tmp_CD_b, Fn_x_ih);
+          blitz::Array<double,1> x_ih = (*x)[id](blitz::Range::all(), h);
+          if(update) {
+            // Computes xih = Axih * Cus * Fn_x_ih
+            math::prod(*UtSigmaInv, Fn_x_ih, tmp_ru); 
+            math::prod(IdPlusUProd_ih, tmp_ru, x_ih);
+          }
+          else {
+            tmp_ruru = IdPlusUProd_ih;
+            tmp_ruru += x_ih(i) * x_ih(j); 
+            for(int c=0; c<UProd->extent(0); ++c)
+            {
+              blitz::Array<double,2> A1_x_c = (*A1)[t](c,blitz::Range::all(),blitz::Range::all());
+              A1_x_c += tmp_ruru * stats_ih.n(c);
+            }
+            (*A2)[t] += Fn_x_ih(i) * x_ih(j);
+          }
+        }
+      }
+    }
+  };
+
+  /**
+   * Processes a shard of the identities: either updates their z, or 
+   * accumulates the statistics used to estimate D.
+   */
+  struct JFAZStep {
+    const StatsList* stats;
+    const std::vector<blitz::Array<double,1> >* Nacc;
+    const std::vector<blitz::Array<double,1> >* Facc;
+    const blitz::Array<double,1>* m;
+    const blitz::Array<double,2>* V;
+    const blitz::Array<double,2>* U;
+    const std::vector<blitz::Array<double,2> >* x;
+    const std::vector<blitz::Array<double,1> >* y;
+    const blitz::Array<double,1>* DProd;
+    const blitz::Array<double,1>* DtSigmaInv;
+    std::vector<blitz::Array<double,1> >* z;
+    std::vector<blitz::Array<double,1> >* A1;
+    std::vector<blitz::Array<double,1> >* A2;
+    bool update;
+
+    void operator()(size_t t, size_t start, size_t end) const {
+      const int CD = m->extent(0);
+      blitz::Array<double,1> IdPlusDProd_i(CD), Fn_z_i(CD), tmp_CD(CD), tmp_CD_b(CD);
+      for(size_t id=start; id<end; ++id) {
+        idPlusDProdInv(*DProd, (*Nacc)[id], tmp_CD, IdPlusDProd_i);
+        computeFn_z((*Facc)[id], (*Nacc)[id], *m, *V, (*y)[id], (*x)[id], *U,
+          (*stats)[id], tmp_CD, tmp_CD_b, Fn_z_i);
+        blitz::Array<double,1>& z_i = (*z)[id];
+        if(update) {
+          // Computes zi = Azi * D^T.Sigma^-1 * Fn_zi
+          z_i = IdPlusDProd_i * *DtSigmaInv * Fn_z_i; 
+        }
+        else {
+          core::repelem((*Nacc)[id], tmp_CD);
+          (*A1)[t] += (IdPlusDProd_i + z_i * z_i) * tmp_CD;
+          (*A2)[t] += Fn_z_i * z_i;
+        }
+      }
+    }
+  };
+}
+
 train::JFABaseTrainer::JFABaseTrainer(mach::JFABaseMachine& m): 
   JFABaseTrainerBase(m),
   m_cache_VtSigmaInv(0), m_cache_VProd(0), m_cache_IdPlusVProd_i(0), 
@@ -664,7 +911,7 @@ train::JFABaseTrainer::JFABaseTrainer(mach::JFABaseMachine& m):
   m_cache_DtSigmaInv(0), m_cache_DProd(0), m_cache_IdPlusDProd_i(0),
   m_cache_Fn_z_i(0), m_cache_A1_z(0), m_cache_A2_z(0),
   m_tmp_rvrv(0), m_tmp_rvD(0), m_tmp_ruru(0), m_tmp_ruD(0),
-  m_tmp_rv(0), m_tmp_ru(0), m_tmp_CD(0), m_tmp_CD_b(0)
+  m_tmp_rv(0), m_tmp_ru(0), m_tmp_CD(0), m_tmp_CD_b(0), m_n_threads(1)
 {
   initCache();
 }
@@ -737,35 +984,16 @@ void train::JFABaseTrainer::computeVProd()
 
 void train::JFABaseTrainer::computeIdPlusVProd_i(const size_t id) 
 {
-  const blitz::Array<double,1>& Ni = m_Nacc[id];
-  math::eye(m_tmp_rvrv); // m_tmp_rvrv = I
-  for(size_t c=0; c<m_jfa_machine.getDimC(); ++c) {
-    blitz::Array<double,2> VProd_c = m_cache_VProd(c,blitz::Range::all(),blitz::Range::all());
-    m_tmp_rvrv += VProd_c * Ni(c);
-  }
-  math::inv(m_tmp_rvrv, m_cache_IdPlusVProd_i); // m_cache_IdPlusVProd_i = ( I+Vt*diag(sigma)^-1*Ni*V)^-1
+  // m_cache_IdPlusVProd_i = ( I+Vt*diag(sigma)^-1*Ni*V)^-1
+  idPlusProdInv(m_cache_VProd, m_Nacc[id], m_tmp_rvrv, m_cache_IdPlusVProd_i);
 }
 
 void train::JFABaseTrainer::computeFn_y_i(const std::vector<std::vector<boost::shared_ptr<const bob::machine::GMMStats> > >& stats, const size_t id)
 {
   // Compute Fn_yi = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - D*z_{i} - U*x_{i,h}) (Normalised first order statistics)
-  const blitz::Array<double,1>& Fi = m_Facc[id];
-  const blitz::Array<double,1>& m = m_cache_ubm_mean;
-  const blitz::Array<double,1>& d = m_jfa_machine.getD();
-  const blitz::Array<double,1>& z = m_z[id];
-  core::repelem(m_Nacc[id], m_tmp_CD);
-  m_cache_Fn_y_i = Fi - m_tmp_CD * (m + d * z); // Fn_yi = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - D*z_{i}) 
-  const blitz::Array<double,2>& X = m_x[id];
-  const blitz::Array<double,2>& U = m_jfa_machine.getU();
-  for(int h=0; h<X.extent(1); ++h) // Loops over the sessions
-  {
-    blitz::Array<double,1> Xh = X(blitz::Range::all(), h); // Xh = x_{i,h} (length: ru)
-    math::prod(U, Xh, m_tmp_CD_b); // m_tmp_CD_b = U*x_{i,h}
-    const blitz::Array<double,1>& Nih = stats[id][h]->n;
-    core::repelem(Nih, m_tmp_CD);
-    m_cache_Fn_y_i -= m_tmp_CD * m_tmp_CD_b; // N_{i,h} * U * x_{i,h}
-  }
-  // Fn_yi = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - D*z_{i} - U*x_{i,h})
+  computeFn_y(m_Facc[id], m_Nacc[id], m_cache_ubm_mean, m_jfa_machine.getD(),
+    m_z[id], m_x[id], m_jfa_machine.getU(), stats[id], m_tmp_CD, m_tmp_CD_b,
+    m_cache_Fn_y_i);
 }
 
 void train::JFABaseTrainer::updateY_i(const size_t id)
@@ -782,36 +1010,36 @@ void train::JFABaseTrainer::updateY(const std::vector<std::vector<boost::shared_
   // Precomputation
   computeVtSigmaInv();
   computeVProd();
-  // Loops over all people
-  for(size_t id=0; id<m_Nacc.size(); ++id) {
-    computeIdPlusVProd_i(id);
-    computeFn_y_i(stats, id);
-    updateY_i(id);
-  }
+  // Loops over all people (in parallel)
+  JFAYStep step = {&stats, &m_Nacc, &m_Facc, &m_cache_ubm_mean, 
+    &m_jfa_machine.getD(), &m_jfa_machine.getU(), &m_x, &m_z, &m_cache_VProd,
+    &m_cache_VtSigmaInv, &m_y, 0, 0, true};
+  core::parallelFor(m_Nacc.size(), m_n_threads, step);
 }
 
 void train::JFABaseTrainer::updateV(const std::vector<std::vector<boost::shared_ptr<const bob::machine::GMMStats> > >& stats)
 {  
-  // Initializes the cache accumulator
+  // Loops over all people (in parallel), each thread having its own 
+  // accumulators, which are then merged in shard order
+  const size_t n_threads = core::getNThreads(m_n_threads, m_Nacc.size());
+  std::vector<blitz::Array<double,3> > acc_A1(n_threads);
+  std::vector<blitz::Array<double,2> > acc_A2(n_threads);
+  for(size_t t=0; t<n_threads; ++t) {
+    acc_A1[t].resize(m_cache_A1_y.shape());
+    acc_A1[t] = 0.;
+    acc_A2[t].resize(m_cache_A2_y.shape());
+    acc_A2[t] = 0.;
+  }
+  JFAYStep step = {&stats, &m_Nacc, &m_Facc, &m_cache_ubm_mean, 
+    &m_jfa_machine.getD(), &m_jfa_machine.getU(), &m_x, &m_z, &m_cache_VProd,
+    &m_cache_VtSigmaInv, &m_y, &acc_A1, &acc_A2, false};
+  core::parallelFor(m_Nacc.size(), m_n_threads, step);
+
   m_cache_A1_y = 0.;
   m_cache_A2_y = 0.;
-  // Loops over all people
-  blitz::firstIndex i;
-  blitz::secondIndex j;
-  for(size_t id=0; id<m_Nacc.size(); ++id) {
-    computeIdPlusVProd_i(id);
-    computeFn_y_i(stats, id);
-
-    // Needs to return values to be accumulated for estimating V
-    const blitz::Array<double,1>& y = m_y[id];
-    m_tmp_rvrv = m_cache_IdPlusVProd_i;
-    m_tmp_rvrv += y(i) * y(j); 
-    for(size_t c=0; c<m_jfa_machine.getDimC(); ++c)
-    {
-      blitz::Array<double,2> A1_y_c = m_cache_A1_y(c,blitz::Range::all(),blitz::Range::all());
-      A1_y_c += m_tmp_rvrv * m_Nacc[id](c);
-    }
-    m_cache_A2_y += m_cache_Fn_y_i(i) * y(j);
+  for(size_t t=0; t<n_threads; ++t) {
+    m_cache_A1_y += acc_A1[t];
+    m_cache_A2_y += acc_A2[t];
   }
  
   const size_t dim = m_jfa_machine.getDimD();
@@ -858,35 +1086,16 @@ void train::JFABaseTrainer::computeUProd()
 
 void train::JFABaseTrainer::computeIdPlusUProd_ih(const std::vector<std::vector<boost::shared_ptr<const bob::machine::GMMStats> > >& stats, const size_t id, const size_t h) 
 {
-  const blitz::Array<double,1>& Nih = stats[id][h]->n;
-  math::eye(m_tmp_ruru); // m_tmp_ruru = I
-  for(size_t c=0; c<m_jfa_machine.getDimC(); ++c) {
-    blitz::Array<double,2> UProd_c = m_cache_UProd(c,blitz::Range::all(),blitz::Range::all());
-    m_tmp_ruru += UProd_c * Nih(c);
-  }
-  math::inv(m_tmp_ruru, m_cache_IdPlusUProd_ih); // m_cache_IdPlusUProd_ih = ( I+Ut*diag(sigma)^-1*Ni*U)^-1
+  // m_cache_IdPlusUProd_ih = ( I+Ut*diag(sigma)^-1*Ni*U)^-1
+  idPlusProdInv(m_cache_UProd, stats[id][h]->n, m_tmp_ruru, m_cache_IdPlusUProd_ih);
 }
 
 void train::JFABaseTrainer::computeFn_x_ih(const std::vector<std::vector<boost::shared_ptr<const bob::machine::GMMStats> > >& stats, const size_t id, const size_t h)
 {
-  // Compute Fn_x_ih = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - D*z_{i} - V*y_{i}) (Normalised first order statistics)
-  const blitz::Array<double,2>& Fih = stats[id][h]->sumPx;
-  const blitz::Array<double,1>& m = m_cache_ubm_mean;
-  const blitz::Array<double,1>& d = m_jfa_machine.getD();
-  const blitz::Array<double,1>& z = m_z[id];
-  const blitz::Array<double,1>& Nih = stats[id][h]->n;
-  core::repelem(Nih, m_tmp_CD); 
-  for(size_t c=0; c<m_jfa_machine.getDimC(); ++c) {
-    blitz::Array<double,1> Fn_x_ih_c = m_cache_Fn_x_ih(blitz::Range(c*m_jfa_machine.getDimD(),(c+1)*m_jfa_machine.getDimD()-1));
-    Fn_x_ih_c = Fih(c,blitz::Range::all());
-  } 
-  m_cache_Fn_x_ih -= m_tmp_CD * (m + d * z); // Fn_x_ih = N_{i,h}*(o_{i,h} - m - D*z_{i}) 
-
-  const blitz::Array<double,1>& y = m_y[id];
-  const blitz::Array<double,2>& V = m_jfa_machine.getV();
-  math::prod(V, y, m_tmp_CD_b);
-  m_cache_Fn_x_ih -= m_tmp_CD * m_tmp_CD_b;
-  // Fn_x_ih = N_{i,h}*(o_{i,h} - m - D*z_{i} - V*y_{i})
+  // Compute Fn_x_ih = N_{i,h}*(o_{i,h} - m - D*z_{i} - V*y_{i}) (Normalised first order statistics)
+  computeFn_x(stats[id][h]->sumPx, stats[id][h]->n, m_cache_ubm_mean, 
+    m_jfa_machine.getD(), m_z[id], m_jfa_machine.getV(), m_y[id], m_tmp_CD,
+    m_tmp_CD_b, m_cache_Fn_x_ih);
 }
 
 void train::JFABaseTrainer::updateX_ih(const size_t id, const size_t h)
@@ -903,42 +1112,36 @@ void train::JFABaseTrainer::updateX(const std::vector<std::vector<boost::shared_
   // Precomputation
   computeUtSigmaInv();
   computeUProd();
-  // Loops over all people
-  for(size_t id=0; id<stats.size(); ++id) {
-    int n_session_i = m_x[id].extent(1);
-    for(int s=0; s<n_session_i; ++s) {
-      computeIdPlusUProd_ih(stats, id, s);
-      computeFn_x_ih(stats, id, s);
-      updateX_ih(id, s);
-    }
-  }
+  // Loops over all people (in parallel)
+  JFAXStep step = {&stats, &m_cache_ubm_mean, &m_jfa_machine.getD(),
+    &m_jfa_machine.getV(), &m_y, &m_z, &m_cache_UProd, &m_cache_UtSigmaInv,
+    &m_x, 0, 0, true};
+  core::parallelFor(stats.size(), m_n_threads, step);
 }
 
 void train::JFABaseTrainer::updateU(const std::vector<std::vector<boost::shared_ptr<const bob::machine::GMMStats> > >& stats)
 {
-  // Initializes the cache accumulator
+  // Loops over all people (in parallel), each thread having its own 
+  // accumulators, which are then merged in shard order
+  const size_t n_threads = core::getNThreads(m_n_threads, stats.size());
+  std::vector<blitz::Array<double,3> > acc_A1(n_threads);
+  std::vector<blitz::Array<double,2> > acc_A2(n_threads);
+  for(size_t t=0; t<n_threads; ++t) {
+    acc_A1[t].resize(m_cache_A1_x.shape());
+    acc_A1[t] = 0.;
+    acc_A2[t].resize(m_cache_A2_x.shape());
+    acc_A2[t] = 0.;
+  }
+  JFAXStep step = {&stats, &m_cache_ubm_mean, &m_jfa_machine.getD(),
+    &m_jfa_machine.getV(), &m_y, &m_z, &m_cache_UProd, &m_cache_UtSigmaInv,
+    &m_x, &acc_A1, &acc_A2, false};
+  core::parallelFor(stats.size(), m_n_threads, step);
+
   m_cache_A1_x = 0.;
   m_cache_A2_x = 0.;
-  // Loops over all people
-  blitz::firstIndex i;
-  blitz::secondIndex j; 
-  for(size_t id=0; id<stats.size(); ++id) {
-    int n_session_i = m_x[id].extent(1);
-    for(int h=0; h<n_session_i; ++h) {
-      computeIdPlusUProd_ih(stats, id, h);
-      computeFn_x_ih(stats,id, h);
-
-      // Needs to return values to be accumulated for estimating U
-      blitz::Array<double,1> x = m_x[id](blitz::Range::all(), h);
-      m_tmp_ruru = m_cache_IdPlusUProd_ih;
-      m_tmp_ruru += x(i) * x(j); 
-      for(int c=0; c<static_cast<int>(m_jfa_machine.getDimC()); ++c)
-      {
-        blitz::Array<double,2> A1_x_c = m_cache_A1_x(c,blitz::Range::all(),blitz::Range::all());
-        A1_x_c += m_tmp_ruru * stats[id][h]->n(c);
-      }
-      m_cache_A2_x += m_cache_Fn_x_ih(i) * x(j);
-    }
+  for(size_t t=0; t<n_threads; ++t) {
+    m_cache_A1_x += acc_A1[t];
+    m_cache_A2_x += acc_A2[t];
   }
 
   const size_t dim = m_jfa_machine.getDimD();
@@ -969,35 +1172,16 @@ void train::JFABaseTrainer::computeDProd()
 
 void train::JFABaseTrainer::computeIdPlusDProd_i(const size_t id)
 {
-  const blitz::Array<double,1>& Ni = m_Nacc[id];
-  core::repelem(Ni, m_tmp_CD); // m_tmp_CD = Ni 'repmat'
-  m_cache_IdPlusDProd_i = 1.; // m_cache_IdPlusDProd_i = Id
-  m_cache_IdPlusDProd_i += m_cache_DProd * m_tmp_CD; // m_cache_IdPlusDProd_i = I+Dt*diag(sigma)^-1*Ni*D
-  m_cache_IdPlusDProd_i = 1 / m_cache_IdPlusDProd_i; // m_cache_IdPlusVProd_i = (I+Dt*diag(sigma)^-1*Ni*D)^-1
+  // m_cache_IdPlusDProd_i = (I+Dt*diag(sigma)^-1*Ni*D)^-1
+  idPlusDProdInv(m_cache_DProd, m_Nacc[id], m_tmp_CD, m_cache_IdPlusDProd_i);
 }
 
 void train::JFABaseTrainer::computeFn_z_i(const std::vector<std::vector<boost::shared_ptr<const bob::machine::GMMStats> > >& stats, const size_t id)
 {
   // Compute Fn_z_i = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - V*y_{i} - U*x_{i,h}) (Normalised first order statistics)
-  const blitz::Array<double,1>& Fi = m_Facc[id];
-  const blitz::Array<double,1>& m = m_cache_ubm_mean;
-  const blitz::Array<double,2>& V = m_jfa_machine.getV();
-  const blitz::Array<double,1>& y = m_y[id];
-  core::repelem(m_Nacc[id], m_tmp_CD);
-  math::prod(V, y, m_tmp_CD_b); // m_tmp_CD_b = V * y
-  m_cache_Fn_z_i = Fi - m_tmp_CD * (m + m_tmp_CD_b); // Fn_yi = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - V*y_{i}) 
-
-  const blitz::Array<double,2>& X = m_x[id];
-  const blitz::Array<double,2>& U = m_jfa_machine.getU();
-  for(int h=0; h<X.extent(1); ++h) // Loops over the sessions
-  {
-    const blitz::Array<double,1>& Nh = stats[id][h]->n; // Nh = N_{i,h} (length: C)
-    core::repelem(Nh, m_tmp_CD);
-    blitz::Array<double,1> Xh = X(blitz::Range::all(), h); // Xh = x_{i,h} (length: ru)
-    math::prod(U, Xh, m_tmp_CD_b);
-    m_cache_Fn_z_i -= m_tmp_CD * m_tmp_CD_b;
-  }
-  // Fn_z_i = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - V*y_{i} - U*x_{i,h})
+  computeFn_z(m_Facc[id], m_Nacc[id], m_cache_ubm_mean, m_jfa_machine.getV(),
+    m_y[id], m_x[id], m_jfa_machine.getU(), stats[id], m_tmp_CD, m_tmp_CD_b,
+    m_cache_Fn_z_i);
 }
 
 void train::JFABaseTrainer::updateZ_i(const size_t id)
@@ -1013,32 +1197,36 @@ void train::JFABaseTrainer::updateZ(const std::vector<std::vector<boost::shared_
   // Precomputation
   computeDtSigmaInv();
   computeDProd();
-  // Loops over all people
-  for(size_t id=0; id<m_Nacc.size(); ++id) {
-    computeIdPlusDProd_i(id);
-    computeFn_z_i(stats, id);
-    updateZ_i(id);
-  }
+  // Loops over all people (in parallel)
+  JFAZStep step = {&stats, &m_Nacc, &m_Facc, &m_cache_ubm_mean, 
+    &m_jfa_machine.getV(), &m_jfa_machine.getU(), &m_x, &m_y, &m_cache_DProd,
+    &m_cache_DtSigmaInv, &m_z, 0, 0, true};
+  core::parallelFor(m_Nacc.size(), m_n_threads, step);
 }
 
 void train::JFABaseTrainer::updateD(const std::vector<std::vector<boost::shared_ptr<const bob::machine::GMMStats> > >& stats)
 {
-  // Initializes the cache accumulator
+  // Loops over all people (in parallel), each thread having its own 
+  // accumulators, which are then merged in shard order
+  const size_t n_threads = core::getNThreads(m_n_threads, m_Nacc.size());
+  std::vector<blitz::Array<double,1> > acc_A1(n_threads), acc_A2(n_threads);
+  for(size_t t=0; t<n_threads; ++t) {
+    acc_A1[t].resize(m_cache_A1_z.shape());
+    acc_A1[t] = 0.;
+    acc_A2[t].resize(m_cache_A2_z.shape());
+    acc_A2[t] = 0.;
+  }
+  JFAZStep step = {&stats, &m_Nacc, &m_Facc, &m_cache_ubm_mean, 
+    &m_jfa_machine.getV(), &m_jfa_machine.getU(), &m_x, &m_y, &m_cache_DProd,
+    &m_cache_DtSigmaInv, &m_z, &acc_A1, &acc_A2, false};
+  core::parallelFor(m_Nacc.size(), m_n_threads, step);
+
   m_cache_A1_z = 0.;
   m_cache_A2_z = 0.;
-  // Loops over all people
-  blitz::firstIndex i;
-  blitz::secondIndex j; 
-  for(size_t id=0; id<m_Nacc.size(); ++id) {
-    computeIdPlusDProd_i(id);
-    computeFn_z_i(stats, id);
-
-    // Needs to return values to be accumulated for estimating D
-    blitz::Array<double,1> z = m_z[id];
-    core::repelem(m_Nacc[id], m_tmp_CD);
-    m_cache_A1_z += (m_cache_IdPlusDProd_i + z * z) * m_tmp_CD;
-    m_cache_A2_z += m_cache_Fn_z_i * z;
-  } 
+  for(size_t t=0; t<n_threads; ++t) {
+    m_cache_A1_z += acc_A1[t];
+    m_cache_A2_z += acc_A2[t];
+  }
 
   blitz::Array<double,1>& d = m_jfa_machine.updateD();
   d = m_cache_A2_z / m_cache_A1_z;
@@ -21,8 +21,11 @@
 
 #include "bob/trainer/KMeansTrainer.h"
 #include "bob/core/array_copy.h"
+#include "bob/core/parallel.h"
 #include "bob/trainer/Exception.h"
 #include <boost/random.hpp>
+#include <limits>
+#include <cmath>
 
 #if BOOST_VERSION >= 104700
 #include <boost/random/discrete_distribution.hpp>
@@ -32,19 +35,21 @@ bob::trainer::KMeansTrainer::KMeansTrainer(double convergence_threshold,
     size_t max_iterations, bool compute_likelihood, InitializationMethod i_m):
   bob::trainer::EMTrainer<bob::machine::KMeansMachine, blitz::Array<double,2> >(
     convergence_threshold, max_iterations, compute_likelihood), 
-  m_initialization_method(i_m),
+  m_initialization_method(i_m), m_assignment_method(BRUTE_FORCE),
   m_seed(-1), m_average_min_distance(0),
-  m_zeroethOrderStats(0), m_firstOrderStats(0,0)
+  m_zeroethOrderStats(0), m_firstOrderStats(0,0),
+  m_bounds_valid(false)
 {
 }
 
 bob::trainer::KMeansTrainer::KMeansTrainer(const bob::trainer::KMeansTrainer& other):
-  bob::trainer::EMTrainer<bob::machine::KMeansMachine, blitz::Array<double,2> >(
-    other.m_convergence_threshold, other.m_max_iterations, other.m_compute_likelihood), 
+  bob::trainer::EMTrainer<bob::machine::KMeansMachine, blitz::Array<double,2> >(other), 
   m_initialization_method(other.m_initialization_method),
+  m_assignment_method(other.m_assignment_method),
   m_seed(other.m_seed), m_average_min_distance(other.m_average_min_distance),
   m_zeroethOrderStats(bob::core::array::ccopy(other.m_zeroethOrderStats)), 
-  m_firstOrderStats(bob::core::array::ccopy(other.m_firstOrderStats))
+  m_firstOrderStats(bob::core::array::ccopy(other.m_firstOrderStats)),
+  m_bounds_valid(false)
 {
 }
  
@@ -55,10 +60,12 @@ bob::trainer::KMeansTrainer& bob::trainer::KMeansTrainer::operator=
   {
     EMTrainer<bob::machine::KMeansMachine, blitz::Array<double,2> >::operator=(other);
     m_initialization_method = other.m_initialization_method;
+    m_assignment_method = other.m_assignment_method;
     m_seed = other.m_seed;
     m_average_min_distance = other.m_average_min_distance;
     m_zeroethOrderStats.reference(bob::core::array::ccopy(other.m_zeroethOrderStats));
     m_firstOrderStats.reference(bob::core::array::ccopy(other.m_firstOrderStats));
+    m_bounds_valid = false;
   }
   return *this;
 }
@@ -66,6 +73,7 @@ bob::trainer::KMeansTrainer& bob::trainer::KMeansTrainer::operator=
 bool bob::trainer::KMeansTrainer::operator==(const bob::trainer::KMeansTrainer& b) const {
   return EMTrainer<bob::machine::KMeansMachine, blitz::Array<double,2> >::operator==(b) &&
          m_initialization_method == b.m_initialization_method &&
+         m_assignment_method == b.m_assignment_method &&
          m_seed == b.m_seed && m_average_min_distance == b.m_average_min_distance &&
          bob::core::array::hasSameShape(m_zeroethOrderStats, b.m_zeroethOrderStats) &&
          bob::core::array::hasSameShape(m_firstOrderStats, b.m_firstOrderStats) &&
@@ -152,23 +160,26 @@ void bob::trainer::KMeansTrainer::initialization(bob::machine::KMeansMachine& km
     kmeans.setMean(0, mean);
 
     // 1.b. Loops, computes probability distribution and select samples accordingly
+    //   The distance of each sample to the closest mean is kept from one
+    //   iteration to the next one, and only compared to the last new mean
+    blitz::Array<double,1> min_distances(n_data);
+    for(size_t s=0; s<n_data; ++s)
+      min_distances(s) = kmeans.getDistanceFromMean(ar(s,a), 0);
     blitz::Array<double,1> weights(n_data);
     for(size_t m=1; m<kmeans.getNMeans(); ++m) 
     {
-      // For each sample, puts the distance to the closest mean in the weight vector
-      for(size_t s=0; s<n_data; ++s)
+      // Updates the distance to the closest mean with the last selected mean
+      if(m > 1)
       {
-        blitz::Array<double,1> s_cur = ar(s,a);
-        double& w_cur = weights(s);
-        // Initializes with the distance to first mean
-        w_cur = kmeans.getDistanceFromMean(s_cur, 0);
-        // Loops over the remaining mean and update the mean distance if required
-        for(size_t i=1; i<m; ++i)
-          w_cur = std::min(w_cur, kmeans.getDistanceFromMean(s_cur, i));
+        for(size_t s=0; s<n_data; ++s)
+        {
+          double& d_cur = min_distances(s);
+          d_cur = std::min(d_cur, kmeans.getDistanceFromMean(ar(s,a), m-1));
+        }
       }
       // Square and normalize the weights vectors such that
       // \f$weights[x] = D(x)^{2} \sum_{y} D(y)^{2}\f$
-      weights = blitz::pow2(weights);
+      weights = blitz::pow2(min_distances);
       weights /= blitz::sum(weights);
 
       // Takes a sample according to the weights distribution
@@ -183,6 +194,128 @@ void bob::trainer::KMeansTrainer::initialization(bob::machine::KMeansMachine& km
    // Resize the accumulator
   m_zeroethOrderStats.resize(kmeans.getNMeans());
   m_firstOrderStats.resize(kmeans.getNMeans(), kmeans.getNInputs());
+  // The bounds of the HAMERLY assignment method are computed by the first
+  // E-step
+  resetBounds();
+}
+
+/**
+ * Number of samples for which the GEMM assignment method computes the 
+ * distances at once
+ */
+static const int s_gemm_block_size = 256;
+
+namespace {
+  /**
+   * Statistics of a contiguous shard of the data
+   */
+  struct KMeansShard {
+    double distance;
+    blitz::Array<double,1> zeroeth;
+    blitz::Array<double,2> first;
+  };
+
+  /**
+   * Finds the closest mean of the samples of a contiguous shard of the data
+   * and accumulates their statistics. The HAMERLY bounds are stored per
+   * sample, so that the shards do not share any writable memory.
+   */
+  struct KMeansShardAccumulator {
+    const bob::machine::KMeansMachine* kmeans;
+    const blitz::Array<double,2>* ar;
+    bob::trainer::KMeansTrainer::AssignmentMethod method;
+    std::vector<KMeansShard>* shards;
+    // HAMERLY assignment method only
+    bool bounds_valid;
+    size_t* closest_means;
+    double* lower_bounds;
+    const double* half_separations;
+
+    void operator()(size_t t, size_t start, size_t end) const {
+      // The samples are copied element-wise into buffers of this thread, as
+      // slicing the shared data would modify its (non thread-safe) 
+      // reference count
+      KMeansShard& s = (*shards)[t];
+      blitz::Range a = blitz::Range::all();
+      const int n_inputs = ar->extent(1);
+      if(method == bob::trainer::KMeansTrainer::GEMM) {
+        const int n_means = kmeans->getNMeans();
+        blitz::Array<double,2> samples(s_gemm_block_size, n_inputs);
+        blitz::Array<double,2> distances(s_gemm_block_size, n_means);
+        for(int b=start; b<(int)end; b+=s_gemm_block_size) {
+          const int n_block = std::min(s_gemm_block_size, (int)end-b);
+          blitz::Range rb(0, n_block-1);
+          blitz::Array<double,2> X = samples(rb, a);
+          for(int n=0; n<n_block; ++n)
+            for(int k=0; k<n_inputs; ++k) X(n,k) = (*ar)(b+n,k);
+          blitz::Array<double,2> d = distances(rb, a);
+          kmeans->getDistancesFromMeans_(X, d);
+          for(int n=0; n<n_block; ++n) {
+            size_t closest_mean = 0;
+            for(int j=1; j<n_means; ++j)
+              if(d(n,j) < d(n,closest_mean)) closest_mean = j;
+            // the exact distance is accumulated
+            blitz::Array<double,1> x = X(n,a);
+            accumulate(s, x, closest_mean, 
+              kmeans->getDistanceFromMean(x, closest_mean));
+          }
+        }
+      }
+      else {
+        blitz::Array<double,1> x(n_inputs);
+        for(size_t i=start; i<end; ++i) {
+          // get example
+          for(int k=0; k<n_inputs; ++k) x(k) = (*ar)((int)i,k);
+
+          // find closest mean, and distance from that mean
+          size_t closest_mean = 0;
+          double min_distance = 0;
+          if(method == bob::trainer::KMeansTrainer::HAMERLY)
+            hamerly(x, i, closest_mean, min_distance);
+          else
+            kmeans->getClosestMean(x,closest_mean,min_distance);
+
+          accumulate(s, x, closest_mean, min_distance);
+        }
+      }
+    }
+
+    void accumulate(KMeansShard& s, const blitz::Array<double,1>& x,
+      const size_t closest_mean, const double min_distance) const {
+      s.distance += min_distance;
+      ++s.zeroeth(closest_mean);
+      s.first(closest_mean,blitz::Range::all()) += x;
+    }
+
+    void hamerly(const blitz::Array<double,1>& x, const size_t i,
+      size_t& closest_mean, double& min_distance) const {
+      if(bounds_valid) {
+        // The previous closest mean is still the closest one if its 
+        // distance is below the lower bound of the distance to any other 
+        // mean, or below half the distance to the nearest other mean
+        closest_mean = closest_means[i];
+        min_distance = kmeans->getDistanceFromMean(x, closest_mean);
+        if(sqrt(min_distance) <= std::max(lower_bounds[i], 
+              half_separations[closest_mean]))
+          return;
+      }
+      // Otherwise, computes all the distances, and the new bound
+      double second_distance = std::numeric_limits<double>::max();
+      min_distance = std::numeric_limits<double>::max();
+      for(size_t j=0; j<kmeans->getNMeans(); ++j) {
+        const double d = kmeans->getDistanceFromMean(x, j);
+        if(d < min_distance) {
+          second_distance = min_distance;
+          min_distance = d;
+          closest_mean = j;
+        }
+        else if(d < second_distance)
+          second_distance = d;
+      }
+      closest_means[i] = closest_mean;
+      lower_bounds[i] = sqrt(second_distance);
+    }
+  };
 }
 
 void bob::trainer::KMeansTrainer::eStep(bob::machine::KMeansMachine& kmeans, 
@@ -191,23 +324,93 @@ void bob::trainer::KMeansTrainer::eStep(bob::machine::KMeansMachine& kmeans,
   // initialise the accumulators
   resetAccumulators(kmeans);
 
-  // iterate over data samples
+  const size_t n_samples = ar.extent(0);
+  const size_t n_means = kmeans.getNMeans();
+  const blitz::Array<double,2>& means = kmeans.getMeans();
   blitz::Range a = blitz::Range::all();
-  for(int i=0; i<ar.extent(0); ++i) {
-    // get example
-    blitz::Array<double, 1> x(ar(i,a));
-
-    // find closest mean, and distance from that mean
-    size_t closest_mean = 0;
-    double min_distance = 0;
-    kmeans.getClosestMean(x,closest_mean,min_distance);
-
-    // accumulate the stats
-    m_average_min_distance += min_distance;
-    ++m_zeroethOrderStats(closest_mean);
-    m_firstOrderStats(closest_mean,blitz::Range::all()) += x;
+
+  // HAMERLY: moves the bounds according to the displacement of the means
+  // since the previous E-step (the data must not have changed since the
+  // last call to resetBounds()), and computes half the distance of each
+  // mean to the nearest other one
+  blitz::Array<double,1> half_separations;
+  if(m_assignment_method == HAMERLY) {
+    m_bounds_valid = m_bounds_valid && m_closest_means.size() == n_samples &&
+      bob::core::array::hasSameShape(m_bounds_means, means);
+    if(m_bounds_valid) {
+      double max_move = 0., second_max_move = 0.;
+      size_t max_mean = 0;
+      for(size_t j=0; j<n_means; ++j) {
+        const double move = sqrt(blitz::sum(blitz::pow2(
+          means((int)j,a) - m_bounds_means((int)j,a))));
+        if(move > max_move) {
+          second_max_move = max_move;
+          max_move = move;
+          max_mean = j;
+        }
+        else if(move > second_max_move)
+          second_max_move = move;
+      }
+      for(size_t i=0; i<n_samples; ++i)
+        m_lower_bounds(i) -= (m_closest_means[i] == max_mean ? 
+          second_max_move : max_move);
+    }
+    else {
+      m_closest_means.resize(n_samples);
+      m_lower_bounds.resize(n_samples);
+    }
+    half_separations.resize(n_means);
+    half_separations = std::numeric_limits<double>::max();
+    for(size_t j=0; j<n_means; ++j)
+      for(size_t k=j+1; k<n_means; ++k) {
+        const double h = 0.5 * sqrt(kmeans.getDistanceFromMean(means((int)k,a), j));
+        half_separations(j) = std::min(half_separations(j), h);
+        half_separations(k) = std::min(half_separations(k), h);
+      }
+  }
+
+  const size_t n_threads = bob::core::getNThreads(m_n_threads, n_samples);
+  std::vector<KMeansShard> shards(n_threads);
+  if(n_threads == 1) {
+    // accumulates directly into the members
+    shards[0].distance = 0.;
+    shards[0].zeroeth.reference(m_zeroethOrderStats);
+    shards[0].first.reference(m_firstOrderStats);
+  }
+  else {
+    // getClosestMean() is const and does not touch any cache: the machine
+    // can be shared by all the threads, each thread has its own statistics
+    for(size_t t=0; t<n_threads; ++t) {
+      shards[t].distance = 0.;
+      shards[t].zeroeth.resize(m_zeroethOrderStats.shape());
+      shards[t].zeroeth = 0.;
+      shards[t].first.resize(m_firstOrderStats.shape());
+      shards[t].first = 0.;
+    }
+  }
+  KMeansShardAccumulator acc = {&kmeans, &ar, m_assignment_method, &shards,
+    m_bounds_valid, 
+    (m_assignment_method == HAMERLY && n_samples > 0 ? &m_closest_means[0] : 0),
+    m_lower_bounds.data(), half_separations.data()};
+  bob::core::parallelFor(n_samples, n_threads, acc);
+
+  // merge in shard order, for reproducible results
+  if(n_threads == 1)
+    m_average_min_distance += shards[0].distance;
+  else {
+    for(size_t t=0; t<n_threads; ++t) {
+      m_average_min_distance += shards[t].distance;
+      m_zeroethOrderStats += shards[t].zeroeth;
+      m_firstOrderStats += shards[t].first;
+    }
   }
   m_average_min_distance /= static_cast<double>(ar.extent(0));
+
+  if(m_assignment_method == HAMERLY) {
+    m_bounds_means.resize(means.shape());
+    m_bounds_means = means;
+    m_bounds_valid = true;
+  }
 }
 
 void bob::trainer::KMeansTrainer::mStep(bob::machine::KMeansMachine& kmeans, 
@@ -229,6 +432,12 @@ double bob::trainer::KMeansTrainer::computeLikelihood(bob::machine::KMeansMachin
 void bob::trainer::KMeansTrainer::finalization(bob::machine::KMeansMachine& kmeans,
   const blitz::Array<double,2>& ar) 
 {
+  resetBounds();
+}
+
+void bob::trainer::KMeansTrainer::resetBounds()
+{
+  m_bounds_valid = false;
 }
 
 bool bob::trainer::KMeansTrainer::resetAccumulators(bob::machine::KMeansMachine& kmeans)
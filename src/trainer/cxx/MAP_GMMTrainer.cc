@@ -48,6 +48,7 @@ void train::MAP_GMMTrainer::initialization(mach::GMMMachine& gmm, const blitz::A
     gmm.getGaussian(i)->updateVariance() = m_prior_gmm->getGaussian(i)->getVariance();
     gmm.getGaussian(i)->applyVarianceThresholds();
   }
+  gmm.updateCacheSupervectors();
   // Initializes cache
   m_cache_alpha.resize(n_gaussians);
   m_cache_ml_weights.resize(n_gaussians);
@@ -135,4 +136,7 @@ void train::MAP_GMMTrainer::mStep(mach::GMMMachine& gmm, const blitz::Array<doub
       gmm.getGaussian(i)->applyVarianceThresholds();
     }
   }
+
+  // The components were updated in place
+  gmm.updateCacheSupervectors();
 }
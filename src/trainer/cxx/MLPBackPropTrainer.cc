@@ -23,6 +23,7 @@
 #include <algorithm>
 #include "bob/core/array_check.h"
 #include "bob/math/linear.h"
+#include "bob/math/gemm.h"
 #include "bob/machine/MLPException.h"
 #include "bob/trainer/Exception.h"
 #include "bob/trainer/MLPBackPropTrainer.h"
@@ -44,8 +45,7 @@ train::MLPBackPropTrainer::MLPBackPropTrainer(const mach::MLP& machine,
   m_delta_bias(m_H + 1),
   m_prev_delta(m_H + 1),
   m_prev_delta_bias(m_H + 1),
-  m_actfun(machine.getActivationFunction()),
-  m_bwdfun(),
+  m_activation(machine.getActivation()),
   m_target(),
   m_error(m_H + 1),
   m_output(m_H + 2)
@@ -64,18 +64,13 @@ train::MLPBackPropTrainer::MLPBackPropTrainer(const mach::MLP& machine,
 
   reset();
 
-  switch (machine.getActivation()) {
+  switch (m_activation) {
     case mach::LINEAR:
-      m_bwdfun = mach::linear_derivative;
-      break;
     case mach::TANH:
-      m_bwdfun = mach::tanh_derivative;
-      break;
     case mach::LOG:
-      m_bwdfun = mach::logistic_derivative;
       break;
     default:
-      throw mach::UnsupportedActivation(machine.getActivation());
+      throw mach::UnsupportedActivation(m_activation);
   }
 
   setBatchSize(batch_size);
@@ -94,8 +89,7 @@ train::MLPBackPropTrainer::MLPBackPropTrainer(const MLPBackPropTrainer& other):
   m_delta_bias(m_H + 1),
   m_prev_delta(m_H + 1),
   m_prev_delta_bias(m_H + 1),
-  m_actfun(other.m_actfun),
-  m_bwdfun(other.m_bwdfun),
+  m_activation(other.m_activation),
   m_target(bob::core::array::ccopy(other.m_target)),
   m_error(m_H + 1),
   m_output(m_H + 2)
@@ -123,8 +117,7 @@ train::MLPBackPropTrainer& train::MLPBackPropTrainer::operator=
   m_delta_bias.resize(m_H + 1);
   m_prev_delta.resize(m_H + 1);
   m_prev_delta_bias.resize(m_H + 1);
-  m_actfun = other.m_actfun;
-  m_bwdfun = other.m_bwdfun;
+  m_activation = other.m_activation;
   m_target.reference(bob::core::array::ccopy(other.m_target));
   m_error.resize(m_H + 1);
   m_output.resize(m_H + 2);
@@ -186,42 +179,28 @@ bool train::MLPBackPropTrainer::isCompatible(const mach::MLP& machine) const
 }
 
 void train::MLPBackPropTrainer::forward_step() {
-  size_t batch_size = m_target.extent(0);
   for (size_t k=0; k<m_weight_ref.size(); ++k) { //for all layers
-    math::prod_(m_output[k], m_weight_ref[k], m_output[k+1]);
-    for (int i=0; i<(int)batch_size; ++i) { //for every example
-      for (int j=0; j<m_output[k+1].extent(1); ++j) { //for all variables
-        m_output[k+1](i,j) = m_actfun(m_output[k+1](i,j) + m_bias_ref[k](j));
-      }
-    }
+    math::gemm_(m_output[k], m_weight_ref[k], m_output[k+1]);
+    mach::activate(m_activation, m_bias_ref[k], m_output[k+1]);
   }
 }
 
 void train::MLPBackPropTrainer::backward_step() {
-  size_t batch_size = m_target.extent(0);
   //last layer
   m_error[m_H] = m_target - m_output.back();
-  for (int i=0; i<(int)batch_size; ++i) { //for every example
-    for (int j=0; j<m_error[m_H].extent(1); ++j) { //for all variables
-      m_error[m_H](i,j) *= m_bwdfun(m_output[m_H+1](i,j));
-    }
-  }
+  mach::multiplyByDerivative(m_activation, m_output[m_H+1], m_error[m_H]);
 
   //all other layers
   for (size_t k=m_H; k>0; --k) {
-    math::prod_(m_error[k], m_weight_ref[k].transpose(1,0), m_error[k-1]);
-    for (int i=0; i<(int)batch_size; ++i) { //for every example
-      for (int j=0; j<m_error[k-1].extent(1); ++j) { //for all variables
-        m_error[k-1](i,j) *= m_bwdfun(m_output[k](i,j));
-      }
-    }
+    math::gemm_(m_error[k], m_weight_ref[k], m_error[k-1], false, true);
+    mach::multiplyByDerivative(m_activation, m_output[k], m_error[k-1]);
   }
 }
 
 void train::MLPBackPropTrainer::backprop_weight_update() {
   size_t batch_size = m_target.extent(0);
   for (size_t k=0; k<m_weight_ref.size(); ++k) { //for all layers
-    math::prod_(m_output[k].transpose(1,0), m_error[k], m_delta[k]);
+    math::gemm_(m_output[k], m_error[k], m_delta[k], true, false);
     m_delta[k] *= m_learning_rate / batch_size;
     m_weight_ref[k] += ((1-m_momentum)*m_delta[k]) + 
       (m_momentum*m_prev_delta[k]);
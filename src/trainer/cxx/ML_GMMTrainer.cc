@@ -87,5 +87,8 @@ void train::ML_GMMTrainer::mStep(mach::GMMMachine& gmm, const blitz::Array<doubl
       gmm.getGaussian(i)->applyVarianceThresholds();
     }
   }
+
+  // The components were updated in place
+  gmm.updateCacheSupervectors();
 }
 
@@ -0,0 +1,123 @@
+/**
+ * @file trainer/cxx/MiniBatchKMeansTrainer.cc
+ * @date Fri 16 Oct 2026 13:21:40 CEST
+ * @author agent <agent@local>
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bob/trainer/MiniBatchKMeansTrainer.h"
+#include "bob/core/array_assert.h"
+#include "bob/core/array_copy.h"
+#include <boost/random.hpp>
+
+bob::trainer::MiniBatchKMeansTrainer::MiniBatchKMeansTrainer(size_t batch_size,
+    size_t max_iterations):
+  m_batch_size(batch_size), m_max_iterations(max_iterations), m_seed(-1),
+  m_counts(0)
+{
+}
+
+bob::trainer::MiniBatchKMeansTrainer::MiniBatchKMeansTrainer(
+    const bob::trainer::MiniBatchKMeansTrainer& other):
+  m_batch_size(other.m_batch_size), m_max_iterations(other.m_max_iterations),
+  m_seed(other.m_seed), m_counts(bob::core::array::ccopy(other.m_counts))
+{
+}
+
+bob::trainer::MiniBatchKMeansTrainer& bob::trainer::MiniBatchKMeansTrainer::operator=
+(const bob::trainer::MiniBatchKMeansTrainer& other)
+{
+  if(this != &other)
+  {
+    m_batch_size = other.m_batch_size;
+    m_max_iterations = other.m_max_iterations;
+    m_seed = other.m_seed;
+    m_counts.reference(bob::core::array::ccopy(other.m_counts));
+  }
+  return *this;
+}
+
+bool bob::trainer::MiniBatchKMeansTrainer::operator==(const bob::trainer::MiniBatchKMeansTrainer& b) const {
+  return m_batch_size == b.m_batch_size &&
+         m_max_iterations == b.m_max_iterations && m_seed == b.m_seed &&
+         bob::core::array::hasSameShape(m_counts, b.m_counts) &&
+         blitz::all(m_counts == b.m_counts);
+}
+
+bool bob::trainer::MiniBatchKMeansTrainer::operator!=(const bob::trainer::MiniBatchKMeansTrainer& b) const {
+  return !(this->operator==(b));
+}
+
+void bob::trainer::MiniBatchKMeansTrainer::reset()
+{
+  m_counts = 0.;
+}
+
+void bob::trainer::MiniBatchKMeansTrainer::train(bob::machine::KMeansMachine& kmeans,
+  const blitz::Array<double,2>& data)
+{
+  bob::core::array::assertSameDimensionLength(data.extent(1), kmeans.getNInputs());
+  m_counts.resize(kmeans.getNMeans());
+  reset();
+  if(data.extent(0) == 0) return;
+
+  boost::mt19937 rng;
+  if(m_seed != -1) rng.seed((uint32_t)m_seed);
+  boost::uniform_int<> range(0, data.extent(0)-1);
+  boost::variate_generator<boost::mt19937&, boost::uniform_int<> > die(rng, range);
+
+  blitz::Range a = blitz::Range::all();
+  blitz::Array<double,2> batch(m_batch_size, kmeans.getNInputs());
+  for(size_t iter=0; iter<m_max_iterations; ++iter) {
+    for(size_t n=0; n<m_batch_size; ++n)
+      batch((int)n,a) = data(die(),a);
+    update(kmeans, batch);
+  }
+}
+
+void bob::trainer::MiniBatchKMeansTrainer::update(bob::machine::KMeansMachine& kmeans,
+  const blitz::Array<double,2>& batch)
+{
+  bob::core::array::assertSameDimensionLength(batch.extent(1), kmeans.getNInputs());
+  const int n_means = kmeans.getNMeans();
+  const int n_samples = batch.extent(0);
+  if(m_counts.extent(0) != n_means) {
+    m_counts.resize(n_means);
+    reset();
+  }
+
+  // Finds the closest mean of all the samples of the batch first
+  m_cache_distances.resize(n_samples, n_means);
+  m_cache_closest_means.resize(n_samples);
+  kmeans.getDistancesFromMeans_(batch, m_cache_distances);
+  for(int n=0; n<n_samples; ++n) {
+    size_t closest_mean = 0;
+    for(int j=1; j<n_means; ++j)
+      if(m_cache_distances(n,j) < m_cache_distances(n,(int)closest_mean))
+        closest_mean = j;
+    m_cache_closest_means[n] = closest_mean;
+  }
+
+  // Then moves each mean towards its samples, with a per-mean learning rate
+  blitz::Array<double,2>& means = kmeans.updateMeans();
+  blitz::Range a = blitz::Range::all();
+  for(int n=0; n<n_samples; ++n) {
+    const int j = m_cache_closest_means[n];
+    m_counts(j) += 1.;
+    const double eta = 1. / m_counts(j);
+    means(j,a) = (1. - eta) * means(j,a) + eta * batch(n,a);
+  }
+}
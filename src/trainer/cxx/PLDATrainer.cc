@@ -31,6 +31,7 @@
 #include "bob/math/inv.h"
 #include "bob/math/svd.h"
 #include "bob/trainer/Exception.h"
+#include "bob/core/parallel.h"
 
 
 bob::trainer::PLDABaseTrainer::PLDABaseTrainer(double convergence_threshold, 
@@ -55,8 +56,7 @@ bob::trainer::PLDABaseTrainer::PLDABaseTrainer(double convergence_threshold,
 
 bob::trainer::PLDABaseTrainer::PLDABaseTrainer(const bob::trainer::PLDABaseTrainer& other):
   EMTrainer<bob::machine::PLDABaseMachine, std::vector<blitz::Array<double,2> > >
-    (other.m_convergence_threshold, other.m_max_iterations, 
-     other.m_compute_likelihood),
+    (other),
   m_dim_f(other.m_dim_f), m_dim_g(other.m_dim_g), 
   m_use_sum_second_order(other.m_use_sum_second_order),
   m_S(bob::core::array::ccopy(other.m_S)),
@@ -472,99 +472,224 @@ void bob::trainer::PLDABaseTrainer::initSigma(bob::machine::PLDABaseMachine& mac
   machine.applyVarianceThresholds();
 }
 
+namespace {
+  /**
+   * E-step of a contiguous shard of the identities. The latent variables of
+   * an identity only depend on its own samples and on the current F, G and
+   * sigma: each thread has its own scratch arrays and sum of the second
+   * order statistics. The samples and the arrays shared by all the threads
+   * are read element-wise or through index expressions, as slicing or
+   * transposing them would update their reference counts concurrently.
+   */
+  struct PLDAEStep {
+    const std::vector<blitz::Array<double,2> >* v_ar;
+    const blitz::Array<double,1>* mu;
+    const blitz::Array<double,2>* alpha;
+    const blitz::Array<double,2>* F;
+    const blitz::Array<double,2>* FtBeta;
+    const blitz::Array<double,2>* GtISigma;
+    const std::vector<const blitz::Array<double,2>*>* gamma;
+    const std::vector<const blitz::Array<double,2>*>* zeta;
+    const std::vector<const blitz::Array<double,2>*>* iota;
+    int dim_f;
+    int dim_g;
+    bool use_sum_second_order;
+    std::vector<blitz::Array<double,2> >* z_first_order;
+    std::vector<blitz::Array<double,3> >* z_second_order;
+    std::vector<blitz::Array<double,2> >* sum_z_second_order;
+
+    void operator()(size_t t, size_t start, size_t end) const {
+      const int dim_d = mu->extent(0);
+      blitz::Array<double,1> nf_1(dim_f), nf_2(dim_f), ng_1(dim_g);
+      blitz::Array<double,1> D_1(dim_d), D_2(dim_d);
+      blitz::Array<double,2>& sum_so = (*sum_z_second_order)[t];
+      blitz::Range r1(0, dim_f-1);
+      blitz::Range r2(dim_f, dim_f+dim_g-1);
+      blitz::Array<double,2> z_sum_so_11 = sum_so(r1,r1);
+      blitz::Array<double,2> z_sum_so_12 = sum_so(r1,r2);
+      blitz::Array<double,2> z_sum_so_21 = sum_so(r2,r1);
+      blitz::Array<double,2> z_sum_so_22 = sum_so(r2,r2);
+
+      // blitz indices
+      blitz::firstIndex bi;
+      blitz::secondIndex bj;
+      for(size_t i=start; i<end; ++i)
+      {
+        const blitz::Array<double,2>& x_i = (*v_ar)[i];
+        // Computes expectation of z_ij = [h_i w_ij]
+        // 1/a/ Computes expectation of h_i
+        // Loop over the samples
+        nf_1 = 0.;
+        for(int j=0; j<x_i.extent(0); ++j)
+        {
+          // D_1 = x_sj-mu
+          for(int d=0; d<dim_d; ++d) D_1(d) = x_i(j,d) - (*mu)(d);
+          // nf_2 = F^T.beta.(x_sj-mu)
+          bob::math::prod(*FtBeta, D_1, nf_2);
+          // nf_1 = sum_j F^T.beta.(x_sj-mu)
+          nf_1 += nf_2;
+        }
+        const blitz::Array<double,2>& gamma_a = *(*gamma)[i];
+        // nf_2 = E(h_i) = gamma_A  sum_j F^T.beta.(x_sj-mu)
+        bob::math::prod(gamma_a, nf_1, nf_2);
+
+        // 1/b/ Precomputes: D_2 = F.E{h_i}
+        bob::math::prod(*F, nf_2, D_2);
+
+        // 2/ First and second order statistics of z
+        // Precomputed values 
+        const blitz::Array<double,2>& zeta_a = *(*zeta)[i];
+        const blitz::Array<double,2>& iota_a = *(*iota)[i];
+
+        // Extracts statistics of z_ij = [h_i w_ij] from y_i = [h_i w_i1 ... w_iJ]
+        for(int j=0; j<x_i.extent(0); ++j)
+        {
+          // 1/ First order statistics of z
+          blitz::Array<double,1> z_first_order_ij_1 = (*z_first_order)[i](j,r1);
+          z_first_order_ij_1 = nf_2; // E{h_i}
+          // D_1 = x_sj - mu - F.E{h_i}
+          for(int d=0; d<dim_d; ++d) D_1(d) = x_i(j,d) - (*mu)(d) - D_2(d);
+          // ng_1 = G^T.sigma^-1.(x_sj-mu-fhi)
+          bob::math::prod(*GtISigma, D_1, ng_1);
+          // z_first_order_ij_2 = (Id+G^T.sigma^-1.G)^-1.G^T.sigma^-1.(x_sj-mu) = E{w_ij}
+          blitz::Array<double,1> z_first_order_ij_2 = (*z_first_order)[i](j,r2);
+          bob::math::prod(*alpha, ng_1, z_first_order_ij_2); 
+
+          // 2/ Second order statistics of z
+          if(use_sum_second_order)
+          {
+            z_sum_so_11 += gamma_a + z_first_order_ij_1(bi) * z_first_order_ij_1(bj);
+            z_sum_so_12 += iota_a + z_first_order_ij_1(bi) * z_first_order_ij_2(bj);
+            z_sum_so_21 += iota_a(bj,bi) + z_first_order_ij_2(bi) * z_first_order_ij_1(bj);
+            z_sum_so_22 += zeta_a + z_first_order_ij_2(bi) * z_first_order_ij_2(bj);
+          }
+          else
+          {
+            blitz::Array<double,2> z_so_11 = (*z_second_order)[i](j,r1,r1);
+            z_so_11 = gamma_a + z_first_order_ij_1(bi) * z_first_order_ij_1(bj);
+            z_sum_so_11 += z_so_11;
+            blitz::Array<double,2> z_so_12 = (*z_second_order)[i](j,r1,r2);
+            z_so_12 = iota_a + z_first_order_ij_1(bi) * z_first_order_ij_2(bj);
+            z_sum_so_12 += z_so_12;
+            blitz::Array<double,2> z_so_21 = (*z_second_order)[i](j,r2,r1);
+            z_so_21 = iota_a(bj,bi) + z_first_order_ij_2(bi) * z_first_order_ij_1(bj);
+            z_sum_so_21 += z_so_21;
+            blitz::Array<double,2> z_so_22 = (*z_second_order)[i](j,r2,r2);
+            z_so_22 = zeta_a + z_first_order_ij_2(bi) * z_first_order_ij_2(bj);
+            z_sum_so_22 += z_so_22;
+          }
+        }
+      }
+    }
+  };
+
+  /**
+   * Accumulates sum_ij (x_ij-mu).E{z_ij}^T over a shard of the identities
+   */
+  struct PLDAFGAccumulator {
+    const std::vector<blitz::Array<double,2> >* v_ar;
+    const blitz::Array<double,1>* mu;
+    const std::vector<blitz::Array<double,2> >* z_first_order;
+    std::vector<blitz::Array<double,2> >* acc;
+
+    void operator()(size_t t, size_t start, size_t end) const {
+      blitz::Array<double,2>& D_nfng_2 = (*acc)[t];
+      blitz::Array<double,1> D_1(mu->extent(0));
+      blitz::Array<double,2> D_nfng_1(D_nfng_2.extent(0), D_nfng_2.extent(1));
+      blitz::Range a = blitz::Range::all();
+      for(size_t i=start; i<end; ++i)
+      {
+        const blitz::Array<double,2>& x_i = (*v_ar)[i];
+        // Loop over the samples
+        for(int j=0; j<x_i.extent(0); ++j)
+        {
+          // D_1 = x_sj-mu
+          for(int d=0; d<D_1.extent(0); ++d) D_1(d) = x_i(j,d) - (*mu)(d);
+          // z_first_order_ij = E{z_ij}
+          blitz::Array<double,1> z_first_order_ij = (*z_first_order)[i](j, a);
+          // D_nfng_1 = (x_sj-mu).E{z_ij}^T
+          bob::math::prod(D_1, z_first_order_ij, D_nfng_1);
+          D_nfng_2 += D_nfng_1;
+        }
+      }
+    }
+  };
+
+  /**
+   * Accumulates sum_ij Diag{(x_ij-mu).(x_ij-mu)^T - B.E{z_i}.(x_ij-mu)^T}
+   * over a shard of the identities
+   */
+  struct PLDASigmaAccumulator {
+    const std::vector<blitz::Array<double,2> >* v_ar;
+    const blitz::Array<double,1>* mu;
+    const blitz::Array<double,2>* B;
+    const std::vector<blitz::Array<double,2> >* z_first_order;
+    std::vector<blitz::Array<double,1> >* acc;
+
+    void operator()(size_t t, size_t start, size_t end) const {
+      blitz::Array<double,1>& sigma = (*acc)[t];
+      blitz::Array<double,1> D_1(mu->extent(0)), D_2(mu->extent(0));
+      blitz::Range a = blitz::Range::all();
+      for(size_t i=start; i<end; ++i)
+      {
+        const blitz::Array<double,2>& x_i = (*v_ar)[i];
+        // Loop over the samples
+        for(int j=0; j<x_i.extent(0); ++j)
+        {
+          // D_1 = x_ij-mu
+          for(int d=0; d<D_1.extent(0); ++d) D_1(d) = x_i(j,d) - (*mu)(d);
+          // sigma += Diag{(x_ij-mu).(x_ij-mu)^T}
+          sigma += blitz::pow2(D_1);
+
+          // z_first_order_ij = E{z_ij}
+          blitz::Array<double,1> z_first_order_ij = (*z_first_order)[i](j,a);
+          // D_2 = B.E{z_ij}
+          bob::math::prod(*B, z_first_order_ij, D_2);
+          // sigma -= Diag{B.E{z_ij}.(x_ij-mu)
+          sigma -= (D_1 * D_2);
+        }
+      }
+    }
+  };
+}
+
 void bob::trainer::PLDABaseTrainer::eStep(bob::machine::PLDABaseMachine& machine, 
   const std::vector<blitz::Array<double,2> >& v_ar)
 {  
   // Precomputes useful variables using current estimates of F,G, and sigma
   precomputeFromFGSigma(machine);
-  // Gets the mean mu from the machine
-  const blitz::Array<double,1>& mu = machine.getMu();
-  const blitz::Array<double,2>& alpha = machine.getAlpha();
-  const blitz::Array<double,2>& F = machine.getF();
-  const blitz::Array<double,2>& FtBeta = machine.getFtBeta();
-  const blitz::Array<double,2>& GtISigma = machine.getGtISigma();
-  blitz::Range a = blitz::Range::all();
 
-  // blitz indices
-  blitz::firstIndex bi;
-  blitz::secondIndex bj;
-  // Initializes sum of z second order statistics to 0
-  m_sum_z_second_order = 0.;
+  // Looks up the gamma_a, zeta_a and iota_a of each identity beforehand, 
+  // as the maps they are stored into can not be accessed concurrently
+  std::vector<const blitz::Array<double,2>*> gamma(v_ar.size());
+  std::vector<const blitz::Array<double,2>*> zeta(v_ar.size());
+  std::vector<const blitz::Array<double,2>*> iota(v_ar.size());
   for(size_t i=0; i<v_ar.size(); ++i)
   {
-    // Computes expectation of z_ij = [h_i w_ij]
-    // 1/a/ Computes expectation of h_i
-    // Loop over the samples
-    m_cache_nf_1 = 0.;
-    for(int j=0; j<v_ar[i].extent(0); ++j)
-    {
-      // m_cache_D_1 = x_sj-mu
-      m_cache_D_1 = v_ar[i](j,a) - mu;
+    const size_t n_i = v_ar[i].extent(0);
+    gamma[i] = &machine.getAddGamma(n_i);
+    zeta[i] = &m_zeta[n_i];
+    iota[i] = &m_iota[n_i];
+  }
 
-      // m_cache_nf_2 = F^T.beta.(x_sj-mu)
-      bob::math::prod(FtBeta, m_cache_D_1, m_cache_nf_2);
-      // m_cache_nf_1 = sum_j F^T.beta.(x_sj-mu)
-      m_cache_nf_1 += m_cache_nf_2;
-    }
-    const blitz::Array<double,2>& gamma_a = machine.getAddGamma(v_ar[i].extent(0));
-    blitz::Range r_hi(0, (int)m_dim_f-1);
-    // m_cache_nf_2 = E(h_i) = gamma_A  sum_j F^T.beta.(x_sj-mu)
-    bob::math::prod(gamma_a, m_cache_nf_1, m_cache_nf_2);
-
-    // 1/b/ Precomputes: m_cache_D_2 = F.E{h_i}
-    bob::math::prod(F, m_cache_nf_2, m_cache_D_2);
-
-    // 2/ First and second order statistics of z
-    // Precomputed values 
-    blitz::Array<double,2>& zeta_a = m_zeta[v_ar[i].extent(0)];
-    blitz::Array<double,2>& iota_a = m_iota[v_ar[i].extent(0)];
-    blitz::Array<double,2> iotat_a = iota_a.transpose(1,0);
-
-    // Extracts statistics of z_ij = [h_i w_ij] from y_i = [h_i w_i1 ... w_iJ]
-    blitz::Range r1(0, (int)m_dim_f-1);
-    blitz::Range r2((int)m_dim_f, (int)m_dim_f+(int)m_dim_g-1);
-    for(int j=0; j<v_ar[i].extent(0); ++j)
-    {
-      // 1/ First order statistics of z
-      blitz::Array<double,1> z_first_order_ij_1 = m_z_first_order[i](j,r1);
-      z_first_order_ij_1 = m_cache_nf_2; // E{h_i}
-      // m_cache_D_1 = x_sj - mu - F.E{h_i}
-      m_cache_D_1 = v_ar[i](j,a) - mu - m_cache_D_2;
-      // m_cache_ng_1 = G^T.sigma^-1.(x_sj-mu-fhi)
-      bob::math::prod(GtISigma, m_cache_D_1, m_cache_ng_1);
-      // z_first_order_ij_2 = (Id+G^T.sigma^-1.G)^-1.G^T.sigma^-1.(x_sj-mu) = E{w_ij}
-      blitz::Array<double,1> z_first_order_ij_2 = m_z_first_order[i](j,r2);
-      bob::math::prod(alpha, m_cache_ng_1, z_first_order_ij_2); 
-
-      // 2/ Second order statistics of z
-      blitz::Array<double,2> z_sum_so_11 = m_sum_z_second_order(r1,r1);
-      blitz::Array<double,2> z_sum_so_12 = m_sum_z_second_order(r1,r2);
-      blitz::Array<double,2> z_sum_so_21 = m_sum_z_second_order(r2,r1);
-      blitz::Array<double,2> z_sum_so_22 = m_sum_z_second_order(r2,r2);
-      if(m_use_sum_second_order)
-      {
-        z_sum_so_11 += gamma_a + z_first_order_ij_1(bi) * z_first_order_ij_1(bj);
-        z_sum_so_12 += iota_a + z_first_order_ij_1(bi) * z_first_order_ij_2(bj);
-        z_sum_so_21 += iotat_a + z_first_order_ij_2(bi) * z_first_order_ij_1(bj);
-        z_sum_so_22 += zeta_a + z_first_order_ij_2(bi) * z_first_order_ij_2(bj);
-      }
-      else
-      {
-        blitz::Array<double,2> z_so_11 = m_z_second_order[i](j,r1,r1);
-        z_so_11 = gamma_a + z_first_order_ij_1(bi) * z_first_order_ij_1(bj);
-        z_sum_so_11 += z_so_11;
-        blitz::Array<double,2> z_so_12 = m_z_second_order[i](j,r1,r2);
-        z_so_12 = iota_a + z_first_order_ij_1(bi) * z_first_order_ij_2(bj);
-        z_sum_so_12 += z_so_12;
-        blitz::Array<double,2> z_so_21 = m_z_second_order[i](j,r2,r1);
-        z_so_21 = iotat_a + z_first_order_ij_2(bi) * z_first_order_ij_1(bj);
-        z_sum_so_21 += z_so_21;
-        blitz::Array<double,2> z_so_22 = m_z_second_order[i](j,r2,r2);
-        z_so_22 = zeta_a + z_first_order_ij_2(bi) * z_first_order_ij_2(bj);
-        z_sum_so_22 += z_so_22;
-      }
-    }
+  // Each thread accumulates its own sum of the z second order statistics,
+  // which are merged in shard order
+  const size_t n_threads = bob::core::getNThreads(m_n_threads, v_ar.size());
+  std::vector<blitz::Array<double,2> > sum_so(n_threads);
+  for(size_t t=0; t<n_threads; ++t)
+  {
+    sum_so[t].resize(m_sum_z_second_order.shape());
+    sum_so[t] = 0.;
   }
+
+  PLDAEStep step = {&v_ar, &machine.getMu(), &machine.getAlpha(), 
+    &machine.getF(), &machine.getFtBeta(), &machine.getGtISigma(),
+    &gamma, &zeta, &iota, (int)m_dim_f, (int)m_dim_g, 
+    m_use_sum_second_order, &m_z_first_order, &m_z_second_order, &sum_so};
+  bob::core::parallelFor(v_ar.size(), m_n_threads, step);
+
+  m_sum_z_second_order = 0.;
+  for(size_t t=0; t<n_threads; ++t) m_sum_z_second_order += sum_so[t];
 }
 
 void bob::trainer::PLDABaseTrainer::precomputeFromFGSigma(bob::machine::PLDABaseMachine& machine)
@@ -654,25 +779,19 @@ void bob::trainer::PLDABaseTrainer::updateFG(bob::machine::PLDABaseMachine& mach
   /// Computes the B matrix (B = [F G])
   /// B = (sum_ij (x_ij-mu).E{z_i}^T).(sum_ij E{z_i.z_i^T})^-1
 
-  // 1/ Computes the numerator (sum_ij (x_ij-mu).E{z_i}^T)
-  // Gets the mean mu from the machine
-  const blitz::Array<double,1>& mu = machine.getMu();
-  blitz::Range a = blitz::Range::all();
-  m_cache_D_nfng_2 = 0.;
-  for(size_t i=0; i<v_ar.size(); ++i)
+  // 1/ Computes the numerator (sum_ij (x_ij-mu).E{z_i}^T), each thread
+  //    accumulating over a shard of the identities
+  const size_t n_threads = bob::core::getNThreads(m_n_threads, v_ar.size());
+  std::vector<blitz::Array<double,2> > acc(n_threads);
+  for(size_t t=0; t<n_threads; ++t)
   {
-    // Loop over the samples
-    for(int j=0; j<v_ar[i].extent(0); ++j)
-    {
-      // m_cache_D_1 = x_sj-mu
-      m_cache_D_1 = v_ar[i](j,a) - mu;
-      // z_first_order_ij = E{z_ij}
-      blitz::Array<double,1> z_first_order_ij = m_z_first_order[i](j, a);
-      // m_cache_D_nfng_1 = (x_sj-mu).E{z_ij}^T
-      bob::math::prod(m_cache_D_1, z_first_order_ij, m_cache_D_nfng_1);
-      m_cache_D_nfng_2 += m_cache_D_nfng_1;
-    }
+    acc[t].resize(m_cache_D_nfng_2.shape());
+    acc[t] = 0.;
   }
+  PLDAFGAccumulator f = {&v_ar, &machine.getMu(), &m_z_first_order, &acc};
+  bob::core::parallelFor(v_ar.size(), m_n_threads, f);
+  m_cache_D_nfng_2 = 0.;
+  for(size_t t=0; t<n_threads; ++t) m_cache_D_nfng_2 += acc[t];
 
   // 2/ Computes the denominator inv(sum_ij E{z_i.z_i^T})
   bob::math::inv(m_sum_z_second_order, m_cache_nfng_nfng);
@@ -697,30 +816,23 @@ void bob::trainer::PLDABaseTrainer::updateSigma(bob::machine::PLDABaseMachine& m
 
   // Gets the mean mu and the matrix sigma from the machine
   blitz::Array<double,1>& sigma = machine.updateSigma();
-  const blitz::Array<double,1>& mu = machine.getMu();
-  blitz::Range a = blitz::Range::all();
 
-  sigma = 0.;
-  size_t n_IJ=0; /// counts the number of samples
-  for(size_t i=0; i<v_ar.size(); ++i)
+  // Each thread accumulates over a shard of the identities
+  const size_t n_threads = bob::core::getNThreads(m_n_threads, v_ar.size());
+  std::vector<blitz::Array<double,1> > acc(n_threads);
+  for(size_t t=0; t<n_threads; ++t)
   {
-    // Loop over the samples
-    for(int j=0; j<v_ar[i].extent(0); ++j)
-    {
-      // m_cache_D_1 = x_ij-mu
-      m_cache_D_1 = v_ar[i](j,a) - mu;
-      // sigma += Diag{(x_ij-mu).(x_ij-mu)^T}
-      sigma += blitz::pow2(m_cache_D_1);
-
-      // z_first_order_ij = E{z_ij}
-      blitz::Array<double,1> z_first_order_ij = m_z_first_order[i](j,a);
-      // m_cache_D_2 = B.E{z_ij}
-      bob::math::prod(m_B, z_first_order_ij, m_cache_D_2);
-      // sigma -= Diag{B.E{z_ij}.(x_ij-mu)
-      sigma -= (m_cache_D_1 * m_cache_D_2);
-      ++n_IJ;
-    }
+    acc[t].resize(sigma.shape());
+    acc[t] = 0.;
   }
+  PLDASigmaAccumulator f = {&v_ar, &machine.getMu(), &m_B, &m_z_first_order, 
+    &acc};
+  bob::core::parallelFor(v_ar.size(), m_n_threads, f);
+
+  sigma = 0.;
+  for(size_t t=0; t<n_threads; ++t) sigma += acc[t];
+  size_t n_IJ=0; /// counts the number of samples
+  for(size_t i=0; i<v_ar.size(); ++i) n_IJ += v_ar[i].extent(0);
   // Normalizes by the number of samples
   sigma /= static_cast<double>(n_IJ);
   // Apply variance threshold
@@ -0,0 +1,155 @@
+/**
+ * @file trainer/cxx/test/plda.cc
+ * @date Fri 16 Oct 2026 23:57:31 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Tests the multi-threaded E-step and training of the PLDA base
+ * trainer against the single-threaded ones
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Trainer-plda Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/random.hpp>
+#include <blitz/array.h>
+#include <vector>
+
+#include "bob/trainer/PLDATrainer.h"
+#include "bob/machine/PLDAMachine.h"
+
+static const int DIM_D = 7;
+static const int DIM_F = 3;
+static const int DIM_G = 2;
+static const int N_IDENTITIES = 41;
+
+struct T {
+  double epsilon;
+  std::vector<blitz::Array<double,2> > data;
+
+  T(): epsilon(1e-10) {
+    boost::mt19937 rng;
+    boost::normal_distribution<double> normal;
+    boost::variate_generator<boost::mt19937&,
+      boost::normal_distribution<double> > gen(rng, normal);
+    boost::uniform_int<> n_samples(1, 6);
+    for (int i=0; i<N_IDENTITIES; ++i) {
+      // identities with different numbers of samples
+      blitz::Array<double,2> x_i(n_samples(rng), DIM_D);
+      blitz::Array<double,1> identity(DIM_D);
+      for (int d=0; d<DIM_D; ++d) identity(d) = 3. * gen();
+      for (int j=0; j<x_i.extent(0); ++j)
+        for (int d=0; d<DIM_D; ++d) x_i(j,d) = identity(d) + gen();
+      data.push_back(x_i);
+    }
+  }
+};
+
+template <typename U, int N>
+static void check_close(const blitz::Array<U,N>& a,
+    const blitz::Array<U,N>& b, const double epsilon) {
+  BOOST_REQUIRE(a.shape() == b.shape());
+  BOOST_CHECK_SMALL(blitz::max(blitz::abs(a - b)), epsilon);
+}
+
+/**
+ * Runs a single E-step from the same initial machine, with n_threads
+ * threads, and compares the statistics of the latent variables to the
+ * single-threaded ones
+ */
+static void check_estep(T& t, bool use_sum_second_order) {
+  bob::machine::PLDABaseMachine machine(DIM_D, DIM_F, DIM_G);
+  bob::trainer::PLDABaseTrainer ref(0.001, 1, false, use_sum_second_order);
+  ref.setSeed(7);
+  ref.initialization(machine, t.data);
+  const bob::machine::PLDABaseMachine init(machine);
+  ref.eStep(machine, t.data);
+
+  const size_t n_threads[] = {2, 4, 0};
+  for (size_t k=0; k<sizeof(n_threads)/sizeof(n_threads[0]); ++k) {
+    // several times, to give the threads more chances to interfere
+    for (int run=0; run<5; ++run) {
+      bob::machine::PLDABaseMachine m(init);
+      bob::trainer::PLDABaseTrainer trainer(0.001, 1, false,
+        use_sum_second_order);
+      trainer.setSeed(7);
+      trainer.setNThreads(n_threads[k]);
+      trainer.initialization(m, t.data);
+      trainer.eStep(m, t.data);
+
+      // the statistics of an identity only depend on its own samples
+      BOOST_REQUIRE_EQUAL(trainer.getZFirstOrder().size(), t.data.size());
+      for (size_t i=0; i<t.data.size(); ++i) {
+        BOOST_CHECK(blitz::all(trainer.getZFirstOrder()[i] ==
+          ref.getZFirstOrder()[i]));
+        if (!use_sum_second_order)
+          BOOST_CHECK(blitz::all(trainer.getZSecondOrder()[i] ==
+            ref.getZSecondOrder()[i]));
+      }
+      // the sum is accumulated per thread, then reduced
+      check_close(trainer.getZSecondOrderSum(), ref.getZSecondOrderSum(),
+        t.epsilon);
+    }
+  }
+}
+
+/**
+ * Trains a machine with n_threads threads, and compares it to the one
+ * trained with a single thread
+ */
+static void check_train(T& t, bool use_sum_second_order) {
+  bob::machine::PLDABaseMachine ref_machine(DIM_D, DIM_F, DIM_G);
+  bob::trainer::PLDABaseTrainer ref(0.001, 5, false, use_sum_second_order);
+  ref.setSeed(7);
+  ref.train(ref_machine, t.data);
+
+  const size_t n_threads[] = {2, 3, 0};
+  for (size_t k=0; k<sizeof(n_threads)/sizeof(n_threads[0]); ++k) {
+    bob::machine::PLDABaseMachine machine(DIM_D, DIM_F, DIM_G);
+    bob::trainer::PLDABaseTrainer trainer(0.001, 5, false,
+      use_sum_second_order);
+    trainer.setSeed(7);
+    trainer.setNThreads(n_threads[k]);
+    trainer.train(machine, t.data);
+
+    // the sums of the statistics are reduced in another order
+    check_close(machine.getMu(), ref_machine.getMu(), 1e-8);
+    check_close(machine.getF(), ref_machine.getF(), 1e-8);
+    check_close(machine.getG(), ref_machine.getG(), 1e-8);
+    check_close(machine.getSigma(), ref_machine.getSigma(), 1e-8);
+  }
+}
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( test_estep_threads )
+{
+  check_estep(*this, true);
+}
+
+BOOST_AUTO_TEST_CASE( test_estep_threads_second_order )
+{
+  check_estep(*this, false);
+}
+
+BOOST_AUTO_TEST_CASE( test_train_threads )
+{
+  check_train(*this, true);
+  check_train(*this, false);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
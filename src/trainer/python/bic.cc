@@ -20,6 +20,12 @@
 
 #include <boost/python.hpp>
 #include "bob/trainer/BICTrainer.h"
+#include "bob/core/python/gil.h"
+
+static void bic_train(const bob::trainer::BICTrainer& t, bob::machine::BICMachine& machine, const blitz::Array<double,2>& intra_differences, const blitz::Array<double,2>& extra_differences){
+  bob::python::no_gil unlock;
+  t.train(machine, intra_differences, extra_differences);
+}
 
 void bind_trainer_bic(){
 
@@ -44,7 +50,7 @@ void bind_trainer_bic(){
 
     .def(
       "train",
-      &bob::trainer::BICTrainer::train,
+      &bic_train,
       (
           boost::python::arg("machine"),
           boost::python::arg("intra_differences"),
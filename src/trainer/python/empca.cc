@@ -20,15 +20,25 @@
 #include <boost/python.hpp>
 #include "bob/machine/LinearMachine.h"
 #include "bob/trainer/EMPCATrainer.h"
+#include "bob/core/python/gil.h"
 
 using namespace boost::python;
 
 object ppca_train(bob::trainer::EMPCATrainer& t, const blitz::Array<double,2>& data) {
   bob::machine::LinearMachine m;
-  t.train(m, data);
+  {
+    bob::python::no_gil unlock;
+    t.train(m, data);
+  }
   return object(m);
 }
 
+template <typename T, typename M, typename S>
+static void em_train(T& t, M& machine, const S& data) {
+  bob::python::no_gil unlock;
+  t.train(machine, data);
+}
+
 void bind_trainer_empca() {
 
   typedef bob::trainer::EMTrainer<bob::machine::LinearMachine, blitz::Array<double,2> > EMTrainerLinearBase; 
@@ -37,7 +47,7 @@ void bind_trainer_empca() {
     .add_property("convergence_threshold", &EMTrainerLinearBase::getConvergenceThreshold, &EMTrainerLinearBase::setConvergenceThreshold, "Convergence threshold")
     .add_property("max_iterations", &EMTrainerLinearBase::getMaxIterations, &EMTrainerLinearBase::setMaxIterations, "Max iterations")
     .add_property("compute_likelihood_variable", &EMTrainerLinearBase::getComputeLikelihood, &EMTrainerLinearBase::setComputeLikelihood, "Indicates whether the log likelihood should be computed during EM or not")
-    .def("train", &EMTrainerLinearBase::train, (arg("machine"), arg("data")), "Trains a machine using data")
+    .def("train", &em_train<EMTrainerLinearBase, bob::machine::LinearMachine, blitz::Array<double,2> >, (arg("machine"), arg("data")), "Trains a machine using data")
     .def("initialization", &EMTrainerLinearBase::initialization, (arg("machine"), arg("data")), "This method is called before the EM algorithm")
     .def("finalization", &EMTrainerLinearBase::finalization, (arg("machine"), arg("data")), "This method is called at the end of the EM algorithm")
     .def("e_step", &EMTrainerLinearBase::eStep, (arg("machine"), arg("data")),
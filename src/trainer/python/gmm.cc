@@ -21,12 +21,41 @@
 #include "bob/trainer/GMMTrainer.h"
 #include "bob/trainer/MAP_GMMTrainer.h"
 #include "bob/trainer/ML_GMMTrainer.h"
+#include "bob/core/python/gil.h"
 
 using namespace boost::python;
 namespace train = bob::trainer;
 namespace mach = bob::machine;
 namespace io = bob::io;
 
+/**
+ * The EM steps run without the Python GIL: the trainers bound in this module
+ * cannot be extended from Python, so they never call back into it.
+ */
+template <typename T, typename M, typename S>
+static void em_train(T& t, M& machine, const S& data) {
+  bob::python::no_gil unlock;
+  t.train(machine, data);
+}
+
+template <typename T, typename M, typename S>
+static void em_initialization(T& t, M& machine, const S& data) {
+  bob::python::no_gil unlock;
+  t.initialization(machine, data);
+}
+
+template <typename T, typename M, typename S>
+static void em_e_step(T& t, M& machine, const S& data) {
+  bob::python::no_gil unlock;
+  t.eStep(machine, data);
+}
+
+template <typename T, typename M, typename S>
+static void em_m_step(T& t, M& machine, const S& data) {
+  bob::python::no_gil unlock;
+  t.mStep(machine, data);
+}
+
 void bind_trainer_gmm() {
 
   typedef train::EMTrainer<mach::GMMMachine, blitz::Array<double,2> > EMTrainerGMMBase; 
@@ -34,17 +63,18 @@ void bind_trainer_gmm() {
   class_<EMTrainerGMMBase, boost::noncopyable>("EMTrainerGMM", "The base python class for all EM-based trainers.", no_init)
     .add_property("convergence_threshold", &EMTrainerGMMBase::getConvergenceThreshold, &EMTrainerGMMBase::setConvergenceThreshold, "Convergence threshold")
     .add_property("max_iterations", &EMTrainerGMMBase::getMaxIterations, &EMTrainerGMMBase::setMaxIterations, "Max iterations")
-    .def("train", &EMTrainerGMMBase::train, (arg("machine"), arg("data")), "Train a machine using data")
-    .def("initialization", &EMTrainerGMMBase::initialization, (arg("machine"), arg("data")), "This method is called before the EM algorithm")
+    .add_property("n_threads", &EMTrainerGMMBase::getNThreads, &EMTrainerGMMBase::setNThreads, "Number of threads used by the E-step (0 means one per hardware core)")
+    .def("train", &em_train<EMTrainerGMMBase, mach::GMMMachine, blitz::Array<double,2> >, (arg("machine"), arg("data")), "Train a machine using data")
+    .def("initialization", &em_initialization<EMTrainerGMMBase, mach::GMMMachine, blitz::Array<double,2> >, (arg("machine"), arg("data")), "This method is called before the EM algorithm")
     .def("finalization", &EMTrainerGMMBase::finalization, (arg("machine"), arg("data")), "This method is called after the EM algorithm")
-    .def("e_step", &EMTrainerGMMBase::eStep, (arg("machine"), arg("data")),
+    .def("e_step", &em_e_step<EMTrainerGMMBase, mach::GMMMachine, blitz::Array<double,2> >, (arg("machine"), arg("data")),
        "Update the hidden variable distribution (or the sufficient statistics) given the Machine parameters. "
        "Also, calculate the average output of the Machine given these parameters.\n"
        "Return the average output of the Machine across the dataset. "
        "The EM algorithm will terminate once the change in average_output "
        "is less than the convergence_threshold.")
     .def("compute_likelihood", &EMTrainerGMMBase::computeLikelihood, (arg("machine")), "Returns the likelihood.")
-    .def("m_step", &EMTrainerGMMBase::mStep, (arg("machine"), arg("data")), "Update the Machine parameters given the hidden variable distribution (or the sufficient statistics)")
+    .def("m_step", &em_m_step<EMTrainerGMMBase, mach::GMMMachine, blitz::Array<double,2> >, (arg("machine"), arg("data")), "Update the Machine parameters given the hidden variable distribution (or the sufficient statistics)")
   ;
 
   class_<train::GMMTrainer, boost::noncopyable, bases<EMTrainerGMMBase> >("GMMTrainer",
@@ -24,6 +24,7 @@
 #include <boost/python/stl_iterator.hpp>
 #include "bob/trainer/JFATrainer.h"
 #include "bob/machine/JFAMachine.h"
+#include "bob/core/python/gil.h"
 #include <boost/shared_ptr.hpp>
 
 using namespace boost::python;
@@ -77,6 +78,11 @@ static void estimate_zandd(tp::const_ndarray F, tp::const_ndarray N,
       spk_ids.bz<uint32_t,1>());
 }
 
+/**
+ * The GMMStats are extracted while holding the GIL. The returned vectors
+ * keep them alive, so that the trainers never release the last reference
+ * to a Python object while running without the GIL.
+ */
 static void extractGMMStatsVectors(list list_stats, 
   std::vector<std::vector<boost::shared_ptr<const mach::GMMStats> > >& gmm_stats)
 {
@@ -99,6 +105,7 @@ static void jfa_train(train::JFABaseTrainer& t, list list_stats, const size_t n_
   std::vector<std::vector<boost::shared_ptr<const mach::GMMStats> > > gmm_stats;
   extractGMMStatsVectors(list_stats, gmm_stats);
   // Calls the train function
+  tp::no_gil unlock;
   t.train(gmm_stats, n_iter);
 }
 
@@ -107,6 +114,7 @@ static void jfa_train_noinit(train::JFABaseTrainer& t, list list_stats, const si
   std::vector<std::vector<boost::shared_ptr<const mach::GMMStats> > > gmm_stats;
   extractGMMStatsVectors(list_stats, gmm_stats);
   // Calls the train function
+  tp::no_gil unlock;
   t.trainNoInit(gmm_stats, n_iter);
 }
 
@@ -117,6 +125,7 @@ static void jfa_train_ISV(train::JFABaseTrainer& t, list list_stats,
   std::vector<std::vector<boost::shared_ptr<const mach::GMMStats> > > gmm_stats;
   extractGMMStatsVectors(list_stats, gmm_stats);
   // Calls the train function
+  tp::no_gil unlock;
   t.trainISV(gmm_stats, n_iter, relevance_factor);
 }
 
@@ -126,6 +135,7 @@ static void jfa_train_ISV_noinit(train::JFABaseTrainer& t, list list_stats,
   std::vector<std::vector<boost::shared_ptr<const mach::GMMStats> > > gmm_stats;
   extractGMMStatsVectors(list_stats, gmm_stats);
   // Calls the train function
+  tp::no_gil unlock;
   t.trainISVNoInit(gmm_stats, n_iter, relevance_factor);
 }
 
@@ -140,6 +150,7 @@ static void jfa_enrol(train::JFATrainer& t, list stats, const size_t n_iter)
   }
 
   // Calls the enrol function
+  tp::no_gil unlock;
   t.enrol(gmm_stats, n_iter);
 }
 
@@ -225,6 +236,7 @@ static void jfa_updateX(train::JFABaseTrainer& t, list list_stats)
   std::vector<std::vector<boost::shared_ptr<const mach::GMMStats> > > gmm_stats;
   extractGMMStatsVectors(list_stats, gmm_stats);
   // Calls the train function
+  tp::no_gil unlock;
   t.updateX(gmm_stats);
 }
 
@@ -233,6 +245,7 @@ static void jfa_updateY(train::JFABaseTrainer& t, list list_stats)
   std::vector<std::vector<boost::shared_ptr<const mach::GMMStats> > > gmm_stats;
   extractGMMStatsVectors(list_stats, gmm_stats);
   // Calls the train function
+  tp::no_gil unlock;
   t.updateY(gmm_stats);
 }
 
@@ -241,6 +254,7 @@ static void jfa_updateZ(train::JFABaseTrainer& t, list list_stats)
   std::vector<std::vector<boost::shared_ptr<const mach::GMMStats> > > gmm_stats;
   extractGMMStatsVectors(list_stats, gmm_stats);
   // Calls the train function
+  tp::no_gil unlock;
   t.updateZ(gmm_stats);
 }
 
@@ -249,6 +263,7 @@ static void jfa_updateU(train::JFABaseTrainer& t, list list_stats)
   std::vector<std::vector<boost::shared_ptr<const mach::GMMStats> > > gmm_stats;
   extractGMMStatsVectors(list_stats, gmm_stats);
   // Calls the train function
+  tp::no_gil unlock;
   t.updateU(gmm_stats);
 }
 
@@ -257,6 +272,7 @@ static void jfa_updateV(train::JFABaseTrainer& t, list list_stats)
   std::vector<std::vector<boost::shared_ptr<const mach::GMMStats> > > gmm_stats;
   extractGMMStatsVectors(list_stats, gmm_stats);
   // Calls the train function
+  tp::no_gil unlock;
   t.updateV(gmm_stats);
 }
 
@@ -265,6 +281,7 @@ static void jfa_updateD(train::JFABaseTrainer& t, list list_stats)
   std::vector<std::vector<boost::shared_ptr<const mach::GMMStats> > > gmm_stats;
   extractGMMStatsVectors(list_stats, gmm_stats);
   // Calls the train function
+  tp::no_gil unlock;
   t.updateD(gmm_stats);
 }
 
@@ -301,6 +318,7 @@ void bind_trainer_jfa() {
     .def("__updateU__", &jfa_updateU, (arg("self"), arg("stats")), "Updates U.")
     .def("__updateZ__", &jfa_updateZ, (arg("self"), arg("stats")), "Updates Z.")
     .def("__updateD__", &jfa_updateD, (arg("self"), arg("stats")), "Updates D.")
+    .add_property("n_threads", &train::JFABaseTrainer::getNThreads, &train::JFABaseTrainer::setNThreads, "Number of threads used to process the identities (0 means one per hardware core)")
     ;
 
   class_<train::JFATrainer, boost::noncopyable>("JFATrainer", "Create a trainer for the JFA.", init<mach::JFAMachine&, train::JFABaseTrainer&>((arg("jfa"), arg("base_trainer")),"Initializes a new JFATrainer."))
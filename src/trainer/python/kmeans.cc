@@ -20,6 +20,8 @@
 
 #include "bob/core/python/ndarray.h"
 #include "bob/trainer/KMeansTrainer.h"
+#include "bob/trainer/MiniBatchKMeansTrainer.h"
+#include "bob/core/python/gil.h"
 
 using namespace boost::python;
 
@@ -57,6 +59,41 @@ static void py_setFirstOrderStats(bob::trainer::KMeansTrainer& op, bob::python::
   op.setFirstOrderStats(stats.bz<double,2>());
 }
 
+// EM steps, released from the GIL as in trainer/python/gmm.cc
+template <typename T, typename M, typename S>
+static void em_train(T& t, M& machine, const S& data) {
+  bob::python::no_gil unlock;
+  t.train(machine, data);
+}
+
+template <typename T, typename M, typename S>
+static void em_initialization(T& t, M& machine, const S& data) {
+  bob::python::no_gil unlock;
+  t.initialization(machine, data);
+}
+
+template <typename T, typename M, typename S>
+static void em_e_step(T& t, M& machine, const S& data) {
+  bob::python::no_gil unlock;
+  t.eStep(machine, data);
+}
+
+template <typename T, typename M, typename S>
+static void em_m_step(T& t, M& machine, const S& data) {
+  bob::python::no_gil unlock;
+  t.mStep(machine, data);
+}
+
+static void minibatch_train(bob::trainer::MiniBatchKMeansTrainer& t, bob::machine::KMeansMachine& machine, const blitz::Array<double,2>& data) {
+  bob::python::no_gil unlock;
+  t.train(machine, data);
+}
+
+static void minibatch_update(bob::trainer::MiniBatchKMeansTrainer& t, bob::machine::KMeansMachine& machine, const blitz::Array<double,2>& batch) {
+  bob::python::no_gil unlock;
+  t.update(machine, batch);
+}
+
 void bind_trainer_kmeans() 
 {
   typedef bob::trainer::EMTrainer<bob::machine::KMeansMachine, blitz::Array<double,2> > EMTrainerKMeansBase; 
@@ -64,18 +101,19 @@ void bind_trainer_kmeans()
   class_<EMTrainerKMeansBase, boost::noncopyable>("EMTrainerKMeans", "The base python class for all EM-based trainers.", no_init)
     .add_property("convergence_threshold", &EMTrainerKMeansBase::getConvergenceThreshold, &EMTrainerKMeansBase::setConvergenceThreshold, "Convergence threshold")
     .add_property("max_iterations", &EMTrainerKMeansBase::getMaxIterations, &EMTrainerKMeansBase::setMaxIterations, "Max iterations")
+    .add_property("n_threads", &EMTrainerKMeansBase::getNThreads, &EMTrainerKMeansBase::setNThreads, "Number of threads used by the E-step (0 means one per hardware core)")
     .add_property("compute_likelihood", &EMTrainerKMeansBase::getComputeLikelihood, &EMTrainerKMeansBase::setComputeLikelihood, "Tells whether we compute the average min distance or not.")
     .def(self == self)
     .def(self != self)
-    .def("train", &EMTrainerKMeansBase::train, (arg("machine"), arg("data")), "Train a machine using data")
-    .def("initialization", &EMTrainerKMeansBase::initialization, (arg("machine"), arg("data")), "This method is called before the EM algorithm")
-    .def("e_step", &EMTrainerKMeansBase::eStep, (arg("machine"), arg("data")),
+    .def("train", &em_train<EMTrainerKMeansBase, bob::machine::KMeansMachine, blitz::Array<double,2> >, (arg("machine"), arg("data")), "Train a machine using data")
+    .def("initialization", &em_initialization<EMTrainerKMeansBase, bob::machine::KMeansMachine, blitz::Array<double,2> >, (arg("machine"), arg("data")), "This method is called before the EM algorithm")
+    .def("e_step", &em_e_step<EMTrainerKMeansBase, bob::machine::KMeansMachine, blitz::Array<double,2> >, (arg("machine"), arg("data")),
        "Update the hidden variable distribution (or the sufficient statistics) given the Machine parameters. "
        "Also, calculate the average output of the Machine given these parameters.\n"
        "Return the average output of the Machine across the dataset. "
        "The EM algorithm will terminate once the change in average_output "
        "is less than the convergence_threshold.")
-    .def("m_step", &EMTrainerKMeansBase::mStep, (arg("machine"), arg("data")), "Update the Machine parameters given the hidden variable distribution (or the sufficient statistics)")
+    .def("m_step", &em_m_step<EMTrainerKMeansBase, bob::machine::KMeansMachine, blitz::Array<double,2> >, (arg("machine"), arg("data")), "Update the Machine parameters given the hidden variable distribution (or the sufficient statistics)")
     .def("compute_likelihood", &EMTrainerKMeansBase::computeLikelihood, (arg("machine")), "Returns the average min distance")
     .def("finalization", &EMTrainerKMeansBase::finalization, (arg("machine"), arg("data")), "This method is called after the EM algorithm")
   ;
@@ -93,6 +131,8 @@ void bind_trainer_kmeans()
      .def(self != self)
      .add_property("initialization_method", &bob::trainer::KMeansTrainer::getInitializationMethod, &bob::trainer::KMeansTrainer::setInitializationMethod, "The initialization method to generate the initial means.")
      .add_property("seed", &bob::trainer::KMeansTrainer::getSeed, &bob::trainer::KMeansTrainer::setSeed, "Seed used to genrated pseudo-random numbers")
+     .add_property("assignment_method", &bob::trainer::KMeansTrainer::getAssignmentMethod, &bob::trainer::KMeansTrainer::setAssignmentMethod, "The method used by the E-step to find the closest mean of each sample: BRUTE_FORCE (default), GEMM (blocks of samples at once, with a matrix product) or HAMERLY (triangle inequality bounds skip most distance computations; call reset_bounds() before an E-step on other data).")
+     .def("reset_bounds", &bob::trainer::KMeansTrainer::resetBounds, "Discards the bounds of the HAMERLY assignment method. To be called before an E-step on other data (or on data modified in place) than the previous E-step, outside of initialization() and finalization().")
      .add_property("average_min_distance", &bob::trainer::KMeansTrainer::getAverageMinDistance, &bob::trainer::KMeansTrainer::setAverageMinDistance, "Average min distance. Useful to parallelize the E-step.")
      .add_property("zeroeth_order_statistics", &py_getZeroethOrderStats, &py_setZeroethOrderStats, "The zeroeth order statistics. Useful to parallelize the E-step.")
      .add_property("first_order_statistics", &py_getFirstOrderStats, &py_setFirstOrderStats, "The first order statistics. Useful to parallelize the E-step.")
@@ -111,6 +151,44 @@ void bind_trainer_kmeans()
     .export_values()
     ;   
 
+  enum_<bob::trainer::KMeansTrainer::AssignmentMethod>("assignment_method_type")
+    .value("BRUTE_FORCE", bob::trainer::KMeansTrainer::BRUTE_FORCE)
+    .value("GEMM", bob::trainer::KMeansTrainer::GEMM)
+    .value("HAMERLY", bob::trainer::KMeansTrainer::HAMERLY)
+    .export_values()
+    ;
+
   // Binds methods that has nested enum values as default parameters
   KMT.def(init<optional<double,int,bool,bob::trainer::KMeansTrainer::InitializationMethod> >((arg("convergence_threshold")=0.001, arg("max_iterations")=10, arg("compute_likelihood")=true, arg("initialization_method")=bob::trainer::KMeansTrainer::RANDOM)));
 }
+
+static object py_getCounts(const bob::trainer::MiniBatchKMeansTrainer& op) 
+{
+  const blitz::Array<double,1>& counts = op.getCounts();
+  bob::python::ndarray counts_new(bob::core::array::t_float64, 
+    counts.extent(0));
+  blitz::Array<double,1> counts_new_ = counts_new.bz<double,1>();
+  counts_new_ = counts;
+  return counts_new.self();
+}
+
+void bind_trainer_minibatch_kmeans() 
+{
+  class_<bob::trainer::MiniBatchKMeansTrainer, boost::shared_ptr<bob::trainer::MiniBatchKMeansTrainer> >("MiniBatchKMeansTrainer",
+      "Trains a KMeans machine with mini-batches.\n"
+      "See D. Sculley, \"Web-scale k-means clustering\", WWW 2010.\n"
+      "Each mean is moved towards the samples of a batch it is the closest to, with a learning rate that is the inverse of the number of samples assigned to it so far. "
+      "The means of the machine must be initialized beforehand (e.g. with the initialization() method of a KMeansTrainer on a subset of the data).",
+      init<optional<size_t,size_t> >((arg("batch_size")=1000, arg("max_iterations")=100)))
+    .def(init<bob::trainer::MiniBatchKMeansTrainer&>(args("other")))
+    .def(self == self)
+    .def(self != self)
+    .add_property("batch_size", &bob::trainer::MiniBatchKMeansTrainer::getBatchSize, &bob::trainer::MiniBatchKMeansTrainer::setBatchSize, "Number of samples of each batch drawn by train()")
+    .add_property("max_iterations", &bob::trainer::MiniBatchKMeansTrainer::getMaxIterations, &bob::trainer::MiniBatchKMeansTrainer::setMaxIterations, "Number of batches processed by train()")
+    .add_property("seed", &bob::trainer::MiniBatchKMeansTrainer::getSeed, &bob::trainer::MiniBatchKMeansTrainer::setSeed, "Seed used to draw the batches")
+    .add_property("counts", &py_getCounts, "Number of samples assigned to each mean so far")
+    .def("train", &minibatch_train, (arg("machine"), arg("data")), "Processes max_iterations batches of batch_size samples drawn (with replacement) from the data. The counts are reset first.")
+    .def("update", &minibatch_update, (arg("machine"), arg("batch")), "Updates the means with a batch of samples (one per row). The counts are kept from one call to the next one, until reset() is called.")
+    .def("reset", &bob::trainer::MiniBatchKMeansTrainer::reset, "Resets the counts")
+  ;
+}
@@ -24,6 +24,7 @@
 #include <boost/python/stl_iterator.hpp>
 #include "bob/trainer/SVDPCATrainer.h"
 #include "bob/trainer/FisherLDATrainer.h"
+#include "bob/core/python/gil.h"
 
 using namespace boost::python;
 namespace io = bob::io;
@@ -33,14 +34,20 @@ namespace train = bob::trainer;
 tuple eig_train1 (const train::SVDPCATrainer& t, const blitz::Array<double,2>& data) {
   blitz::Array<double,1> eig_val(data.extent(1));
   mach::LinearMachine m;
-  t.train(m, eig_val, data);
+  {
+    bob::python::no_gil unlock;
+    t.train(m, eig_val, data);
+  }
   return make_tuple(m, eig_val);
 }
 
 object eig_train2 (const train::SVDPCATrainer& t, mach::LinearMachine& m,
     const blitz::Array<double,2>& data) {
   blitz::Array<double,1> eig_val(data.extent(1));
-  t.train(m, eig_val, data);
+  {
+    bob::python::no_gil unlock;
+    t.train(m, eig_val, data);
+  }
   return object(eig_val);
 }
 
@@ -49,7 +56,10 @@ tuple lda_train1 (const train::FisherLDATrainer& t, object data) {
   std::vector<blitz::Array<double,2> > vdata(dbegin, dend);
   blitz::Array<double,1> eig_val(vdata[0].extent(1));
   mach::LinearMachine m;
-  t.train(m, eig_val, vdata);
+  {
+    bob::python::no_gil unlock;
+    t.train(m, eig_val, vdata);
+  }
   return make_tuple(m, eig_val);
 }
 
@@ -58,7 +68,10 @@ object lda_train2 (const train::FisherLDATrainer& t, mach::LinearMachine& m,
   stl_input_iterator<blitz::Array<double,2> > dbegin(data), dend;
   std::vector<blitz::Array<double,2> > vdata(dbegin, dend);
   blitz::Array<double,1> eig_val(vdata[0].extent(1));
-  t.train(m, eig_val, vdata);
+  {
+    bob::python::no_gil unlock;
+    t.train(m, eig_val, vdata);
+  }
   return object(eig_val);
 }
 
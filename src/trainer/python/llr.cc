@@ -23,6 +23,7 @@
 #include "bob/core/python/ndarray.h"
 #include <boost/python/stl_iterator.hpp>
 #include "bob/trainer/LLRTrainer.h"
+#include "bob/core/python/gil.h"
 
 using namespace boost::python;
 
@@ -34,8 +35,13 @@ object train1(const bob::trainer::LLRTrainer& t,
   if(info1.dtype != bob::core::array::t_float64 || info1.nd != 2 ||
      info2.dtype != bob::core::array::t_float64 || info2.nd != 2)
     PYTHON_ERROR(TypeError, "Can only train with double precision array of 2 dimensions.");
+  const blitz::Array<double,2> data1_ = data1.bz<double,2>();
+  const blitz::Array<double,2> data2_ = data2.bz<double,2>();
   bob::machine::LinearMachine m;
-  t.train(m, data1.bz<double,2>(), data2.bz<double,2>());
+  {
+    bob::python::no_gil unlock;
+    t.train(m, data1_, data2_);
+  }
   return object(m);
 }
 
@@ -47,7 +53,10 @@ void train2(const bob::trainer::LLRTrainer& t, bob::machine::LinearMachine& m,
   if(info1.dtype != bob::core::array::t_float64 || info1.nd != 2 ||
      info2.dtype != bob::core::array::t_float64 || info2.nd != 2)
     PYTHON_ERROR(TypeError, "Can only train with double precision array of 2 dimensions.");
-  t.train(m, data1.bz<double,2>(), data2.bz<double,2>());
+  const blitz::Array<double,2> data1_ = data1.bz<double,2>();
+  const blitz::Array<double,2> data2_ = data2.bz<double,2>();
+  bob::python::no_gil unlock;
+  t.train(m, data1_, data2_);
 }
 
 void bind_trainer_llr() 
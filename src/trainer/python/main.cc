@@ -26,6 +26,7 @@
 void bind_trainer_linear();
 void bind_trainer_gmm();
 void bind_trainer_kmeans();
+void bind_trainer_minibatch_kmeans();
 void bind_trainer_rprop();
 void bind_trainer_backprop();
 void bind_trainer_jfa();
@@ -46,6 +47,7 @@ BOOST_PYTHON_MODULE(_trainer) {
   bind_trainer_linear();
   bind_trainer_gmm();
   bind_trainer_kmeans();
+  bind_trainer_minibatch_kmeans();
   bind_trainer_rprop();
   bind_trainer_backprop();
   bind_trainer_jfa();
@@ -24,6 +24,7 @@
 #include <boost/python.hpp>
 #include "bob/machine/PLDAMachine.h"
 #include "bob/trainer/PLDATrainer.h"
+#include "bob/core/python/gil.h"
 
 using namespace boost::python;
 
@@ -39,6 +40,7 @@ static void plda_train(bob::trainer::PLDABaseTrainer& t, bob::machine::PLDABaseM
   }
 
   // Calls the train function
+  bob::python::no_gil unlock;
   t.train(m, v_arraysets);
 }
 
@@ -54,6 +56,7 @@ static void plda_initialization(bob::trainer::PLDABaseTrainer& t, bob::machine::
   }
 
   // Calls the initialization function
+  bob::python::no_gil unlock;
   t.initialization(m, v_arraysets);
 }
 
@@ -69,6 +72,7 @@ static void plda_eStep(bob::trainer::PLDABaseTrainer& t, bob::machine::PLDABaseM
   }
 
   // Calls the eStep function
+  bob::python::no_gil unlock;
   t.eStep(m, v_arraysets);
 }
 
@@ -84,6 +88,7 @@ static void plda_mStep(bob::trainer::PLDABaseTrainer& t, bob::machine::PLDABaseM
   }
 
   // Calls the mStep function
+  bob::python::no_gil unlock;
   t.mStep(m, v_arraysets);
 }
 
@@ -99,6 +104,7 @@ static void plda_finalization(bob::trainer::PLDABaseTrainer& t, bob::machine::PL
   }
 
   // Calls the finalization function
+  bob::python::no_gil unlock;
   t.finalization(m, v_arraysets);
 }
 
@@ -116,6 +122,37 @@ static object get_z_second_order(bob::trainer::PLDABaseTrainer& m) {
   return tuple(retval);
 }
 
+// EM steps, released from the GIL as in trainer/python/gmm.cc
+template <typename T, typename M, typename S>
+static void em_train(T& t, M& machine, const S& data) {
+  bob::python::no_gil unlock;
+  t.train(machine, data);
+}
+
+template <typename T, typename M, typename S>
+static void em_initialization(T& t, M& machine, const S& data) {
+  bob::python::no_gil unlock;
+  t.initialization(machine, data);
+}
+
+template <typename T, typename M, typename S>
+static void em_e_step(T& t, M& machine, const S& data) {
+  bob::python::no_gil unlock;
+  t.eStep(machine, data);
+}
+
+template <typename T, typename M, typename S>
+static void em_m_step(T& t, M& machine, const S& data) {
+  bob::python::no_gil unlock;
+  t.mStep(machine, data);
+}
+
+static void plda_enrol(bob::trainer::PLDATrainer& t, bob::machine::PLDAMachine& m, const blitz::Array<double,2>& ar)
+{
+  bob::python::no_gil unlock;
+  t.enrol(m, ar);
+}
+
 void bind_trainer_plda() 
 {
   typedef bob::trainer::EMTrainer<bob::machine::PLDABaseMachine, std::vector<blitz::Array<double,2> > > EMTrainerPLDABase; 
@@ -124,12 +161,13 @@ void bind_trainer_plda()
     .add_property("convergence_threshold", &EMTrainerPLDABase::getConvergenceThreshold, &EMTrainerPLDABase::setConvergenceThreshold, "Convergence threshold")
     .add_property("max_iterations", &EMTrainerPLDABase::getMaxIterations, &EMTrainerPLDABase::setMaxIterations, "Max iterations")
     .add_property("compute_likelihood_variable", &EMTrainerPLDABase::getComputeLikelihood, &EMTrainerPLDABase::setComputeLikelihood, "Indicates whether the log likelihood should be computed during EM or not")
-    .def("train", &EMTrainerPLDABase::train, (arg("machine"), arg("data")), "Trains a machine using data")
-    .def("initialization", &EMTrainerPLDABase::initialization, (arg("machine"), arg("data")), "This method is called before the EM algorithm")
+    .add_property("n_threads", &EMTrainerPLDABase::getNThreads, &EMTrainerPLDABase::setNThreads, "Number of threads used to process the identities in the E- and M-steps (0 means one per hardware core)")
+    .def("train", &em_train<EMTrainerPLDABase, bob::machine::PLDABaseMachine, std::vector<blitz::Array<double,2> > >, (arg("machine"), arg("data")), "Trains a machine using data")
+    .def("initialization", &em_initialization<EMTrainerPLDABase, bob::machine::PLDABaseMachine, std::vector<blitz::Array<double,2> > >, (arg("machine"), arg("data")), "This method is called before the EM algorithm")
     .def("finalization", &EMTrainerPLDABase::finalization, (arg("machine"), arg("data")), "This method is called at the end of the EM algorithm")
-    .def("e_step", &EMTrainerPLDABase::eStep, (arg("machine"), arg("data")),
+    .def("e_step", &em_e_step<EMTrainerPLDABase, bob::machine::PLDABaseMachine, std::vector<blitz::Array<double,2> > >, (arg("machine"), arg("data")),
        "Updates the hidden variable distribution (or the sufficient statistics) given the Machine parameters. ")
-    .def("m_step", &EMTrainerPLDABase::mStep, (arg("machine"), arg("data")), "Updates the Machine parameters given the hidden variable distribution (or the sufficient statistics)")
+    .def("m_step", &em_m_step<EMTrainerPLDABase, bob::machine::PLDABaseMachine, std::vector<blitz::Array<double,2> > >, (arg("machine"), arg("data")), "Updates the Machine parameters given the hidden variable distribution (or the sufficient statistics)")
     .def("compute_likelihood", &EMTrainerPLDABase::computeLikelihood, (arg("machine"), arg("data")), "Computes the current log likelihood given the hidden variable distribution (or the sufficient statistics)")
   ;
 
@@ -172,6 +210,6 @@ void bind_trainer_plda()
 
   class_<bob::trainer::PLDATrainer, boost::noncopyable>("PLDATrainer", "Create a trainer for the PLDA.", init<>("Initializes a new PLDATrainer."))
     .def(init<const bob::trainer::PLDATrainer&>((arg("trainer")), "Copy constructs a PLDATrainer"))
-    .def("enrol", &bob::trainer::PLDATrainer::enrol, (arg("self"), arg("plda_machine"), arg("arrayset")), "Call the enrollment procedure.")
+    .def("enrol", &plda_enrol, (arg("self"), arg("plda_machine"), arg("arrayset")), "Call the enrollment procedure.")
     ;
 }
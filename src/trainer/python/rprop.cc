@@ -25,6 +25,7 @@
 #include <boost/make_shared.hpp>
 #include "bob/trainer/DataShuffler.h"
 #include "bob/trainer/MLPRPropTrainer.h"
+#include "bob/core/python/gil.h"
 
 using namespace boost::python;
 namespace tp = bob::python;
@@ -124,6 +125,18 @@ static boost::shared_ptr<train::DataShuffler> shuffler_from_arrays_or_arraysets
   return shuffler_from_arrays(data, target);
 }
 
+static void rprop_train(train::MLPRPropTrainer& t, mach::MLP& m,
+    const blitz::Array<double,2>& input, const blitz::Array<double,2>& target) {
+  tp::no_gil unlock;
+  t.train(m, input, target);
+}
+
+static void rprop_train_(train::MLPRPropTrainer& t, mach::MLP& m,
+    const blitz::Array<double,2>& input, const blitz::Array<double,2>& target) {
+  tp::no_gil unlock;
+  t.train_(m, input, target);
+}
+
 void bind_trainer_rprop() {
   class_<train::DataShuffler, boost::shared_ptr<train::DataShuffler> >("DataShuffler", "A data shuffler is capable of being populated with data from one or multiple classes and matching target values. Once setup, the shuffer can randomly select a number of vectors and accompaning targets for the different classes, filling up user containers.\n\nData shufflers are particular useful for training neural networks.", no_init)
     .def("__init__", make_constructor(&shuffler_from_arrays_or_arraysets, default_call_policies(), (arg("data"), arg("target"))), "Initializes the shuffler with some data classes and corresponding targets. The data is read by considering examples are lying on different rows of the input data if it is composed of a list of NumPy ndarrays or copied internally if it is composed of a list of io.Arraysets.")
@@ -143,7 +156,7 @@ void bind_trainer_rprop() {
     .add_property("batch_size", &train::MLPRPropTrainer::getBatchSize, &train::MLPRPropTrainer::setBatchSize)
     .add_property("train_biases", &train::MLPRPropTrainer::getTrainBiases, &train::MLPRPropTrainer::setTrainBiases)
     .def("is_compatible", &train::MLPRPropTrainer::isCompatible, (arg("self"), arg("machine")), "Checks if a given machine is compatible with my inner settings")
-    .def("train", &train::MLPRPropTrainer::train, (arg("self"), arg("machine"), arg("input"), arg("target")), "Trains the MLP to perform discrimination. The training is executed outside the machine context, but uses all the current machine layout. The given machine is updated with new weights and biases at the end of the training that is performed a single time. Iterate as much as you want to refine the training.\n\nThe machine given as input is checked for compatibility with the current initialized settings. If the two are not compatible, an exception is thrown.\n\n.. note::\n   In RProp, training is done in batches. You should set the batch size properly at class initialization or use setBatchSize().\n\n.. note::\n   The machine is not initialized randomly at each train() call. It is your task to call random() once at the machine you want to train and then call train() as many times as you think are necessary. This design allows for a training criteria to be encoded outside the scope of this trainer and to this type to focus only on applying the training when requested to.")
-    .def("train_", &train::MLPRPropTrainer::train_, (arg("self"), arg("machine"), arg("input"), arg("target")), "This is a version of the train() method above, which does no compatibility check on the input machine.")
+    .def("train", &rprop_train, (arg("self"), arg("machine"), arg("input"), arg("target")), "Trains the MLP to perform discrimination. The training is executed outside the machine context, but uses all the current machine layout. The given machine is updated with new weights and biases at the end of the training that is performed a single time. Iterate as much as you want to refine the training.\n\nThe machine given as input is checked for compatibility with the current initialized settings. If the two are not compatible, an exception is thrown.\n\n.. note::\n   In RProp, training is done in batches. You should set the batch size properly at class initialization or use setBatchSize().\n\n.. note::\n   The machine is not initialized randomly at each train() call. It is your task to call random() once at the machine you want to train and then call train() as many times as you think are necessary. This design allows for a training criteria to be encoded outside the scope of this trainer and to this type to focus only on applying the training when requested to.")
+    .def("train_", &rprop_train_, (arg("self"), arg("machine"), arg("input"), arg("target")), "This is a version of the train() method above, which does no compatibility check on the input machine.")
     ;
 }
@@ -23,6 +23,7 @@
 #include "bob/core/python/ndarray.h"
 #include <boost/python/stl_iterator.hpp>
 #include "bob/trainer/SVMTrainer.h"
+#include "bob/core/python/gil.h"
 
 using namespace boost::python;
 namespace tp = bob::python;
@@ -34,6 +35,7 @@ static boost::shared_ptr<mach::SupportVector> train1
 (const train::SVMTrainer& trainer, object data) {
   stl_input_iterator<blitz::Array<double,2> > dbegin(data), dend;
   std::vector<blitz::Array<double,2> > vdata(dbegin, dend);
+  tp::no_gil unlock;
   return trainer.train(vdata);
 }
 
@@ -42,7 +44,10 @@ static boost::shared_ptr<mach::SupportVector> train2
  tp::const_ndarray div) {
   stl_input_iterator<blitz::Array<double,2> > dbegin(data), dend;
   std::vector<blitz::Array<double,2> > vdata(dbegin, dend);
-  return trainer.train(vdata, sub.bz<double,1>(), div.bz<double,1>());
+  const blitz::Array<double,1> sub_ = sub.bz<double,1>();
+  const blitz::Array<double,1> div_ = div.bz<double,1>();
+  tp::no_gil unlock;
+  return trainer.train(vdata, sub_, div_);
 }
 
 void bind_trainer_svm() {
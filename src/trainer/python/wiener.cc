@@ -23,6 +23,7 @@
 #include <boost/python.hpp>
 #include <boost/shared_ptr.hpp>
 #include "bob/trainer/WienerTrainer.h"
+#include "bob/core/python/gil.h"
 
 using namespace boost::python;
 namespace io = bob::io;
@@ -37,6 +38,7 @@ boost::shared_ptr<mach::WienerMachine> wiener_train1 (const train::WienerTrainer
 
 void wiener_train2 (const train::WienerTrainer& t, mach::WienerMachine& m,
     const blitz::Array<double,3>& data) {
+  bob::python::no_gil unlock;
   t.train(m, data);
 }
 
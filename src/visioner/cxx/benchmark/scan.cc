@@ -0,0 +1,97 @@
+/**
+ * @file visioner/cxx/benchmark/scan.cc
+ * @date Fri 16 Oct 2026 18:10:37 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Benchmarks of the face detector scan. The program takes the
+ * detection model and an 8-bit gray-scale image in binary PGM format as
+ * arguments.
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOB_BENCHMARK_SUITE "visioner"
+#define BOB_BENCHMARK_MAIN
+#include "bob/core/benchmark.h"
+
+#include "bob/visioner/cv/cv_detector.h"
+
+namespace bench = bob::core::benchmark;
+
+struct Load {
+  bob::visioner::CVDetector* detector;
+  const blitz::Array<uint8_t,2>* image;
+  void operator()() const {
+    detector->load(image->data(), image->extent(0), image->extent(1));
+  }
+};
+
+struct Scan {
+  const bob::visioner::CVDetector* detector;
+  std::vector<bob::visioner::detection_t>* detections;
+  void operator()() const { detector->scan(*detections); }
+};
+
+/**
+ * Reads a binary (P5) PGM file, so that this program does not depend on
+ * bob::io just for that
+ */
+static blitz::Array<uint8_t,2> read_pgm(const std::string& filename) {
+  std::ifstream in(filename.c_str(), std::ios::binary);
+  std::string magic;
+  int cols = 0, rows = 0, max = 0;
+  in >> magic >> cols >> rows >> max;
+  in.get();
+  if (!in || magic != "P5" || max != 255 || cols <= 0 || rows <= 0) {
+    boost::format m("cannot read '%s' as an 8-bit binary PGM image");
+    m % filename;
+    throw std::runtime_error(m.str());
+  }
+  blitz::Array<uint8_t,2> image(rows, cols);
+  in.read(reinterpret_cast<char*>(image.data()), rows * cols);
+  if (!in) {
+    boost::format m("'%s' is truncated");
+    m % filename;
+    throw std::runtime_error(m.str());
+  }
+  return image;
+}
+
+void bob_benchmark(bench::Suite& suite) {
+  const std::vector<std::string>& args = suite.getArguments();
+  if (args.size() != 2)
+    throw std::runtime_error("usage: benchmark_bob_visioner_scan [options] <detection model> <image.pgm>");
+
+  const blitz::Array<uint8_t,2> image = read_pgm(args[1]);
+  const int h = image.extent(0);
+  const int w = image.extent(1);
+  const std::string size = (boost::format("%dx%d") % h % w).str();
+
+  const uint64_t levels[] = {0, 10};
+  for (size_t i=0; i<sizeof(levels)/sizeof(uint64_t); ++i) {
+    bob::visioner::CVDetector detector(args[0], 0.0, levels[i], 2, 0.05,
+        bob::visioner::CVDetector::Scanning);
+    const std::string name = (boost::format("/%s/levels=%d") % size %
+        levels[i]).str();
+
+    Load load = {&detector, &image};
+    suite.run("detector-load" + name, load, 1, h*w);
+
+    load();
+    std::vector<bob::visioner::detection_t> detections;
+    Scan scan = {&detector, &detections};
+    suite.run("detector-scan" + name, scan, 1, h*w);
+  }
+}
@@ -31,9 +31,129 @@
 #include "bob/visioner/cv/cv_detector.h"
 #include "bob/visioner/model/mdecoder.h"
 #include "bob/visioner/util/timer.h"
+#include "bob/visioner/util/threads.h"
 
 namespace bob { namespace visioner {
 
+  // Number of sub-window columns scanned by a task
+  static const int scan_band_size = 32;
+
+  /////////////////////////////////////////////////////////////////////////////////////////
+  // Copies of a model used by the scanning threads (the models keep the
+  //	preprocessed image). Each copy remembers the scan and the scale it was
+  //	last preprocessed for, so that it is reused without preprocessing.
+  //	The copies are borrowed with a ScanModels::guard_t, which gives them
+  //	back when it goes out of scope.
+  /////////////////////////////////////////////////////////////////////////////////////////
+
+  class ScanModels
+  {
+    private:
+
+      // Model copy and the (scan, scale) it was preprocessed for
+      struct entry_t
+      {
+        boost::shared_ptr<Model>        m_model;
+        uint64_t                        m_generation;
+        uint64_t                        m_scale;
+      };
+
+    public:
+
+      // Borrows a model preprocessed for the given scale, for its scope
+      class guard_t : private boost::noncopyable
+      {
+        public:
+
+          guard_t(ScanModels& models, uint64_t generation, uint64_t is, 
+              const ipscale_t& ip)
+            :       m_models(models), 
+                    m_entry(models.acquire(generation, is, ip))
+          {
+          }
+
+          ~guard_t()
+          {
+            m_models.release(m_entry);
+          }
+
+          const Model& model() const { return *m_entry.m_model; }
+
+        private:
+
+          ScanModels&     m_models;
+          entry_t         m_entry;
+      };
+
+      // Constructor
+      ScanModels(const boost::shared_ptr<Model>& model)
+        :       m_model(model), m_generation(0)
+      {
+      }
+
+      // Start a new scan (returns its identifier)
+      uint64_t start()
+      {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        return ++ m_generation;
+      }
+
+    private:
+
+      // Get a model preprocessed for the given scale
+      entry_t acquire(uint64_t generation, uint64_t is, const ipscale_t& ip)
+      {
+        entry_t entry;
+        {
+          boost::lock_guard<boost::mutex> lock(m_mutex);
+          std::vector<entry_t>::iterator it = m_free.begin();
+          for ( ; it != m_free.end(); ++ it)
+          {
+            if (it->m_generation == generation && it->m_scale == is)
+            {
+              break;
+            }
+          }
+          if (it == m_free.end() && m_free.empty() == false)
+          {
+            it = m_free.end() - 1;
+          }
+          if (it != m_free.end())
+          {
+            entry = *it;
+            m_free.erase(it);
+          }
+        }
+
+        if (entry.m_model.get() == 0)
+        {
+          entry.m_model = m_model->clone();
+          entry.m_generation = 0;
+          entry.m_scale = 0;
+        }
+        if (entry.m_generation != generation || entry.m_scale != is)
+        {
+          entry.m_model->preprocess(ip);
+          entry.m_generation = generation;
+          entry.m_scale = is;
+        }
+        return entry;
+      }
+
+      // Give back a model
+      void release(const entry_t& entry)
+      {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        m_free.push_back(entry);
+      }
+
+      // Attributes
+      boost::shared_ptr<Model>  m_model;
+      boost::mutex              m_mutex;
+      uint64_t                  m_generation;
+      std::vector<entry_t>      m_free;
+  };
+
   // Constructor
   CVDetector::CVDetector():	
     m_ds(2),
@@ -104,6 +224,8 @@ namespace bob { namespace visioner {
       return false;
     }
 
+    m_scan_models.reset(new ScanModels(m_model));
+
     param_t _param = param();
     _param.m_ds = m_ds;
     m_ipyramid.reset(_param); 
@@ -158,6 +280,8 @@ namespace bob { namespace visioner {
         throw std::runtime_error(m.str());
       }
 
+      m_scan_models.reset(new ScanModels(m_model));
+
       param_t _param = param();
       _param.m_ds = m_ds;
       m_ipyramid.reset(_param); 
@@ -200,9 +324,10 @@ namespace bob { namespace visioner {
     return	m_ipyramid.load(ipscale) &&
       m_ipyramid.empty() == false;
   }
-  bool CVDetector::load(const uint8_t* image, uint64_t rows, uint64_t cols)
+  bool CVDetector::load(const uint8_t* image, uint64_t rows, uint64_t cols, 
+      uint64_t stride)
   {
-    return	m_ipyramid.load(image, rows, cols) &&
+    return	m_ipyramid.load(image, rows, cols, stride) &&
       m_ipyramid.empty() == false;
   }
 
@@ -256,44 +381,43 @@ namespace bob { namespace visioner {
       return false;
     }
 
-    // Scan the image ... 
-    Timer timer;
+    // Split the scanning in bands of sub-windows ...
+    std::vector<scan_band_t> bands;
     for (uint64_t is = 0; is < m_ipyramid.size(); is ++)
     {
       const ipscale_t& ip = m_ipyramid[is];
-      m_model->preprocess(ip);
+      const int band_dx = scan_band_size * ip.m_scan_dx;
 
-      // ... with every model type
+      // ... for every model type
       for (uint64_t o = 0; o < n_outputs(); o ++)
       {
-        for (int x = ip.m_scan_min_x; x < ip.m_scan_max_x; x += ip.m_scan_dx)
-          for (int y = ip.m_scan_min_y; y < ip.m_scan_max_y; y += ip.m_scan_dy)
-          {
-            // Concentrate computation on the most promising detections
-            double score = 0.0;
-            for (uint64_t l = 0; l <= m_levels && score >= 0.0; l ++)
-            {
-              const uint64_t lbegin = m_lmodel_begins[o][l];
-              const uint64_t lend = m_lmodel_ends[o][l];
-              score += m_model->score(o, lbegin, lend, x, y);
-
-              // Update statistics
-              m_stats.m_evals += lend - lbegin;
-            }
+        for (int x = ip.m_scan_min_x; x < ip.m_scan_max_x; x += band_dx)
+        {
+          const scan_band_t band = 
+          { is, o, x, std::min(x + band_dx, ip.m_scan_max_x) };
+          bands.push_back(band);
+        }
+      }
+    }
 
-            // Threshold detection and map it to the original image size
-            if (score >= m_threshold)
-            {
-              detections.push_back(make_detection(
-                    score, 
-                    m_ipyramid.map(subwindow_t(x, y, is)), 
-                    o));
-            }
+    // ... scan them with the thread pool and merge the results in order
+    Timer timer;
+    const uint64_t generation = m_scan_models->start();
+    std::vector<std::vector<detection_t> > band_detections(bands.size());
+    std::vector<stats_t> band_stats(bands.size());
+    thread_loop(boost::bind(&CVDetector::scan_bands,
+          this, boost::cref(bands), generation, boost::ref(band_detections),
+          boost::ref(band_stats), boost::lambda::_1),
+        bands.size());
+
+    for (uint64_t b = 0; b < bands.size(); b ++)
+    {
+      detections.insert(detections.end(), 
+          band_detections[b].begin(), band_detections[b].end());
 
-            // Update statistics
-            m_stats.m_sws ++;
-          }
-      }
+      // Update statistics
+      m_stats.m_sws += band_stats[b].m_sws;
+      m_stats.m_evals += band_stats[b].m_evals;
     }
 
     // Update statistics
@@ -321,6 +445,50 @@ namespace bob { namespace visioner {
     }
   }
 
+  // Scan the sub-windows of the bands in the given range
+  void CVDetector::scan_bands(const std::vector<scan_band_t>& bands, 
+      uint64_t generation, std::vector<std::vector<detection_t> >& detections,
+      std::vector<stats_t>& stats, const std::pair<uint64_t, uint64_t>& range) const
+  {
+    for (uint64_t b = range.first; b < range.second; b ++)
+    {
+      const scan_band_t& band = bands[b];
+      const uint64_t is = band.m_scale, o = band.m_output;
+      const ipscale_t& ip = m_ipyramid[is];
+
+      const ScanModels::guard_t guard(*m_scan_models, generation, is, ip);
+      const Model& model = guard.model();
+
+      for (int x = band.m_min_x; x < band.m_max_x; x += ip.m_scan_dx)
+        for (int y = ip.m_scan_min_y; y < ip.m_scan_max_y; y += ip.m_scan_dy)
+        {
+          // Concentrate computation on the most promising detections
+          double score = 0.0;
+          for (uint64_t l = 0; l <= m_levels && score >= 0.0; l ++)
+          {
+            const uint64_t lbegin = m_lmodel_begins[o][l];
+            const uint64_t lend = m_lmodel_ends[o][l];
+            score += model.score(o, lbegin, lend, x, y);
+
+            // Update statistics
+            stats[b].m_evals += lend - lbegin;
+          }
+
+          // Threshold detection and map it to the original image size
+          if (score >= m_threshold)
+          {
+            detections[b].push_back(make_detection(
+                  score, 
+                  m_ipyramid.map(subwindow_t(x, y, is)), 
+                  o));
+          }
+
+          // Update statistics
+          stats[b].m_sws ++;
+        }
+    }
+  }
+
   // Label detections
   bool CVDetector::label(const detection_t& detection) const
   {
@@ -23,6 +23,7 @@
  */
 
 #include "bob/visioner/vision/image.h"
+#include "bob/visioner/vision/resample.h"
 #include "bob/visioner/util/util.h"
 
 namespace bob { namespace visioner {	
@@ -44,11 +45,14 @@ namespace bob { namespace visioner {
   bool scale(const Matrix<uint8_t>& src, double scale, Matrix<uint8_t>& dst)
   {
     scale = range(scale, 0.01, 1.00);
-    const int new_w = (int)(0.5 + scale * src.cols());
-    const int new_h = (int)(0.5 + scale * src.rows());
+    uint64_t new_h, new_w;
+    if (scaled_size(src.rows(), src.cols(), scale, new_h, new_w) == false)
+    {
+      return false;
+    }
 
-    QImage qimage = convert(src);
-    return load(qimage.scaled(new_w, new_h, Qt::KeepAspectRatio, Qt::SmoothTransformation), dst);
+    downscale(src, new_h, new_w, dst);
+    return true;
   }
 
   // Convert from <Matrix<uint8_t>> to <QImage>
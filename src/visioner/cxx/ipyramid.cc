@@ -27,6 +27,7 @@
 #include "bob/visioner/model/ipyramid.h"
 #include "bob/visioner/vision/image.h"
 #include "bob/visioner/vision/integral.h"
+#include "bob/visioner/vision/resample.h"
 
 namespace bob { namespace visioner {
 
@@ -121,6 +122,54 @@ namespace bob { namespace visioner {
     m_param = param;
   }
 
+  // Build the scaled versions of the top image
+  //	NB: Each level is downscaled from the smallest level that is at least
+  //	twice larger (or from the top image), so that the cost of building the
+  //	pyramid does not grow with the number of levels times the size of the
+  //	original image, while each level is still averaged from enough pixels.
+  void ipyramid_t::build(const std::vector<double>& scales)
+  {
+    const ipscale_t& top = m_ipscales[0];
+    for (uint64_t i = 1; i < scales.size(); i ++)
+    {
+      ipscale_t& dst = m_ipscales[i];
+      dst.m_scale = range(scales[i], 0.0, 1.0);
+      dst.m_inv_scale = inverse(dst.m_scale);
+
+      dst.m_objects = top.m_objects;
+      for (std::vector<Object>::iterator it = dst.m_objects.begin(); it != dst.m_objects.end(); ++ it)
+      {
+        it->scale(dst.m_scale);
+      }
+
+      uint64_t isrc = 0;
+      for (uint64_t j = i - 1; j > 0; j --)
+      {
+        if (m_ipscales[j].m_scale >= 2.0 * dst.m_scale)
+        {
+          isrc = j;
+          break;
+        }
+      }
+
+      uint64_t new_h, new_w;
+      const bool valid = scaled_size(top.rows(), top.cols(), dst.m_scale, new_h, new_w);
+      if (valid == true)
+      {
+        downscale(m_ipscales[isrc].m_image, new_h, new_w, dst.m_image);
+        update_ipscale(dst, m_param);
+      }
+
+      if (	valid == false ||
+          dst.m_scan_min_x >= dst.m_scan_max_x ||
+          dst.m_scan_min_y >= dst.m_scan_max_y)
+      {
+        m_ipscales.erase(m_ipscales.begin() + i, m_ipscales.end());
+        break;
+      }
+    }
+  }
+
   // Loads scaled versions of an image and its ground truth
   bool ipyramid_t::load(const std::string& ifile, const std::string& gfile)
   {
@@ -150,20 +199,7 @@ namespace bob { namespace visioner {
     update_ipscale(m_ipscales[0], m_param);
 
     // Build the scaled versions of the original image
-    const ipscale_t& src = m_ipscales[0];
-    for (uint64_t i = 1; i < scales.size(); i ++)
-    {
-      ipscale_t& dst = m_ipscales[i];
-      src.scale(scales[i], dst);
-      update_ipscale(dst, m_param);
-
-      if (	dst.m_scan_min_x >= dst.m_scan_max_x ||
-          dst.m_scan_min_y >= dst.m_scan_max_y)
-      {
-        m_ipscales.erase(m_ipscales.begin() + i, m_ipscales.end());
-        break;
-      }
-    }
+    build(scales);
 
     // OK
     return true;
@@ -188,56 +224,39 @@ namespace bob { namespace visioner {
     update_ipscale(m_ipscales[0], m_param);
 
     // Build the scaled versions of the original image
-    const ipscale_t& src = m_ipscales[0];
-    for (uint64_t i = 1; i < scales.size(); i ++) {
-      ipscale_t& dst = m_ipscales[i];
-      src.scale(scales[i], dst);
-      update_ipscale(dst, m_param);
-
-      if (dst.m_scan_min_x >= dst.m_scan_max_x ||
-          dst.m_scan_min_y >= dst.m_scan_max_y) {
-        m_ipscales.erase(m_ipscales.begin() + i, m_ipscales.end());
-        break;
-      }
-    }
+    build(scales);
 
     // OK
     return true;
   }
 
   // Loads scaled versions of an image without its ground-thruth
-  bool ipyramid_t::load(const uint8_t* image, uint64_t rows, uint64_t cols)
+  bool ipyramid_t::load(const uint8_t* image, uint64_t rows, uint64_t cols,
+      uint64_t stride)
   {
-    //AA: no simple way not to have a copy here...
-    Matrix<uint8_t> tmp_image(rows, cols, image);
+    if (stride == 0) stride = cols;
 
     // Compute the scalling factors
-    const std::vector<double> scales = scan_scales(m_param.m_rows, m_param.m_cols, tmp_image.rows(), tmp_image.cols(), m_param.m_ds);
+    const std::vector<double> scales = scan_scales(m_param.m_rows, m_param.m_cols, rows, cols, m_param.m_ds);
     if (scales.empty()) return false;
 
     m_ipscales.resize(scales.size());
 
-    // Load the ground truth and the image
-    m_ipscales[0].m_scale = 1.0;
-    m_ipscales[0].m_inv_scale = 1.0;
-    m_ipscales[0].m_image = tmp_image;
-    update_ipscale(m_ipscales[0], m_param);
-
-    // Build the scaled versions of the original image
-    const ipscale_t& src = m_ipscales[0];
-    for (uint64_t i = 1; i < scales.size(); i ++)
+    // Copy the (strided) rows to the top level, the only copy of the image
+    // (reusing the buffers of the previous image, if any)
+    ipscale_t& top = m_ipscales[0];
+    top.m_scale = 1.0;
+    top.m_inv_scale = 1.0;
+    top.m_objects.clear();
+    top.m_image.resize(rows, cols);
+    for (uint64_t y = 0; y < rows; y ++)
     {
-      ipscale_t& dst = m_ipscales[i];
-      src.scale(scales[i], dst);
-      update_ipscale(dst, m_param);
-
-      if (	dst.m_scan_min_x >= dst.m_scan_max_x ||
-          dst.m_scan_min_y >= dst.m_scan_max_y)
-      {
-        m_ipscales.erase(m_ipscales.begin() + i, m_ipscales.end());
-        break;
-      }
+      std::copy(image + y * stride, image + y * stride + cols, top.m_image[y]);
     }
+    update_ipscale(top, m_param);
+
+    // Build the scaled versions of the original image
+    build(scales);
 
     // OK
     return true;
@@ -0,0 +1,183 @@
+/**
+ * @file visioner/cxx/resample.cc
+ * @date Fri 16 Oct 2026 14:02:11 CEST
+ * @author agent <agent@local>
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "bob/visioner/vision/resample.h"
+
+namespace bob { namespace visioner {
+
+  // Fixed-point precision of the filter weights and of the intermediate
+  //	(horizontally filtered) image
+  static const int weight_bits = 14;
+  static const int tmp_bits = 8;
+
+  /**
+   * Area-averaging filter from <src> to <dst> samples: the destination
+   *	sample <d> is the weighted sum of the source samples 
+   *	[m_begins[d], m_begins[d] + m_sizes[d]), with the weights starting at
+   *	m_offsets[d]. The weights of each destination sample sum exactly to
+   *	1 << weight_bits.
+   */
+  struct filter_t {
+
+    filter_t(uint64_t src, uint64_t dst)
+      : m_begins(dst), m_sizes(dst), m_offsets(dst)
+    {
+      const double ratio = (double)src / (double)dst;
+      const double inv_ratio = 1.0 / ratio;
+      const int32_t one = 1 << weight_bits;
+
+      for (uint64_t d = 0; d < dst; d ++)
+      {
+        const double start = d * ratio, stop = std::min((double)src, (d + 1) * ratio);
+        const uint64_t begin = std::min(src - 1, (uint64_t)start);
+        const uint64_t end = std::min(src, (uint64_t)std::ceil(stop - 1e-9));
+
+        m_begins[d] = begin;
+        m_offsets[d] = m_weights.size();
+
+        int32_t sum = 0, max_weight = -1;
+        uint64_t max_index = m_weights.size();
+        for (uint64_t s = begin; s < end; s ++)
+        {
+          const double overlap = std::min(stop, s + 1.0) - std::max(start, (double)s);
+          const int32_t weight = (int32_t)(0.5 + overlap * inv_ratio * one);
+          if (weight > max_weight)
+          {
+            max_weight = weight;
+            max_index = m_weights.size();
+          }
+          m_weights.push_back(weight);
+          sum += weight;
+        }
+
+        // Make the weights sum exactly to one (rounding errors)
+        m_weights[max_index] += one - sum;
+        m_sizes[d] = m_weights.size() - m_offsets[d];
+      }
+    }
+
+    std::vector<uint64_t>       m_begins;
+    std::vector<uint64_t>       m_sizes;
+    std::vector<uint64_t>       m_offsets;
+    std::vector<int32_t>        m_weights;
+  };
+
+  void downscale(const uint8_t* src, uint64_t rows, uint64_t cols, uint64_t stride,
+      uint64_t dst_rows, uint64_t dst_cols, Matrix<uint8_t>& dst)
+  {
+    dst_rows = std::min(dst_rows, rows);
+    dst_cols = std::min(dst_cols, cols);
+    dst.resize(dst_rows, dst_cols);
+    if (dst_rows == 0 || dst_cols == 0)
+    {
+      return;
+    }
+
+    const filter_t hfilter(cols, dst_cols);
+    const filter_t vfilter(rows, dst_rows);
+
+    // Filter the rows: <rows> x <dst_cols> intermediate image
+    std::vector<uint16_t> tmp(rows * dst_cols);
+    const int32_t tmp_shift = weight_bits - tmp_bits;
+    const int32_t tmp_round = 1 << (tmp_shift - 1);
+    for (uint64_t y = 0; y < rows; y ++)
+    {
+      const uint8_t* src_row = src + y * stride;
+      uint16_t* tmp_row = &tmp[y * dst_cols];
+      for (uint64_t x = 0; x < dst_cols; x ++)
+      {
+        const uint8_t* ps = src_row + hfilter.m_begins[x];
+        const int32_t* pw = &hfilter.m_weights[hfilter.m_offsets[x]];
+        uint32_t sum = 0;
+        for (uint64_t k = 0; k < hfilter.m_sizes[x]; k ++)
+        {
+          sum += pw[k] * ps[k];
+        }
+        tmp_row[x] = (uint16_t)((sum + tmp_round) >> tmp_shift);
+      }
+    }
+
+    // Filter the columns: whole rows at once (contiguous accumulation)
+    std::vector<uint32_t> acc(dst_cols);
+    const int32_t dst_shift = weight_bits + tmp_bits;
+    const uint32_t dst_round = 1 << (dst_shift - 1);
+    for (uint64_t y = 0; y < dst_rows; y ++)
+    {
+      std::fill(acc.begin(), acc.end(), dst_round);
+      const int32_t* pw = &vfilter.m_weights[vfilter.m_offsets[y]];
+      for (uint64_t k = 0; k < vfilter.m_sizes[y]; k ++)
+      {
+        const uint16_t* tmp_row = &tmp[(vfilter.m_begins[y] + k) * dst_cols];
+        const uint32_t weight = pw[k];
+        for (uint64_t x = 0; x < dst_cols; x ++)
+        {
+          acc[x] += weight * tmp_row[x];
+        }
+      }
+
+      uint8_t* dst_row = dst[y];
+      for (uint64_t x = 0; x < dst_cols; x ++)
+      {
+        dst_row[x] = (uint8_t)std::min((uint32_t)255, acc[x] >> dst_shift);
+      }
+    }
+  }
+
+  void downscale(const Matrix<uint8_t>& src, uint64_t dst_rows, uint64_t dst_cols,
+      Matrix<uint8_t>& dst)
+  {
+    if (src.empty())
+    {
+      dst.clear();
+      return;
+    }
+    downscale(&src(0, 0), src.rows(), src.cols(), src.cols(), 
+        dst_rows, dst_cols, dst);
+  }
+
+  bool scaled_size(uint64_t rows, uint64_t cols, double scale,
+      uint64_t& new_rows, uint64_t& new_cols)
+  {
+    new_cols = (uint64_t)(0.5 + scale * cols);
+    new_rows = (uint64_t)(0.5 + scale * rows);
+    if (new_cols < 1 || new_rows < 1)
+    {
+      return false;
+    }
+
+    const uint64_t rcols = new_rows * cols / rows;
+    if (rcols <= new_cols)
+    {
+      new_cols = rcols;
+    }
+    else
+    {
+      new_rows = new_cols * rows / cols;
+    }
+    new_cols = std::max(new_cols, (uint64_t)1);
+    new_rows = std::max(new_rows, (uint64_t)1);
+    return true;
+  }
+
+}}
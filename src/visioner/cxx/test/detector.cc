@@ -0,0 +1,137 @@
+/**
+ * @file visioner/cxx/test/detector.cc
+ * @date Fri 16 Oct 2026 22:03:17 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Test the concurrent scanning of images by several detectors
+ * sharing the same model
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE visioner-detector Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include "bob/visioner/cv/cv_detector.h"
+
+namespace bv = bob::visioner;
+
+/**
+ * Reads a binary (P5) PGM file
+ */
+static void read_pgm(const std::string& filename, std::vector<uint8_t>& image,
+    uint64_t& rows, uint64_t& cols) {
+  std::ifstream in(filename.c_str(), std::ios::binary);
+  std::string magic;
+  int max = 0;
+  in >> magic >> cols >> rows >> max;
+  in.get();
+  if (!in || magic != "P5" || max != 255 || cols == 0 || rows == 0)
+    throw std::runtime_error("cannot read '" + filename + "' as a PGM image");
+  image.resize(rows * cols);
+  in.read(reinterpret_cast<char*>(&image[0]), image.size());
+  if (!in) throw std::runtime_error("'" + filename + "' is truncated");
+}
+
+static std::string getenv_str(const char* name) {
+  const char* value = getenv(name);
+  if (!value) throw std::runtime_error(std::string(name) + " is not set");
+  return value;
+}
+
+struct T {
+  std::vector<uint8_t> image;    // original image
+  std::vector<uint8_t> flipped;  // flipped left-right
+  uint64_t rows, cols;
+  bv::CVDetector detector;
+
+  T(): rows(0), cols(0),
+    detector(getenv_str("BOB_VISIONER_MODEL"), 0.0, 0, 2, 0.05,
+        bv::CVDetector::Scanning)
+  {
+    read_pgm(getenv_str("BOB_VISIONER_IMAGE"), image, rows, cols);
+    flipped.resize(image.size());
+    for (uint64_t y=0; y<rows; ++y)
+      for (uint64_t x=0; x<cols; ++x)
+        flipped[y * cols + x] = image[y * cols + cols - 1 - x];
+  }
+
+  ~T() {}
+};
+
+static void check_equal(const std::vector<bv::detection_t>& a,
+    const std::vector<bv::detection_t>& b) {
+  BOOST_REQUIRE_EQUAL(a.size(), b.size());
+  for (size_t i=0; i<a.size(); ++i) {
+    BOOST_CHECK_EQUAL(a[i].first, b[i].first);
+    BOOST_CHECK(a[i].second.first == b[i].second.first);
+    BOOST_CHECK_EQUAL(a[i].second.second, b[i].second.second);
+  }
+}
+
+/**
+ * Scans the two images alternately with its own copy of the detector (the
+ * copies share the model and its per-thread copies)
+ */
+static void detect(const bv::CVDetector* prototype, const T* t,
+    size_t first, size_t n_scans,
+    std::vector<std::vector<bv::detection_t> >* detections) {
+  bv::CVDetector detector(*prototype);
+  detections->resize(n_scans);
+  for (size_t i=0; i<n_scans; ++i) {
+    const std::vector<uint8_t>& image = ((first + i) % 2 ? t->flipped : t->image);
+    detector.load(&image[0], t->rows, t->cols);
+    detector.scan((*detections)[i]);
+  }
+}
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( test_concurrent_detect )
+{
+  // Reference detections, one image after the other
+  std::vector<bv::detection_t> ref[2];
+  BOOST_REQUIRE(detector.load(&image[0], rows, cols));
+  BOOST_REQUIRE(detector.scan(ref[0]));
+  BOOST_REQUIRE(detector.load(&flipped[0], rows, cols));
+  BOOST_REQUIRE(detector.scan(ref[1]));
+  BOOST_CHECK(ref[0].empty() == false);
+
+  // Several threads detecting at once, with copies of the same detector
+  const size_t n_threads = 4;
+  const size_t n_scans = 3;
+  std::vector<std::vector<bv::detection_t> > detections[n_threads];
+  boost::thread_group threads;
+  for (size_t t=0; t<n_threads; ++t)
+    threads.create_thread(boost::bind(&detect, &detector, this, t, n_scans,
+          &detections[t]));
+  threads.join_all();
+
+  for (size_t t=0; t<n_threads; ++t) {
+    BOOST_REQUIRE_EQUAL(detections[t].size(), n_scans);
+    for (size_t i=0; i<n_scans; ++i)
+      check_equal(detections[t][i], ref[(t + i) % 2]);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
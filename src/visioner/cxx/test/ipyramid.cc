@@ -0,0 +1,128 @@
+/**
+ * @file visioner/cxx/test/ipyramid.cc
+ * @date Fri 16 Oct 2026 21:38:52 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Test the loading of images with strided rows in the image pyramid
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE visioner-ipyramid Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "bob/visioner/model/ipyramid.h"
+#include "bob/visioner/vision/resample.h"
+
+namespace bv = bob::visioner;
+
+struct T {
+  static const uint64_t rows = 97;
+  static const uint64_t cols = 131;
+  static const uint64_t stride = 150;
+  std::vector<uint8_t> contiguous;
+  std::vector<uint8_t> strided;
+
+  T(): contiguous(rows * cols), strided(rows * stride, 0) {
+    for (uint64_t y=0; y<rows; ++y)
+      for (uint64_t x=0; x<cols; ++x) {
+        const uint8_t v = (uint8_t)((y * 7 + x * 13 + (x * y) % 23) % 256);
+        contiguous[y * cols + x] = v;
+        strided[y * stride + x] = v;
+      }
+    // the padding at the end of the rows must not be read
+    for (uint64_t y=0; y<rows; ++y)
+      for (uint64_t x=cols; x<stride; ++x)
+        strided[y * stride + x] = 255;
+  }
+
+  ~T() {}
+};
+
+static void check_equal(const bv::ipyramid_t& a, const bv::ipyramid_t& b) {
+  BOOST_REQUIRE_EQUAL(a.size(), b.size());
+  for (uint64_t s=0; s<a.size(); ++s) {
+    const bv::ipscale_t& ia = a[s];
+    const bv::ipscale_t& ib = b[s];
+    BOOST_CHECK_EQUAL(ia.rows(), ib.rows());
+    BOOST_CHECK_EQUAL(ia.cols(), ib.cols());
+    BOOST_CHECK(ia.m_image == ib.m_image);
+    BOOST_CHECK_EQUAL(ia.m_scale, ib.m_scale);
+    BOOST_CHECK_EQUAL(ia.m_scan_min_x, ib.m_scan_min_x);
+    BOOST_CHECK_EQUAL(ia.m_scan_max_x, ib.m_scan_max_x);
+    BOOST_CHECK_EQUAL(ia.m_scan_min_y, ib.m_scan_min_y);
+    BOOST_CHECK_EQUAL(ia.m_scan_max_y, ib.m_scan_max_y);
+  }
+}
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( test_strided_load )
+{
+  bv::ipyramid_t p1, p2, p3;
+  BOOST_REQUIRE(p1.load(&contiguous[0], rows, cols));
+  BOOST_REQUIRE(p2.load(&contiguous[0], rows, cols, cols));
+  BOOST_REQUIRE(p3.load(&strided[0], rows, cols, stride));
+  BOOST_CHECK(p1.size() > 1);
+  check_equal(p1, p2);
+  check_equal(p1, p3);
+
+  // the top level is the image itself
+  for (uint64_t y=0; y<rows; ++y)
+    for (uint64_t x=0; x<cols; ++x)
+      BOOST_CHECK_EQUAL((int)p3[0].m_image(y,x), (int)contiguous[y * cols + x]);
+}
+
+BOOST_AUTO_TEST_CASE( test_reload )
+{
+  // The buffers of a pyramid are reused: loading a strided image after a
+  // larger one gives the same pyramid as loading it first
+  std::vector<uint8_t> large(2 * rows * 2 * cols, 17);
+  bv::ipyramid_t p1, p2;
+  BOOST_REQUIRE(p1.load(&large[0], 2 * rows, 2 * cols));
+  BOOST_REQUIRE(p1.load(&strided[0], rows, cols, stride));
+  BOOST_REQUIRE(p2.load(&contiguous[0], rows, cols));
+  check_equal(p1, p2);
+}
+
+BOOST_AUTO_TEST_CASE( test_keep_aspect_ratio )
+{
+  // As Qt::KeepAspectRatio: 0.25 * (97 x 131) is rounded to 24 x 33, and
+  // the largest size that fits in it with the aspect ratio of the image is
+  // 24 x 32
+  const bv::Matrix<uint8_t> image(rows, cols, &contiguous[0]);
+  bv::Matrix<uint8_t> scaled;
+  BOOST_REQUIRE(bv::scale(image, 0.25, scaled));
+  BOOST_CHECK_EQUAL(scaled.rows(), (uint64_t)24);
+  BOOST_CHECK_EQUAL(scaled.cols(), (uint64_t)32);
+
+  // the levels of the pyramid have the same sizes as the scaled images
+  bv::ipyramid_t p;
+  BOOST_REQUIRE(p.load(&contiguous[0], rows, cols));
+  for (uint64_t s=1; s<p.size(); ++s) {
+    uint64_t r, c;
+    BOOST_REQUIRE(bv::scaled_size(rows, cols, p[s].m_scale, r, c));
+    BOOST_CHECK_EQUAL(p[s].rows(), r);
+    BOOST_CHECK_EQUAL(p[s].cols(), c);
+    BOOST_CHECK(c * rows <= r * cols + cols);
+    BOOST_CHECK(r * cols <= c * rows + rows);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
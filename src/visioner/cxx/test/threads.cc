@@ -0,0 +1,188 @@
+/**
+ * @file visioner/cxx/test/threads.cc
+ * @date Fri 16 Oct 2026 21:14:08 CEST
+ * @author agent <agent@local>
+ *
+ * @brief Test the thread pool and the loops split on it
+ *
+ * Copyright (C) 2026 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE visioner-threads Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+
+#include "bob/visioner/util/threads.h"
+
+namespace bv = bob::visioner;
+
+/**
+ * Records the ranges (or tasks) processed and the largest number of threads
+ * running at the same time
+ */
+struct Recorder {
+  boost::mutex mutex;
+  std::vector<std::pair<uint64_t, uint64_t> > ranges;
+  size_t active;
+  size_t max_active;
+
+  Recorder(): active(0), max_active(0) {}
+
+  void enter() {
+    boost::lock_guard<boost::mutex> lock(mutex);
+    ++active;
+    max_active = std::max(max_active, active);
+  }
+
+  void leave(const std::pair<uint64_t, uint64_t>& range) {
+    boost::lock_guard<boost::mutex> lock(mutex);
+    --active;
+    ranges.push_back(range);
+  }
+};
+
+// Sleeps a bit, so that the threads overlap
+static void record_range(Recorder& recorder,
+    const std::pair<uint64_t, uint64_t>& range) {
+  recorder.enter();
+  boost::this_thread::sleep(boost::posix_time::milliseconds(2));
+  recorder.leave(range);
+}
+
+static void record_task(Recorder& recorder, uint64_t itask) {
+  record_range(recorder, std::make_pair(itask, itask + 1));
+}
+
+static void throw_task(uint64_t itask) {
+  if (itask == 3) throw std::runtime_error("task 3 failed");
+}
+
+// Checks that the recorded ranges are a partition of [0, size)
+static void check_partition(const Recorder& recorder, uint64_t size) {
+  std::vector<int> count(size, 0);
+  for (size_t i=0; i<recorder.ranges.size(); ++i) {
+    BOOST_CHECK(recorder.ranges[i].first <= recorder.ranges[i].second);
+    BOOST_CHECK(recorder.ranges[i].second <= size);
+    for (uint64_t k=recorder.ranges[i].first; k<recorder.ranges[i].second; ++k)
+      ++count[k];
+  }
+  for (uint64_t k=0; k<size; ++k) BOOST_CHECK_EQUAL(count[k], 1);
+}
+
+struct T {
+  T() { bv::ThreadPool::instance().set_n_threads(4); }
+  ~T() { bv::ThreadPool::instance().set_n_threads(0); }
+};
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( test_pool_run )
+{
+  bv::ThreadPool& pool = bv::ThreadPool::instance();
+  BOOST_CHECK_EQUAL(pool.n_threads(), (size_t)4);
+
+  for (size_t max_threads=0; max_threads<=5; ++max_threads) {
+    Recorder recorder;
+    const boost::function<void (uint64_t)> task =
+      boost::bind(&record_task, boost::ref(recorder), _1);
+    pool.run(37, task, max_threads);
+    BOOST_CHECK_EQUAL(recorder.ranges.size(), (size_t)37);
+    check_partition(recorder, 37);
+    BOOST_CHECK(recorder.max_active >= 1);
+    BOOST_CHECK(recorder.max_active <= 4);
+    if (max_threads > 0) BOOST_CHECK(recorder.max_active <= max_threads);
+  }
+}
+
+// Does not sleep: the workers finish the last tasks of a job while the
+// next one is submitted
+static void record_short_task(Recorder& recorder, uint64_t itask) {
+  recorder.enter();
+  recorder.leave(std::make_pair(itask, itask + 1));
+}
+
+BOOST_AUTO_TEST_CASE( test_pool_consecutive_jobs )
+{
+  // The threads still running a job are counted until they leave it, so
+  // that they do not run the tasks of the next job beyond its maximum
+  bv::ThreadPool& pool = bv::ThreadPool::instance();
+  for (size_t job=0; job<500; ++job) {
+    const size_t max_threads = 2 + job % 2;
+    Recorder recorder;
+    const boost::function<void (uint64_t)> task =
+      boost::bind(&record_short_task, boost::ref(recorder), _1);
+    pool.run(7 + job % 5, task, max_threads);
+    check_partition(recorder, 7 + job % 5);
+    BOOST_CHECK(recorder.max_active <= max_threads);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_pool_error )
+{
+  const boost::function<void (uint64_t)> task = &throw_task;
+  BOOST_CHECK_THROW(bv::ThreadPool::instance().run(10, task),
+      std::runtime_error);
+
+  // The pool is still usable afterwards
+  Recorder recorder;
+  const boost::function<void (uint64_t)> task2 =
+    boost::bind(&record_task, boost::ref(recorder), _1);
+  bv::ThreadPool::instance().run(10, task2);
+  check_partition(recorder, 10);
+}
+
+BOOST_AUTO_TEST_CASE( test_thread_loop )
+{
+  const uint64_t sizes[] = {0, 1, 3, 16, 100};
+  for (size_t i=0; i<sizeof(sizes)/sizeof(sizes[0]); ++i)
+    for (size_t num_of_threads=1; num_of_threads<=6; ++num_of_threads) {
+      Recorder recorder;
+      bv::thread_loop(boost::bind(&record_range, boost::ref(recorder), _1),
+          sizes[i], num_of_threads);
+      check_partition(recorder, sizes[i]);
+      // num_of_threads is honoured, and the loop is split in more chunks
+      // than threads to balance the load
+      BOOST_CHECK(recorder.max_active <= std::min<size_t>(num_of_threads, 4));
+      BOOST_CHECK(recorder.ranges.size() <=
+          std::min<size_t>(num_of_threads, 4) * bv::detail::tasks_per_thread);
+      if (sizes[i] >= 16)
+        BOOST_CHECK_EQUAL(recorder.ranges.size(),
+            std::min<size_t>(num_of_threads, 4) * bv::detail::tasks_per_thread);
+    }
+}
+
+// Runs a thread_loop (called by several threads at once)
+static void run_loop(Recorder* recorder, uint64_t size) {
+  bv::thread_loop(boost::bind(&record_range, boost::ref(*recorder), _1), size);
+}
+
+BOOST_AUTO_TEST_CASE( test_concurrent_callers )
+{
+  // The jobs of concurrent callers are serialized, and all complete
+  Recorder recorders[4];
+  boost::thread_group callers;
+  for (size_t i=0; i<4; ++i)
+    callers.create_thread(boost::bind(&run_loop, &recorders[i], 20 + i));
+  callers.join_all();
+  for (size_t i=0; i<4; ++i)
+    check_partition(recorders[i], 20 + i);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
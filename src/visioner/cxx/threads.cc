@@ -22,6 +22,14 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdexcept>
+#include <boost/thread/tss.hpp>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include "bob/visioner/util/threads.h"
 
 // Split some objects to process using multiple threads
@@ -38,3 +46,235 @@ void bob::visioner::thread_split(uint64_t n_objects,
   }
 
 }
+
+// Set in the threads that are currently running a task of the pool
+static boost::thread_specific_ptr<bool> s_in_task;
+
+static bool in_task() {
+  return s_in_task.get() && *s_in_task;
+}
+
+namespace {
+
+  // Flags the current thread as running a task of the pool (for its scope)
+  class TaskScope {
+    public:
+      TaskScope(): m_previous(in_task()) {
+        if (!s_in_task.get()) s_in_task.reset(new bool(false));
+        *s_in_task = true;
+      }
+      ~TaskScope() { *s_in_task = m_previous; }
+    private:
+      bool m_previous;
+  };
+
+}
+
+bob::visioner::ThreadPool& bob::visioner::ThreadPool::instance() {
+  static ThreadPool pool;
+  return pool;
+}
+
+bob::visioner::ThreadPool::ThreadPool()
+  : m_n_threads(0), m_pinning(false), m_stop(false),
+    m_task(0), m_n_tasks(0), m_next_task(0), m_pending_tasks(0),
+    m_max_threads(0), m_active_threads(0), m_error_task(0)
+{
+  set_n_threads(0);
+}
+
+bob::visioner::ThreadPool::~ThreadPool() {
+  stop();
+}
+
+void bob::visioner::ThreadPool::set_n_threads(size_t n_threads) {
+  if (n_threads == 0) n_threads = boost::thread::hardware_concurrency();
+  if (n_threads == 0) n_threads = 1;
+
+  boost::lock_guard<boost::mutex> submit(m_submit_mutex);
+  if (n_threads == m_n_threads) return;
+  stop(); // restarted with the new number of threads by the next job
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  m_n_threads = n_threads;
+}
+
+size_t bob::visioner::ThreadPool::n_threads() const {
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  return m_n_threads;
+}
+
+void bob::visioner::ThreadPool::set_pinning(bool pinning) {
+  boost::lock_guard<boost::mutex> submit(m_submit_mutex);
+  if (pinning == m_pinning) return;
+  stop(); // restarted with the new pinning by the next job
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  m_pinning = pinning;
+}
+
+bool bob::visioner::ThreadPool::pinning() const {
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  return m_pinning;
+}
+
+// Starts the worker threads (the submitting thread is the last one)
+void bob::visioner::ThreadPool::start() {
+  m_stop = false;
+  const size_t n_cores = std::max(1u, boost::thread::hardware_concurrency());
+  for (size_t ith = 0; ith + 1 < m_n_threads; ++ ith) {
+    boost::shared_ptr<boost::thread> worker(new boost::thread(
+          boost::bind(&ThreadPool::work, this)));
+#if defined(__linux__)
+    if (m_pinning) {
+      cpu_set_t cores;
+      CPU_ZERO(&cores);
+      CPU_SET(ith % n_cores, &cores);
+      pthread_setaffinity_np(worker->native_handle(), sizeof(cpu_set_t), &cores);
+    }
+#else
+    (void)n_cores;
+#endif
+    m_workers.push_back(worker);
+  }
+}
+
+// Stops and joins the worker threads (no job is running)
+void bob::visioner::ThreadPool::stop() {
+  {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_work_cond.notify_all();
+  for (size_t ith = 0; ith < m_workers.size(); ++ ith) {
+    m_workers[ith]->join();
+  }
+  m_workers.clear();
+}
+
+// Main loop of the worker threads
+void bob::visioner::ThreadPool::work() {
+  for (;;) {
+    {
+      boost::unique_lock<boost::mutex> lock(m_mutex);
+      while (!m_stop && (m_next_task >= m_n_tasks || 
+            m_active_threads >= m_max_threads)) {
+        m_work_cond.wait(lock);
+      }
+      if (m_stop) {
+        return;
+      }
+    }
+    execute();
+  }
+}
+
+// Runs the tasks of the current job until none is left to start (if the
+// maximum number of threads working on the job is not already reached)
+// NB: A thread is counted as active from the moment it joins the job to
+//  the moment it leaves it, both under the lock, and run() waits for all
+//  the threads to leave a job before submitting the next one: a worker
+//  finishing the last tasks of a job cannot run the tasks of the next job
+//  without being counted.
+void bob::visioner::ThreadPool::execute() {
+  TaskScope scope;
+  {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    if (m_next_task >= m_n_tasks || m_active_threads >= m_max_threads) {
+      return;
+    }
+    ++ m_active_threads;
+  }
+  for (;;) {
+    uint64_t itask;
+    const boost::function<void (uint64_t)>* task;
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      if (m_next_task >= m_n_tasks) {
+        if (-- m_active_threads == 0) {
+          m_done_cond.notify_all();
+        }
+        return;
+      }
+      itask = m_next_task ++;
+      task = m_task;
+    }
+
+    std::string error;
+    try {
+      (*task)(itask);
+    }
+    catch (std::exception& e) {
+      error = e.what();
+      if (error.empty()) error = "unknown exception";
+    }
+    catch (...) {
+      error = "unknown exception";
+    }
+
+    bool done;
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      if (!error.empty() && (m_error.empty() || itask < m_error_task)) {
+        m_error = error;
+        m_error_task = itask;
+      }
+      done = (-- m_pending_tasks == 0);
+    }
+    if (done) {
+      m_done_cond.notify_all();
+    }
+  }
+}
+
+void bob::visioner::ThreadPool::run(uint64_t n_tasks, 
+    const boost::function<void (uint64_t)>& task, size_t max_threads) {
+
+  if (n_tasks == 0) {
+    return;
+  }
+
+  // Nested jobs and jobs that cannot be split: run inline
+  if (in_task() || n_tasks == 1 || n_threads() == 1 || max_threads == 1) {
+    TaskScope scope;
+    for (uint64_t itask = 0; itask < n_tasks; ++ itask) {
+      task(itask);
+    }
+    return;
+  }
+
+  // Concurrent callers wait here for the current job to complete
+  boost::lock_guard<boost::mutex> submit(m_submit_mutex);
+  if (m_workers.empty()) {
+    start();
+  }
+
+  {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_task = &task;
+    m_n_tasks = n_tasks;
+    m_next_task = 0;
+    m_pending_tasks = n_tasks;
+    m_max_threads = (max_threads == 0 ? m_n_threads : 
+        std::min(max_threads, m_n_threads));
+    m_error.clear();
+  }
+  m_work_cond.notify_all();
+
+  // The submitting thread processes tasks as well
+  execute();
+
+  std::string error;
+  {
+    boost::unique_lock<boost::mutex> lock(m_mutex);
+    // All the tasks are done and all the threads have left the job
+    while (m_pending_tasks > 0 || m_active_threads > 0) {
+      m_done_cond.wait(lock);
+    }
+    m_task = 0;
+    m_n_tasks = m_next_task = 0;
+    error.swap(m_error);
+  }
+
+  if (!error.empty()) {
+    throw std::runtime_error(error);
+  }
+}
@@ -25,6 +25,7 @@
 #include <boost/make_shared.hpp>
 
 #include "bob/core/python/ndarray.h"
+#include "bob/core/python/gil.h"
 
 #include "bob/visioner/util/util.h"
 #include "bob/visioner/cv/cv_detector.h"
@@ -33,20 +34,48 @@
 namespace bp = boost::python;
 namespace tp = bob::python;
 
+/**
+ * Loads the image in the detector. Images with contiguous rows are given
+ * as they are (the pyramid copies them once), other ones are made
+ * contiguous first.
+ */
+static void load_image(bob::visioner::CVDetector& det,
+    const blitz::Array<uint8_t,2>& bzimage) {
+  if (bzimage.stride(1) != 1 || bzimage.stride(0) < bzimage.cols()) {
+    blitz::Array<uint8_t,2> tmp(bzimage.shape());
+    tmp = bzimage;
+    det.load(tmp.data(), tmp.rows(), tmp.cols());
+  }
+  else {
+    det.load(bzimage.data(), bzimage.rows(), bzimage.cols(), bzimage.stride(0));
+  }
+}
+
+/**
+ * Scans the image and sorts the detections by descending scores, without the
+ * GIL. The detector keeps the pyramid of the last image it has loaded, so
+ * that it is used by one thread at a time.
+ */
+static void scan(bob::visioner::CVDetector& det, tp::const_ndarray image,
+    std::vector<bob::visioner::detection_t>& detections) {
+  const blitz::Array<uint8_t,2> bzimage = image.bz<uint8_t,2>();
+  tp::no_gil unlock;
+  tp::object_lock lock(&det);
+  load_image(det, bzimage);
+  det.scan(detections);
+  det.sort_desc(detections);
+}
+
 static bp::object detect_max(bob::visioner::CVDetector& det, 
     tp::const_ndarray image) {
 
-  blitz::Array<uint8_t,2> bzimage = image.bz<uint8_t,2>();
-  det.load(bzimage.data(), bzimage.rows(), bzimage.cols());
   std::vector<bob::visioner::detection_t> detections;
-  det.scan(detections);
+  scan(det, image, detections);
 
   if (detections.size() == 0) {
     return bp::object();
   }
 
-  det.sort_desc(detections);
-
   // Returns a tuple containing the detection bbox
   qreal x, y, width, height;
   detections[0].second.first.getRect(&x, &y, &width, &height);
@@ -55,18 +84,14 @@ static bp::object detect_max(bob::visioner::CVDetector& det,
 
 static bp::object detect(bob::visioner::CVDetector& det,
     tp::const_ndarray image) {
-  
-  blitz::Array<uint8_t,2> bzimage = image.bz<uint8_t,2>();
-  det.load(bzimage.data(), bzimage.rows(), bzimage.cols());
+
   std::vector<bob::visioner::detection_t> detections;
-  det.scan(detections);
-  
+  scan(det, image, detections);
+
   if (detections.size() == 0) {
     return bp::object();
   }
 
-  det.sort_desc(detections);
-
   // Returns a tuple containing all detections, with descending scores
   bp::list tmp;
   qreal x, y, width, height;
@@ -80,24 +105,28 @@ static bp::object detect(bob::visioner::CVDetector& det,
 static bp::object locate(bob::visioner::CVLocalizer& loc,
     bob::visioner::CVDetector& det, tp::const_ndarray image) {
 
-  blitz::Array<uint8_t,2> bzimage = image.bz<uint8_t,2>();
-  det.load(bzimage.data(), bzimage.rows(), bzimage.cols());
+  const blitz::Array<uint8_t,2> bzimage = image.bz<uint8_t,2>();
   std::vector<bob::visioner::detection_t> detections;
-  det.scan(detections);
-  
-  if (detections.size() == 0) {
-    return bp::object();
-  }
-
-  det.sort_desc(detections);
-
-  // Locate keypoints
   bob::visioner::Object object;
   std::vector<QPointF> dt_points;
+  {
+    // keypoints are located on the pyramid loaded in the detector: same
+    // locking as scan() above, until the end of the localization
+    tp::no_gil unlock;
+    tp::object_lock lock(&det);
+    load_image(det, bzimage);
+    det.scan(detections);
+    det.sort_desc(detections);
+
+    // Locate keypoints
+    for (std::vector<bob::visioner::detection_t>::const_iterator it = detections.begin(); it != detections.end(); ++ it) {
+      if (det.match(*it, object) && loc.locate(det, it->second.first, dt_points))
+        break;
+    }
+  }
 
-  for (std::vector<bob::visioner::detection_t>::const_iterator it = detections.begin(); it != detections.end(); ++ it) {
-    if (det.match(*it, object) && loc.locate(det, it->second.first, dt_points))
-      break;
+  if (detections.size() == 0) {
+    return bp::object();
   }
 
   // Returns a 2-tuple: 
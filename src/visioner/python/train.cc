@@ -36,6 +36,7 @@
 
 #include "bob/visioner/model/mdecoder.h"
 #include "bob/visioner/model/sampler.h"
+#include "bob/visioner/util/threads.h"
 
 namespace bp = boost::python;
 namespace tp = bob::python;
@@ -55,6 +56,15 @@ inline static bool is_dot_vbin(const std::string& filename) {
     boost::filesystem::extension(filename) == ".vbgz";
 }
 
+static void set_pool_threads(size_t n_threads, bool pinning) {
+  bob::visioner::ThreadPool::instance().set_n_threads(n_threads);
+  bob::visioner::ThreadPool::instance().set_pinning(pinning);
+}
+
+static size_t get_pool_threads() {
+  return bob::visioner::ThreadPool::instance().n_threads();
+}
+
 static bool train_model(bob::visioner::Model& model, 
     const bob::visioner::Sampler& training, 
     const bob::visioner::Sampler& validation, size_t threads) {
@@ -237,6 +247,9 @@ void bind_visioner_train() {
     .def("train", &train_model, (bp::arg("self"), bp::arg("training_sampler"), bp::arg("validation_sampler"), bp::arg("threads")), "Trains the boosted classifier using training and validation samplers with the specified number of threads (0 to run in the current thread and 1 or more to spawn new worker threads).")
     ;
 
+  bp::def("set_pool_threads", &set_pool_threads, (bp::arg("threads")=0, bp::arg("pinning")=false), "Sets the number of threads of the pool shared by all the multi-threaded training and scanning routines of this module (0 means one per hardware core). Their actual number of tasks still depends on the number of threads given to each of them. If pinning is set, each worker thread is bound to a core (Linux only).");
+  bp::def("get_pool_threads", &get_pool_threads, "Returns the number of threads of the pool shared by all the multi-threaded training and scanning routines of this module.");
+
   bp::scope().attr("LOSSES") = available_losses();
   bp::scope().attr("TAGGERS") = available_taggers();
   bp::scope().attr("MODELS") = available_models();